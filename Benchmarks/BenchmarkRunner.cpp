@@ -0,0 +1,203 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <stdexcept>
+#include "BenchmarkRunner.h"
+
+namespace {
+	std::atomic<std::uint64_t> numAllocations( 0 );
+	std::atomic<std::uint64_t> numAllocatedBytes( 0 );
+	thread_local std::uint64_t numThreadAllocations = 0;
+}
+
+
+// global replacement of the allocation functions for counting all heap allocations of the process (including those of worker threads)
+void* operator new(std::size_t size)
+{
+	numAllocations.fetch_add( 1, std::memory_order_relaxed );
+	numAllocatedBytes.fetch_add( size, std::memory_order_relaxed );
+	numThreadAllocations++;
+	if ( size == 0 ) {
+		size = 1;
+	}
+	void* ptr = std::malloc( size );
+	if ( ptr == nullptr ) {
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+
+void* operator new[](std::size_t size)
+{
+	return operator new( size );
+}
+
+
+void operator delete(void* ptr) noexcept
+{
+	std::free( ptr );
+}
+
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free( ptr );
+}
+
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free( ptr );
+}
+
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+	std::free( ptr );
+}
+
+
+
+/**	@brief		Obtains the number of heap allocations performed by the process since its start
+*	@return						Number of calls of the global operator new
+*	@exception					None
+*	@remarks					Allocations of all threads are counted
+*/
+std::uint64_t Benchmarks::GetNumAllocations()
+{
+	return numAllocations.load( std::memory_order_relaxed );
+}
+
+
+
+/**	@brief		Obtains the number of bytes allocated on the heap by the process since its start
+*	@return						Number of bytes requested from the global operator new
+*	@exception					None
+*	@remarks					Allocations of all threads are counted
+*/
+std::uint64_t Benchmarks::GetNumAllocatedBytes()
+{
+	return numAllocatedBytes.load( std::memory_order_relaxed );
+}
+
+
+
+/**	@brief		Obtains the number of heap allocations performed by the calling thread since its start
+*	@return						Number of calls of the global operator new from the calling thread
+*	@exception					None
+*	@remarks					It allows checking a single operation while worker threads are allocating memory in parallel
+*/
+std::uint64_t Benchmarks::GetNumThreadAllocations()
+{
+	return numThreadAllocations;
+}
+
+
+
+/**	@brief		Constructor
+*	@param		minRunTime				Minimum measurement time of each benchmark [s]
+*	@param		minIterations			Minimum number of calls of each benchmark
+*	@exception	std::domain_error		Thrown if the minimum run time is negative or the minimum number of iterations is smaller than 1
+*	@remarks							None
+*/
+Benchmarks::CBenchmarkRunner::CBenchmarkRunner(double minRunTime, int minIterations)
+	: minRunTime( minRunTime ),
+	  minIterations( minIterations )
+{
+	if ( ( minRunTime < 0 ) || ( minIterations < 1 ) ) {
+		throw std::domain_error( "The minimum run time or number of iterations of the benchmarks is invalid." );
+	}
+}
+
+
+
+/**	@brief		Registers a benchmark
+*	@param		name					Name of the benchmark, it is used for filtering the benchmarks to be run
+*	@param		samplesPerCall			Number of audio samples processed by one call of the benchmark function, it is used for calculating the throughput
+*	@param		benchmark				Function performing one call of the benchmarked operation. All preparations must be done before registration.
+*	@param		isAllocationFree		Flag stating if the benchmarked operation must not allocate memory in the steady state. The benchmark fails if any allocation occurs after the warm-up call.
+*	@return								None
+*	@exception							None
+*	@remarks							The benchmarks are run in the order of registration
+*/
+void Benchmarks::CBenchmarkRunner::Register(const std::string& name, double samplesPerCall, std::function<void(void)> benchmark, bool isAllocationFree)
+{
+	benchmarks.push_back( BenchmarkType{ name, samplesPerCall, benchmark, isAllocationFree } );
+}
+
+
+
+/**	@brief		Runs all benchmarks matching the filter and writes the results as a table
+*	@param		filter					Only benchmarks containing this string in their name are run. All benchmarks are run if it is empty.
+*	@param		out						Output stream for the results
+*	@return								Number of failed benchmarks
+*	@exception							None
+*	@remarks							Each benchmark is called once for warm-up before the measurement. Exceptions thrown by a benchmark are reported and the benchmark is skipped.
+*										Allocations during the measurement of an allocation-free benchmark are reported as failure.
+*/
+int Benchmarks::CBenchmarkRunner::Run(const std::string& filter, std::ostream& out)
+{
+	using namespace std;
+	using namespace std::chrono;
+
+	int numFailed = 0;
+
+	out << left << setw( 56 ) << "Benchmark" << right << setw( 10 ) << "Calls" << setw( 16 ) << "Time/call [us]" << setw( 16 ) << "Samples/s" << setw( 14 ) << "Allocs/call" << setw( 14 ) << "Bytes/call" << endl;
+	out << string( 126, '-' ) << endl;
+
+	for ( const auto& benchmark : benchmarks ) {
+		if ( !filter.empty() && ( benchmark.name.find( filter ) == string::npos ) ) {
+			continue;
+		}
+
+		try {
+			// warm-up call
+			benchmark.benchmark();
+
+			// measurement
+			long long numCalls = 0;
+			auto startAllocations = GetNumAllocations();
+			auto startAllocatedBytes = GetNumAllocatedBytes();
+			auto startTime = steady_clock::now();
+			double elapsed = 0;
+			while ( ( elapsed < minRunTime ) || ( numCalls < minIterations ) ) {
+				benchmark.benchmark();
+				numCalls++;
+				elapsed = duration<double>( steady_clock::now() - startTime ).count();
+			}
+			auto allocationsPerCall = static_cast<double>( GetNumAllocations() - startAllocations ) / numCalls;
+			auto bytesPerCall = static_cast<double>( GetNumAllocatedBytes() - startAllocatedBytes ) / numCalls;
+			auto timePerCall = elapsed / numCalls;
+
+			out << left << setw( 56 ) << benchmark.name << right << setw( 10 ) << numCalls << fixed << setprecision( 1 ) << setw( 16 ) << timePerCall * 1.0e6 << setprecision( 0 ) << setw( 16 ) << benchmark.samplesPerCall / timePerCall << setprecision( 1 ) << setw( 14 ) << allocationsPerCall << setprecision( 0 ) << setw( 14 ) << bytesPerCall << endl;
+			if ( benchmark.isAllocationFree && ( allocationsPerCall > 0 ) ) {
+				throw std::runtime_error( "Memory was allocated in the steady state." );
+			}
+		} catch ( const std::exception& e ) {
+			out << left << setw( 56 ) << benchmark.name << " FAILED: " << e.what() << endl;
+			numFailed++;
+		}
+	}
+
+	return numFailed;
+}
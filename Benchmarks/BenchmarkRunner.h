@@ -0,0 +1,54 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+
+/*@{*/
+/** \ingroup Benchmarks
+*/
+namespace Benchmarks {
+	std::uint64_t GetNumAllocations();
+	std::uint64_t GetNumAllocatedBytes();
+	std::uint64_t GetNumThreadAllocations();
+
+	/**	\ingroup Benchmarks
+	*	Class running registered micro-benchmarks and reporting the throughput (samples/s) and the heap allocations per call
+	*/
+	class CBenchmarkRunner
+	{
+	public:
+		CBenchmarkRunner(double minRunTime, int minIterations);
+		void Register(const std::string& name, double samplesPerCall, std::function<void(void)> benchmark, bool isAllocationFree = false);
+		int Run(const std::string& filter, std::ostream& out);
+	private:
+		struct BenchmarkType {
+			std::string name;
+			double samplesPerCall;
+			std::function<void(void)> benchmark;
+			bool isAllocationFree;
+		};
+
+		double minRunTime;
+		int minIterations;
+		std::vector<BenchmarkType> benchmarks;
+	};
+}
+/*@}*/
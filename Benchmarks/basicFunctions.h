@@ -0,0 +1,198 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <random>
+#include <cmath>
+#include <stdexcept>
+#include <boost/math/constants/constants.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "AudioInputParam.h"
+#include "AnalysisParam.h"
+#include "DataProcessing.h"
+
+/*@{*/
+/** \ingroup Benchmarks
+*/
+namespace Benchmarks {
+	const std::string audioSettingsFileName = "audioSettings.dat";
+	const std::vector<int> testCode = { 1, 2, 3, 4, 5 };			// FME code contained in the generated test signal
+	const double toneLength = 0.07;									// length of a single FME tone [s]
+	const double silenceLength = 0.4;								// length of the silence before and after the FME code [s]
+
+
+	/**	@brief		Loads the audio settings required for the benchmarks
+	*	@param		parameterFileName				File name of the general sequence search parameters
+	*	@param		specializedParameterFileName	File name of the FME sequence search parameters
+	*	@param		maxRequiredProcFreq				Maximum frequency required for the processing [Hz]
+	*	@param		transWidthProc					Transition width of the processing downsampling filter [Hz]
+	*	@param		standardSamplingFreqs			Standard sampling frequencies of the audio input [Hz]
+	*	@return										None
+	*	@exception	std::ios_base::failure			Thrown if the audio settings file cannot be read
+	*	@remarks									None
+	*/
+	inline void LoadAudioSettings(std::string& parameterFileName, std::string& specializedParameterFileName, double& maxRequiredProcFreq, double& transWidthProc, std::vector<double>& standardSamplingFreqs)
+	{
+		double sampleLength, transWidthRec;
+		float mainThreadCycleTime;
+		int numChannels, maxLengthInputQueue, maxMissedAttempts, channel;
+		Core::CAudioInputParam params;
+
+		std::ifstream ifs( audioSettingsFileName );
+		if ( !ifs.is_open() ) {
+			throw std::ios_base::failure( "Parameter file cannot be read." );
+		}
+		boost::archive::text_iarchive ia( ifs );
+		ia >> params;
+		params.Get( sampleLength, numChannels, maxLengthInputQueue, maxMissedAttempts, channel, parameterFileName, specializedParameterFileName, maxRequiredProcFreq, transWidthProc, transWidthRec, mainThreadCycleTime, standardSamplingFreqs );
+	}
+
+
+
+	/**	\ingroup Benchmarks
+	*	General sequence search parameters (see Core::General::CAnalysisParam)
+	*/
+	struct AnalysisSettings {
+		double sampleLength;
+		double sampleLengthCoarse;
+		int maxPeaks;
+		int maxPeaksCoarse;
+		int freqResolution;
+		int freqResolutionCoarse;
+		double maxDeltaF;
+		double overlap;
+		double overlapCoarse;
+		double delta;
+		double deltaCoarse;
+		double maxFreqDevConstrained;
+		double maxFreqDevUnconstrained;
+		int numNeighbours;
+		double evalToneLength;
+		double searchTimestep;
+		std::vector<double> searchFreqs;
+	};
+
+
+
+	/**	@brief		Loads the general sequence search parameters
+	*	@param		parameterFileName				File name of the general sequence search parameters
+	*	@return										General sequence search parameters
+	*	@exception	std::ios_base::failure			Thrown if the parameter file cannot be read
+	*	@remarks									None
+	*/
+	inline AnalysisSettings LoadAnalysisParameters(const std::string& parameterFileName)
+	{
+		AnalysisSettings settings;
+		Core::General::CAnalysisParam params;
+
+		std::ifstream ifs( parameterFileName );
+		if ( !ifs.is_open() ) {
+			throw std::ios_base::failure( "Parameter file cannot be read." );
+		}
+		boost::archive::text_iarchive ia( ifs );
+		ia >> params;
+		params.Get( settings.sampleLength, settings.sampleLengthCoarse, settings.maxPeaks, settings.maxPeaksCoarse, settings.freqResolution, settings.freqResolutionCoarse, settings.maxDeltaF, settings.overlap, settings.overlapCoarse, settings.delta, settings.deltaCoarse, settings.maxFreqDevConstrained, settings.maxFreqDevUnconstrained, settings.numNeighbours, settings.evalToneLength, settings.searchTimestep, std::back_inserter( settings.searchFreqs ) );
+
+		return settings;
+	}
+
+
+
+	/**	@brief		Calculates the processing downsampling factor for a sampling frequency
+	*	@param		samplingFreq				Sampling frequency of the audio input [Hz]
+	*	@param		maxRequiredProcFreq			Maximum frequency required for the processing [Hz]
+	*	@return									Downsampling factor
+	*	@exception								None
+	*	@remarks								Identical to the rule of Core::CAudioInput::CPrivImplementation::GetBestWorkingParameters
+	*/
+	inline int GetDownsamplingFactorProc(double samplingFreq, double maxRequiredProcFreq)
+	{
+		int downsamplingFactorProc = static_cast<int>( std::floor( samplingFreq / ( 2 * maxRequiredProcFreq ) ) );
+		if ( downsamplingFactorProc < 1 ) {
+			downsamplingFactorProc = 1;
+		}
+		if ( ( Core::Processing::CDataProcessing<float>::IsPrimeNumber( downsamplingFactorProc ) ) && ( downsamplingFactorProc != 2 ) ) {
+			downsamplingFactorProc--;
+		}
+
+		return downsamplingFactorProc;
+	}
+
+
+
+	/**	@brief		Generates a noisy test signal containing the FME code Benchmarks::testCode
+	*	@param		samplingFreq				Sampling frequency [Hz]
+	*	@param		searchFreqs					Frequencies of the tones (index 0 - 9: digits 1 - 9, 0; index 10: repetition tone) [Hz]
+	*	@return									Signal containing silence, the FME code and silence again
+	*	@exception								None
+	*	@remarks								The noise is generated with a fixed seed, the signal is therefore reproducible
+	*/
+	inline std::vector<float> GenerateFMESignal(double samplingFreq, const std::vector<double>& searchFreqs)
+	{
+		using namespace std;
+		const auto pi = boost::math::constants::pi<double>();
+
+		mt19937 eng( 42 );
+		normal_distribution<float> noise( 0.0f, 0.01f );
+		vector<float> signal;
+
+		auto numSilence = static_cast<size_t>( silenceLength * samplingFreq );
+		auto numTone = static_cast<size_t>( toneLength * samplingFreq );
+		signal.reserve( 2 * numSilence + testCode.size() * numTone );
+
+		for ( size_t i = 0; i < numSilence; i++ ) {
+			signal.push_back( noise( eng ) );
+		}
+		int lastDigit = -1;
+		for ( auto digit : testCode ) {
+			double freq = ( digit == lastDigit ) ? searchFreqs.at( 10 ) : searchFreqs.at( ( digit + 9 ) % 10 );
+			for ( size_t i = 0; i < numTone; i++ ) {
+				signal.push_back( static_cast<float>( 0.5 * sin( 2 * pi * freq * i / samplingFreq ) ) + noise( eng ) );
+			}
+			lastDigit = digit;
+		}
+		for ( size_t i = 0; i < numSilence; i++ ) {
+			signal.push_back( noise( eng ) );
+		}
+
+		return signal;
+	}
+
+
+
+	/**	@brief		Generates equidistant timestamps for a signal
+	*	@param		startTime					Timestamp of the first sample
+	*	@param		numSamples					Number of samples
+	*	@param		samplingFreq				Sampling frequency [Hz]
+	*	@return									Timestamps of all samples
+	*	@exception								None
+	*	@remarks								None
+	*/
+	inline std::vector<boost::posix_time::ptime> GenerateTimes(const boost::posix_time::ptime& startTime, size_t numSamples, double samplingFreq)
+	{
+		std::vector<boost::posix_time::ptime> times( numSamples );
+		for ( size_t i = 0; i < numSamples; i++ ) {
+			times[i] = startTime + boost::posix_time::microseconds( static_cast<long>( i / samplingFreq * 1.0e6 ) );
+		}
+
+		return times;
+	}
+}
+/*@}*/
@@ -0,0 +1,78 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+/**	\defgroup	Benchmarks	Micro-benchmarks of the signal processing stages.
+*/
+
+/*@{*/
+/** \ingroup Benchmarks
+*/
+#include <iostream>
+#include <string>
+#include <boost/lexical_cast.hpp>
+#include "BenchmarkRunner.h"
+
+// benchmark suites
+#include "filterBenchmark.h"
+#include "fftBenchmark.h"
+#include "searchBenchmark.h"
+
+/*@}*/
+
+
+
+/**	@brief		Main function of the benchmark program
+*	@param		argc						Number of command line arguments
+*	@param		argv						Command line arguments: [filter] [--min-time <seconds>] [--min-iterations <number>]
+*	@return									0 if all benchmarks succeeded, otherwise 1
+*	@exception								None
+*	@remarks								The parameter files of the signal processing are expected in the current directory
+*/
+int main(int argc, char* argv[])
+{
+	using namespace std;
+
+	string filter;
+	double minRunTime = 1.0;
+	int minIterations = 10;
+
+	try {
+		for ( int i = 1; i < argc; i++ ) {
+			string arg = argv[i];
+			if ( ( arg == "--min-time" ) && ( i + 1 < argc ) ) {
+				minRunTime = boost::lexical_cast<double>( argv[++i] );
+			} else if ( ( arg == "--min-iterations" ) && ( i + 1 < argc ) ) {
+				minIterations = boost::lexical_cast<int>( argv[++i] );
+			} else {
+				filter = arg;
+			}
+		}
+
+		Benchmarks::CBenchmarkRunner runner( minRunTime, minIterations );
+		Benchmarks::RegisterFilterBenchmarks( runner );
+		Benchmarks::RegisterFFTBenchmarks( runner );
+		Benchmarks::RegisterSearchBenchmarks( runner );
+
+		if ( runner.Run( filter, cout ) > 0 ) {
+			return 1;
+		}
+	} catch ( const std::exception& e ) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/range/iterator_range.hpp>
+#include "FFT.h"
+#include "DataProcessing.h"
+#include "BenchmarkRunner.h"
+#include "basicFunctions.h"
+
+/*@{*/
+/** \ingroup Benchmarks
+*/
+namespace Benchmarks {
+	/**	@brief		Registers the benchmarks of the spectrogram and the peak search for the fine and the coarse frequency search
+	*	@param		runner						Benchmark runner
+	*	@return									None
+	*	@exception								None
+	*	@remarks								The parameters are identical to those used by Core::General::CFrequencySearch at the highest standard sampling frequency.
+	*											The spectrogram is calculated for one second of audio signal, the peak search for a single spectrum during the first tone.
+	*											As in the frequency search the spectrogram is stored in a contiguous buffer, the peak search in all of its frames must not allocate memory.
+	*/
+	inline void RegisterFFTBenchmarks(CBenchmarkRunner& runner)
+	{
+		using namespace std;
+		using namespace Core::Processing;
+
+		string parameterFileName, specializedParameterFileName;
+		double maxRequiredProcFreq, transWidthProc;
+		vector<double> standardSamplingFreqs;
+
+		LoadAudioSettings( parameterFileName, specializedParameterFileName, maxRequiredProcFreq, transWidthProc, standardSamplingFreqs );
+		auto settings = LoadAnalysisParameters( parameterFileName );
+		double samplingFreq = standardSamplingFreqs.back() / GetDownsamplingFactorProc( standardSamplingFreqs.back(), maxRequiredProcFreq );
+
+		auto signalFloat = GenerateFMESignal( samplingFreq, settings.searchFreqs );
+		auto signal = make_shared< vector<double> >( signalFloat.begin(), signalFloat.begin() + static_cast<size_t>( samplingFreq ) );
+
+		struct SpectrogramConfig {
+			string name;
+			double sampleLength;
+			int freqResolution;
+			double overlap;
+			double delta;
+			int maxNumPeaks;
+		};
+		struct SpectrogramBuffer {
+			vector<double> data;
+			vector< boost::iterator_range< vector<double>::iterator > > frames;	// frames referring to the contiguous data
+		};
+		vector<SpectrogramConfig> configs = {
+			{ "fine", settings.sampleLength, settings.freqResolution, settings.overlap, settings.delta, settings.maxPeaks },
+			{ "coarse", settings.sampleLengthCoarse, settings.freqResolutionCoarse, settings.overlapCoarse, settings.deltaCoarse, settings.maxPeaksCoarse }
+		};
+
+		for ( const auto& config : configs ) {
+			int numSamples = static_cast<int>( config.sampleLength / 1000 * samplingFreq );
+			auto numTimesteps = CFFT<double>::GetNumSpectrogramTimesteps( static_cast<int>( signal->size() ), config.overlap, numSamples );
+
+			auto fft = make_shared< CFFT<double> >();
+			fft->Init( config.freqResolution );
+			auto spectrum = make_shared<SpectrogramBuffer>();
+			spectrum->data.resize( numTimesteps * config.freqResolution );
+			CDataProcessing<double>::SplitIntoFrames( spectrum->data.begin(), spectrum->data.end(), config.freqResolution, back_inserter( spectrum->frames ) );
+			auto freq = make_shared< vector<double> >( config.freqResolution );
+			auto time = make_shared< vector<double> >( numTimesteps );
+
+			auto suffix = "/" + config.name + "/fs:" + to_string( static_cast<int>( samplingFreq ) ) + "/nfft:" + to_string( config.freqResolution );
+			runner.Register( "CFFT::Spectrogram" + suffix, static_cast<double>( signal->size() ), [=]() {
+				fft->Spectrogram( spectrum->frames.begin(), freq->begin(), time->begin(), signal->begin(), signal->end(), numSamples, config.overlap, samplingFreq );
+			} );
+
+			// select a spectrum in the middle of the first tone for the peak search
+			fft->Spectrogram( spectrum->frames.begin(), freq->begin(), time->begin(), signal->begin(), signal->end(), numSamples, config.overlap, samplingFreq );
+			auto toneIndex = static_cast<size_t>( ( silenceLength + toneLength / 2 ) / ( time->at( 1 ) - time->at( 0 ) ) );
+			auto currentFrame = spectrum->frames.at( min( toneIndex, spectrum->frames.size() - 1 ) );
+			auto currentSpectrum = make_shared< vector<double> >( currentFrame.begin(), currentFrame.end() );
+			auto normalizedSpectrum = make_shared< vector<double> >( currentSpectrum->size() );
+			auto minPeaks = make_shared< vector<double> >();
+			auto maxPeaks = make_shared< vector<double> >();
+			CDataProcessing<double>::NormalizeData( currentSpectrum->begin(), currentSpectrum->end(), normalizedSpectrum->begin() );
+
+			runner.Register( "CDataProcessing::NormalizeData" + suffix, static_cast<double>( currentSpectrum->size() ), [=]() {
+				CDataProcessing<double>::NormalizeData( currentSpectrum->begin(), currentSpectrum->end(), normalizedSpectrum->begin() );
+			} );
+			runner.Register( "CDataProcessing::FindPeaks" + suffix, static_cast<double>( currentSpectrum->size() ), [=]() {
+				minPeaks->clear();
+				maxPeaks->clear();
+				CDataProcessing<double>::FindPeaks( freq->begin(), freq->end(), normalizedSpectrum->begin(), back_inserter( *minPeaks ), back_inserter( *maxPeaks ), config.delta );
+			} );
+
+			// peak search in all frames with the buffers of the frequency search
+			auto peakIndices = make_shared< vector<int> >( spectrum->frames.size() * config.maxNumPeaks );
+			auto numPeaks = make_shared< vector<int> >( spectrum->frames.size() );
+			auto peaks = make_shared< vector< vector<float> > >( spectrum->frames.size() );
+			auto levels = make_shared< vector< vector<float> > >( spectrum->frames.size() );
+			for ( size_t i = 0; i < spectrum->frames.size(); i++ ) {
+				( *peaks )[i].reserve( config.maxNumPeaks );
+				( *levels )[i].reserve( config.maxNumPeaks );
+			}
+			CDataProcessing<double>::FindSpectrogramPeakIndices( spectrum->frames.begin(), spectrum->frames.end(), peakIndices->begin(), numPeaks->begin(), config.maxNumPeaks, config.delta );
+
+			runner.Register( "CDataProcessing::FindSpectrogramPeakIndices" + suffix, static_cast<double>( signal->size() ), [=]() {
+				CDataProcessing<double>::FindSpectrogramPeakIndices( spectrum->frames.begin(), spectrum->frames.end(), peakIndices->begin(), numPeaks->begin(), config.maxNumPeaks, config.delta );
+			}, true );
+			runner.Register( "CDataProcessing::InterpolateSpectrogramPeaks" + suffix, static_cast<double>( signal->size() ), [=]() {
+				CDataProcessing<double>::InterpolateSpectrogramPeaks( spectrum->frames.begin(), spectrum->frames.end(), freq->begin(), peakIndices->begin(), numPeaks->begin(), config.maxNumPeaks, peaks->begin(), levels->begin() );
+			}, true );
+		}
+	}
+}
+/*@}*/
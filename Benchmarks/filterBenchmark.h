@@ -0,0 +1,75 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "FIRfilter.h"
+#include "BenchmarkRunner.h"
+#include "basicFunctions.h"
+
+/*@{*/
+/** \ingroup Benchmarks
+*/
+namespace Benchmarks {
+	const double filterSignalLength = 1.0;		// length of the filtered signal per call [s]
+
+
+	/**	@brief		Registers the benchmarks of the processing downsampling filter for all standard sampling frequencies
+	*	@param		runner						Benchmark runner
+	*	@return									None
+	*	@exception								None
+	*	@remarks								The filter is designed identically to Core::Audio::CAudioFullDownsampler with the downsampling factor chosen by the audio input
+	*/
+	inline void RegisterFilterBenchmarks(CBenchmarkRunner& runner)
+	{
+		using namespace std;
+		using namespace Core::Processing::Filter;
+
+		string parameterFileName, specializedParameterFileName;
+		double maxRequiredProcFreq, transWidthProc;
+		vector<double> standardSamplingFreqs;
+
+		LoadAudioSettings( parameterFileName, specializedParameterFileName, maxRequiredProcFreq, transWidthProc, standardSamplingFreqs );
+		auto settings = LoadAnalysisParameters( parameterFileName );
+
+		for ( auto samplingFreq : standardSamplingFreqs ) {
+			int downsamplingFactor = GetDownsamplingFactorProc( samplingFreq, maxRequiredProcFreq );
+
+			vector<float> filterParams;
+			CFIRfilter<float>::DesignLowPassFilter( static_cast<float>( transWidthProc ), static_cast<float>( maxRequiredProcFreq ), static_cast<float>( samplingFreq ), back_inserter( filterParams ) );
+			auto filter = make_shared< CFIRfilter<float> >();
+			if ( downsamplingFactor > 1 ) {
+				filter->SetParams( filterParams.begin(), filterParams.end(), downsamplingFactor, 1, 1e-7f );
+			} else {
+				filter->SetParams( filterParams.begin(), filterParams.end(), downsamplingFactor, 1 );
+			}
+
+			auto signal = make_shared< vector<float> >( GenerateFMESignal( samplingFreq, settings.searchFreqs ) );
+			signal->resize( static_cast<size_t>( filterSignalLength * samplingFreq ) );
+			auto filteredSignal = make_shared< vector<float> >();
+			filteredSignal->reserve( signal->size() );
+
+			auto name = "CFIRfilter::Processing/fs:" + to_string( static_cast<int>( samplingFreq ) ) + "/ds:" + to_string( downsamplingFactor ) + "/order:" + to_string( filterParams.size() - 1 );
+			runner.Register( name, static_cast<double>( signal->size() ), [=]() {
+				filteredSignal->clear();
+				filter->Processing( signal->begin(), signal->end(), back_inserter( *filteredSignal ) );
+			} );
+		}
+	}
+}
+/*@}*/
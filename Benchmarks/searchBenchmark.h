@@ -0,0 +1,368 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "FrequencySearch.h"
+#include "ToneSearch.h"
+#include "FMESequenceSearch.h"
+#include "FME.h"
+#include "BenchmarkRunner.h"
+#include "basicFunctions.h"
+
+/*@{*/
+/** \ingroup Benchmarks
+*/
+namespace Benchmarks {
+	using ToneType = std::tuple< int, boost::posix_time::ptime, boost::posix_time::ptime, boost::posix_time::ptime, float, float >;
+	const double maxWaitTime = 10.0;			// maximum waiting time for the results of a threaded stage [s]
+	const double idleTime = 0.5;				// waiting time without new results after which a threaded stage is regarded as finished during calibration [s]
+	const auto pollingInterval = std::chrono::microseconds( 100 );
+
+
+	/**	\ingroup Benchmarks
+	*	Recorded output of the fine and coarse frequency search for the test signal
+	*/
+	struct FrequencyStreams {
+		std::vector<boost::posix_time::ptime> timeCalc;
+		std::vector<boost::posix_time::ptime> timeRef;
+		std::vector< std::vector<float> > peaks;
+		std::vector<boost::posix_time::ptime> timeCalcCoarse;
+		std::vector< std::vector<float> > peaksCoarse;
+		std::vector< std::vector<float> > absToneLevelsCoarse;
+	};
+
+
+
+	/**	@brief		Waits until a threaded stage has delivered the required number of results
+	*	@param		getNumNewResults			Function obtaining the number of newly available results from the stage
+	*	@param		numRequiredResults			Required number of results
+	*	@return									None
+	*	@exception	std::runtime_error			Thrown if the results are not available within Benchmarks::maxWaitTime
+	*	@remarks								None
+	*/
+	inline void WaitForResults(std::function<size_t(void)> getNumNewResults, size_t numRequiredResults)
+	{
+		using namespace std::chrono;
+
+		size_t numResults = 0;
+		auto startTime = steady_clock::now();
+		while ( numResults < numRequiredResults ) {
+			numResults += getNumNewResults();
+			if ( duration<double>( steady_clock::now() - startTime ).count() > maxWaitTime ) {
+				throw std::runtime_error( "The results of the stage were not available in time." );
+			}
+			std::this_thread::sleep_for( pollingInterval );
+		}
+	}
+
+
+
+	/**	@brief		Collects the results of a threaded stage until no new results are delivered anymore
+	*	@param		getNumNewResults			Function obtaining the number of newly available results from the stage
+	*	@return									Number of results collected
+	*	@exception								None
+	*	@remarks								The stage is regarded as finished if no new results have been delivered during Benchmarks::idleTime
+	*/
+	inline size_t CollectResults(std::function<size_t(void)> getNumNewResults)
+	{
+		using namespace std::chrono;
+
+		size_t numResults = 0;
+		auto lastResultTime = steady_clock::now();
+		while ( duration<double>( steady_clock::now() - lastResultTime ).count() < idleTime ) {
+			auto numNewResults = getNumNewResults();
+			if ( numNewResults > 0 ) {
+				numResults += numNewResults;
+				lastResultTime = steady_clock::now();
+			}
+			std::this_thread::sleep_for( pollingInterval );
+		}
+
+		return numResults;
+	}
+
+
+
+	/**	@brief		Calibrates the number of results a threaded stage delivers for each call in the steady state
+	*	@param		putData						Function putting the data of one call into the stage
+	*	@param		getNumNewResults			Function obtaining the number of newly available results from the stage
+	*	@return									Number of results delivered for each call
+	*	@exception	std::runtime_error			Thrown if the stage does not deliver any results
+	*	@remarks								The first call is ignored, because the stages might require succeeding data for finishing their results
+	*/
+	inline size_t CalibrateStage(std::function<void(void)> putData, std::function<size_t(void)> getNumNewResults)
+	{
+		putData();
+		CollectResults( getNumNewResults );
+		putData();
+		auto numResults = CollectResults( getNumNewResults );
+		if ( numResults == 0 ) {
+			throw std::runtime_error( "The stage does not deliver any results for the test signal." );
+		}
+
+		return numResults;
+	}
+
+
+
+	/**	@brief		Shifts timestamps by a constant offset
+	*	@param		times						Original timestamps
+	*	@param		offset						Time offset
+	*	@param		shiftedTimes				Shifted timestamps. It must have the same size as the original timestamps.
+	*	@return									None
+	*	@exception								None
+	*	@remarks								No memory is allocated
+	*/
+	inline void ShiftTimes(const std::vector<boost::posix_time::ptime>& times, const boost::posix_time::time_duration& offset, std::vector<boost::posix_time::ptime>& shiftedTimes)
+	{
+		for ( size_t i = 0; i < times.size(); i++ ) {
+			shiftedTimes[i] = times[i] + offset;
+		}
+	}
+
+
+
+	/**	@brief		Runtime error callback of the threaded stages
+	*	@param		errorMessage				Error message
+	*	@return									None
+	*	@exception								None
+	*	@remarks								None
+	*/
+	inline void OnRuntimeError(const std::string& errorMessage)
+	{
+		std::cerr << "Runtime error: " << errorMessage << std::endl;
+	}
+
+
+
+	/**	@brief		Records the output of the fine and coarse frequency search for a signal
+	*	@param		settings					General sequence search parameters
+	*	@param		samplingFreq				Sampling frequency of the signal [Hz]
+	*	@param		signal						Signal
+	*	@param		startTime					Timestamp of the first sample
+	*	@return									Recorded frequency streams
+	*	@exception								None
+	*	@remarks								None
+	*/
+	inline FrequencyStreams RecordFrequencyStreams(const AnalysisSettings& settings, double samplingFreq, const std::vector<float>& signal, const boost::posix_time::ptime& startTime)
+	{
+		using namespace std;
+
+		FrequencyStreams streams;
+		vector<boost::posix_time::ptime> timeRefCoarse;
+		vector< vector<float> > absToneLevels;
+		vector<float> searchFreqs( settings.searchFreqs.begin(), settings.searchFreqs.end() );
+		Core::General::CFrequencySearch<float> freqSearch, freqSearchCoarse;
+
+		freqSearch.SetParameters( settings.sampleLength, settings.freqResolution, samplingFreq, settings.maxPeaks, settings.overlap, settings.delta, searchFreqs.begin(), searchFreqs.end(), OnRuntimeError );
+		freqSearchCoarse.SetParameters( settings.sampleLengthCoarse, settings.freqResolutionCoarse, samplingFreq, settings.maxPeaksCoarse, settings.overlapCoarse, settings.deltaCoarse, searchFreqs.begin(), searchFreqs.end(), OnRuntimeError );
+
+		auto times = GenerateTimes( startTime, signal.size(), samplingFreq );
+		freqSearch.PutSignal( times.begin(), times.end(), times.begin(), times.end(), signal.begin(), signal.end() );
+		freqSearchCoarse.PutSignal( times.begin(), times.end(), times.begin(), times.end(), signal.begin(), signal.end() );
+		CollectResults( [&]() {
+			auto numTimesteps = streams.timeCalc.size() + streams.timeCalcCoarse.size();
+			freqSearch.GetPeaks( back_inserter( streams.timeCalc ), back_inserter( streams.timeRef ), back_inserter( streams.peaks ), back_inserter( absToneLevels ) );
+			freqSearchCoarse.GetPeaks( back_inserter( streams.timeCalcCoarse ), back_inserter( timeRefCoarse ), back_inserter( streams.peaksCoarse ), back_inserter( streams.absToneLevelsCoarse ) );
+			return streams.timeCalc.size() + streams.timeCalcCoarse.size() - numTimesteps;
+		} );
+
+		return streams;
+	}
+
+
+
+	/**	@brief		Registers the benchmarks of the frequency search, the tone search, the FME sequence search and the full sequence search
+	*	@param		runner						Benchmark runner
+	*	@return									None
+	*	@exception								None
+	*	@remarks								The stages are threaded, a call therefore covers putting the data of the test signal into the stage and waiting for its results.
+	*											The frequency search benchmark fails if fetching the results into buffers with the required size allocates memory.
+	*											The private CToneSearch::PerformToneSearch is covered by the tone search benchmark. The throughput is given in samples of the audio signal at the processing sampling frequency.
+	*/
+	inline void RegisterSearchBenchmarks(CBenchmarkRunner& runner)
+	{
+		using namespace std;
+		using namespace boost::posix_time;
+
+		string parameterFileName, specializedParameterFileName;
+		double maxRequiredProcFreq, transWidthProc;
+		vector<double> standardSamplingFreqs;
+
+		LoadAudioSettings( parameterFileName, specializedParameterFileName, maxRequiredProcFreq, transWidthProc, standardSamplingFreqs );
+		auto settings = LoadAnalysisParameters( parameterFileName );
+		double samplingFreq = standardSamplingFreqs.back() / GetDownsamplingFactorProc( standardSamplingFreqs.back(), maxRequiredProcFreq );
+		auto signal = make_shared< vector<float> >( GenerateFMESignal( samplingFreq, settings.searchFreqs ) );
+		auto signalDuration = microseconds( static_cast<long>( signal->size() / samplingFreq * 1.0e6 ) ) + seconds( 1 );
+		auto startTime = ptime( microsec_clock::universal_time() );
+		auto suffix = "/fs:" + to_string( static_cast<int>( samplingFreq ) );
+
+		// frequency search with whole signal blocks, the results are fetched into buffers with the required size
+		vector<float> searchFreqs( settings.searchFreqs.begin(), settings.searchFreqs.end() );
+		auto freqSearch = make_shared< Core::General::CFrequencySearch<float> >();
+		freqSearch->SetParameters( settings.sampleLength, settings.freqResolution, samplingFreq, settings.maxPeaks, settings.overlap, settings.delta, searchFreqs.begin(), searchFreqs.end(), OnRuntimeError );
+		int numSamples = static_cast<int>( settings.sampleLength / 1000 * samplingFreq );
+		auto numBlocks = signal->size() / numSamples;
+		auto numPeakResultsPerCall = numBlocks * Core::Processing::CFFT<float>::GetNumSpectrogramTimesteps( numSamples, settings.overlap, numSamples );
+
+		auto blockSignal = make_shared< vector<float> >( signal->begin(), signal->begin() + numBlocks * numSamples );
+		auto blockTimes = make_shared< vector<ptime> >( GenerateTimes( startTime, blockSignal->size(), samplingFreq ) );
+		auto shiftedBlockTimes = make_shared< vector<ptime> >( *blockTimes );
+		auto blockOffset = make_shared<time_duration>( seconds( 0 ) );
+		auto peakStreams = make_shared<FrequencyStreams>();
+		auto peakAbsToneLevels = make_shared< vector< vector<float> > >( numPeakResultsPerCall );
+		auto numFetchedPeakResults = make_shared<size_t>( 0 );
+		peakStreams->timeCalc.resize( numPeakResultsPerCall );
+		peakStreams->timeRef.resize( numPeakResultsPerCall );
+		peakStreams->peaks.resize( numPeakResultsPerCall );
+		for ( size_t i = 0; i < numPeakResultsPerCall; i++ ) {
+			peakStreams->peaks[i].reserve( settings.maxPeaks );
+			( *peakAbsToneLevels )[i].reserve( settings.maxPeaks );
+		}
+
+		auto putSignalBlocks = [=]() {
+			*blockOffset += signalDuration;
+			*numFetchedPeakResults = 0;
+			ShiftTimes( *blockTimes, *blockOffset, *shiftedBlockTimes );
+			freqSearch->PutSignal( shiftedBlockTimes->begin(), shiftedBlockTimes->end(), shiftedBlockTimes->begin(), shiftedBlockTimes->end(), blockSignal->begin(), blockSignal->end() );
+		};
+		auto getNumNewPeakResults = [=]() {
+			auto offset = static_cast<long>( *numFetchedPeakResults );
+			auto startAllocations = GetNumThreadAllocations();
+			auto timeCalcLast = freqSearch->GetPeaks( peakStreams->timeCalc.begin() + offset, peakStreams->timeRef.begin() + offset, peakStreams->peaks.begin() + offset, peakAbsToneLevels->begin() + offset );
+			if ( GetNumThreadAllocations() != startAllocations ) {
+				throw std::runtime_error( "Fetching the results of the frequency search allocated memory." );
+			}
+			auto numNewResults = static_cast<size_t>( distance( peakStreams->timeCalc.begin() + offset, timeCalcLast ) );
+			*numFetchedPeakResults += numNewResults;
+			return numNewResults;
+		};
+
+		runner.Register( "CFrequencySearch" + suffix, static_cast<double>( blockSignal->size() ), [=]() {
+			putSignalBlocks();
+			WaitForResults( getNumNewPeakResults, numPeakResultsPerCall );
+		} );
+
+		// tone search
+		auto streams = make_shared<FrequencyStreams>( RecordFrequencyStreams( settings, samplingFreq, *signal, startTime ) );
+		auto shiftedStreams = make_shared<FrequencyStreams>( *streams );
+		auto toneSearch = make_shared< Core::General::CToneSearch<float> >();
+		map<int, float> searchTones;
+		for ( size_t i = 0; i < settings.searchFreqs.size(); i++ ) {
+			searchTones[static_cast<int>( i ) + 1] = static_cast<float>( settings.searchFreqs[i] );
+		}
+		auto deltaT = microseconds( static_cast<long>( static_cast<int>( settings.sampleLength / 1000 * samplingFreq ) / samplingFreq * 1e6 ) );
+		toneSearch->SetParameters( settings.maxDeltaF, settings.maxFreqDevConstrained, settings.maxFreqDevUnconstrained, settings.numNeighbours, settings.evalToneLength, deltaT, searchTones, OnRuntimeError );
+
+		auto toneOffset = make_shared<time_duration>( seconds( 0 ) );
+		auto tones = make_shared< vector<ToneType> >();
+		auto putFrequencyStreams = [=]() {
+			*toneOffset += signalDuration;
+			ShiftTimes( streams->timeCalc, *toneOffset, shiftedStreams->timeCalc );
+			ShiftTimes( streams->timeRef, *toneOffset, shiftedStreams->timeRef );
+			ShiftTimes( streams->timeCalcCoarse, *toneOffset, shiftedStreams->timeCalcCoarse );
+			toneSearch->PutFrequencyStream( shiftedStreams->timeRef.begin(), shiftedStreams->timeRef.end(), shiftedStreams->timeCalc.begin(), shiftedStreams->peaks.begin(), shiftedStreams->timeCalcCoarse.begin(), shiftedStreams->timeCalcCoarse.end(), shiftedStreams->peaksCoarse.begin(), shiftedStreams->absToneLevelsCoarse.begin() );
+		};
+		auto getNumNewTones = [=]() {
+			auto numTones = tones->size();
+			toneSearch->GetTones( back_inserter( *tones ) );
+			return tones->size() - numTones;
+		};
+		auto numTonesPerCall = CalibrateStage( putFrequencyStreams, getNumNewTones );
+
+		runner.Register( "CToneSearch::PerformToneSearch" + suffix, static_cast<double>( signal->size() ), [=]() {
+			tones->clear();
+			putFrequencyStreams();
+			WaitForResults( getNumNewTones, numTonesPerCall );
+		} );
+
+		// FME sequence search with the tones found for the test signal
+		auto recordedTones = make_shared< vector<ToneType> >( *tones );
+		auto shiftedTones = make_shared< vector<ToneType> >( *tones );
+		map<int, float> searchTonesFME;
+		auto fmeSearch = make_shared< Core::FME::CFMESequenceSearch<float> >();
+		{
+			int codeLength;
+			double excessTime, deltaTMaxTwice, minLength, maxLength, maxToneLevelRatio;
+			Core::FME::CFMEAnalysisParam fmeParams;
+			std::ifstream ifs( specializedParameterFileName );
+			if ( !ifs.is_open() ) {
+				throw std::ios_base::failure( "Parameter file cannot be read." );
+			}
+			boost::archive::text_iarchive ia( ifs );
+			ia >> fmeParams;
+			fmeParams.Get( codeLength, excessTime, deltaTMaxTwice, minLength, maxLength, maxToneLevelRatio );
+			fmeSearch->SetParameters( codeLength, excessTime, deltaTMaxTwice, minLength, maxLength, maxToneLevelRatio, searchTonesFME.begin(), searchTonesFME.end(), OnRuntimeError );
+		}
+
+		auto sequenceOffset = make_shared<time_duration>( seconds( 0 ) );
+		auto sequences = make_shared< deque< tuple< ptime, Utilities::CCodeData<float> > > >();
+		auto putTones = [=]() {
+			*sequenceOffset += signalDuration;
+			for ( size_t i = 0; i < recordedTones->size(); i++ ) {
+				get<1>( ( *shiftedTones )[i] ) = get<1>( ( *recordedTones )[i] ) + *sequenceOffset;
+				get<2>( ( *shiftedTones )[i] ) = get<2>( ( *recordedTones )[i] ) + *sequenceOffset;
+				get<3>( ( *shiftedTones )[i] ) = get<3>( ( *recordedTones )[i] ) + *sequenceOffset;
+			}
+			fmeSearch->PutTonesStream( shiftedTones->begin(), shiftedTones->end() );
+		};
+		auto getNumNewSequences = [=]() {
+			auto numSequences = sequences->size();
+			fmeSearch->GetSequences( back_inserter( *sequences ) );
+			return sequences->size() - numSequences;
+		};
+		auto numSequencesPerCall = CalibrateStage( putTones, getNumNewSequences );
+
+		runner.Register( "CFMESequenceSearch" + suffix, static_cast<double>( signal->size() ), [=]() {
+			sequences->clear();
+			putTones();
+			WaitForResults( getNumNewSequences, numSequencesPerCall );
+		} );
+
+		// full sequence search from the audio signal to the FME sequences
+		auto search = make_shared< Core::FME::CFME<float> >( samplingFreq, parameterFileName, specializedParameterFileName, OnRuntimeError );
+		auto signalTimes = make_shared< vector<ptime> >( GenerateTimes( startTime, signal->size(), samplingFreq ) );
+		auto shiftedSignalTimes = make_shared< vector<ptime> >( *signalTimes );
+		auto signalOffset = make_shared<time_duration>( seconds( 0 ) );
+		auto putSignal = [=]() {
+			*signalOffset += signalDuration;
+			ShiftTimes( *signalTimes, *signalOffset, *shiftedSignalTimes );
+			search->PutSignalData( shiftedSignalTimes->begin(), shiftedSignalTimes->end(), signal->begin(), signal->end() );
+		};
+		auto getNumNewCodes = [=]() {
+			return search->GetSequencesDebug().size();
+		};
+		auto numCodesPerCall = CalibrateStage( putSignal, getNumNewCodes );
+
+		runner.Register( "CSearch (end-to-end)" + suffix, static_cast<double>( signal->size() ), [=]() {
+			putSignal();
+			WaitForResults( getNumNewCodes, numCodesPerCall );
+		} );
+	}
+}
+/*@}*/
@@ -127,6 +127,13 @@ std::string CBasicFunctionality::GetHelpText()
 #ifdef __linux
 	ss << softwareName << u8" -r \"config.xml\" -d : Startet das Gateway als Hintergrunddienst" << endl;
 #endif
+	ss << softwareName << u8" -r \"config.xml\" -m 9100 : Startet das Gateway mit einem Metrik-Server" << endl;
+	ss << u8"                                 (Prometheus-Format) auf dem angegebenen Port" << endl;
+	ss << softwareName << u8" -r \"config.xml\" -p 6352 : Startet das Gateway mit einem Server, der die" << endl;
+	ss << u8"                                 erkannten Alarme an abonnierende Clients verteilt" << endl;
+	ss << softwareName << u8" -r \"config.xml\" -s 6351 : Startet das Gateway ohne Detektion als Server, der die" << endl;
+	ss << u8"                                 Alarme mehrerer Detektoren empfängt und jeden Alarm" << endl;
+	ss << u8"                                 nur einmal weiterleitet" << endl;
 	ss << softwareName << u8" -a                 : Listet die verfügbaren Audioaufnahmegeräte auf" << endl;
 	ss << softwareName << u8" -h                 : Information über die Benutzung des Programms" << endl;
 	ss << softwareName << u8" -pwd               : Zeigt das Konfigurationsverzeichnis" << endl;
@@ -262,11 +269,14 @@ Middleware::CSettingsParam CBasicFunctionality::ValidateXMLConfigFile( const boo
 *	@param		commandLineArgs						Vector containing all command line arguments in the original order
 *	@param		configFile							Will contain the config file (for detection or testing) set by the user. If another option is chosen, it will be empty.
 *	@param		doDaemonize							Will be set to true if the progra should be a daemon (only relevant on linux), false otherwise
+*	@param		metricsPort							Will contain the port of the metrics server set by the user. If the metrics server is not required, it will be 0.
+*	@param		publishPort							Will contain the port of the server distributing the detected sequences set by the user. If the server is not required, it will be 0.
+*	@param		serverPort							Will contain the port of the server receiving the sequences of remote detector sites set by the user. If the detection is performed locally, it will be 0.
 *	@return 										Choice of the user
 *	@exception 	std::logic_error					Thrown if the user choice is invalid
 *	@remarks 										None
 */
-TypeOfChoice CBasicFunctionality::ProcessCommandLineArguments( const std::vector<std::string>& commandLineArgs, boost::filesystem::path& configFile, bool& doDaemonize )
+TypeOfChoice CBasicFunctionality::ProcessCommandLineArguments( const std::vector<std::string>& commandLineArgs, boost::filesystem::path& configFile, bool& doDaemonize, unsigned short& metricsPort, unsigned short& publishPort, unsigned short& serverPort )
 {
 	using namespace std;
 	using namespace boost::filesystem;
@@ -298,11 +308,20 @@ TypeOfChoice CBasicFunctionality::ProcessCommandLineArguments( const std::vector
 		} else if ( ( arg == "--run" ) || ( arg == "-r" ) ) {
 			paramList.push_back( make_pair( DETECTION, path() ) );
 
+		} else if ( ( arg == "--metrics" ) || ( arg == "-m" ) ) {
+			paramList.push_back( make_pair( METRICS, path() ) );
+
+		} else if ( ( arg == "--publish" ) || ( arg == "-p" ) ) {
+			paramList.push_back( make_pair( PUBLISH, path() ) );
+
+		} else if ( ( arg == "--server" ) || ( arg == "-s" ) ) {
+			paramList.push_back( make_pair( SERVER, path() ) );
+
 		} else {
 			// the argument may be a config file name
 			isWrong = true;
 			if ( !paramList.empty() ) {
-				if ( ( paramList.back().first == TEST ) || ( paramList.back().first == DETECTION ) ) {
+				if ( ( paramList.back().first == TEST ) || ( paramList.back().first == DETECTION ) || ( paramList.back().first == METRICS ) || ( paramList.back().first == PUBLISH ) || ( paramList.back().first == SERVER ) ) {
 					// check for wrong position of arguments
 					if ( arg.find( "-" ) == string::npos ) {
 						if ( paramList.back().second.empty() ) {
@@ -335,7 +354,37 @@ TypeOfChoice CBasicFunctionality::ProcessCommandLineArguments( const std::vector
 		}
 	}
 
-	// only exactly one parameter is allowed (except for using daemonize additionally)
+	// check if the metrics server, the publishing server and the server for remote detectors are chosen correctly with the detection mode only
+	auto extractPort = [&]( const TypeOfChoice& option, const string& optionName ) -> unsigned short {
+		auto optionIt = find_if( begin( paramList ), end( paramList ), [&]( auto val ) { return ( val.first == option ); } );
+		if ( optionIt == end( paramList ) ) {
+			return 0;
+		}
+		if ( find_if( begin( paramList ), end( paramList ), []( auto val ) { return ( val.first == DETECTION ); } ) == end( paramList ) ) {
+			throw std::logic_error( u8"Die Option " + optionName + u8" kann nur in Verbindung mit \"--run\" / \"-r\" genutzt werden." );
+		}
+
+		int port = 0;
+		try {
+			port = stoi( optionIt->second.string() );
+		} catch ( std::exception& ) {
+			port = 0;
+		}
+		if ( ( port <= 0 ) || ( port > 65535 ) ) {
+			throw std::logic_error( u8"Die Option " + optionName + u8" erfordert die Angabe eines gültigen Ports." );
+		}
+		paramList.erase( optionIt );
+
+		return static_cast<unsigned short>( port );
+	};
+	metricsPort = extractPort( METRICS, u8"\"--metrics\" / \"-m\"" );
+	publishPort = extractPort( PUBLISH, u8"\"--publish\" / \"-p\"" );
+	serverPort = extractPort( SERVER, u8"\"--server\" / \"-s\"" );
+	if ( ( ( metricsPort > 0 ) && ( ( metricsPort == publishPort ) || ( metricsPort == serverPort ) ) ) || ( ( publishPort > 0 ) && ( publishPort == serverPort ) ) ) {
+		throw std::logic_error( u8"Die Optionen \"--metrics\" / \"-m\", \"--publish\" / \"-p\" und \"--server\" / \"-s\" erfordern unterschiedliche Ports." );
+	}
+
+	// only exactly one parameter is allowed (except for using daemonize, metrics, publish and server additionally)
 	if ( paramList.size() > 1 ) {
 		throw std::logic_error( u8"Anzahl der Aufrufparameter falsch." );
 	}
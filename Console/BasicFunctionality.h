@@ -23,7 +23,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 /*@{*/
 /** \ingroup PersonalFME
 *	@param	TypeOfChoice				Command line options chosen by the user */
-enum TypeOfChoice { NOT_VALID, AUDIO_INFO, VERSION_INFO, HELP, DETECTION, TEST, PRINT_WORKING_DIR, DAEMONIZE };
+enum TypeOfChoice { NOT_VALID, AUDIO_INFO, VERSION_INFO, HELP, DETECTION, TEST, PRINT_WORKING_DIR, DAEMONIZE, METRICS, PUBLISH, SERVER };
 
 /** \ingroup PersonalFME
 *	Class implementing basic methods for the console program
@@ -38,7 +38,7 @@ public:
 	static std::string GetBasicVersionInformation();
 	static std::string GetCompleteVersionInformation();
 	static Middleware::CSettingsParam ValidateXMLConfigFile( const boost::filesystem::path& configFile );
-	static TypeOfChoice ProcessCommandLineArguments( const std::vector<std::string>& commandLineArgs, boost::filesystem::path& configFile, bool& doDaemonize );
+	static TypeOfChoice ProcessCommandLineArguments( const std::vector<std::string>& commandLineArgs, boost::filesystem::path& configFile, bool& doDaemonize, unsigned short& metricsPort, unsigned short& publishPort, unsigned short& serverPort );
 };
 /*@}*/
 
@@ -17,7 +17,14 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #if defined( _WIN32 )
 	#include "stdafx.h"
 #endif
+#include <algorithm>
+#include <sstream>
 #include <boost/filesystem.hpp>
+#if defined( _WIN32 )
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
 #include "DateTime.h"
 #include "german_local_date_time.h"
 #include "BoostStdTimeConverter.h"
@@ -52,10 +59,29 @@ Logger::CLogger& Logger::CLogger::Instance( const boost::filesystem::path& logFi
 
 
 /**	@brief		Destructor
+*	@remarks							All log entries still waiting in the queue are written to the log file before it is closed
 */
 Logger::CLogger::~CLogger(void)
 {
-	outFile.close();
+	isStopping = true;
+	newRecordCondition.notify_all();
+	if ( writerThread.joinable() ) {
+		writerThread.join();
+	}
+
+	// entries logged before the writer thread has ever been started
+	std::vector< std::unique_ptr<CLogRecord> > batch;
+	CLogRecord* record;
+	while ( recordQueue.pop( record ) ) {
+		batch.emplace_back( record );
+	}
+	try {
+		WriteBatch( batch );
+	} catch ( std::exception& ) {
+		// the destructor must not throw
+	}
+
+	std::fclose( outFile );
 }
 
 
@@ -67,6 +93,14 @@ Logger::CLogger::~CLogger(void)
 *	@remarks							The constructor is private and can therefore only be used for instantiating the singleton
 */
 Logger::CLogger::CLogger( const boost::filesystem::path& logFile )
+	: outFile( nullptr ),
+	  recordQueue( maxQueueLength ),
+	  numDroppedRecords( 0 ),
+	  droppedRecordsMetric( Utilities::Metrics::CMetricsRegistry::Instance().GetCounter( "personalfme_log_dropped_total", "Number of log entries dropped due to a full logger queue" ) ),
+	  isWriteError( false ),
+	  isStopping( false ),
+	  numEnqueuedRecords( 0 ),
+	  numWrittenRecords( 0 )
 {
 	using namespace boost;
 	bool  isNewFile;
@@ -77,8 +111,8 @@ Logger::CLogger::CLogger( const boost::filesystem::path& logFile )
 		isNewFile = true;
 	}
 
-	outFile.open( logFile.string(), std::ios_base::app );
-	if ( !outFile.good() ) {
+	outFile = std::fopen( logFile.string().c_str(), "ab" );
+	if ( !outFile ) {
 		throw std::runtime_error( u8"Die Logdatei kann nicht initialisiert werden." );
 	}
 
@@ -89,39 +123,167 @@ Logger::CLogger::CLogger( const boost::filesystem::path& logFile )
 
 
 
-/**	@brief		Non-thread safe logging worker method
+/**	@brief		Starts the background thread writing the log file
+*	@return								None
+*	@exception							None
+*	@remarks							The thread is started only with the first log entry, because the process may be daemonized (forked) after the instantiation of the logger
+*/
+void Logger::CLogger::StartWriterThread()
+{
+	std::call_once( writerOnceFlag, [this]() {
+		writerThread = std::thread( &CLogger::WriterThread, this );
+	} );
+}
+
+
+
+/**	@brief		Queues a log entry for being written by the background thread
 *	@param		logLevel				Level of the event to be stored
 *	@param		eventTime				Time of the event (UTC-time)
 *	@param		message					Message to be stored
 *	@return								None
-*	@exception	std::runtime_error		Thrown if the storage of the event message on file failed. The event time is stored in German local time.
-*	@remarks							The method itself is not thread-safe
+*	@exception	std::runtime_error		Thrown if writing of previous log entries to the file has failed since the last call
+*	@remarks							The method never blocks. If the queue is full, the entry is dropped and the number of dropped entries is reported in the log file later on.
 */
 void Logger::CLogger::PerformLogging( const Utilities::Message::MessageType& logLevel, const boost::posix_time::ptime& eventTime, const std::string& message)
+{
+	using namespace std;
+	unique_ptr<CLogRecord> record( new CLogRecord{ logLevel, eventTime, message } );
+
+	StartWriterThread();
+	if ( recordQueue.bounded_push( record.get() ) ) {
+		record.release();
+		numEnqueuedRecords++;
+		newRecordCondition.notify_one();
+	} else {
+		numDroppedRecords++;
+		droppedRecordsMetric->Increment();
+	}
+
+	// report failures of the asynchronous file access to the caller
+	if ( isWriteError.exchange( false ) ) {
+		lock_guard<mutex> lock( writerMutex );
+		throw std::runtime_error( std::string( u8"Fehler beim Schreiben der Log-Datei: " ) + writeErrorText );
+	}
+}
+
+
+
+/**	@brief		Background thread writing the queued log entries to file
+*	@return								None
+*	@exception							None
+*	@remarks							All entries available at a time are written as one batch with a single synchronization of the file to disk (group commit)
+*/
+void Logger::CLogger::WriterThread()
+{
+	using namespace std;
+	vector< unique_ptr<CLogRecord> > batch;
+	CLogRecord* record;
+	bool isFinished = false;
+
+	while ( !isFinished ) {
+		{
+			// the timeout guarantees progress even if a notification was issued before the thread started waiting
+			unique_lock<mutex> lock( writerMutex );
+			newRecordCondition.wait_for( lock, maxFlushInterval, [this]() { return isStopping || ( numEnqueuedRecords > numWrittenRecords ); } );
+		}
+		isFinished = isStopping;
+
+		while ( recordQueue.pop( record ) ) {
+			batch.emplace_back( record );
+		}
+
+		try {
+			WriteBatch( batch );
+		} catch ( std::exception& e ) {
+			lock_guard<mutex> lock( writerMutex );
+			writeErrorText = e.what();
+			isWriteError = true;
+		}
+
+		{
+			lock_guard<mutex> lock( writerMutex );
+			numWrittenRecords += batch.size();
+		}
+		batchWrittenCondition.notify_all();
+		batch.clear();
+	}
+}
+
+
+
+/**	@brief		Writes a batch of log entries to the log file and synchronizes it to disk
+*	@param		batch					Log entries to be written
+*	@return								None
+*	@exception	std::runtime_error		Thrown if the storage of the event messages on file failed
+*	@remarks							The event time is stored in German local time
+*/
+void Logger::CLogger::WriteBatch( std::vector< std::unique_ptr<CLogRecord> >& batch )
 {
 	using namespace std;
 	using namespace Utilities::Time;
 	using namespace Utilities::Message;
 
-	outFile.exceptions ( std::ifstream::failbit | std::ifstream::badbit );
-	try {
-		outFile << german_local_date_time( eventTime ) << "\t";
-		if ( logLevel == MESSAGE_ERROR ) {
-			outFile << u8"FEHLER: ";
+	stringstream ss;
+	auto numDropped = numDroppedRecords.exchange( 0 );
+
+	if ( batch.empty() && ( numDropped == 0 ) ) {
+		return;
+	}
+
+	for ( const auto& record : batch ) {
+		ss << german_local_date_time( record->eventTime ) << "\t";
+		if ( record->logLevel == MESSAGE_ERROR ) {
+			ss << u8"FEHLER: ";
 		}
-		outFile << message << endl;
-		outFile.flush();
-	} catch ( std::exception& e ) {
-		throw std::runtime_error( std::string( u8"Fehler beim Schreiben der Log-Datei: " ) + e.what() );
+		ss << record->message << "\n";
+	}
+	if ( numDropped > 0 ) {
+		ss << german_local_date_time( boost::posix_time::microsec_clock::universal_time() ) << "\t" << u8"FEHLER: " << numDropped << u8" Log-Einträge wurden wegen Überlastung verworfen." << "\n";
+	}
+
+	auto text = ss.str();
+	if ( ( std::fwrite( text.data(), 1, text.size(), outFile ) != text.size() ) || ( std::fflush( outFile ) != 0 ) ) {
+		throw std::runtime_error( u8"Die Logdatei ist nicht beschreibbar." );
+	}
+
+	#ifdef _WIN32
+		if ( _commit( _fileno( outFile ) ) != 0 ) {
+	#else
+		if ( fsync( fileno( outFile ) ) != 0 ) {
+	#endif
+		throw std::runtime_error( u8"Die Logdatei kann nicht auf den Datenträger geschrieben werden." );
+	}
+}
+
+
+
+/**	@brief		Waits until all log entries queued so far have been written to the log file
+*	@return								None
+*	@exception							None
+*	@remarks							This method blocks the caller and should not be used on time-critical threads
+*/
+void Logger::CLogger::Flush()
+{
+	using namespace std;
+
+	if ( !writerThread.joinable() ) {
+		return;
 	}
+
+	unsigned long long targetRecords = numEnqueuedRecords;
+	newRecordCondition.notify_one();
+	unique_lock<mutex> lock( writerMutex );
+	batchWrittenCondition.wait( lock, [&]() { return ( numWrittenRecords >= targetRecords ) || isStopping; } );
 }
 
 
+
 /**	@brief		Adds a status message to the protocol
 *	@param		message								Status message to be added
 *	@return											Text logged for the present status message
-*	@exception	std::runtime_error					Thrown if the storage of the event message on file failed or if the message was empty
-*	@remarks 										None
+*	@exception	std::runtime_error					Thrown if the storage of previous event messages on file failed or if the message was empty
+*	@remarks 										The message is written asynchronously to the log file, the method never blocks on the file access
 */
 std::string Logger::CLogger::Log( std::unique_ptr<Utilities::Message::CStatusMessage> message )
 {
@@ -136,7 +298,6 @@ std::string Logger::CLogger::Log( std::unique_ptr<Utilities::Message::CStatusMes
 		throw std::runtime_error( "Logger called without a log message" );
 	}
 
-	std::lock_guard< std::mutex > lock( logMutex );
 	auto messageType = message->GetType();
 	auto messageTimestamp = message->GetTimestamp();
 
@@ -147,9 +308,11 @@ std::string Logger::CLogger::Log( std::unique_ptr<Utilities::Message::CStatusMes
 		messageText = GenerateDetectorStatusMessage( dynamic_cast<const CDetectorStatusMessage& >( *message ) );
 	} else if ( typeid( *message ) == typeid( CGeneralStatusMessage ) ) {
 		messageText = GenerateGeneralStatusMessage( dynamic_cast<const CGeneralStatusMessage&>( *message ) );
+	} else if ( typeid( *message ) == typeid( CLatencyStatusMessage ) ) {
+		messageText = GenerateLatencyStatusMessage( dynamic_cast<const CLatencyStatusMessage&>( *message ) );
 	}
 
-	// saving in the log file
+	// queueing for the log file, the file access is performed asynchronously
 	PerformLogging( messageType, messageTimestamp, messageText );
 
 	return messageText;
@@ -282,6 +445,47 @@ std::string Logger::CLogger::GenerateGeneralStatusMessage( const Utilities::Mess
 }
 
 
+/**	@brief		Generates a latency record of an alarm to the protocol
+*	@param		message								Latency status message to be added
+*	@return											Generated status message for the protocol
+*	@exception										None
+*	@remarks 										The record is a list of "key=value" pairs, all latencies are given in milliseconds relative to the end of the last tone
+*/
+std::string Logger::CLogger::GenerateLatencyStatusMessage( const Utilities::Message::CLatencyStatusMessage& message ) const
+{
+	using namespace std;
+	using namespace boost::posix_time;
+	using namespace Utilities::Latency;
+	using namespace Utilities::Time;
+
+	vector<int> code;
+	Utilities::CDateTime sequenceTime;
+	string gateway;
+	vector< pair<LatencyStage, ptime> > stageTimes;
+	stringstream codeStream, recordStream;
+	ptime referenceTime;
+
+	message.GetMessageContent( code, sequenceTime, gateway, stageTimes );
+	for ( auto val : code ) { codeStream << val; };
+
+	// all latencies are relative to the end of the last tone (or the first probe point if it is unknown)
+	auto itToneEnd = find_if( begin( stageTimes ), end( stageTimes ), []( const auto& stageTime ) { return ( stageTime.first == TONE_END ); } );
+	if ( itToneEnd != end( stageTimes ) ) {
+		referenceTime = itToneEnd->second;
+	} else if ( !stageTimes.empty() ) {
+		referenceTime = stageTimes.front().second;
+	}
+
+	recordStream << u8"Latenz: code=" << codeStream.str() << " start=" << to_iso_extended_string( CBoostStdTimeConverter::ConvertToBoostTime( sequenceTime ) ) << "Z gateway=" << gateway;
+	for ( const auto& stageTime : stageTimes ) {
+		recordStream << " " << CLatencyMetrics::GetStageName( stageTime.first ) << "_ms=" << ( stageTime.second - referenceTime ).total_milliseconds();
+	}
+
+	return recordStream.str();
+}
+
+
+
 /**	@brief		Short information string on a set of Groupalarm.de configurations
 *	@param		alarmMessage						Groupalarm.de configuration
 *	@param		messageInfoString					Contains short information string on the set after the method call
@@ -397,6 +601,6 @@ void Logger::CLogger::GetEmailInfo( const External::Email::CEmailMessage& alarmM
 
 
 // instantiation of static class members
-std::mutex Logger::CLogger::logMutex;
+const std::chrono::milliseconds Logger::CLogger::maxFlushInterval = std::chrono::milliseconds( 200 );
 std::unique_ptr<Logger::CLogger> Logger::CLogger::instancePtr = nullptr;
 std::once_flag Logger::CLogger::onceFlag;
\ No newline at end of file
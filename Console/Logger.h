@@ -16,16 +16,23 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 #pragma once
 
-#include <fstream>
+#include <cstdio>
 #include <vector>
 #include <string>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/lockfree/queue.hpp>
 #include "SendStatusMessage.h"
 #include "DetectorStatusMessage.h"
 #include "GeneralStatusMessage.h"
+#include "LatencyStatusMessage.h"
+#include "MetricsRegistry.h"
 #include "Groupalarm2Message.h"
 #include "EmailMessage.h"
 
@@ -35,31 +42,62 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 namespace Logger {
 	/**	\ingroup PersonalFME
-	*	Thread safe singleton event logger class
+	*	Single log entry waiting in the queue of the logger for being written to file
+	*/
+	struct CLogRecord
+	{
+		Utilities::Message::MessageType logLevel;
+		boost::posix_time::ptime eventTime;
+		std::string message;
+	};
+
+
+	/**	\ingroup PersonalFME
+	*	Thread safe singleton event logger class. The log file is written asynchronously by a background thread, the calling threads are never blocked by the file access.
 	*/
 	class CLogger
 	{
 	public:
 		static CLogger& Instance( const boost::filesystem::path& logFile = "");
 		std::string Log( std::unique_ptr<Utilities::Message::CStatusMessage> message );
+		void Flush();
 		virtual ~CLogger(void);
 	protected:
 		void PerformLogging(const Utilities::Message::MessageType& logLevel, const boost::posix_time::ptime& eventTime, const std::string& message);
+		void WriterThread();
+		void WriteBatch( std::vector< std::unique_ptr<CLogRecord> >& batch );
+		void StartWriterThread();
 		std::string GenerateSendStatusMessage( const Utilities::Message::CSendStatusMessage<External::CAlarmMessage>& message ) const;
 		std::string GenerateDetectorStatusMessage( const Utilities::Message::CDetectorStatusMessage& message ) const;
 		std::string GenerateGeneralStatusMessage( const Utilities::Message::CGeneralStatusMessage& message ) const;
+		std::string GenerateLatencyStatusMessage( const Utilities::Message::CLatencyStatusMessage& message ) const;
 		void GetGroupalarmInfo( const External::Groupalarm::CGroupalarm2Message& alarmMessage, std::string& messageInfoString, std::string& messageTypeString ) const;
 		void GetEmailInfo( const External::Email::CEmailMessage& alarmMessage, std::string& messageInfoString, std::string& messageTypeString ) const;
 
 		static std::unique_ptr<CLogger> instancePtr;
 		static std::once_flag onceFlag;
-		std::ofstream outFile;
+		std::FILE* outFile;
 	private:
 		CLogger( const boost::filesystem::path& logFile ); // this enforces that no object can be created from the class - except in the static variable instancePtr during the first call of CLogger::Instance
 		CLogger(const CLogger&) = delete;
 		CLogger& operator=(const CLogger&) = delete;
 
-		static std::mutex logMutex;
+		static const size_t maxQueueLength = 4096;
+		static const std::chrono::milliseconds maxFlushInterval;
+
+		boost::lockfree::queue< CLogRecord*, boost::lockfree::fixed_sized<true> > recordQueue;
+		std::atomic<unsigned int> numDroppedRecords;
+		std::shared_ptr<Utilities::Metrics::CCounter> droppedRecordsMetric;
+		std::atomic<bool> isWriteError;
+		std::atomic<bool> isStopping;
+		std::atomic<unsigned long long> numEnqueuedRecords;
+		unsigned long long numWrittenRecords;
+		std::once_flag writerOnceFlag;
+		std::thread writerThread;
+		std::mutex writerMutex;
+		std::condition_variable newRecordCondition;
+		std::condition_variable batchWrittenCondition;
+		std::string writeErrorText;
 	};
 }
 /*@}*/
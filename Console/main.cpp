@@ -44,6 +44,12 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "GeneralStatusMessage.h"
 #include "SettingsParam.h"
 #include "ExecutionDetectorRuntime.h"
+#include "ExecutionServerRuntime.h"
+#include "ConfigFileWatcher.h"
+#include "LatencyProbe.h"
+#include "LatencyMetrics.h"
+#include "MetricsServer.h"
+#include "FMEPublisher.h"
 
 using namespace std;
 
@@ -60,6 +66,8 @@ bool isFinish = false;
 bool isPlayTone;
 /**	@param	logFileName					Name of the log file for storing all operational information. It is located in the user app directory */
 const std::string logFileName = Utilities::CVersionInfo::SoftwareName() + "_log.txt";
+/**	@param	publisher					Optional server distributing the detected sequences to subscribed clients. It is kept until the program ends, so that it outlives the detection. */
+std::unique_ptr< Networking::CFMEPublisher > publisher;
 /**	@param	isGenerateNewBasicSettings	Flag determining if a new basic settings file is generated (not required for normal operation -> false) */
 bool isGenerateNewBasicSettings = false;
 
@@ -192,6 +200,15 @@ void OnFoundSequence(const Utilities::CSeqData& sequence)
 
 	sequenceCode = sequence.GetCode();
 
+	// distribution to the subscribed clients, it never blocks the detection
+	if ( publisher ) {
+		try {
+			publisher->Publish( sequence );
+		} catch ( std::exception& e ) {
+			Logger::CLogger::Instance().Log( std::make_unique<CGeneralStatusMessage>( MESSAGE_ERROR, ptime( microsec_clock::universal_time() ), string( u8"Die Verteilung des Alarms an die Clients ist fehlgeschlagen: " ) + e.what() ) );
+		}
+	}
+
 	// output to screen
 	timeStream << german_local_date_time( time );
 	sync_cout::Inst() << timeStream.str() << "   ";
@@ -404,6 +421,9 @@ int main(int argc, char *argv[])
 
 	Core::Processing::CAudioDevice device;
 	bool doDaemonize;
+	unsigned short metricsPort;
+	unsigned short publishPort;
+	unsigned short serverPort;
 	float minDistanceRepetition;
 	path configFile;
 	string versionString, dateString, licenseString;
@@ -430,7 +450,7 @@ int main(int argc, char *argv[])
 		for ( int argumentID = 1; argumentID < argc; argumentID++ ) {
 			commandLineArgs.push_back( argv[argumentID] );
 		}
-		choice = CBasicFunctionality::ProcessCommandLineArguments( commandLineArgs, configFile, doDaemonize );
+		choice = CBasicFunctionality::ProcessCommandLineArguments( commandLineArgs, configFile, doDaemonize, metricsPort, publishPort, serverPort );
 		if ( !configFile.empty() ) {
 			configFile = absolute( configFile, directories.GetUserSettingsDir() );
 		}
@@ -448,15 +468,48 @@ int main(int argc, char *argv[])
 		switch ( choice ) {
 			case DETECTION:
 			{
-				sync_cout::Inst() << u8"Starte die Fünftonfolgen-Detektion ..." << endl << endl;
+				if ( serverPort > 0 ) {
+					sync_cout::Inst() << u8"Starte den Empfang der Alarme von den Detektoren ..." << endl << endl;
+				} else {
+					sync_cout::Inst() << u8"Starte die Fünftonfolgen-Detektion ..." << endl << endl;
+				}
 				Logger::CLogger::Instance().Log( std::make_unique<CGeneralStatusMessage>( MESSAGE_SUCCESS, ptime( microsec_clock::universal_time() ), string( Utilities::CVersionInfo::SoftwareName() + " " + versionString + u8" gestartet, Konfigurationsdatei: " + configFile.string() + "." ) ) );	
-				params = CBasicFunctionality::ValidateXMLConfigFile( configFile );
+				if ( serverPort > 0 ) {
+					// the server does not require an audio device
+					params.GetFromXML( configFile, directories.GetSchemaDir(), directories.GetPluginDir() );
+				} else {
+					params = CBasicFunctionality::ValidateXMLConfigFile( configFile );
+				}
+
+				// the optional metrics server will be automatically stopped in any situation when leaving the try-block
+				std::unique_ptr< External::Metrics::CMetricsServer > metricsServer;
+				if ( metricsPort > 0 ) {
+					Utilities::Latency::CLatencyProbe::Instance().SetMetrics( std::make_shared<Utilities::Latency::CRegistryLatencyMetrics>() );
+					metricsServer = std::make_unique<External::Metrics::CMetricsServer>( metricsPort );
+					metricsServer->Start();
+					Logger::CLogger::Instance().Log( std::make_unique<CGeneralStatusMessage>( MESSAGE_SUCCESS, ptime( microsec_clock::universal_time() ), u8"Metrik-Server auf Port " + to_string( metricsPort ) + u8" gestartet." ) );
+				}
+
+				// the optional server distributing the detected sequences must be running before the first detection
+				if ( publishPort > 0 ) {
+					publisher = std::make_unique<Networking::CFMEPublisher>( publishPort );
+					publisher->Start();
+					Logger::CLogger::Instance().Log( std::make_unique<CGeneralStatusMessage>( MESSAGE_SUCCESS, ptime( microsec_clock::universal_time() ), u8"Server zur Verteilung der Alarme auf Port " + to_string( publishPort ) + u8" gestartet." ) );
+				}
 
 				std::unique_ptr< Middleware::CExecutionRuntime > runtime; // will be automatically destroyed (stopping all processing) in any situation when leaving the try-block
 				params.GetFunctionalitySettings( device, minDistanceRepetition, isPlayTone );
-				runtime.reset( new Middleware::CExecutionDetectorRuntime( params, directories.GetAppSettingsDir(), directories.GetAudioDir(), directories.GetPluginDir(), OnFoundSequence, OnRecordedData, OnRuntimeError, OnMessage ) );
+				if ( serverPort > 0 ) {
+					// the sequences are received from the remote detector sites on all network interfaces
+					runtime.reset( new Middleware::CExecutionServerRuntime( params, directories.GetAppSettingsDir(), directories.GetAudioDir(), "0.0.0.0", serverPort, OnFoundSequence, OnRuntimeError, OnMessage ) );
+				} else {
+					runtime.reset( new Middleware::CExecutionDetectorRuntime( params, directories.GetAppSettingsDir(), directories.GetAudioDir(), directories.GetPluginDir(), OnFoundSequence, OnRecordedData, OnRuntimeError, OnMessage ) );
+				}
 				runtime->Run();
 
+				// changes of the alarm settings in the configuration file are applied without interrupting the detection
+				Middleware::CConfigFileWatcher configFileWatcher( configFile, [&]() { runtime->ReloadParams( configFile, directories.GetSchemaDir(), directories.GetPluginDir() ); } );
+
 				// lock the main thread until resuming excecution is notified
 				PerformRunning();
 
@@ -505,9 +558,13 @@ int main(int argc, char *argv[])
 			}
 		}
 		sync_cout::Inst() << u8"Fehler: " << endl << e.what() << endl << endl;
+		Core::CAudioInput::ReleaseAudioDevices();
 		return -1;
 	}
 
+	// the Portaudio session used for probing the audio devices must not be closed during the destruction of the static objects
+	Core::CAudioInput::ReleaseAudioDevices();
+
 	return 0;
 }
 /*@}*/
\ No newline at end of file
@@ -0,0 +1,222 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define AUDIOSP_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define AUDIOSP_API __declspec(dllexport)
+	#endif
+#endif
+
+#include <boost/filesystem.hpp>
+#include "PortaudioWrapper.h"
+#include "AudioDeviceProbe.h"
+
+std::once_flag Core::Processing::CAudioDeviceProbe::onceFlag;
+std::unique_ptr<Core::Processing::CAudioDeviceProbe> Core::Processing::CAudioDeviceProbe::instancePtr;
+
+/**	@brief	Maximum age of the cached probing results on systems without hot-plug detection and of negative probing results (the device might have only been busy) */
+const std::chrono::seconds maxProbeAge( 30 );
+
+
+
+/**	@brief		Obtains the process-wide audio device probe
+*	@return									Audio device probe
+*	@exception								None
+*	@remarks								None
+*/
+Core::Processing::CAudioDeviceProbe& Core::Processing::CAudioDeviceProbe::Instance()
+{
+	std::call_once( onceFlag, []() {
+		instancePtr.reset( new CAudioDeviceProbe() );
+	} );
+
+	return *instancePtr;
+}
+
+
+
+/**	@brief		Constructor
+*/
+Core::Processing::CAudioDeviceProbe::CAudioDeviceProbe()
+{
+}
+
+
+
+/**	@brief		Destructor
+*/
+Core::Processing::CAudioDeviceProbe::~CAudioDeviceProbe()
+{
+}
+
+
+
+/**	@brief		Determines if the device is available for the given sampling frequency and number of channels
+*	@param		device						Audio device to be checked. For the default device set it to an empty name.
+*	@param		samplingFreq				Required supported sampling frequency of the device [Hz]
+*	@param		numChannels					Required supported number of channels of the device
+*	@return									True if the device is available, false otherwise
+*	@exception	std::logic_error			Thrown if the specification of the device name and driver is ambiguous within the system
+*	@exception	portaudioException			Thrown if the Portaudio session cannot be opened
+*	@remarks								A positive result is only probed once and taken from the cache afterwards. A negative result is probed again after some time, because the device might have only been busy.
+*/
+bool Core::Processing::CAudioDeviceProbe::IsDeviceAvailable( const CAudioDevice& device, const double& samplingFreq, const int& numChannels )
+{
+	std::lock_guard<std::mutex> lock( probeMutex );
+
+	auto& session = GetSession();
+	auto currTime = std::chrono::steady_clock::now();
+	auto& availability = deviceAvailabilities[DeviceKey( device.GetType(), device.GetDeviceName(), device.GetDriverName(), samplingFreq, numChannels )];
+	if ( !availability.first && ( ( availability.second == ProbeTime() ) || ( ( currTime - availability.second ) > maxProbeAge ) ) ) {
+		availability = std::make_pair( session.IsDeviceAvailable( device, samplingFreq, numChannels ), currTime );
+	}
+
+	return availability.first;
+}
+
+
+
+/**	@brief		Obtains all sampling frequencies supported by the device
+*	@param		device						Audio device to be checked. For the default device set it to an empty name.
+*	@param		numChannels					Required supported number of channels of the device
+*	@param		standardSamplingFreqs		Container with all sampling frequencies to be tested [Hz]
+*	@return									Container with all sampling frequencies out of 'standardSamplingFreqs' supported by the device [Hz]
+*	@exception	std::logic_error			Thrown if the specification of the device name and driver is ambiguous within the system
+*	@exception	portaudioException			Thrown if the Portaudio session cannot be opened
+*	@remarks								None
+*/
+std::vector<double> Core::Processing::CAudioDeviceProbe::GetSupportedSamplingFreqs( const CAudioDevice& device, const int& numChannels, const std::vector<double>& standardSamplingFreqs )
+{
+	std::vector<double> supportedSamplingFreqs;
+
+	for ( auto samplingFreq : standardSamplingFreqs ) {
+		if ( IsDeviceAvailable( device, samplingFreq, numChannels ) ) {
+			supportedSamplingFreqs.push_back( samplingFreq );
+		}
+	}
+
+	return supportedSamplingFreqs;
+}
+
+
+
+/**	@brief		Obtains all input devices available for the given sampling frequency and number of channels
+*	@param		inputDevices				Containing all available input devices
+*	@param		stdInputDevice				Containing the default input device
+*	@param		samplingFreq				Required supported sampling frequency of the devices [Hz]
+*	@param		numChannels					Required supported number of channels of the devices
+*	@return									None
+*	@exception	portaudioException			Thrown if the Portaudio session cannot be opened
+*	@remarks								The result is taken from the cache for a limited time, because devices missing in the list might have only been busy
+*/
+void Core::Processing::CAudioDeviceProbe::GetAvailableInputDevices( std::vector<CAudioDevice>& inputDevices, CAudioDevice& stdInputDevice, const double& samplingFreq, const int& numChannels )
+{
+	std::lock_guard<std::mutex> lock( probeMutex );
+
+	auto& session = GetSession();
+	auto currTime = std::chrono::steady_clock::now();
+	auto& deviceList = inputDeviceLists[DeviceListKey( samplingFreq, numChannels )];
+	if ( ( std::get<2>( deviceList ) == ProbeTime() ) || ( ( currTime - std::get<2>( deviceList ) ) > maxProbeAge ) ) {
+		std::vector<CAudioDevice> currInputDevices;
+		CAudioDevice currStdInputDevice;
+		session.GetAvailableInputDevices( currInputDevices, currStdInputDevice, samplingFreq, numChannels );
+		deviceList = std::make_tuple( currInputDevices, currStdInputDevice, currTime );
+	}
+
+	inputDevices = std::get<0>( deviceList );
+	stdInputDevice = std::get<1>( deviceList );
+}
+
+
+
+/**	@brief		Discards all cached probing results and closes the Portaudio session
+*	@return									None
+*	@exception								None
+*	@remarks								The session is reopened with the next query, this updates the device list of Portaudio. It has to be called before the program ends for closing the Portaudio session orderly.
+*/
+void Core::Processing::CAudioDeviceProbe::Invalidate()
+{
+	std::lock_guard<std::mutex> lock( probeMutex );
+	ResetSession();
+}
+
+
+
+/**	@brief		Obtains the Portaudio session, it is reopened and the cache is discarded if the audio devices of the system have changed
+*	@return									Open Portaudio session
+*	@exception	portaudioException			Thrown if the Portaudio session cannot be opened
+*	@remarks								The caller must hold the probe mutex
+*/
+Core::Processing::CPortaudio<float>& Core::Processing::CAudioDeviceProbe::GetSession()
+{
+	auto currDeviceStamp = GetDeviceStamp();
+	if ( portaudio ) {
+		bool isOutdated;
+		if ( currDeviceStamp.empty() ) {
+			isOutdated = ( std::chrono::steady_clock::now() - sessionStartTime ) > maxProbeAge;
+		} else {
+			isOutdated = ( currDeviceStamp != deviceStamp );
+		}
+
+		if ( isOutdated ) {
+			ResetSession();
+		}
+	}
+
+	if ( !portaudio ) {
+		portaudio = std::make_unique< CPortaudio<float> >();
+		deviceStamp = currDeviceStamp;
+		sessionStartTime = std::chrono::steady_clock::now();
+	}
+
+	return *portaudio;
+}
+
+
+
+/**	@brief		Closes the Portaudio session and discards all cached probing results
+*	@return									None
+*	@exception								None
+*	@remarks								The caller must hold the probe mutex
+*/
+void Core::Processing::CAudioDeviceProbe::ResetSession()
+{
+	portaudio.reset();
+	deviceAvailabilities.clear();
+	inputDeviceLists.clear();
+}
+
+
+
+/**	@brief		Obtains a stamp changing whenever audio devices are plugged in or removed
+*	@return									Stamp of the current audio device configuration. It is empty if the platform does not allow for a cheap detection of changes.
+*	@exception								None
+*	@remarks								Under Linux the ALSA device nodes in /dev/snd are created and removed by udev on hot-plug, which changes the modification time of the directory
+*/
+std::string Core::Processing::CAudioDeviceProbe::GetDeviceStamp()
+{
+#ifdef __linux
+	boost::system::error_code error;
+	auto modificationTime = boost::filesystem::last_write_time( "/dev/snd", error );
+	if ( !error ) {
+		return std::to_string( modificationTime );
+	}
+#endif
+	return std::string();
+}
@@ -0,0 +1,94 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AudioDevice.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef AUDIOSP_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define AUDIOSP_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define AUDIOSP_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define AUDIOSP_API __attribute__ ((visibility ("default")))
+	#else
+		#define AUDIOSP_API
+	#endif		
+#endif
+
+/*@{*/
+/** \ingroup Core
+*/
+namespace Core {
+	namespace Processing {
+		template <class T> class CPortaudio;
+
+		/** \ingroup Core
+		*	Process-wide probe of the audio capture devices. It keeps a single Portaudio session open and caches the availability of the devices for each sampling frequency and number of channels.
+		*	The cache is discarded if the audio devices of the system have changed (hot-plug), the Portaudio session is reopened in that case for obtaining the new device list.
+		*	Negative results are only kept for a limited time, because a device might just be busy. The session should be released by calling Invalidate before the program ends. The class is thread-safe.
+		*/
+		class CAudioDeviceProbe
+		{
+		public:
+			AUDIOSP_API static CAudioDeviceProbe& Instance();
+			AUDIOSP_API virtual ~CAudioDeviceProbe();
+			AUDIOSP_API bool IsDeviceAvailable( const CAudioDevice& device, const double& samplingFreq, const int& numChannels );
+			AUDIOSP_API std::vector<double> GetSupportedSamplingFreqs( const CAudioDevice& device, const int& numChannels, const std::vector<double>& standardSamplingFreqs );
+			AUDIOSP_API void GetAvailableInputDevices( std::vector<CAudioDevice>& inputDevices, CAudioDevice& stdInputDevice, const double& samplingFreq, const int& numChannels );
+			AUDIOSP_API void Invalidate();
+		private:
+			using DeviceKey = std::tuple<int, std::string, std::string, double, int>;
+			using DeviceListKey = std::tuple<double, int>;
+			using ProbeTime = std::chrono::steady_clock::time_point;
+
+			CAudioDeviceProbe();
+			CAudioDeviceProbe( const CAudioDeviceProbe& ) = delete;
+			CAudioDeviceProbe& operator=( const CAudioDeviceProbe& ) = delete;
+			CPortaudio<float>& GetSession();
+			void ResetSession();
+			static std::string GetDeviceStamp();
+
+			static std::once_flag onceFlag;
+			static std::unique_ptr<CAudioDeviceProbe> instancePtr;
+			std::mutex probeMutex;
+			std::unique_ptr< CPortaudio<float> > portaudio;
+			std::string deviceStamp;
+			std::chrono::steady_clock::time_point sessionStartTime;
+			std::map< DeviceKey, std::pair<bool, ProbeTime> > deviceAvailabilities;
+			std::map< DeviceListKey, std::tuple< std::vector<CAudioDevice>, CAudioDevice, ProbeTime > > inputDeviceLists;
+		};
+	}
+}
+/*@}*/
@@ -31,6 +31,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #pragma warning(pop)
 #include "VersionInfo.h"
 #include "AudioInputParam.h"
+#include "ParameterStore.h"
 #include "privImplementation.h"
 
 
@@ -115,11 +116,11 @@ bool Core::CAudioInput::IsRunning(void)
 *	@return										None
 *	@exception									None
 *	@remarks									The highest possible sampling rate refers to the highest required sampling rate of the detection algorithm and may be lower than that of the sound device.
-*												This method can be used before initializing the object and does not interfer with any running audio stream
+*												This method does not require an object and does not interfer with any running audio stream. The devices are probed via Processing::CAudioDeviceProbe, repeated calls are served from its cache.
 */
-void Core::CAudioInput::GetAvailableAudioDevices( std::vector<Processing::CAudioDevice>& devices, Processing::CAudioDevice& stdDevice, double& maxStandardSamplingFreq, const boost::filesystem::path& audioSettingsFile ) const
+void Core::CAudioInput::GetAvailableAudioDevices( std::vector<Processing::CAudioDevice>& devices, Processing::CAudioDevice& stdDevice, double& maxStandardSamplingFreq, const boost::filesystem::path& audioSettingsFile )
 {
-	privHandle->GetAvailableAudioDevices( devices, stdDevice, maxStandardSamplingFreq, audioSettingsFile );
+	CPrivImplementation::GetAvailableAudioDevices( devices, stdDevice, maxStandardSamplingFreq, audioSettingsFile );
 }
 
 
@@ -131,11 +132,24 @@ void Core::CAudioInput::GetAvailableAudioDevices( std::vector<Processing::CAudio
 *	@return										True if the device is available, false otherwise
 *	@exception									None
 *	@remarks									The highest possible sampling rate refers to the highest required sampling rate of the detection algorithm and may be lower than that of the sound device.
-*												This method can be used before initializing the object and does not interfer with any running audio stream
+*												This method does not require an object and does not interfer with any running audio stream. The devices are probed via Processing::CAudioDeviceProbe, repeated calls are served from its cache.
 */
-bool Core::CAudioInput::IsDeviceAvailable( double& maxStandardSamplingFreq, const Processing::CAudioDevice& device, const boost::filesystem::path& audioSettingsFile ) const
+bool Core::CAudioInput::IsDeviceAvailable( double& maxStandardSamplingFreq, const Processing::CAudioDevice& device, const boost::filesystem::path& audioSettingsFile )
 {
-	return privHandle->IsDeviceAvailable( maxStandardSamplingFreq, device, audioSettingsFile );
+	return CPrivImplementation::IsDeviceAvailable( maxStandardSamplingFreq, device, audioSettingsFile );
+}
+
+
+
+/**	@brief		Releases the resources kept for probing the input devices
+*	@return										None
+*	@exception									None
+*	@remarks									This method has to be called before the program ends, it closes the Portaudio session kept open by Processing::CAudioDeviceProbe.
+*												Any further probing of the devices is possible afterwards, it reopens the session.
+*/
+void Core::CAudioInput::ReleaseAudioDevices()
+{
+	CPrivImplementation::ReleaseAudioDevices();
 }
 
 
@@ -178,15 +192,7 @@ void Core::CAudioInput::SaveParameters(std::string audioSettingsFileName, double
 	// generate serialization object
 	params.Set( sampleLength, numChannels, maxLengthInputQueue, maxMissedAttempts, channel, parameterFileName, specializedParameterFileName, maxRequiredProcFreq, transWidthProc, transWidthRec, mainThreadCycleTime, standardSamplingFreqs );
 
-	// initialize serialization
-	std::ofstream ofs( audioSettingsFileName );
-	boost::archive::text_oarchive oa( ofs );
-
-	// serialize parameter object
-	const CAudioInputParam constParams = params; // workaround for correct storing of non-pointer
-	oa << constParams;
-
-	ofs.close();
+	CParameterStore::Save( audioSettingsFileName, params );
 }
 
 
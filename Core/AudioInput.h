@@ -88,8 +88,9 @@ namespace Core {
 		AUDIOSP_API void StartAudioInput(void);
 		AUDIOSP_API void StopAudioInput(void);
 		AUDIOSP_API bool IsRunning(void);
-		AUDIOSP_API void GetAvailableAudioDevices( std::vector<Processing::CAudioDevice>& devices, Processing::CAudioDevice& stdDevice, double& maxStandardSamplingFreq, const boost::filesystem::path& audioSettingsFile ) const;
-		AUDIOSP_API bool IsDeviceAvailable( double& maxStandardSamplingFreq, const Processing::CAudioDevice& device, const boost::filesystem::path& audioSettingsFile ) const;
+		AUDIOSP_API static void GetAvailableAudioDevices( std::vector<Processing::CAudioDevice>& devices, Processing::CAudioDevice& stdDevice, double& maxStandardSamplingFreq, const boost::filesystem::path& audioSettingsFile );
+		AUDIOSP_API static bool IsDeviceAvailable( double& maxStandardSamplingFreq, const Processing::CAudioDevice& device, const boost::filesystem::path& audioSettingsFile );
+		AUDIOSP_API static void ReleaseAudioDevices();
 		AUDIOSP_API void SetAudioDevice( const Processing::CAudioDevice& device );
 		AUDIOSP_API static void SaveParameters( std::string audioSettingsFileName, double sampleLength, int numChannels, int maxLengthInputQueue, int maxMissedAttempts, int channel, std::string parameterFileName, std::string specializedParameterFileName, double maxRequiredProcFreq, double transWidthProc, double transWidthRec, float mainThreadCycleTime, std::vector<double> standardSamplingFreqs );
 		AUDIOSP_API static void GetAudioSPVersion( std::string& versionString, std::string& dateString, std::string& licenseText );
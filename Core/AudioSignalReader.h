@@ -25,6 +25,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <boost/date_time/posix_time/ptime.hpp>
 #include "AudioDevice.h"
 #include "PortaudioWrapper.h"
+#include "MetricsRegistry.h"
 
 /*@{*/
 /** \ingroup Core
@@ -303,6 +304,10 @@ template <class T> void Core::Audio::CAudioSignalReader<T>::ReadAudioInputThread
 	ptime time;
 	size_t oldSize;
 
+	auto queueDepthMetric = Utilities::Metrics::CMetricsRegistry::Instance().GetGauge( "personalfme_audio_queue_samples", "Number of captured audio samples waiting for the signal processing" );
+	auto overflowMetric = Utilities::Metrics::CMetricsRegistry::Instance().GetCounter( "personalfme_audio_queue_overflows_total", "Number of overflows of the audio input queue (loss of audio data)" );
+	auto forcedSyncMetric = Utilities::Metrics::CMetricsRegistry::Instance().GetCounter( "personalfme_audio_forced_synchronizations_total", "Number of blocking writes to the audio input queue after too many missed attempts" );
+
 	try {
 		if ( !isInit ) {
 			throw std::runtime_error( "The object was not initialized before use!" );
@@ -339,6 +344,7 @@ template <class T> void Core::Audio::CAudioSignalReader<T>::ReadAudioInputThread
 				missedAttempts = 0;
 				// write to signal queue
 				UpdateSignalQueue( newInputTime.begin(), newInputTime.end(), newInputSignal.begin(), newInputSignal.end() );
+				queueDepthMetric->Set( static_cast<std::int64_t>( inputSignal.size() ) );
 				newInputTime.clear();
 				newInputSignal.clear();
 			} else {
@@ -348,11 +354,17 @@ template <class T> void Core::Audio::CAudioSignalReader<T>::ReadAudioInputThread
 					missedAttempts = 0;
 					// write to signal queue and store current time
 					UpdateSignalQueue( newInputTime.begin(), newInputTime.end(), newInputSignal.begin(), newInputSignal.end() );
+					queueDepthMetric->Set( static_cast<std::int64_t>( inputSignal.size() ) );
+					forcedSyncMetric->Increment();
 					newInputTime.clear();
 					newInputSignal.clear();
 				}
 			}
 		}
+	} catch (std::overflow_error& e) {
+		// the processing could not keep up with the audio capturing
+		overflowMetric->Increment();
+		runtimeErrorSignal( e.what() );
 	} catch (std::exception& e) {
 		// signal to calling thread that an error occured and the thread was finished abnormally
 		runtimeErrorSignal( e.what() );
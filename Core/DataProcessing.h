@@ -20,11 +20,14 @@ Copyright(C) 2012 Eli Billauer, released to the public domain. Any use is allowe
 #pragma once
 
 #include <vector>
+#include <cmath>
 #include <limits>
 #include <algorithm>
 #include <iterator>
+#include <stdexcept>
 #include <boost/math/constants/constants.hpp>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/range/iterator_range.hpp>
 
 /*@{*/
 /** \ingroup Core
@@ -40,10 +43,15 @@ namespace Core {
 			CDataProcessing(void);
 			~CDataProcessing(void);
 			template <class InputIterator1, class InputIterator2, class OutputIterator> static void FindPeaks(InputIterator1 xFirst, InputIterator1 xLast, InputIterator2 dataFirst, OutputIterator minPeaksFirst, OutputIterator maxPeaksFirst, double delta);
+			template <class InputIterator, class OutputIterator> static int FindPeakIndices(InputIterator dataFirst, InputIterator dataLast, OutputIterator peakIndicesFirst, const int& maxNumPeaks, double delta);
+			template <class InputIterator, class OutputIterator1, class OutputIterator2> static void FindSpectrogramPeakIndices(InputIterator framesFirst, InputIterator framesLast, OutputIterator1 peakIndicesFirst, OutputIterator2 numPeaksFirst, const int& maxNumPeaks, double delta);
+			template <class InputIterator1, class InputIterator2, class InputIterator3, class InputIterator4, class OutputIterator1, class OutputIterator2> static void InterpolateSpectrogramPeaks(InputIterator1 framesFirst, InputIterator1 framesLast, InputIterator2 freqFirst, InputIterator3 peakIndicesFirst, InputIterator4 numPeaksFirst, const int& maxNumPeaks, OutputIterator1 peaksFirst, OutputIterator2 levelsFirst);
+			template <class RandomAccessIterator, class OutputIterator> static void SplitIntoFrames(RandomAccessIterator dataFirst, RandomAccessIterator dataLast, const int& frameLength, OutputIterator framesFirst);
 			template <class InputIterator1, class InputIterator2, class OutputIterator> static void SubstractBaseline(InputIterator1 xFirst, InputIterator1 xLast, InputIterator2 dataFirst, OutputIterator outputFirst, T lowerBound, T upperBound);
 			template <class InputIterator1, class InputIterator2, class OutputIterator1, class OutputIterator2> static void LimitDataRange(InputIterator1 xFirst, InputIterator1 xLast, InputIterator2 dataFirst, OutputIterator1 xOutputFirst, OutputIterator2 dataOutputFirst, T lowerBound, T upperBound);
 			template <class InputIterator, class OutputIterator> static void NormalizeData(InputIterator dataFirst, InputIterator dataLast, OutputIterator outputFirst);
 			template <class InputIterator, class OutputIterator> static void HammingWindow( InputIterator dataFirst, InputIterator dataLast, OutputIterator outputFirst);
+			static T InterpolatePeak(const T& leftLevel, const T& peakLevel, const T& rightLevel, T& interpolatedLevel);
 			static int GreatestCommonDivisor(int number1, int number2);
 			static bool IsPrimeNumber(int number);
 			static int MakeEven(const T& number);
@@ -151,6 +159,174 @@ template <class T> template <class InputIterator1, class InputIterator2, class O
 
 
 
+/**	@brief 		Finds the indices of the peaks in a given dataset normalized to its maximum.
+*	@param		dataFirst			Iterator to beginning of the data (e.g. power density, ...)
+*	@param		dataLast			Iterator to end of the data
+*	@param		peakIndicesFirst	Iterator to beginning of the container for the indices of the peak maxima, it must have space for maxNumPeaks elements
+*	@param		maxNumPeaks			Maximum number of peaks to be found
+*	@param		delta				Threshold value defining minimum distance between the peak and the left neighboring opposed peak, relative to the maximum of the data
+*	@return							Number of peaks found. If there are more than maxNumPeaks peaks, the search is stopped and maxNumPeaks + 1 is returned.
+*	@exception	std::out_of_range	Thrown if the variable delta is not positive
+*	@remarks						The result is identical to CDataProcessing<T>::FindPeaks with the data normalized by CDataProcessing<T>::NormalizeData, but the data is neither copied nor normalized.
+*									Instead the threshold is scaled with the maximum, which is obtained in a reduction loop that can be vectorized by the compiler. No memory is allocated.
+*									The function is intended for non-negative data, no peaks are found if the maximum is not positive.
+*/
+template <class T> template <class InputIterator, class OutputIterator> int Core::Processing::CDataProcessing<T>::FindPeakIndices(InputIterator dataFirst, InputIterator dataLast, OutputIterator peakIndicesFirst, const int& maxNumPeaks, double delta)
+{
+	T current, scale, threshold;
+	T min = std::numeric_limits<T>::max();
+	T max = -std::numeric_limits<T>::max();
+	int maxPos = 0;
+	int numPeaks = 0;
+	bool lookForMax = true;
+
+	// check input parameters
+	if ( delta < 0 ) {
+		throw std::out_of_range("Delta must be positive!");
+	}
+
+	// the normalization is replaced by scaling the threshold, negative values correspond to zero after normalization
+	scale = 0;
+	for ( auto it = dataFirst; it != dataLast; ++it ) {
+		scale = ( *it > scale ) ? *it : scale;
+	}
+	if ( scale <= 0 ) {
+		return 0;
+	}
+	threshold = static_cast<T>( delta ) * scale;
+
+	int i = 0;
+	for ( auto it = dataFirst; it != dataLast; ++it, i++ ) {
+		current = ( *it > 0 ) ? *it : static_cast<T>( 0 );
+
+		// check current value for possible maximum
+		if ( current > max ) {
+			max = current;
+			maxPos = i;
+		}
+
+		// check current value for possible minimum
+		if ( current < min ) {
+			min = current;
+		}
+
+		if ( lookForMax ) {
+			// check if next minimum to the left was more than delta lower
+			if ( current < ( max - threshold ) ) {
+				if ( numPeaks == maxNumPeaks ) {
+					return maxNumPeaks + 1;
+				}
+				*( peakIndicesFirst++ ) = maxPos;
+				numPeaks++;
+				min = current;
+				lookForMax = false;
+			}
+		} else {
+			// check if next maximum to the left was more than delta higher
+			if ( current > ( min + threshold ) ) {
+				max = current;
+				maxPos = i;
+				lookForMax = true;
+			}
+		}
+	}
+
+	return numPeaks;
+}
+
+
+
+/**	@brief 		Finds the indices of the peaks in all frames of a spectrogram, each frame is normalized to its maximum.
+*	@param		framesFirst			Iterator to beginning of the frames, each frame is a container with the data of all frequency bins
+*	@param		framesLast			Iterator to end of the frames
+*	@param		peakIndicesFirst	Iterator to beginning of the container for the indices of the peak maxima. Each frame occupies a block of maxNumPeaks elements, therefore the container must have space for the number of frames times maxNumPeaks elements.
+*	@param		numPeaksFirst		Iterator to beginning of the container for the number of peaks found in each frame, it must have space for the number of frames
+*	@param		maxNumPeaks			Maximum allowed number of peaks in a frame. A higher number of peaks suggests noise, zero peaks are reported for such a frame.
+*	@param		delta				Threshold value defining minimum distance between the peak and the left neighboring opposed peak, relative to the maximum of the frame
+*	@return							None
+*	@exception	std::out_of_range	Thrown if the variable delta is not positive
+*	@remarks						No memory is allocated, see CDataProcessing<T>::FindPeakIndices for details
+*/
+template <class T> template <class InputIterator, class OutputIterator1, class OutputIterator2> void Core::Processing::CDataProcessing<T>::FindSpectrogramPeakIndices(InputIterator framesFirst, InputIterator framesLast, OutputIterator1 peakIndicesFirst, OutputIterator2 numPeaksFirst, const int& maxNumPeaks, double delta)
+{
+	int numPeaks;
+
+	for ( auto frameIt = framesFirst; frameIt != framesLast; ++frameIt ) {
+		numPeaks = FindPeakIndices( std::begin( *frameIt ), std::end( *frameIt ), peakIndicesFirst, maxNumPeaks, delta );
+		if ( numPeaks > maxNumPeaks ) {
+			numPeaks = 0;
+		}
+		*( numPeaksFirst++ ) = numPeaks;
+		std::advance( peakIndicesFirst, maxNumPeaks );
+	}
+}
+
+
+
+/**	@brief 		Determines the frequencies and levels of the peaks in all frames of a spectrogram by interpolation between the frequency bins.
+*	@param		framesFirst			Iterator to beginning of the frames, each frame is a container with the power density of all frequency bins
+*	@param		framesLast			Iterator to end of the frames
+*	@param		freqFirst			Random access iterator to beginning of the container with the frequencies of the bins
+*	@param		peakIndicesFirst	Random access iterator to beginning of the peak indices obtained by CDataProcessing<T>::FindSpectrogramPeakIndices. Each frame occupies a block of maxNumPeaks elements.
+*	@param		numPeaksFirst		Iterator to beginning of the container with the number of peaks found in each frame
+*	@param		maxNumPeaks			Maximum allowed number of peaks in a frame
+*	@param		peaksFirst			Iterator to beginning of the container for the peak frequencies. It is a 2D-container with the first dimension corresponding to the frames, which must already have the required size.
+*	@param		levelsFirst			Iterator to beginning of the container for the interpolated power density of the peaks. It is a 2D-container like 'peaksFirst'.
+*	@return							None
+*	@exception						None
+*	@remarks						The inner output containers are resized to the number of peaks of the frame. No memory is allocated if they have a capacity of maxNumPeaks.
+*/
+template <class T> template <class InputIterator1, class InputIterator2, class InputIterator3, class InputIterator4, class OutputIterator1, class OutputIterator2> void Core::Processing::CDataProcessing<T>::InterpolateSpectrogramPeaks(InputIterator1 framesFirst, InputIterator1 framesLast, InputIterator2 freqFirst, InputIterator3 peakIndicesFirst, InputIterator4 numPeaksFirst, const int& maxNumPeaks, OutputIterator1 peaksFirst, OutputIterator2 levelsFirst)
+{
+	using PeakType = typename std::iterator_traits<OutputIterator1>::value_type::value_type;
+	using LevelType = typename std::iterator_traits<OutputIterator2>::value_type::value_type;
+
+	int peakIndex, numBins;
+	T peakFreq, peakLevel;
+
+	for ( auto frameIt = framesFirst; frameIt != framesLast; ++frameIt, ++numPeaksFirst, ++peaksFirst, ++levelsFirst ) {
+		auto frameFirst = std::begin( *frameIt );
+		numBins = static_cast<int>( std::distance( frameFirst, std::end( *frameIt ) ) );
+		peaksFirst->resize( *numPeaksFirst );
+		levelsFirst->resize( *numPeaksFirst );
+		for ( int j = 0; j < *numPeaksFirst; j++ ) {
+			peakIndex = peakIndicesFirst[j];
+			peakFreq = freqFirst[peakIndex];
+			peakLevel = frameFirst[peakIndex];
+			if ( ( peakIndex > 0 ) && ( peakIndex + 1 < numBins ) ) {
+				peakFreq += InterpolatePeak( frameFirst[peakIndex - 1], frameFirst[peakIndex], frameFirst[peakIndex + 1], peakLevel ) * ( freqFirst[peakIndex + 1] - freqFirst[peakIndex] );
+			}
+			( *peaksFirst )[j] = static_cast<PeakType>( peakFreq );
+			( *levelsFirst )[j] = static_cast<LevelType>( peakLevel );
+		}
+		std::advance( peakIndicesFirst, maxNumPeaks );
+	}
+}
+
+
+
+/**	@brief 		Splits a contiguous buffer into frames of equal length without copying the data.
+*	@param		dataFirst			Random access iterator to beginning of the buffer, for example a spectrogram stored frame by frame
+*	@param		dataLast			Random access iterator to end of the buffer
+*	@param		frameLength			Number of elements of each frame
+*	@param		framesFirst			Iterator to beginning of the container for the frames (data type: boost::iterator_range<RandomAccessIterator>). Use std::back_inserter if you do not know the number of frames in advance.
+*	@return							None
+*	@exception	std::out_of_range	Thrown if the frame length is not positive
+*	@remarks						An incomplete frame at the end of the buffer is ignored. The frames refer to the buffer and become invalid if it is reallocated.
+*/
+template <class T> template <class RandomAccessIterator, class OutputIterator> void Core::Processing::CDataProcessing<T>::SplitIntoFrames(RandomAccessIterator dataFirst, RandomAccessIterator dataLast, const int& frameLength, OutputIterator framesFirst)
+{
+	if ( frameLength <= 0 ) {
+		throw std::out_of_range( "The frame length must be positive." );
+	}
+
+	for ( auto frameFirst = dataFirst; std::distance( frameFirst, dataLast ) >= frameLength; frameFirst += frameLength ) {
+		*( framesFirst++ ) = boost::make_iterator_range( frameFirst, frameFirst + frameLength );
+	}
+}
+
+
+
 /**	@brief 		Cuts all data outside the boundaries in both "x" and "data".
 *	@param		xFirst					Iterator to beginning of the abscissa value container
 *	@param		xLast					Iterator to end of the abscissa value container
@@ -274,6 +450,44 @@ template <class T> template <class InputIterator, class OutputIterator> void Cor
 
 
 
+/**	@brief			Estimates the position and the level of a spectral peak between the frequency bins.
+*	@param			leftLevel			Power density of the bin left of the peak bin
+*	@param			peakLevel			Power density of the peak bin, it must be a local maximum
+*	@param			rightLevel			Power density of the bin right of the peak bin
+*	@param			interpolatedLevel	Power density at the interpolated position of the peak
+*	@return								Position of the peak relative to the peak bin in units of the bin width, it is in the range [-0.5, 0.5]
+*	@exception							None
+*	@remarks							A parabola is fitted through the logarithm of the three levels, which is very accurate for the main lobe of the Hamming-window.
+*										The peak bin itself is returned if any level is not positive or if the peak bin is not a local maximum.
+*/
+template <class T> T Core::Processing::CDataProcessing<T>::InterpolatePeak(const T& leftLevel, const T& peakLevel, const T& rightLevel, T& interpolatedLevel)
+{
+	using namespace std;
+
+	T left, center, right, curvature, offset;
+
+	interpolatedLevel = peakLevel;
+	if ( ( leftLevel <= 0 ) || ( peakLevel <= 0 ) || ( rightLevel <= 0 ) || ( leftLevel > peakLevel ) || ( rightLevel > peakLevel ) ) {
+		return 0;
+	}
+
+	left = log( leftLevel );
+	center = log( peakLevel );
+	right = log( rightLevel );
+	curvature = left - 2 * center + right;
+	if ( curvature >= 0 ) {
+		return 0; // flat peak
+	}
+
+	offset = static_cast<T>( 0.5 ) * ( left - right ) / curvature;
+	offset = max( static_cast<T>( -0.5 ), min( static_cast<T>( 0.5 ), offset ) );
+	interpolatedLevel = exp( center - static_cast<T>( 0.25 ) * ( left - right ) * offset );
+
+	return offset;
+}
+
+
+
 /**	@brief	Applies the Hamming-window on the data.
 *	@param		dataFirst			Iterator to beginning of data container.
 *	@param		dataLast			Iterator to one element after the end of the data container.
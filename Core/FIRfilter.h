@@ -28,6 +28,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "DataProcessing.h"
 #include "FFT.h"
 #include "SearchTransferFunc.h"
+#include "FilterDesignCache.h"
 
 /*@{*/
 /** \ingroup Core
@@ -414,7 +415,7 @@ template <class T> template <class InIt> void Core::Processing::Filter::CFIRfilt
 *	@exception	std::length_error			Thrown if either the starting value for the filter order or the maximum filter order are negative or if the starting value for the filter order is larger than the maximum filter order
 *	@exception	std::range_error			Thrown if the sampling frequency, the transition width or the cutoff frequency are negative, the transition width is larger than the cutoff frequency or if the cutoff frequency is larger than half of the sampling frequency
 *	@exception	std::domain_error			Thrown if the maximum filter order is smaller than the minimum filter order required for realizing the given cutoff frequency
-*	@remarks								The algorithm follows the IEEE Programs for Digital Signal Processing. Wiley & Sons 1979, program 5.2.
+*	@remarks								The algorithm follows the IEEE Programs for Digital Signal Processing. Wiley & Sons 1979, program 5.2. The filter order found by the optimization is cached in CFilterDesignCache.
 */
 template <class T> template <class OutIt> OutIt Core::Processing::Filter::CFIRfilter<T>::DesignLowPassFilter(const T& transitionWidth, const T& cutoffFreq, const T& samplingFreq, OutIt bFirst, const int& startFilterOrder, const int& maxFilterOrder)
 {
@@ -436,8 +437,12 @@ template <class T> template <class OutIt> OutIt Core::Processing::Filter::CFIRfi
 		throw std::length_error( "The starting filter order is larger than the maximum filter order" );
 	}
 
-	// find the required transition width by solution of the non-linear system of transition width vs. filter order
-	finalFilterOrder = Solver::FindTransitionWidth( startFilterOrder, transitionWidth, cutoffFreq, samplingFreq, maxFilterOrder );
+	// find the required transition width by solution of the non-linear system of transition width vs. filter order (only if not already done before)
+	auto& designCache = CFilterDesignCache::Instance();
+	if ( !designCache.GetFilterOrder( transitionWidth, cutoffFreq, samplingFreq, startFilterOrder, maxFilterOrder, finalFilterOrder ) ) {
+		finalFilterOrder = Solver::FindTransitionWidth( startFilterOrder, transitionWidth, cutoffFreq, samplingFreq, maxFilterOrder );
+		designCache.AddFilterOrder( transitionWidth, cutoffFreq, samplingFreq, startFilterOrder, maxFilterOrder, finalFilterOrder ); // if the cache file cannot be written, the optimization is only repeated after a restart
+	}
 
 	// generate the required filter
 	DesignLowPassFilter( finalFilterOrder, cutoffFreq / samplingFreq * static_cast<T>( 2.0 ), back_inserter( b ) );
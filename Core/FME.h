@@ -28,6 +28,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "BoostStdTimeConverter.h"
 #include "FMEAnalysisParam.h"
 #include "FMESequenceSearch.h"
+#include "ParameterStore.h"
 #include "Search.h"
 
 /*@{*/
@@ -192,18 +193,8 @@ template <class T> std::deque< Utilities::CSeqData > Core::FME::CFME<T>::GetSequ
 */
 template <class T> void Core::FME::CFME<T>::LoadFMEParameters(std::string fileName, FME::CFMEAnalysisParam &params)
 {
-	// deserialize parameter data from file
-	std::ifstream ifs( fileName );
-    boost::archive::text_iarchive ia( ifs );
-	
-	// read parameters
-	if ( !ifs.eof() ) {
-		ia >> params;
-	} else {
-		throw std::ios_base::failure("Parameter file cannot be read.");
-	}
-
-	ifs.close();
+	// the parameter file is only read once for all searchers
+	params = *Core::CParameterStore::Instance().GetFMEAnalysisParam( fileName );
 }
 
 
@@ -217,13 +208,5 @@ template <class T> void Core::FME::CFME<T>::LoadFMEParameters(std::string fileNa
 */
 template <class T> void Core::FME::CFME<T>::SaveFMEParameters(std::string fileName, FME::CFMEAnalysisParam params)
 {
-	// initialize serialization
-	std::ofstream ofs( fileName );
-	boost::archive::text_oarchive oa( ofs );
-
-	// serialize parameter object
-	const FME::CFMEAnalysisParam constParams = params; // workaround
-	oa << constParams;
-
-	ofs.close();
+	Core::CParameterStore::Save( fileName, params );
 }
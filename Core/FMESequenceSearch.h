@@ -23,10 +23,14 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <tuple>
 #include <limits>
 #include <iterator>
+#include <chrono>
 #include <boost/signals2.hpp>
 #include <boost/thread.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include "CodeData.h"
+#include "BoostStdTimeConverter.h"
+#include "LatencyProbe.h"
+#include "MetricsRegistry.h"
 
 /*@{*/
 /** \ingroup Core
@@ -56,6 +60,7 @@ namespace Core {
 			template <class In_It, class Out_It> void FindCodeSequences(In_It tonesBegin, In_It tonesEnd, Out_It foundCodesBegin, boost::posix_time::ptime& calcStartTimeLast, std::vector<int>& lastCode);
 			template <class Out_It> Out_It GetNextDatasets(std::deque< typename CFMESequenceSearch<T>::template ToneType<T> >& currTones, Out_It processTonesBegin);
 			void SearchFullSequencesThread(void);
+			template <class In_It> void MarkLatencyProbes(In_It foundCodesBegin, In_It foundCodesEnd);
 
 			boost::signals2::signal < void ( const std::string& ) > runtimeErrorSignal;
 			std::unique_ptr< boost::thread > threadSequenceSearch;
@@ -511,6 +516,42 @@ template <class T> template <class In_It, class Out_It> Out_It Core::FME::CFMESe
 
 
 
+/**	@brief		Marks the end of the last tone and the detection time of found code sequences in the latency probe
+*	@param		foundCodesBegin			Iterator to the beginning of the container with the found code sequences. Datatype: std::tuple< boost::posix_time::ptime, boost::posix_time::ptime, Utilities::CCodeData<T> >.
+*	@param		foundCodesEnd			Iterator to one element after the end of the container with the found code sequences
+*	@return 							None
+*	@exception 							None
+*	@remarks 							The end of the last tone is based on the reference time of the audio data, i.e. the time the samples were recorded
+*/
+template <class T> template <class In_It> void Core::FME::CFMESequenceSearch<T>::MarkLatencyProbes(In_It foundCodesBegin, In_It foundCodesEnd)
+{
+	using namespace std;
+	using namespace boost::posix_time;
+	using namespace Utilities::Latency;
+	using namespace Utilities::Time;
+
+	auto detectionTime = microsec_clock::universal_time();
+	for ( auto it = foundCodesBegin; it != foundCodesEnd; it++ ) {
+		const auto& codeData = get<2>( *it );
+		if ( codeData.GetLength() == 0 ) {
+			continue;
+		}
+
+		// the last tone ends after all previous tone periods and its own tone length
+		auto tonePeriods = codeData.GetTonePeriods();
+		auto toneEndTime = get<0>( *it ) + microseconds( static_cast<long long>( codeData.GetToneLengths().back() * 1.0e6 ) );
+		for ( auto itPeriod = tonePeriods.begin(); itPeriod != tonePeriods.end() - 1; itPeriod++ ) {
+			toneEndTime += microseconds( static_cast<long long>( *itPeriod * 1.0e6 ) );
+		}
+
+		auto sequenceTime = CBoostStdTimeConverter::ConvertToStdTime( get<0>( *it ) );
+		CLatencyProbe::Instance().Mark( codeData.GetTones(), sequenceTime, TONE_END, toneEndTime );
+		CLatencyProbe::Instance().Mark( codeData.GetTones(), sequenceTime, SEQUENCE_DETECTED, detectionTime );
+	}
+}
+
+
+
 /**	@brief		Function containing the thread continously analyzing the tone data
 *	@return 							None
 *	@exception 	std::runtime_error		Thrown if the parameters of the object were not set properly before using the function
@@ -526,6 +567,7 @@ template <class T> void Core::FME::CFMESequenceSearch<T>::SearchFullSequencesThr
 	std::vector<int> lastCode;
 	deque< typename CFMESequenceSearch<T>::template ToneType<T> > currTones, processTones;
 	deque< tuple< ptime, ptime, Utilities::CCodeData<T> > > newFoundCodes;
+	Utilities::Metrics::CStageMetrics stageMetrics( "sequence_search" );
 
 	try {	
 		if ( !isInit ) {
@@ -544,16 +586,22 @@ template <class T> void Core::FME::CFMESequenceSearch<T>::SearchFullSequencesThr
 			currTones.insert( currTones.end(), tones.begin(), tones.end() );
 			tones.clear();
 
+			stageMetrics.SetQueueLength( currTones.size() );
 			if ( static_cast<int>( currTones.size() ) >= codeLength ) {
 				lock.unlock();				
 				
 				// get data for next analysis step and delete the no longer required data
+				auto startTime = std::chrono::steady_clock::now();
 				processTones.clear();
 				GetNextDatasets( currTones, back_inserter( processTones ) );
 				
 				// search for peaks in the new signal spectrogram
 				FindFullCodeSequences( processTones.begin(), processTones.end(), back_inserter( newFoundCodes ), startTimeLast, lastCode );	
+				stageMetrics.ObserveProcessingTime( std::chrono::steady_clock::now() - startTime );
 									
+				// mark the end of the last tone (timestamp of the audio data) and the detection for the latency records
+				MarkLatencyProbes( newFoundCodes.begin(), newFoundCodes.end() );
+
 				// move result to data stream
 				boost::unique_lock<boost::mutex> lockResult( resultMutex );
 				foundCodes.insert( foundCodes.end(), newFoundCodes.begin(), newFoundCodes.end() );
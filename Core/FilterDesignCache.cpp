@@ -0,0 +1,174 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define AUDIOSP_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define AUDIOSP_API __declspec(dllexport)
+	#endif
+#endif
+
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <boost/filesystem.hpp>
+#include "FilterDesignCache.h"
+
+std::once_flag Core::Processing::Filter::CFilterDesignCache::onceFlag;
+std::unique_ptr<Core::Processing::Filter::CFilterDesignCache> Core::Processing::Filter::CFilterDesignCache::instancePtr;
+
+/**	@brief	Identifier in the first line of the cache file, the file is ignored if it does not match */
+const std::string cacheFileHeader = "# PersonalFME filter design cache 1";
+
+
+
+/**	@brief		Obtains the process-wide filter design cache
+*	@return									Filter design cache
+*	@exception								None
+*	@remarks								None
+*/
+Core::Processing::Filter::CFilterDesignCache& Core::Processing::Filter::CFilterDesignCache::Instance()
+{
+	std::call_once( onceFlag, []() {
+		instancePtr.reset( new CFilterDesignCache() );
+	} );
+
+	return *instancePtr;
+}
+
+
+
+/**	@brief		Sets the file persisting the cache and loads all filter orders stored in it
+*	@param		cacheFileName				Name of the cache file with an absolute path. It is created with the first new filter order if it is not existing.
+*	@return									None
+*	@exception								None
+*	@remarks								The cache is only an optimization: an unreadable or invalid file is ignored and a failed write is only reported by AddFilterOrder
+*/
+void Core::Processing::Filter::CFilterDesignCache::SetCacheFile( const std::string& cacheFileName )
+{
+	using namespace std;
+
+	string line;
+	double transitionWidth, cutoffFreq, samplingFreq;
+	int startFilterOrder, maxFilterOrder, filterOrder;
+
+	lock_guard<mutex> lock( cacheMutex );
+	CFilterDesignCache::cacheFileName = cacheFileName;
+
+	ifstream cacheFile( cacheFileName );
+	if ( !getline( cacheFile, line ) || ( line != cacheFileHeader ) ) {
+		return;
+	}
+
+	while ( getline( cacheFile, line ) ) {
+		istringstream lineStream( line );
+		if ( lineStream >> transitionWidth >> cutoffFreq >> samplingFreq >> startFilterOrder >> maxFilterOrder >> filterOrder ) {
+			filterOrders[ make_tuple( transitionWidth, cutoffFreq, samplingFreq, startFilterOrder, maxFilterOrder ) ] = filterOrder;
+		}
+	}
+}
+
+
+
+/**	@brief		Obtains a cached filter order
+*	@param		transitionWidth				Width of the transition zone of the filter [Hz]
+*	@param		cutoffFreq					Cutoff frequency of the low-pass filter [Hz]
+*	@param		samplingFreq				Sampling frequency [Hz]
+*	@param		startFilterOrder			Filter order used for starting the optimization
+*	@param		maxFilterOrder				Maximum filter order allowed
+*	@param		filterOrder					Cached filter order, it is only set if it has been found
+*	@return									True if the filter order has been found in the cache, false otherwise
+*	@exception								None
+*	@remarks								The parameters must be exactly identical to those used for the optimization
+*/
+bool Core::Processing::Filter::CFilterDesignCache::GetFilterOrder( const double& transitionWidth, const double& cutoffFreq, const double& samplingFreq, const int& startFilterOrder, const int& maxFilterOrder, int& filterOrder )
+{
+	std::lock_guard<std::mutex> lock( cacheMutex );
+
+	auto filterOrderIt = filterOrders.find( std::make_tuple( transitionWidth, cutoffFreq, samplingFreq, startFilterOrder, maxFilterOrder ) );
+	if ( filterOrderIt == filterOrders.end() ) {
+		return false;
+	}
+	filterOrder = filterOrderIt->second;
+
+	return true;
+}
+
+
+
+/**	@brief		Adds a filter order found by the optimization to the cache
+*	@param		transitionWidth				Width of the transition zone of the filter [Hz]
+*	@param		cutoffFreq					Cutoff frequency of the low-pass filter [Hz]
+*	@param		samplingFreq				Sampling frequency [Hz]
+*	@param		startFilterOrder			Filter order used for starting the optimization
+*	@param		maxFilterOrder				Maximum filter order allowed
+*	@param		filterOrder					Filter order found by the optimization
+*	@return									False if the cache file could not be written, true otherwise. The filter order is cached in memory in any case.
+*	@exception								None
+*	@remarks								The cache file is rewritten if it has been set. The new file is written completely before it atomically replaces the old one, so that an interrupted write never leaves a truncated file.
+*/
+bool Core::Processing::Filter::CFilterDesignCache::AddFilterOrder( const double& transitionWidth, const double& cutoffFreq, const double& samplingFreq, const int& startFilterOrder, const int& maxFilterOrder, const int& filterOrder )
+{
+	using namespace std;
+
+	lock_guard<mutex> lock( cacheMutex );
+	auto isInserted = filterOrders.insert( make_pair( make_tuple( transitionWidth, cutoffFreq, samplingFreq, startFilterOrder, maxFilterOrder ), filterOrder ) ).second;
+	if ( !isInserted || cacheFileName.empty() ) {
+		return true;
+	}
+
+	// the complete file is rewritten, it contains only very few entries
+	auto tempFileName = cacheFileName + ".tmp";
+	ofstream cacheFile( tempFileName, ios::trunc );
+	if ( !cacheFile ) {
+		return false;
+	}
+	cacheFile << cacheFileHeader << "\n";
+	cacheFile << setprecision( numeric_limits<double>::max_digits10 );
+	for ( const auto& entry : filterOrders ) {
+		cacheFile << get<0>( entry.first ) << " " << get<1>( entry.first ) << " " << get<2>( entry.first ) << " " << get<3>( entry.first ) << " " << get<4>( entry.first ) << " " << entry.second << "\n";
+	}
+	cacheFile.close();
+
+	boost::system::error_code error;
+	if ( cacheFile.fail() ) {
+		boost::filesystem::remove( tempFileName, error );
+		return false;
+	}
+	boost::filesystem::rename( tempFileName, cacheFileName, error );
+	if ( error ) {
+		boost::filesystem::remove( tempFileName, error );
+		return false;
+	}
+
+	return true;
+}
+
+
+
+/**	@brief		Removes all filter orders from the cache
+*	@return									None
+*	@exception								None
+*	@remarks								The cache file is not changed
+*/
+void Core::Processing::Filter::CFilterDesignCache::Clear()
+{
+	std::lock_guard<std::mutex> lock( cacheMutex );
+	filterOrders.clear();
+}
@@ -0,0 +1,81 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <memory>
+#include <string>
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef AUDIOSP_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define AUDIOSP_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define AUDIOSP_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define AUDIOSP_API __attribute__ ((visibility ("default")))
+	#else
+		#define AUDIOSP_API
+	#endif		
+#endif
+
+/*@{*/
+/** \ingroup Core
+*/
+namespace Core {
+	namespace Processing {
+		namespace Filter {
+			/** \ingroup Core
+			*	Process-wide cache of the FIR-filter orders found by Solver::FindTransitionWidth. Only the filter order needs to be stored, the filter coefficients follow directly from it.
+			*	The cache can optionally be persisted to a file, so that the optimization is not repeated at the next program start.
+			*/
+			class CFilterDesignCache
+			{
+			public:
+				AUDIOSP_API static CFilterDesignCache& Instance();
+				AUDIOSP_API void SetCacheFile( const std::string& cacheFileName );
+				AUDIOSP_API bool GetFilterOrder( const double& transitionWidth, const double& cutoffFreq, const double& samplingFreq, const int& startFilterOrder, const int& maxFilterOrder, int& filterOrder );
+				AUDIOSP_API bool AddFilterOrder( const double& transitionWidth, const double& cutoffFreq, const double& samplingFreq, const int& startFilterOrder, const int& maxFilterOrder, const int& filterOrder );
+				AUDIOSP_API void Clear();
+			private:
+				using DesignKey = std::tuple<double, double, double, int, int>;
+
+				CFilterDesignCache() {};
+				CFilterDesignCache( const CFilterDesignCache& ) = delete;
+				CFilterDesignCache& operator=( const CFilterDesignCache& ) = delete;
+
+				static std::once_flag onceFlag;
+				static std::unique_ptr<CFilterDesignCache> instancePtr;
+				std::mutex cacheMutex;
+				std::string cacheFileName;
+				std::map<DesignKey, int> filterOrders;
+			};
+		}
+	}
+}
+/*@}*/
@@ -23,12 +23,15 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <algorithm>
 #include <tuple>
 #include <memory>
+#include <chrono>
 #include <boost/signals2.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread.hpp>
+#include <boost/range/iterator_range.hpp>
 #include "FFT.h"
 #include "DataProcessing.h"
+#include "MetricsRegistry.h"
 
 
 
@@ -71,7 +74,15 @@ namespace Core {
 			std::vector< boost::posix_time::ptime > peaksRefTime;
 			std::vector< std::vector<T> > peaks;
 			std::vector< std::vector<T> > absToneLevels;
+			size_t numResults;
 			std::vector<T> searchFreqs;
+			std::vector<double> spectrumSignal;
+			std::vector<double> spectrum;
+			std::vector< boost::iterator_range< std::vector<double>::iterator > > spectrumFrames;
+			std::vector<double> spectrumFreq;
+			std::vector<double> spectrumTime;
+			std::vector<int> peakIndices;
+			std::vector<int> numPeaks;
 			int numSamples;
 			int freqResolution;
 			int maxNumPeaks;
@@ -91,7 +102,8 @@ namespace Core {
 */
 template <class T>
 Core::General::CFrequencySearch<T>::CFrequencySearch(void)
-	:isInit(false)
+	:numResults(0),
+	 isInit(false)
 {
 }
 
@@ -113,7 +125,8 @@ Core::General::CFrequencySearch<T>::CFrequencySearch(void)
 */
 template <class T>
 template <class InputIterator> Core::General::CFrequencySearch<T>::CFrequencySearch(double sampleLength, int freqResolution, double samplingFreq, int maxNumPeaks, double overlap, double delta, InputIterator searchFreqFirst, InputIterator searchFreqLast, std::function<void(const std::string&)> runtimeErrorCallback)
-	:isInit(false)
+	:numResults(0),
+	 isInit(false)
 {
 	// set parameters
 	SetParameters(sampleLength, freqResolution, samplingFreq, maxNumPeaks, overlap, delta, searchFreqFirst, searchFreqLast, runtimeErrorCallback);
@@ -270,7 +283,8 @@ template <class In_It1, class In_It2, class In_It3> void Core::General::CFrequen
 *	@param		absToneLevelsFirst	Iterator to beginning of the container with the absolute signal level of the found peaks (in 'peaksFirst'). It will be set after calling the function. It is a 2D-container, the first dimension is corresponding to the timesteps and the second one to maxNumPeaks.
 *	@return 						None
 *	@exception 						None
-*	@remarks 						None
+*	@remarks 						The first dimension of the output containers must already have the required size. The inner containers are resized to the number of peaks, they do not allocate memory if they have a capacity of maxNumPeaks.
+*									The spectrogram is stored frame by frame in a single contiguous buffer, which is reused for all calls.
 */
 template <class T>
 template <class In_It1, class Out_It1, class Out_It2, class Out_It3, class Out_It4> void Core::General::CFrequencySearch<T>::SearchFrequencyPeaks(boost::posix_time::ptime startTimeCalc, boost::posix_time::ptime startTimeRef, In_It1 currentSignalFirst, In_It1 currentSignalLast, Out_It1 timeCalcFirst, Out_It2 timeRefFirst, Out_It3 peaksFirst, Out_It4 absToneLevelsFirst)
@@ -280,64 +294,33 @@ template <class In_It1, class Out_It1, class Out_It2, class Out_It3, class Out_I
 	using namespace Core::Processing;
 	using namespace std;
 
-	vector< vector<double> > spectrum;
-	vector< vector<T> > peaks, absToneLevels;
-	vector<double> time, freq, currentSignal, currentSpectrum, normalizedSpectrum, minPeaksNew, maxPeaksNew;
-	vector<T> maxPeaks, absToneLevelsNew;
-	
 	// obtain input data
-	currentSignal.resize( distance( currentSignalFirst, currentSignalLast ) );
-	transform( currentSignalFirst, currentSignalLast, begin( currentSignal ), []( auto val ) { return ( numeric_cast<double>( val ) ); } ); // converts to double
+	spectrumSignal.resize( distance( currentSignalFirst, currentSignalLast ) );
+	transform( currentSignalFirst, currentSignalLast, begin( spectrumSignal ), []( auto val ) { return ( numeric_cast<double>( val ) ); } ); // converts to double
 
 	// lock any changes in the parameter set
 	boost::shared_lock<boost::shared_mutex> lock( parameterMutex );
 	
-	// calculate spectrogram with relative times - datatype double is required for FFT in order to ensure sufficient accuracy for the time
-	spectrum.resize( Core::Processing::CFFT<T>::GetNumSpectrogramTimesteps( numeric_cast<int>( currentSignal.size() ), overlap, numSamples ) );
-	for (size_t i=0; i < spectrum.size(); i++) {
-		spectrum[i].resize( freqResolution );
-	}
-
-	freq.resize( freqResolution );
-	time.resize( Processing::CFFT<T>::GetNumSpectrogramTimesteps( currentSignal.size(), overlap, numSamples ) );
-	fft.Spectrogram( spectrum.begin(), freq.begin(), time.begin(), currentSignal.begin(), currentSignal.end(), numSamples, overlap, samplingFreq );
-
-	// analyze spectrogram
-	for ( size_t i=0; i < spectrum.size(); i++ ) {
-		currentSpectrum.assign( spectrum[i].begin(), spectrum[i].end() );
+	// calculate spectrogram with relative times - datatype double is required for FFT in order to ensure sufficient accuracy for the time, the buffers are reused for all calls
+	spectrum.resize( Core::Processing::CFFT<T>::GetNumSpectrogramTimesteps( numeric_cast<int>( spectrumSignal.size() ), overlap, numSamples ) * freqResolution );
+	spectrumFrames.clear();
+	CDataProcessing<double>::SplitIntoFrames( spectrum.begin(), spectrum.end(), freqResolution, back_inserter( spectrumFrames ) );
 
-		// normalize data
-		normalizedSpectrum.resize( currentSpectrum.size() );
-		CDataProcessing<double>::NormalizeData( currentSpectrum.begin(), currentSpectrum.end(), normalizedSpectrum.begin() );
+	spectrumFreq.resize( freqResolution );
+	spectrumTime.resize( spectrumFrames.size() );
+	fft.Spectrogram( spectrumFrames.begin(), spectrumFreq.begin(), spectrumTime.begin(), spectrumSignal.begin(), spectrumSignal.end(), numSamples, overlap, samplingFreq );
 
-		// find peaks
-		minPeaksNew.clear();
-		maxPeaksNew.clear();
-		CDataProcessing<double>::FindPeaks( freq.begin(), freq.end(), normalizedSpectrum.begin(), back_inserter( minPeaksNew ), back_inserter( maxPeaksNew ), delta );
-		
-		// ignore a too large number of peaks, which indicates noise
-		if ( numeric_cast<int>( maxPeaksNew.size() ) > maxNumPeaks ) {
-			maxPeaksNew.clear();
-		}
+	// find the peaks of all frames at once - frames with too many peaks indicate noise and are ignored
+	peakIndices.resize( spectrumFrames.size() * maxNumPeaks );
+	numPeaks.resize( spectrumFrames.size() );
+	CDataProcessing<double>::FindSpectrogramPeakIndices( spectrumFrames.begin(), spectrumFrames.end(), peakIndices.begin(), numPeaks.begin(), maxNumPeaks, delta );
 
-		maxPeaks.resize( maxPeaksNew.size() );
-		transform( begin( maxPeaksNew ), end( maxPeaksNew ), begin( maxPeaks ), []( auto val ) { return static_cast<T>( val ); } ); // convert back to datatype T
-		peaks.push_back( maxPeaks );
-
-		// determine the absolute peak levels
-		absToneLevelsNew.clear();
-		for ( auto currPeak : maxPeaksNew ) {
-			auto currPeakIndex = distance( begin( freq ), find_if( begin( freq ), end( freq ), [=]( auto val ) { return ( val >= currPeak ); } ) );
-			absToneLevelsNew.push_back( static_cast<T>( *( begin( currentSpectrum ) + currPeakIndex ) ) ); // convert back to datatype T
-		}
-		absToneLevels.push_back( absToneLevelsNew );
-	}
+	// determine the peak frequencies and absolute peak levels between the frequency bins (converted back to datatype T)
+	CDataProcessing<double>::InterpolateSpectrogramPeaks( spectrumFrames.begin(), spectrumFrames.end(), spectrumFreq.begin(), peakIndices.begin(), numPeaks.begin(), maxNumPeaks, peaksFirst, absToneLevelsFirst );
 
 	// set output containers
-	transform( begin( time ), end( time ), timeCalcFirst, [=]( auto currTime ) { return ( startTimeCalc + microseconds( static_cast<long>( currTime * 1.0e6 ) ) ); } );	// output time is absolute - conversion errors < 1 µs are not relevant here (ms-range)
-	transform( begin( time ), end( time ), timeRefFirst, [=]( auto currTime ) { return ( startTimeRef + microseconds( static_cast<long>( currTime * 1.0e6 ) ) ); } );	// the reference timestamps are interpolated by calculated timesteps
-	move( begin( peaks ), end( peaks ), peaksFirst );
-	move( begin( absToneLevels ), end( absToneLevels ), absToneLevelsFirst );
+	transform( begin( spectrumTime ), end( spectrumTime ), timeCalcFirst, [=]( auto currTime ) { return ( startTimeCalc + microseconds( static_cast<long>( currTime * 1.0e6 ) ) ); } );	// output time is absolute - conversion errors < 1 µs are not relevant here (ms-range)
+	transform( begin( spectrumTime ), end( spectrumTime ), timeRefFirst, [=]( auto currTime ) { return ( startTimeRef + microseconds( static_cast<long>( currTime * 1.0e6 ) ) ); } );	// the reference timestamps are interpolated by calculated timesteps
 }
 
 
@@ -351,11 +334,13 @@ template <class T>
 void Core::General::CFrequencySearch<T>::FrequencySearchThread()
 {
 	using namespace std;
+	const size_t numBufferedBlocks = 4;		// number of analyzed signal blocks the result containers are reserved for
 
 	vector< boost::posix_time::ptime > newCalcTimes, newRefTimes;
 	deque< boost::posix_time::ptime> currentCalcTime, currentRefTime;
 	deque<T> currentSignal;
 	vector< vector<T> > newPeaks, newAbsToneLevels;
+	Utilities::Metrics::CStageMetrics stageMetrics( "frequency_search" );
 	
 	try {
 		if ( !isInit ) {
@@ -374,6 +359,19 @@ void Core::General::CFrequencySearch<T>::FrequencySearchThread()
 		newCalcTimes.resize( newPeaks.size() );
 		newRefTimes.resize( newPeaks.size() );
 
+		// the result slots are allocated once with a capacity of maxNumPeaks, they are kept when the results are fetched
+		{
+			boost::unique_lock<boost::mutex> lockResult( resultMutex );
+			peaksCalcTime.reserve( newPeaks.size() * numBufferedBlocks );
+			peaksRefTime.reserve( newPeaks.size() * numBufferedBlocks );
+			peaks.resize( max( peaks.size(), newPeaks.size() * numBufferedBlocks ) );
+			absToneLevels.resize( peaks.size() );
+			for (size_t i=0; i < peaks.size(); i++) {
+				peaks[i].reserve( maxNumPeaks );
+				absToneLevels[i].reserve( maxNumPeaks );
+			}
+		}
+
 		// process audio data until interruption is requested
 		while ( !(boost::this_thread::interruption_requested()) ) {
 			// read from signal queue	
@@ -384,22 +382,34 @@ void Core::General::CFrequencySearch<T>::FrequencySearchThread()
 			signalCalcTime.clear();
 			signalRefTime.clear();
 			signal.clear();
+			stageMetrics.SetQueueLength( currentSignal.size() );
 		
 			if ( (int)(currentSignal.size()) >= numSamples ) {
 				// search for peaks in the new signal spectrogram
 				lock.unlock();
 				
+				auto startTime = std::chrono::steady_clock::now();
 				SearchFrequencyPeaks( currentCalcTime.front(), currentRefTime.front(), currentSignal.begin(), currentSignal.begin() + numSamples, newCalcTimes.begin(), newRefTimes.begin(), newPeaks.begin(), newAbsToneLevels.begin() );
 				currentCalcTime.erase( currentCalcTime.begin(), currentCalcTime.begin() + numSamples );
 				currentRefTime.erase( currentRefTime.begin(), currentRefTime.begin() + numSamples );
 				currentSignal.erase( currentSignal.begin(), currentSignal.begin() + numSamples );
+				stageMetrics.ObserveProcessingTime( std::chrono::steady_clock::now() - startTime );
 
 				// move result to data stream
 				boost::unique_lock<boost::mutex> lockResult( resultMutex );
 				peaksCalcTime.insert( peaksCalcTime.end(), newCalcTimes.begin(), newCalcTimes.end() );
 				peaksRefTime.insert( peaksRefTime.end(), newRefTimes.begin(), newRefTimes.end() );
-				peaks.insert( peaks.end(), newPeaks.begin(), newPeaks.end() );
-				absToneLevels.insert( absToneLevels.end(), newAbsToneLevels.begin(), newAbsToneLevels.end() );
+				// the peaks are swapped with the next free result slots, both keep their capacity of maxNumPeaks - new slots are only required if the results are not fetched in time
+				for (size_t i=0; i < newPeaks.size(); i++, numResults++) {
+					if ( numResults == peaks.size() ) {
+						peaks.emplace_back();
+						peaks.back().reserve( maxNumPeaks );
+						absToneLevels.emplace_back();
+						absToneLevels.back().reserve( maxNumPeaks );
+					}
+					peaks[numResults].swap( newPeaks[i] );
+					absToneLevels[numResults].swap( newAbsToneLevels[i] );
+				}
 			} else {
 				// wait for new audio data
     			newSignalDataCondition.wait( inputSignalMutex ); 
@@ -422,31 +432,20 @@ void Core::General::CFrequencySearch<T>::FrequencySearchThread()
 *	@exception 						None
 *	@remarks 						All data that is transfered with this function is deleted and no longer accessible. Reference time: Absolute time stamp with around 15 ms precision (depending on the operating system), required for reference.
 *									Calculated time: High precision relative time stamps. The absolute value is not useful.
+*									The results are copied and the internal result buffers keep their capacity. No memory is allocated if the output containers already have the required size and their inner containers a capacity of maxNumPeaks.
 */
 template <class T>
 template <class Out_It1, class Out_It2, class Out_It3, class Out_It4> Out_It1 Core::General::CFrequencySearch<T>::GetPeaks(Out_It1 timeCalcFirst, Out_It2 timeRefFirst, Out_It3 peaksFirst, Out_It4 absToneLevelsFirst)
 {
-	std::vector< boost::posix_time::ptime > newPeaksCalcTime, newPeaksRefTime;
-	std::vector < std::vector<T> > newPeaks, newAbsToneLevels;
-
-	// copy to local data in order to reduce lock time
+	// copy to output - the result slots remain allocated for the following results
 	boost::unique_lock<boost::mutex> lockResult( resultMutex );
-	newPeaksCalcTime.assign( peaksCalcTime.begin(), peaksCalcTime.end() );
-	newPeaksRefTime.assign( peaksRefTime.begin(), peaksRefTime.end() );
-	newPeaks.assign( peaks.begin(), peaks.end() );
-	newAbsToneLevels.assign( absToneLevels.begin(), absToneLevels.end() );
-
-	// delete old results
+	std::copy( peaksRefTime.begin(), peaksRefTime.end(), timeRefFirst );
+	std::copy( peaks.begin(), peaks.begin() + numResults, peaksFirst );
+	std::copy( absToneLevels.begin(), absToneLevels.begin() + numResults, absToneLevelsFirst );
+	auto timeCalcLast = std::copy( peaksCalcTime.begin(), peaksCalcTime.end(), timeCalcFirst );
 	peaksCalcTime.clear();
 	peaksRefTime.clear();
-	peaks.clear();
-	absToneLevels.clear();
-
-	lockResult.unlock();
+	numResults = 0;
 
-	// copy to output
-	std::move( newPeaksRefTime.begin(), newPeaksRefTime.end(), timeRefFirst );
-	std::move( newPeaks.begin(), newPeaks.end(), peaksFirst );
-	std::move( newAbsToneLevels.begin(), newAbsToneLevels.end(), absToneLevelsFirst );
-	return std::move( newPeaksCalcTime.begin(), newPeaksCalcTime.end(), timeCalcFirst );
+	return timeCalcLast;
 }
\ No newline at end of file
@@ -0,0 +1,328 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define AUDIOSP_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define AUDIOSP_API __declspec(dllexport)
+	#endif
+#endif
+
+#include <ios>
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+#include "ParameterStore.h"
+
+std::once_flag Core::CParameterStore::onceFlag;
+std::unique_ptr<Core::CParameterStore> Core::CParameterStore::instancePtr;
+
+/**	@brief	Identifier in the first line of a binary parameter file, it is followed by the schema version, the parameter type and the byte order */
+const std::string binaryFileHeader = "# PersonalFME binary parameter file";
+
+/**	@brief	Schema version of the binary parameter files, files with another version are rejected */
+const int binarySchemaVersion = 1;
+
+
+
+/**	@brief		Obtains the byte order of the current platform
+*	@return									"le" for little-endian, "be" for big-endian platforms
+*	@exception								None
+*	@remarks								None
+*/
+static std::string GetByteOrder()
+{
+	const std::uint16_t testValue = 1;
+	return ( *reinterpret_cast<const unsigned char*>( &testValue ) == 1 ) ? "le" : "be";
+}
+
+
+
+/**	@brief		Obtains the process-wide parameter store
+*	@return									Parameter store
+*	@exception								None
+*	@remarks								None
+*/
+Core::CParameterStore& Core::CParameterStore::Instance()
+{
+	std::call_once( onceFlag, []() {
+		instancePtr.reset( new CParameterStore() );
+	} );
+
+	return *instancePtr;
+}
+
+
+
+/**	@brief		Destructor
+*	@remarks								None
+*/
+Core::CParameterStore::~CParameterStore()
+{
+}
+
+
+
+/**	@brief		Obtains the parameters for the general sequence search
+*	@param		fileName					Name of the parameter file (params.dat) with an absolute path
+*	@return									Parameters, the object is shared by all callers and is not changed anymore
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be read
+*	@remarks								The file is only read if it is not in the store or if it has been changed on disk
+*/
+std::shared_ptr<const Core::General::CAnalysisParam> Core::CParameterStore::GetAnalysisParam( const std::string& fileName )
+{
+	return Get( analysisParams, fileName, "analysis" );
+}
+
+
+
+/**	@brief		Obtains the parameters for the 5-tone-sequence evaluation
+*	@param		fileName					Name of the parameter file (fmeParams.dat) with an absolute path
+*	@return									Parameters, the object is shared by all callers and is not changed anymore
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be read
+*	@remarks								The file is only read if it is not in the store or if it has been changed on disk
+*/
+std::shared_ptr<const Core::FME::CFMEAnalysisParam> Core::CParameterStore::GetFMEAnalysisParam( const std::string& fileName )
+{
+	return Get( fmeAnalysisParams, fileName, "fme" );
+}
+
+
+
+/**	@brief		Obtains the audio settings
+*	@param		fileName					Name of the audio settings file (audioSettings.dat) with an absolute path
+*	@return									Audio settings, the object is shared by all callers and is not changed anymore
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be read
+*	@remarks								The file is only read if it is not in the store or if it has been changed on disk
+*/
+std::shared_ptr<const Core::CAudioInputParam> Core::CParameterStore::GetAudioInputParam( const std::string& fileName )
+{
+	return Get( audioInputParams, fileName, "audio" );
+}
+
+
+
+/**	@brief		Saves the parameters for the general sequence search
+*	@param		fileName					Name of the parameter file (params.dat) with an absolute path
+*	@param		params						Parameters
+*	@param		format						File format, the binary format can only be read on the same platform
+*	@return									None
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be written
+*	@remarks								The stored parameters of the file are discarded
+*/
+void Core::CParameterStore::Save( const std::string& fileName, const General::CAnalysisParam& params, const ParameterFileFormat& format )
+{
+	Save( fileName, "analysis", params, format );
+}
+
+
+
+/**	@brief		Saves the parameters for the 5-tone-sequence evaluation
+*	@param		fileName					Name of the parameter file (fmeParams.dat) with an absolute path
+*	@param		params						Parameters
+*	@param		format						File format, the binary format can only be read on the same platform
+*	@return									None
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be written
+*	@remarks								The stored parameters of the file are discarded
+*/
+void Core::CParameterStore::Save( const std::string& fileName, const FME::CFMEAnalysisParam& params, const ParameterFileFormat& format )
+{
+	Save( fileName, "fme", params, format );
+}
+
+
+
+/**	@brief		Saves the audio settings
+*	@param		fileName					Name of the audio settings file (audioSettings.dat) with an absolute path
+*	@param		params						Audio settings
+*	@param		format						File format, the binary format can only be read on the same platform
+*	@return									None
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be written
+*	@remarks								The stored parameters of the file are discarded
+*/
+void Core::CParameterStore::Save( const std::string& fileName, const CAudioInputParam& params, const ParameterFileFormat& format )
+{
+	Save( fileName, "audio", params, format );
+}
+
+
+
+/**	@brief		Obtains the version of the store
+*	@return									Version, it is increased every time a parameter file is read
+*	@exception								None
+*	@remarks								None
+*/
+std::uint64_t Core::CParameterStore::GetVersion()
+{
+	std::lock_guard<std::mutex> lock( storeMutex );
+	return version;
+}
+
+
+
+/**	@brief		Discards the stored parameters of a file
+*	@param		fileName					Name of the parameter file with an absolute path
+*	@return									None
+*	@exception								None
+*	@remarks								The file is read again with the next request
+*/
+void Core::CParameterStore::Invalidate( const std::string& fileName )
+{
+	auto key = boost::filesystem::absolute( fileName ).string();
+
+	std::lock_guard<std::mutex> lock( storeMutex );
+	analysisParams.erase( key );
+	fmeAnalysisParams.erase( key );
+	audioInputParams.erase( key );
+}
+
+
+
+/**	@brief		Discards all stored parameters
+*	@return									None
+*	@exception								None
+*	@remarks								None
+*/
+void Core::CParameterStore::Clear()
+{
+	std::lock_guard<std::mutex> lock( storeMutex );
+	analysisParams.clear();
+	fmeAnalysisParams.clear();
+	audioInputParams.clear();
+}
+
+
+
+/**	@brief		Obtains the parameters of a file from the store, they are read from the file if required
+*	@param		entries						Stored parameters of the requested type
+*	@param		fileName					Name of the parameter file with an absolute path
+*	@param		typeID						Identifier of the parameter type in the binary file format
+*	@return									Parameters
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be read
+*	@remarks								The modification time and the size of the file are used for detecting changes
+*/
+template <class Param> std::shared_ptr<const Param> Core::CParameterStore::Get( std::map< std::string, CEntry<Param> >& entries, const std::string& fileName, const std::string& typeID )
+{
+	using namespace std;
+
+	boost::system::error_code timeError, sizeError;
+	CEntry<Param> entry;
+
+	auto key = boost::filesystem::absolute( fileName ).string();
+	entry.writeTime = boost::filesystem::last_write_time( key, timeError );
+	entry.fileSize = boost::filesystem::file_size( key, sizeError );
+	if ( timeError || sizeError ) {
+		throw std::ios_base::failure( "Parameter file cannot be read." );
+	}
+
+	lock_guard<mutex> lock( storeMutex );
+	auto entryIt = entries.find( key );
+	if ( ( entryIt != entries.end() ) && ( entryIt->second.writeTime == entry.writeTime ) && ( entryIt->second.fileSize == entry.fileSize ) ) {
+		return entryIt->second.params;
+	}
+
+	auto params = make_shared<Param>();
+	Load( key, typeID, *params );
+	entry.params = params;
+	entries[key] = entry;
+	version++;
+
+	return entry.params;
+}
+
+
+
+/**	@brief		Reads a parameter file in the text or the binary format
+*	@param		fileName					Name of the parameter file with an absolute path
+*	@param		typeID						Identifier of the parameter type in the binary file format
+*	@param		params						Parameters read from the file
+*	@return									None
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be read or if it is a binary file of another schema version, parameter type or platform
+*	@remarks								Text files are identified by the missing header of the binary format
+*/
+template <class Param> void Core::CParameterStore::Load( const std::string& fileName, const std::string& typeID, Param& params )
+{
+	using namespace std;
+
+	string header;
+	int schemaVersion;
+	string fileTypeID, byteOrder;
+
+	ifstream ifs( fileName, ios::binary );
+	if ( !ifs || ( ifs.peek() == char_traits<char>::eof() ) ) {
+		throw std::ios_base::failure( "Parameter file cannot be read." );
+	}
+
+	if ( ifs.peek() != binaryFileHeader.front() ) {
+		boost::archive::text_iarchive ia( ifs );
+		ia >> params;
+		return;
+	}
+
+	getline( ifs, header );
+	if ( header.compare( 0, binaryFileHeader.size(), binaryFileHeader ) != 0 ) {
+		throw std::ios_base::failure( "Parameter file cannot be read." );
+	}
+	istringstream headerStream( header.substr( binaryFileHeader.size() ) );
+	if ( !( headerStream >> schemaVersion >> fileTypeID >> byteOrder ) || ( schemaVersion != binarySchemaVersion ) || ( fileTypeID != typeID ) || ( byteOrder != GetByteOrder() ) ) {
+		throw std::ios_base::failure( "Parameter file has an unsupported format: " + fileName );
+	}
+	boost::archive::binary_iarchive ia( ifs );
+	ia >> params;
+}
+
+
+
+/**	@brief		Writes a parameter file in the text or the binary format
+*	@param		fileName					Name of the parameter file with an absolute path
+*	@param		typeID						Identifier of the parameter type in the binary file format
+*	@param		params						Parameters
+*	@param		format						File format
+*	@return									None
+*	@exception	std::ios_base::failure		Thrown if the parameter file cannot be written
+*	@remarks								The stored parameters of the file are discarded
+*/
+template <class Param> void Core::CParameterStore::Save( const std::string& fileName, const std::string& typeID, const Param& params, const ParameterFileFormat& format )
+{
+	using namespace std;
+
+	{
+		ofstream ofs( fileName, ios::binary | ios::trunc );
+		if ( !ofs ) {
+			throw std::ios_base::failure( "Parameter file cannot be written." );
+		}
+
+		if ( format == BINARY_FORMAT ) {
+			ofs << binaryFileHeader << " " << binarySchemaVersion << " " << typeID << " " << GetByteOrder() << "\n";
+			boost::archive::binary_oarchive oa( ofs );
+			oa << params;
+		} else {
+			boost::archive::text_oarchive oa( ofs );
+			oa << params;
+		}
+	}
+
+	// the modification time has only a resolution of seconds, a file changed twice within the same second would not be detected
+	Instance().Invalidate( fileName );
+}
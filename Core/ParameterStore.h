@@ -0,0 +1,102 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <ctime>
+#include "AnalysisParam.h"
+#include "FMEAnalysisParam.h"
+#include "AudioInputParam.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef AUDIOSP_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define AUDIOSP_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define AUDIOSP_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define AUDIOSP_API __attribute__ ((visibility ("default")))
+	#else
+		#define AUDIOSP_API
+	#endif		
+#endif
+
+/*@{*/
+/** \ingroup Core
+*/
+namespace Core {
+	/** \ingroup Core
+	*	File formats of the parameter files
+	*/
+	enum ParameterFileFormat { TEXT_FORMAT, BINARY_FORMAT };
+
+	/** \ingroup Core
+	*	Process-wide store of the parameter files (params.dat, fmeParams.dat, audioSettings.dat). Each file is only read once and shared as an immutable object by all components.
+	*	A file is only read again if it has been changed on disk. Every read increases the version of the store. The files can be stored either in the portable text format
+	*	or in a compact binary format that is only readable on the same platform. Both formats are detected automatically. The class is thread-safe.
+	*/
+	class CParameterStore
+	{
+	public:
+		AUDIOSP_API static CParameterStore& Instance();
+		AUDIOSP_API virtual ~CParameterStore();
+		AUDIOSP_API std::shared_ptr<const General::CAnalysisParam> GetAnalysisParam( const std::string& fileName );
+		AUDIOSP_API std::shared_ptr<const FME::CFMEAnalysisParam> GetFMEAnalysisParam( const std::string& fileName );
+		AUDIOSP_API std::shared_ptr<const CAudioInputParam> GetAudioInputParam( const std::string& fileName );
+		AUDIOSP_API static void Save( const std::string& fileName, const General::CAnalysisParam& params, const ParameterFileFormat& format = TEXT_FORMAT );
+		AUDIOSP_API static void Save( const std::string& fileName, const FME::CFMEAnalysisParam& params, const ParameterFileFormat& format = TEXT_FORMAT );
+		AUDIOSP_API static void Save( const std::string& fileName, const CAudioInputParam& params, const ParameterFileFormat& format = TEXT_FORMAT );
+		AUDIOSP_API std::uint64_t GetVersion();
+		AUDIOSP_API void Invalidate( const std::string& fileName );
+		AUDIOSP_API void Clear();
+	private:
+		template <class Param> struct CEntry {
+			std::time_t writeTime;
+			std::uintmax_t fileSize;
+			std::shared_ptr<const Param> params;
+		};
+
+		CParameterStore() : version( 0 ) {};
+		CParameterStore( const CParameterStore& ) = delete;
+		CParameterStore& operator=( const CParameterStore& ) = delete;
+		template <class Param> std::shared_ptr<const Param> Get( std::map< std::string, CEntry<Param> >& entries, const std::string& fileName, const std::string& typeID );
+		template <class Param> static void Load( const std::string& fileName, const std::string& typeID, Param& params );
+		template <class Param> static void Save( const std::string& fileName, const std::string& typeID, const Param& params, const ParameterFileFormat& format );
+
+		static std::once_flag onceFlag;
+		static std::unique_ptr<CParameterStore> instancePtr;
+		std::mutex storeMutex;
+		std::uint64_t version;
+		std::map< std::string, CEntry<General::CAnalysisParam> > analysisParams;
+		std::map< std::string, CEntry<FME::CFMEAnalysisParam> > fmeAnalysisParams;
+		std::map< std::string, CEntry<CAudioInputParam> > audioInputParams;
+	};
+}
+/*@}*/
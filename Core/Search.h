@@ -37,9 +37,11 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <boost/archive/text_iarchive.hpp>
 #include "ToneSearch.h"
 #include "AnalysisParam.h"
+#include "ParameterStore.h"
 #include "FrequencySearch.h"
 #include "SeqData.h"
 #include "SeqDataComplete.h"
+#include "MetricsRegistry.h"
 
 
 /*@{*/
@@ -414,18 +416,8 @@ template <class T> template <class In_It, class In_It2, class In_It3> void Core:
 */
 template <class T> void Core::General::CSearch<T>::LoadParameters(std::string filterFileName, CAnalysisParam &params)
 {
-	// deserialize parameter data from file
-	std::ifstream ifs( filterFileName );
-    boost::archive::text_iarchive ia( ifs );
-	
-	// read parameters
-	if ( !ifs.eof() ) {
-		ia >> params;
-	} else {
-		throw std::ios_base::failure("Parameter file cannot be read.");
-	}
-
-	ifs.close();
+	// the parameter file is only read once for all searchers
+	params = *Core::CParameterStore::Instance().GetAnalysisParam( filterFileName );
 }
 
 
@@ -439,15 +431,7 @@ template <class T> void Core::General::CSearch<T>::LoadParameters(std::string fi
 */
 template <class T> void Core::General::CSearch<T>::SaveParameters(std::string filterFileName, CAnalysisParam params)
 {
-	// initialize serialization
-	std::ofstream ofs( filterFileName );
-	boost::archive::text_oarchive oa( ofs );
-
-	// serialize parameter object
-	const CAnalysisParam constParams = params; // workaround
-	oa << constParams;
-
-	ofs.close();
+	Core::CParameterStore::Save( filterFileName, params );
 }
 
 
@@ -465,6 +449,7 @@ template <class T> void Core::General::CSearch<T>::AnalysisThread(void)
 	vector<T> procSignal;
 	vector<ptime> procCalcSignalTime, procRefSignalTime;
 	vector< tuple< int, ptime, ptime, ptime, T, T > > newTones;
+	Utilities::Metrics::CStageMetrics stageMetrics( "analysis" );
 	
 	try {
 		// lock parameter variables
@@ -474,6 +459,7 @@ template <class T> void Core::General::CSearch<T>::AnalysisThread(void)
 		while ( !(boost::this_thread::interruption_requested()) ) {
 			// lock signal data mutex
 			boost::unique_lock<boost::mutex> lock( signalMutex );
+			stageMetrics.SetQueueLength( signal.size() );
 			if ( !( signal.empty() ) ) {
 				procSignal.assign( signal.begin(), signal.end() );
 				signal.clear();
@@ -485,6 +471,7 @@ template <class T> void Core::General::CSearch<T>::AnalysisThread(void)
 			lock.unlock();
 
 			// analysis of filtered signal data for finding the tone stream
+			auto startTime = std::chrono::steady_clock::now();
 			if ( !( procSignal.empty() ) ) {
 				SetNewSignalData( procCalcSignalTime.begin(), procCalcSignalTime.end(), procRefSignalTime.begin(), procRefSignalTime.end(), procSignal.begin(), procSignal.end() );		
 			}
@@ -496,6 +483,7 @@ template <class T> void Core::General::CSearch<T>::AnalysisThread(void)
 			if ( !( newTones.empty() ) ) {
 				PerformSpecializedCalculation( newTones );
 			}
+			stageMetrics.ObserveProcessingTime( std::chrono::steady_clock::now() - startTime );
 
 			// delay thread
 			std::this_thread::sleep_for( std::chrono::microseconds( static_cast<long long>( searchTimestep * 1e6 ) ) );
@@ -27,17 +27,12 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "FIRfilter.h"
 #include "SearchTransferFunc.h"
 
-double Core::Processing::Filter::Solver::samplingFreq;
-double Core::Processing::Filter::Solver::normCutoffFreq;
-double Core::Processing::Filter::Solver::goalTransWidth;
-double Core::Processing::Filter::Solver::minFilterOrder;
-
 
 
 /**	@brief		Calculation of the transition width residual (in respect to the goal transition width) for finding the corresponding filter order
 *	@param		currFilterOrder				Alglib-array containing the current filter order. The dimension of the array must be 1.
 *	@param		currTransWidthResidual		Alglib-array containing the transition width residual. The dimension of the array must be 1.
-*	@param		ptr							Not used, only for compatibility with the Alglib-library
+*	@param		ptr							Pointer to the Solver::SolverContext of the present search
 *	@return									None
 *	@exception								None
 *	@remarks								This function is intended for use with the Alglib nonlinear equation solvers. The function gives f(x) for the minimization: F = ( f(x) )^2 -> min
@@ -51,10 +46,12 @@ void Core::Processing::Filter::Solver::GetFuncVal(const alglib::real_1d_array &c
 	const int deltaEven = 2;
 	const int numPoints = 2;
 
+	const auto& context = *static_cast<const SolverContext*>( ptr );
+
 	filterOrders.setlength( numPoints );
 	filterOrders(0) = CDataProcessing<double>::NextSmallerEven( currFilterOrder(0) );
 	// checks if the chosen filter order is lower than the minimum allowed - due to the constraints of the minimizer, choosing the next larger even filter order is always sufficient
-	if ( filterOrders(0) < minFilterOrder ) {
+	if ( filterOrders(0) < context.minFilterOrder ) {
 		filterOrders(0) += deltaEven;
 	}
 	for (int i=1; i < filterOrders.length(); i++) {
@@ -64,11 +61,11 @@ void Core::Processing::Filter::Solver::GetFuncVal(const alglib::real_1d_array &c
 	// calculate the corresponding transition widths
 	transWidths.setlength( filterOrders.length() );
 	for (int i=0; i < filterOrders.length(); i++) {
-		transWidths(i) = CFIRfilter<double>::CalcTransitionWidth( static_cast<int>( filterOrders(i) ), normCutoffFreq, samplingFreq );
+		transWidths(i) = CFIRfilter<double>::CalcTransitionWidth( static_cast<int>( filterOrders(i) ), context.normCutoffFreq, context.samplingFreq );
 	}
 
 	// calculate the residual of the transition width
 	spline1dbuildlinear( filterOrders, transWidths, interpolationModel );
 	currTransWidth = spline1dcalc( interpolationModel, currFilterOrder(0) );
-	currTransWidthResidual(0) = std::abs( currTransWidth * samplingFreq - goalTransWidth );
+	currTransWidthResidual(0) = std::abs( currTransWidth * context.samplingFreq - context.goalTransWidth );
 }
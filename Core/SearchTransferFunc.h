@@ -49,12 +49,18 @@ namespace Core {
 	namespace Processing {
 		namespace Filter {
 			namespace Solver {
+				/**	\ingroup Core
+				*	Problem state of a single filter order search, it is passed to the Alglib-callback via its user pointer
+				*/
+				struct SolverContext {
+					double samplingFreq;
+					double normCutoffFreq;
+					double goalTransWidth;
+					double minFilterOrder;
+				};
+
 				AUDIOSP_API void GetFuncVal(const alglib::real_1d_array &currFilterOrder, alglib::real_1d_array &currTransWidthResidual, void *ptr);
 				template <class T> int FindTransitionWidth(const int& startFilterOrder, const T& goalTransWidth, const T& cutoffFreq, const T& samplingFreq, const int& maxFilterOrder, const double& diffStep = 1e-4, const int& itMax = 500, const double& minResValue = 1e-10, const double& minResFunction = 1e-10, const double& minResGradient = 1e-10);
-				AUDIOSP_API extern double samplingFreq;
-				AUDIOSP_API extern double normCutoffFreq;
-				AUDIOSP_API extern double goalTransWidth;
-				AUDIOSP_API extern double minFilterOrder;
 			}
 		}
 	}
@@ -78,7 +84,7 @@ namespace Core {
 *	@return									Filter order for which the chosen filter type gives a transition width equal to 'goalTransWidth'. This order is always even. A small deviation might occur because due to the discrete and even filter order an exact matching of the transition width might not be possible.
 *	@exception	std::domain_error			Thrown if the maximum filter order is smaller than the minimum filter order required for realizing the given cutoff frequency
 *	@exception	std::range_error			Thrown if the relative cutoff frequency is larger than 0.5 of sampling frequency
-*	@remarks								None
+*	@remarks								The method is re-entrant, several filters can be designed concurrently
 */
 template <typename T>
 int Core::Processing::Filter::Solver::FindTransitionWidth(const int& startFilterOrder, const T& goalTransWidth, const T& cutoffFreq, const T& samplingFreq, const int& maxFilterOrder, const double& diffStep, const int& itMax, const double& minResValue, const double& minResFunction, const double& minResGradient)
@@ -108,16 +114,17 @@ int Core::Processing::Filter::Solver::FindTransitionWidth(const int& startFilter
 		throw std::domain_error( "The cutoff frequency cannot be realized for the given maximum filter order." );
 	}
 
-	Solver::normCutoffFreq = realNormCutoffFreq;
-	Solver::samplingFreq = samplingFreq;
-	Solver::goalTransWidth = goalTransWidth;
-	Solver::minFilterOrder = lowerBoundFilterOrder(0);
+	SolverContext context;
+	context.normCutoffFreq = realNormCutoffFreq;
+	context.samplingFreq = samplingFreq;
+	context.goalTransWidth = goalTransWidth;
+	context.minFilterOrder = lowerBoundFilterOrder(0);
 
 	// solve nonlinear transfer function problem
 	minlmcreatev( 1, filterOrder, diffStep, state );
 	minlmsetbc( state, lowerBoundFilterOrder, upperBoundFilterOrder );
 	minlmsetcond( state, 0, 0 );
-	minlmoptimize( state, GetFuncVal );
+	minlmoptimize( state, GetFuncVal, nullptr, &context );
     minlmresults( state, filterOrder, optimizationReport );  
 	finalFilterOrder = CDataProcessing<double>::MakeEven( filterOrder(0) ); // the result must be always even
 
@@ -19,10 +19,14 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <deque>
 #include <string>
 #include <functional>
+#include <chrono>
+#include <sstream>
 #include <boost/thread.hpp>
 #include <boost/signals2.hpp>
 #include "SeqData.h"
 #include "SeqDataComplete.h"
+#include "LatencyProbe.h"
+#include "MetricsRegistry.h"
 
 /*@{*/
 /** \ingroup Core
@@ -171,6 +175,7 @@ template <class T> void Core::Audio::CSequencePasser<T>::SequencePassingThread(v
 	using namespace boost::posix_time;
 	
 	deque< Utilities::CSeqDataComplete<T> > sequenceCopy;
+	Utilities::Metrics::CStageMetrics stageMetrics( "sequence_passer" );
 
 	try {
 		if ( !isInit ) {
@@ -186,14 +191,17 @@ template <class T> void Core::Audio::CSequencePasser<T>::SequencePassingThread(v
 			boost::unique_lock<boost::mutex> lock( sequenceMutex );
 			sequenceCopy.assign( foundSequences.begin(), foundSequences.end() );
 			foundSequences.clear();
+			stageMetrics.SetQueueLength( sequenceCopy.size() );
 
 			if ( sequenceCopy.size() > 0 ) {
 				lock.unlock();
 
 				while ( !sequenceCopy.empty() ) {			
 					// fire signal to the callback function
+					auto startTime = std::chrono::steady_clock::now();
 					SignalNewSequence( sequenceCopy.front() );				
 					sequenceCopy.pop_front();
+					stageMetrics.ObserveProcessingTime( std::chrono::steady_clock::now() - startTime );
 				}
 			} else {
 				// set thread back to waiting state
@@ -219,6 +227,12 @@ template <class T> void Core::Audio::CSequencePasser<T>::SignalNewSequence(const
 	// lock any changes in the parameter set
 	boost::shared_lock<boost::shared_mutex> lock( parameterMutex );
 
+	// count the detections of each code
+	std::stringstream codeStream;
+	for ( auto tone : sequenceData.GetCodeData().GetTones() ) { codeStream << tone; };
+	Utilities::Metrics::CMetricsRegistry::Instance().GetCounter( "personalfme_detected_sequences_total", "Number of detected sequences for each code", { { "code", codeStream.str() } } )->Increment();
+
 	// fire signal to connected functions
+	Utilities::Latency::CLatencyProbe::Instance().Mark( sequenceData.GetCodeData().GetTones(), sequenceData.GetStartTime(), Utilities::Latency::SEQUENCE_PASSED );
 	foundSequenceSignal( Utilities::CSeqData( sequenceData.GetStartTime(), sequenceData.GetCodeData().GetTones(), sequenceData.GetInfoString() ) );
 }
@@ -20,10 +20,12 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <queue>
 #include <tuple>
 #include <memory>
+#include <chrono>
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/signals2.hpp>
 #include <boost/thread.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include "MetricsRegistry.h"
 
 /*@{*/
 /** \ingroup Core
@@ -663,6 +665,7 @@ template <class T> void Core::General::CToneSearch<T>::SearchTonesThread()
 	vector< vector<T> > currPeaksCoarse, processPeaksCoarse, currAbsToneLevelsCoarse, processAbsToneLevelsCoarse, currPeaks, processPeaks;
 	vector<T> newData;
 	deque< tuple< int, ptime, ptime, ptime, T, T > > newTones, oldTones;
+	Utilities::Metrics::CStageMetrics stageMetrics( "tone_search" );
 	
 	try {
 		if ( !isInit ) {
@@ -689,6 +692,7 @@ template <class T> void Core::General::CToneSearch<T>::SearchTonesThread()
 			timeCalc.clear();
 			timeRef.clear();
 			peaks.clear();
+			stageMetrics.SetQueueLength( currPeaks.size() );
 
 			// check for identical lengths of time and peak containers
 			if ( ( currCalcTimeCoarse.size() != currPeaksCoarse.size() ) || ( currCalcTime.size() != currPeaks.size() ) ) {
@@ -700,6 +704,7 @@ template <class T> void Core::General::CToneSearch<T>::SearchTonesThread()
 				lock.unlock();
 				
 				// get data for next analysis step and delete the used data
+				auto startTime = std::chrono::steady_clock::now();
 				try {
 					GetNextDatasets( currCalcTimeCoarse, currPeaksCoarse, currAbsToneLevelsCoarse, currCalcTime, currRefTime, currPeaks, processCalcTimeCoarse, processPeaksCoarse, processAbsToneLevelsCoarse, processCalcTime, processRefTime, processPeaks );
 				} catch ( Exception::streamLengthException e ) {
@@ -721,6 +726,7 @@ template <class T> void Core::General::CToneSearch<T>::SearchTonesThread()
 							}
 						}
 					}				
+					stageMetrics.ObserveProcessingTime( std::chrono::steady_clock::now() - startTime );
 									
 					// move result to data stream
 					boost::unique_lock<boost::mutex> lockResult( resultMutex );
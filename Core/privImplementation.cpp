@@ -39,6 +39,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "PortaudioWrapper.h"
 #include "SeqDataComplete.h"
 #include "DataProcessing.h"
+#include "FilterDesignCache.h"
+#include "AudioDeviceProbe.h"
+#include "ParameterStore.h"
 #include "privImplementation.h"
 
 
@@ -49,23 +52,11 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 *	@param		standardSamplingFreqs			Vector container storing all sampling frequencies to be tested [Hz]
 *	@return 									Vector container storing all valid sampling frequencies of the audio capture device [Hz]
 *	@exception 									None
-*	@remarks 									None
+*	@remarks 									The results are cached by the process-wide Processing::CAudioDeviceProbe
 */
 std::vector<double> Core::CAudioInput::CPrivImplementation::GetPossibleSamplingFreqs(const Processing::CAudioDevice& device, const int& numChannels, const std::vector<double>& standardSamplingFreqs)
 {
-	Processing::CAudioDevice defaultInputDevice;
-	std::vector<Processing::CAudioDevice> availableInputDevices;
-	std::vector<double> possibleSamplingFreqs;
-	Core::Processing::CPortaudio<float> portaudio;
-
-	// checks if the required device is available for the given sampling rates
-	for ( auto samplingFreq : standardSamplingFreqs ) {
-		if ( portaudio.IsDeviceAvailable( device, samplingFreq, numChannels ) ) {
-			possibleSamplingFreqs.push_back(samplingFreq );	
-		}	
-	}
-
-	return possibleSamplingFreqs;
+	return Processing::CAudioDeviceProbe::Instance().GetSupportedSamplingFreqs( device, numChannels, standardSamplingFreqs );
 }
 
 
@@ -79,18 +70,8 @@ std::vector<double> Core::CAudioInput::CPrivImplementation::GetPossibleSamplingF
 */
 void Core::CAudioInput::CPrivImplementation::LoadParameters(std::string audioSettingsFileName, Core::CAudioInputParam &params)
 {
-	// deserialize parameter data from file
-	std::ifstream ifs( audioSettingsFileName );
-	boost::archive::text_iarchive ia( ifs );
-	
-	// read parameters
-	if ( !ifs.eof() ) {
-		ia >> params;
-	} else {
-		throw std::ios_base::failure("Parameter file cannot be read.");
-	}
-
-	ifs.close();
+	// the audio settings are only read once, they are requested several times during the initialization
+	params = *CParameterStore::Instance().GetAudioInputParam( audioSettingsFileName );
 }
 
 
@@ -228,6 +209,9 @@ void Core::CAudioInput::CPrivImplementation::SetParameters(Processing::CAudioDev
 
 	CPrivImplementation::samplingFreqProcessing = CPrivImplementation::samplingFreqInput / downsamplingFactorProc;
 
+	// the designed filters are cached next to the audio settings file, so that the filter optimization is only performed at the first start
+	Processing::Filter::CFilterDesignCache::Instance().SetCacheFile( ( boost::filesystem::path( audioSettingsFileName ).parent_path() / "filterDesignCache.dat" ).string() );
+
 	// initialize downsampling filtering
 	GetRelevantAudioSettings( audioSettingsFileName, transWidthProc, transWidthRec, mainThreadCycleTime );
 	CPrivImplementation::mainThreadCycleTime = mainThreadCycleTime;
@@ -344,7 +328,7 @@ void  Core::CAudioInput::CPrivImplementation::GetAvailableAudioDevices( std::vec
 	// obtain the available devices for all standard sampling frequencies
 	for ( auto currStandardSamplingFreq : standardSamplingFreqs ) {
 		currDevices.clear();
-		dataReader.GetAudioDevices( currDevices, currStdDevice, currStandardSamplingFreq, numChannels ); // the method is independent of any running streams and works with the default initialized object of CPortaudio
+		Processing::CAudioDeviceProbe::Instance().GetAvailableInputDevices( currDevices, currStdDevice, currStandardSamplingFreq, numChannels ); // the probe is independent of any running streams
 
 		if ( !currDevices.empty() ) {
 			devicesMap[currStandardSamplingFreq] = currDevices;
@@ -375,12 +359,11 @@ void  Core::CAudioInput::CPrivImplementation::GetAvailableAudioDevices( std::vec
 *	@remarks									The highest possible sampling rate refers to the highest required sampling rate of the detection algorithm and may be lower than that of the sound device.
 *												This method can be used before initializing the object and does not interfer with any running audio stream
 */
-bool Core::CAudioInput::CPrivImplementation::IsDeviceAvailable( double& maxStandardSamplingFreq, const Processing::CAudioDevice& device, const boost::filesystem::path& audioSettingsFile ) const
+bool Core::CAudioInput::CPrivImplementation::IsDeviceAvailable( double& maxStandardSamplingFreq, const Processing::CAudioDevice& device, const boost::filesystem::path& audioSettingsFile )
 {
 	using namespace std;
 
-	bool currIsAvailable;
-	set<double> availabilitySet;
+	vector<double> possibleSamplingFreqs;
 	string parameterFileName, specializedParameterFileName;
 	int numChannels, maxLengthInputQueue, maxMissedAttempts, channel;
 	double sampleLength, maxRequiredProcFreq, transWidthProc, transWidthRec;
@@ -392,17 +375,12 @@ bool Core::CAudioInput::CPrivImplementation::IsDeviceAvailable( double& maxStand
 	LoadParameters( audioSettingsFile.string(), params );
 	params.Get( sampleLength, numChannels, maxLengthInputQueue, maxMissedAttempts, channel, parameterFileName, specializedParameterFileName, maxRequiredProcFreq, transWidthProc, transWidthRec, mainThreadCycleTime, standardSamplingFreqs );
 
-	// obtain the available devices for all standard sampling frequencies)
-	for ( auto currStandardSamplingFreq : standardSamplingFreqs ) {
-		currIsAvailable = dataReader.IsDeviceAvailable( device, currStandardSamplingFreq, numChannels ); // the method is independent of any running streams and works with the default initialized object of CPortaudio
-		if ( currIsAvailable ) {
-			availabilitySet.insert( currStandardSamplingFreq );
-		}
-	}
+	// obtain the availability of the device for all standard sampling frequencies
+	possibleSamplingFreqs = GetPossibleSamplingFreqs( device, numChannels, standardSamplingFreqs );
 
 	// determine the highest possible standard sampling frequency
-	if ( !availabilitySet.empty() ) {
-		maxStandardSamplingFreq = *( availabilitySet.rbegin() );
+	if ( !possibleSamplingFreqs.empty() ) {
+		maxStandardSamplingFreq = *max_element( possibleSamplingFreqs.begin(), possibleSamplingFreqs.end() );
 		return true;
 	} else {
 		maxStandardSamplingFreq = 0.0;
@@ -412,6 +390,18 @@ bool Core::CAudioInput::CPrivImplementation::IsDeviceAvailable( double& maxStand
 
 
 
+/**	@brief		Releases the resources kept for probing the input devices
+*	@return										None
+*	@exception									None
+*	@remarks									The Portaudio session of the process-wide Processing::CAudioDeviceProbe is closed and its cache is discarded
+*/
+void Core::CAudioInput::CPrivImplementation::ReleaseAudioDevices()
+{
+	Processing::CAudioDeviceProbe::Instance().Invalidate();
+}
+
+
+
 /**	@brief		Set the input device
 *	@param		device							Chosen input device. It can be obtained from CAudioInput::GetAudioDevices. For default device set it to an empty name.
 *	@return										None
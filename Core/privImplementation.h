@@ -45,8 +45,9 @@ public:
 	virtual ~CPrivImplementation(void){};
 	void SetParameters(Processing::CAudioDevice device, std::string audioSettingsFileName, std::function<void(const Utilities::CSeqData&)> foundCallback, std::function<void(const std::string&)> runtimeErrorCallback, std::shared_ptr<RecordingParam> recordingParams);
 	void SetFileNames(const std::string& parameterFileName, const std::string& specializedParameterFileName);
-	void GetAvailableAudioDevices( std::vector<Processing::CAudioDevice>& devices, Processing::CAudioDevice& stdDevice, double& maxStandardSamplingFreq, const boost::filesystem::path& audioSettingsFile );
-	bool IsDeviceAvailable( double& maxStandardSamplingFreq, const Processing::CAudioDevice& device, const boost::filesystem::path& audioSettingsFile ) const;
+	static void GetAvailableAudioDevices( std::vector<Processing::CAudioDevice>& devices, Processing::CAudioDevice& stdDevice, double& maxStandardSamplingFreq, const boost::filesystem::path& audioSettingsFile );
+	static bool IsDeviceAvailable( double& maxStandardSamplingFreq, const Processing::CAudioDevice& device, const boost::filesystem::path& audioSettingsFile );
+	static void ReleaseAudioDevices();
 	void SetAudioDevice(const Processing::CAudioDevice& device);
 	void StartAudioInput(void);
 	void StopAudioInput(void);
@@ -0,0 +1,153 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define Middleware_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define Middleware_API __declspec(dllexport)
+	#endif
+#endif
+
+#include <stdexcept>
+#include <Poco/Exception.h>
+#include <Poco/Delegate.h>
+#include <Poco/DirectoryWatcher.h>
+#include <Poco/Path.h>
+#include "ConfigFileWatcher.h"
+
+
+constexpr std::chrono::milliseconds Middleware::CConfigFileWatcher::settlingTime;
+
+
+/** \ingroup Middleware
+*	Receiving the events of the directory containing the configuration file
+*/
+struct Middleware::CConfigFileWatcher::DirectoryEventHandler {
+	DirectoryEventHandler( CConfigFileWatcher& watcher ) : watcher( watcher ) {};
+
+	/**	@brief		Called for any change in the directory, only changes of the configuration file are passed on
+	*	@param		sender								Sending directory watcher
+	*	@param		event								Directory event
+	*	@return 										None
+	*	@exception 										None
+	*	@remarks 										None
+	*/
+	void OnDirectoryEvent( const void* sender, const Poco::DirectoryWatcher::DirectoryEvent& event )
+	{
+		if ( Poco::Path( event.item.path() ).getFileName() == watcher.configFile.filename().string() ) {
+			watcher.OnFileChanged();
+		}
+	}
+
+	CConfigFileWatcher& watcher;
+};
+
+
+/**	@brief		Constructor
+*	@param		configFile							Configuration file to be watched, also an atomic replacement of the file (as performed by many editors) is detected
+*	@param		changeCallback						Function called on a separate thread if the configuration file has been changed. It must handle all exceptions itself.
+*	@exception 	std::runtime_error					Thrown if the directory of the configuration file cannot be watched
+*	@remarks 										None
+*/
+Middleware::CConfigFileWatcher::CConfigFileWatcher( const boost::filesystem::path& configFile, std::function<void()> changeCallback )
+	: configFile( configFile ),
+	  changeCallback( changeCallback ),
+	  isChanged( false ),
+	  isTerminateThread( false )
+{
+	using namespace Poco;
+
+	notificationThread = std::thread( &CConfigFileWatcher::NotificationThread, this );
+
+	try {
+		// the directory is watched, because editors often replace the file instead of modifying it
+		eventHandler = std::make_unique<DirectoryEventHandler>( *this );
+		directoryWatcher = std::make_unique<DirectoryWatcher>( configFile.parent_path().string(), DirectoryWatcher::DW_ITEM_ADDED | DirectoryWatcher::DW_ITEM_MODIFIED | DirectoryWatcher::DW_ITEM_MOVED_TO );
+		directoryWatcher->itemAdded += delegate( eventHandler.get(), &DirectoryEventHandler::OnDirectoryEvent );
+		directoryWatcher->itemModified += delegate( eventHandler.get(), &DirectoryEventHandler::OnDirectoryEvent );
+		directoryWatcher->itemMovedTo += delegate( eventHandler.get(), &DirectoryEventHandler::OnDirectoryEvent );
+	} catch ( Poco::Exception& e ) {
+		{
+			std::lock_guard<std::mutex> lock( watcherMutex );
+			isTerminateThread = true;
+		}
+		changeCondition.notify_all();
+		notificationThread.join();
+		throw std::runtime_error( u8"Die Konfigurationsdatei " + configFile.string() + u8" kann nicht überwacht werden: " + e.displayText() );
+	}
+}
+
+
+/**	@brief		Destructor
+*	@remarks 										A change callback in progress is completed before the destruction
+*/
+Middleware::CConfigFileWatcher::~CConfigFileWatcher()
+{
+	// no further events are received after the destruction of the directory watcher
+	directoryWatcher.reset();
+
+	{
+		std::lock_guard<std::mutex> lock( watcherMutex );
+		isTerminateThread = true;
+	}
+	changeCondition.notify_all();
+	notificationThread.join();
+}
+
+
+/**	@brief		Registers a change of the configuration file
+*	@return 										None
+*	@exception 										None
+*	@remarks 										None
+*/
+void Middleware::CConfigFileWatcher::OnFileChanged()
+{
+	{
+		std::lock_guard<std::mutex> lock( watcherMutex );
+		isChanged = true;
+		lastChangeTime = std::chrono::steady_clock::now();
+	}
+	changeCondition.notify_all();
+}
+
+
+/**	@brief		Background thread calling the change callback after the configuration file has settled
+*	@return 										None
+*	@exception 										None
+*	@remarks 										The callback is called only once the file has not been changed anymore for CConfigFileWatcher::settlingTime
+*/
+void Middleware::CConfigFileWatcher::NotificationThread()
+{
+	std::unique_lock<std::mutex> lock( watcherMutex );
+	while ( true ) {
+		changeCondition.wait( lock, [this]() { return ( isChanged || isTerminateThread ); } );
+
+		// wait until the file has settled
+		while ( !isTerminateThread && ( std::chrono::steady_clock::now() < lastChangeTime + settlingTime ) ) {
+			changeCondition.wait_until( lock, lastChangeTime + settlingTime );
+		}
+		if ( isTerminateThread ) {
+			break;
+		}
+
+		isChanged = false;
+		lock.unlock();
+		changeCallback();
+		lock.lock();
+	}
+}
@@ -0,0 +1,87 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
+#include <boost/filesystem.hpp>
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef Middleware_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define Middleware_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define Middleware_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define Middleware_API __attribute__ ((visibility ("default")))
+	#else
+		#define Middleware_API
+	#endif		
+#endif
+
+namespace Poco {
+	class DirectoryWatcher;
+}
+
+
+/*@{*/
+/** \ingroup Middleware
+*/
+namespace Middleware {
+	/** \ingroup Middleware
+	*	Class watching the configuration file for changes. The file system notifications of the operating system are used (inotify on Linux).
+	*	Several notifications in quick succession (as caused by editors saving a file) are merged into a single call of the change callback.
+	*/
+	class CConfigFileWatcher
+	{
+	public:
+		Middleware_API CConfigFileWatcher( const boost::filesystem::path& configFile, std::function<void()> changeCallback );
+		Middleware_API virtual ~CConfigFileWatcher();
+	private:
+		struct DirectoryEventHandler;
+		void OnFileChanged();
+		void NotificationThread();
+
+		/**	@brief		Time without further changes of the file before the change callback is called */
+		static constexpr std::chrono::milliseconds settlingTime{ 1000 };
+
+		boost::filesystem::path configFile;
+		std::function<void()> changeCallback;
+		std::mutex watcherMutex;
+		std::condition_variable changeCondition;
+		bool isChanged;
+		bool isTerminateThread;
+		std::chrono::steady_clock::time_point lastChangeTime;
+		std::thread notificationThread;
+		std::unique_ptr<DirectoryEventHandler> eventHandler;
+		std::unique_ptr<Poco::DirectoryWatcher> directoryWatcher;
+	};
+}
+/*@}*/
@@ -73,6 +73,13 @@ Middleware::CExecutionDetectorRuntime::CExecutionDetectorRuntime(const CSettings
 	CExecutionDetectorRuntime::onRecordedDataCallback = onRecordedDataCallback;
 	CExecutionDetectorRuntime::audioDir = audioDir;
 
+	// alarm messages still pending before the last shutdown are resent, the operation is continued without the journal if it is not available
+	try {
+		gateways.SetJournalDirectory( audioDir / "journal" );
+	} catch ( std::exception& e ) {
+		OnStatusMessage( std::make_unique<Utilities::Message::CGeneralStatusMessage>( Utilities::Message::MESSAGE_ERROR, boost::posix_time::ptime( boost::posix_time::microsec_clock::universal_time() ), u8"Das Nachrichtenjournal kann nicht geöffnet werden: " + std::string( e.what() ) ) );
+	}
+
 	// start audio device - it is assumed that the audio settings file and all connected settings files are given relative to the subfolder in the Windows application specific folder
 	recordingParams = make_shared<Core::RecordingParam>();
 	recordingParams->recordedCallback = bind( &CExecutionDetectorRuntime::OnRecordedData, this, placeholders::_1, placeholders::_2, placeholders::_3 );
@@ -254,8 +261,7 @@ void Middleware::CExecutionDetectorRuntime::OnProcessingSequence(const Utilities
 */
 void Middleware::GetAvailableAudioDevices( std::vector<Core::Processing::CAudioDevice>& devices, Core::Processing::CAudioDevice& stdDevice, double& maxStandardSamplingFreq, const boost::filesystem::path& appSettingsDir )
 {
-	std::unique_ptr<Core::CAudioInput> audioInput = std::make_unique<Core::CFMEAudioInput>();
-	audioInput->GetAvailableAudioDevices( devices, stdDevice, maxStandardSamplingFreq, absolute( CAudioSettings::GetAudioSettingsFileName(), appSettingsDir ) );
+	Core::CAudioInput::GetAvailableAudioDevices( devices, stdDevice, maxStandardSamplingFreq, absolute( CAudioSettings::GetAudioSettingsFileName(), appSettingsDir ) );
 }
 
 
@@ -271,10 +277,5 @@ void Middleware::GetAvailableAudioDevices( std::vector<Core::Processing::CAudioD
 */
 bool Middleware::IsDeviceAvailable( double& maxStandardSamplingFreq, const Core::Processing::CAudioDevice& device, const boost::filesystem::path& appSettingsDir )
 {
-	bool isAvailable;
-
-	std::unique_ptr<Core::CAudioInput> audioInput = std::make_unique<Core::CFMEAudioInput>();
-	isAvailable = audioInput->IsDeviceAvailable( maxStandardSamplingFreq, device, absolute( CAudioSettings::GetAudioSettingsFileName(), appSettingsDir ) );
-
-	return isAvailable;
+	return Core::CAudioInput::IsDeviceAvailable( maxStandardSamplingFreq, device, absolute( CAudioSettings::GetAudioSettingsFileName(), appSettingsDir ) );
 }
\ No newline at end of file
@@ -25,8 +25,10 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 
 #include "BoostStdTimeConverter.h"
 #include "SendStatusMessage.h"
+#include "GeneralStatusMessage.h"
 #include "AlarmMessage.h"
 #include "AudioSettings.h"
+#include "LatencyProbe.h"
 #include "ExecutionRuntime.h"
 
 
@@ -57,6 +59,9 @@ Middleware::CExecutionRuntime::CExecutionRuntime(const CSettingsParam& newParams
 	params.GetGatewaySettings( loginDatabase, alarmMessagesDatabase );	
 	gateways.ResetGatewayLoginDatabase( loginDatabase );
 	gateways.ResetAlarmMessagesDatabase( alarmMessagesDatabase );
+
+	// the latency records of the alarms are logged as status messages
+	Utilities::Latency::CLatencyProbe::Instance().SetRecordCallback( messageFromDetectorCallback );
 }
 
 
@@ -66,6 +71,7 @@ Middleware::CExecutionRuntime::CExecutionRuntime(const CSettingsParam& newParams
 */
 Middleware::CExecutionRuntime::~CExecutionRuntime()
 {
+	Utilities::Latency::CLatencyProbe::Instance().SetRecordCallback( nullptr );
 }
 
 
@@ -77,11 +83,96 @@ Middleware::CExecutionRuntime::~CExecutionRuntime()
 */
 Middleware::CSettingsParam Middleware::CExecutionRuntime::GetParams()
 {
+	std::lock_guard<std::mutex> lock( paramsMutex );
 	return params;
 }
 
 
 
+/**	@brief		Applies changed parameters to the running detection / server operation
+*	@param		newParams							Changed parameter set, usually obtained from the modified configuration file
+*	@return 										None
+*	@exception 										Exceptions of the resetting of the databases are passed on, the running parameters remain unchanged in this case
+*	@remarks 										Only the alarm gateway settings are applied, the detection is not interrupted. Only the changed databases are reset.
+*													Changes of the other settings require a restart, they are reported by a status message.
+*/
+void Middleware::CExecutionRuntime::ReloadParams( const CSettingsParam& newParams )
+{
+	using namespace std;
+	using namespace boost::posix_time;
+	using namespace Utilities::Message;
+
+	External::CAlarmMessageDatabase alarmMessagesDatabase, newAlarmMessagesDatabase;
+	External::CGatewayLoginDatabase loginDatabase, newLoginDatabase;
+	CSettingsParam currParams, appliedParams;
+
+	currParams = GetParams();
+	currParams.GetGatewaySettings( loginDatabase, alarmMessagesDatabase );
+	newParams.GetGatewaySettings( newLoginDatabase, newAlarmMessagesDatabase );
+
+	bool isLoginDatabaseChanged = ( newLoginDatabase != loginDatabase );
+	bool isAlarmMessagesDatabaseChanged = ( newAlarmMessagesDatabase != alarmMessagesDatabase );
+
+	// the alarm messages database is reset last, the new alarm messages may require the new gateways
+	if ( isLoginDatabaseChanged ) {
+		gateways.ResetGatewayLoginDatabase( newLoginDatabase );
+	}
+	if ( isAlarmMessagesDatabaseChanged ) {
+		try {
+			gateways.ResetAlarmMessagesDatabase( newAlarmMessagesDatabase );
+		} catch ( ... ) {
+			// the running gateways must match the running parameters
+			if ( isLoginDatabaseChanged ) {
+				gateways.ResetGatewayLoginDatabase( loginDatabase );
+			}
+			throw;
+		}
+	}
+
+	// only the gateway settings are taken over (this also updates the whitelist)
+	appliedParams = currParams;
+	appliedParams.SetGatewaySettings( newLoginDatabase, newAlarmMessagesDatabase );
+	{
+		std::lock_guard<std::mutex> lock( paramsMutex );
+		params = appliedParams;
+	}
+
+	if ( appliedParams != newParams ) {
+		OnStatusMessage( make_unique<CGeneralStatusMessage>( MESSAGE_ERROR, ptime( microsec_clock::universal_time() ), u8"Die geänderten Audio- und Aufnahmeeinstellungen der Konfigurationsdatei werden erst nach einem Neustart wirksam." ) );
+	}
+	if ( isLoginDatabaseChanged || isAlarmMessagesDatabaseChanged ) {
+		OnStatusMessage( make_unique<CGeneralStatusMessage>( MESSAGE_SUCCESS, ptime( microsec_clock::universal_time() ), u8"Die geänderten Alarmierungseinstellungen der Konfigurationsdatei wurden übernommen." ) );
+	}
+}
+
+
+
+/**	@brief		Reads the changed configuration file and applies it to the running detection / server operation
+*	@param		configFile							Changed configuration file
+*	@param		schemaDir							XML schema file directory
+*	@param		pluginDir							Directory containing the audio plugins
+*	@return 										None
+*	@exception 										None
+*	@remarks 										An invalid configuration file is reported by a status message, the running parameters remain unchanged in this case.
+*													See CExecutionRuntime::ReloadParams( const CSettingsParam& ) for the applied settings.
+*/
+void Middleware::CExecutionRuntime::ReloadParams( const boost::filesystem::path& configFile, const boost::filesystem::path& schemaDir, const boost::filesystem::path& pluginDir )
+{
+	using namespace std;
+	using namespace boost::posix_time;
+	using namespace Utilities::Message;
+
+	try {
+		CSettingsParam newParams;
+		newParams.GetFromXML( configFile, schemaDir, pluginDir ); // will throw an XML-exception in case of a parsing or validation error
+		ReloadParams( newParams );
+	} catch ( std::exception& e ) {
+		OnStatusMessage( make_unique<CGeneralStatusMessage>( MESSAGE_ERROR, ptime( microsec_clock::universal_time() ), string( u8"Die geänderte Konfigurationsdatei kann nicht übernommen werden, die bisherigen Einstellungen bleiben gültig: " ) + e.what() ) );
+	}
+}
+
+
+
 /**	@brief		Basic processing of sequences (identical on detectors and servers)
 *	@param		sequenceData						Data of the new FME sequence
 *	@return 										None
@@ -136,6 +227,7 @@ void Middleware::CExecutionRuntime::BasicSequenceProcessing( const Utilities::CS
 	sequenceCode = sequenceData.GetCode();
 	if ( ( get<1>( previousSequence ) == sequenceCode ) && ( ( time - get<0>( previousSequence ) ) < microseconds( static_cast<long>( minDistanceRepetition * 1.0e6 ) ) ) ) {
 		sequencesBlacklist.push_back( make_tuple( time, sequenceData.GetCode() ) ); // entry to blacklist due to too close repetitions
+		Utilities::Latency::CLatencyProbe::Instance().Discard( sequenceCode, sequenceData.GetStartTime() );
 		return;
 	}
 
@@ -143,9 +235,11 @@ void Middleware::CExecutionRuntime::BasicSequenceProcessing( const Utilities::CS
 	auto itFound = find( begin( sequencesWhitelist ), end( sequencesWhitelist ), sequenceCode );
 	if ( ( itFound == end( sequencesWhitelist ) ) && ( !sequencesWhitelist.empty() ) ) {
 		sequencesBlacklist.push_back( std::make_tuple( time, sequenceData.GetCode() ) ); // entry to blacklist due to a sequence not allowed to be stored
+		Utilities::Latency::CLatencyProbe::Instance().Discard( sequenceCode, sequenceData.GetStartTime() );
 		return;
 	}
 	lockBlacklist.unlock();
+	Utilities::Latency::CLatencyProbe::Instance().Mark( sequenceCode, sequenceData.GetStartTime(), Utilities::Latency::SEQUENCE_PROCESSED );
 
 	// user-defined processing
 	onFoundSequenceCallback( sequenceData );
@@ -20,6 +20,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <tuple>
 #include <string>
 #include <thread>
+#include <mutex>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem.hpp>
 #include "SeqData.h"
@@ -63,6 +64,8 @@ namespace Middleware {
 		Middleware_API CExecutionRuntime( const CSettingsParam& newParams, const boost::filesystem::path& appSettingsDir, std::function<void( const std::string& )> runtimeErrorCallback, std::function<void( std::unique_ptr<Utilities::Message::CStatusMessage> )> messageFromDetectorCallback );
 		Middleware_API virtual ~CExecutionRuntime(void);
 		Middleware_API virtual void Run(void) = 0;
+		Middleware_API virtual void ReloadParams( const CSettingsParam& newParams );
+		Middleware_API virtual void ReloadParams( const boost::filesystem::path& configFile, const boost::filesystem::path& schemaDir, const boost::filesystem::path& pluginDir );
 	protected:
 		Middleware_API virtual void OnProcessingSequence(const Utilities::CSeqData& sequence) = 0;
 		Middleware_API virtual void OnRuntimeError(const std::string& errorString);
@@ -76,6 +79,7 @@ namespace Middleware {
 		std::function<void(const Utilities::CSeqData&)> onFoundSequenceCallback;
 		External::CAlarmGatewaysManager gateways;
 	private:
+		std::mutex paramsMutex;
 		CSettingsParam params;
 		std::function< void( const std::string& ) > runtimeErrorCallback;
 		std::function< void( std::unique_ptr<Utilities::Message::CStatusMessage> ) > statusMessageCallback;
@@ -0,0 +1,182 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define Middleware_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define Middleware_API __declspec(dllexport)
+	#endif
+#endif
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include "BoostStdTimeConverter.h"
+#include "GeneralStatusMessage.h"
+#include "LatencyProbe.h"
+#include "ExecutionServerRuntime.h"
+
+/*@{*/
+/** \ingroup Middleware
+*/
+namespace Middleware {
+	namespace ServerRuntime {
+		const float minDeduplicationWindow = 1.0f;		// minimum time window for the de-duplication [s], it covers the clock deviations between the detector sites
+	}
+}
+/*@}*/
+
+
+
+/**	@brief		Constructor
+*	@param		newParams							Parameter for the server operation
+*	@param		appSettingsDir						Directory containing the basic general (audio, ...) settings files
+*	@param		dataDir								Directory where the message journal should be stored
+*	@param		address								Address of the network interface the server is listening on
+*	@param		port								Port the server is listening on for the remote detector sites
+*	@param		onFoundSequenceCallback				Function called if a sequence has been received that is not a duplicate
+*	@param		runtimeErrorCallback				Function called if an error occurs during the execution of the server
+*	@param		messageFromDetectorCallback			Function called if the server emits a message that should be logged by the caller
+*	@param		numThreads							Number of threads serving the network connections, 0 uses the number of hardware threads
+*	@exception 	std::runtime_error					Thrown if the server could not be initialized
+*	@remarks 										The sequences are de-duplicated within the minimum distance between repetitions set in the functionality settings
+*/
+Middleware::CExecutionServerRuntime::CExecutionServerRuntime( const CSettingsParam& newParams, const boost::filesystem::path& appSettingsDir, const boost::filesystem::path& dataDir, const std::string& address, const unsigned short& port, std::function<void(const Utilities::CSeqData&)> onFoundSequenceCallback, std::function<void(const std::string&)> runtimeErrorCallback, std::function<void( std::unique_ptr<Utilities::Message::CStatusMessage> )> messageFromDetectorCallback, const unsigned int& numThreads )
+	: CExecutionRuntime( newParams, appSettingsDir, runtimeErrorCallback, messageFromDetectorCallback )
+{
+	using namespace std;
+	using namespace boost::posix_time;
+	using namespace Utilities::Metrics;
+
+	Core::Processing::CAudioDevice device;
+	bool isPlayTone;
+	float minDistanceRepetition, window;
+
+	CExecutionRuntime::GetParams().GetFunctionalitySettings( device, minDistanceRepetition, isPlayTone );
+	CExecutionRuntime::onFoundSequenceCallback = onFoundSequenceCallback;
+
+	window = max( minDistanceRepetition, ServerRuntime::minDeduplicationWindow );
+	deduplicator = make_unique<CSequenceDeduplicator>( microseconds( static_cast<long>( window * 1.0e6 ) ) );
+	receivedMetric = CMetricsRegistry::Instance().GetCounter( "personalfme_server_received_total", "Number of sequences received from the remote detector sites" );
+	duplicatesMetric = CMetricsRegistry::Instance().GetCounter( "personalfme_server_duplicates_total", "Number of received sequences suppressed as duplicates of an already forwarded alarm" );
+
+	// alarm messages still pending before the last shutdown are resent, the operation is continued without the journal if it is not available
+	try {
+		gateways.SetJournalDirectory( dataDir / "journal" );
+	} catch ( std::exception& e ) {
+		OnStatusMessage( make_unique<Utilities::Message::CGeneralStatusMessage>( Utilities::Message::MESSAGE_ERROR, ptime( microsec_clock::universal_time() ), u8"Das Nachrichtenjournal kann nicht geöffnet werden: " + string( e.what() ) ) );
+	}
+
+	try {
+		server.Init( address, port, bind( &CExecutionServerRuntime::OnProcessingSequence, this, placeholders::_1 ), numThreads );
+	} catch ( std::exception& e ) {
+		throw std::runtime_error( "The server could not be started. Error message: " + string( e.what() ) );
+	}
+}
+
+
+
+/**	@brief		Starts receiving the sequences from the remote detector sites
+*	@return 										None
+*	@exception	std::logic_error					Thrown if the server is already running within this object
+*	@remarks 										The function returns immediately, the server is running in its own thread until the object is deleted
+*/
+void Middleware::CExecutionServerRuntime::Run(void)
+{
+	using namespace std;
+	using namespace boost::posix_time;
+	using namespace Utilities::Message;
+
+	std::lock_guard<std::mutex> lock( serverMutex );
+	if ( serverThread ) {
+		throw std::logic_error( "The server is already running." );
+	}
+	serverThread = make_unique<std::thread>( &CExecutionServerRuntime::ServerThread, this );
+
+	OnStatusMessage( make_unique<CGeneralStatusMessage>( MESSAGE_SUCCESS, ptime( microsec_clock::universal_time() ), u8"Der Empfang der Alarme von den Detektoren wurde gestartet." ) );
+}
+
+
+
+/**	@brief		Destructor
+*	@remarks 										None
+*/
+Middleware::CExecutionServerRuntime::~CExecutionServerRuntime(void)
+{
+	using namespace boost::posix_time;
+	using namespace Utilities::Message;
+
+	// stop the server (it will return when all pending sequences have been processed)
+	std::lock_guard<std::mutex> lock( serverMutex );
+	if ( serverThread ) {
+		server.Stop();
+		serverThread->join();
+		OnStatusMessage( std::make_unique<CGeneralStatusMessage>( MESSAGE_SUCCESS, ptime( microsec_clock::universal_time() ), u8"Der Empfang der Alarme von den Detektoren wurde beendet." ) );
+	}
+}
+
+
+
+/**	@brief		Thread function running the server
+*	@return 										None
+*	@exception										None
+*	@remarks 										Any errors are reported via the runtime error callback
+*/
+void Middleware::CExecutionServerRuntime::ServerThread(void)
+{
+	try {
+		server.Run();
+	} catch ( std::exception& e ) {
+		OnRuntimeError( e.what() );
+	}
+}
+
+
+
+/**	@brief		Processing of a sequence received from one of the remote detector sites
+*	@param		sequence							Containing the reference time and the code of the sequence
+*	@return 										None
+*	@exception										None
+*	@remarks 										Only the first of all sequences with the same code within the de-duplication time window is forwarded
+*/
+void Middleware::CExecutionServerRuntime::OnProcessingSequence( const Utilities::CSeqData& sequence )
+{
+	using namespace boost::posix_time;
+	ptime time, receiveTime;
+	bool isDuplicate;
+
+	receivedMetric->Increment();
+	receiveTime = microsec_clock::universal_time();
+	try {
+		time = Utilities::Time::CBoostStdTimeConverter::ConvertToBoostTime( sequence.GetStartTime() );
+	} catch ( std::out_of_range e ) {
+		// set to "not a date / time"
+		time = ptime();
+	}
+
+	std::unique_lock<std::mutex> lock( deduplicatorMutex );
+	isDuplicate = deduplicator->IsDuplicate( sequence.GetCode(), time, receiveTime );
+	lock.unlock();
+
+	if ( isDuplicate ) {
+		duplicatesMetric->Increment();
+		Utilities::Latency::CLatencyProbe::Instance().Discard( sequence.GetCode(), sequence.GetStartTime() );
+		return;
+	}
+
+	BasicSequenceProcessing( sequence );
+}
@@ -0,0 +1,80 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <string>
+#include "FMEServer.h"
+#include "SeqData.h"
+#include "MetricsRegistry.h"
+#include "SequenceDeduplicator.h"
+#include "ExecutionRuntime.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef Middleware_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define Middleware_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define Middleware_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define Middleware_API __attribute__ ((visibility ("default")))
+	#else
+		#define Middleware_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Middleware
+*/
+namespace Middleware {
+	/** \ingroup Middleware
+	*	Class implementing the server runtime environment aggregating the sequences received from several remote detector sites.
+	*	The same alarm detected by several sites is only forwarded once to the alarm gateways.
+	*/
+	class CExecutionServerRuntime : public CExecutionRuntime
+	{
+	public:
+		Middleware_API CExecutionServerRuntime( const CSettingsParam& newParams, const boost::filesystem::path& appSettingsDir, const boost::filesystem::path& dataDir, const std::string& address, const unsigned short& port, std::function<void(const Utilities::CSeqData&)> onFoundSequenceCallback, std::function<void(const std::string&)> runtimeErrorCallback, std::function<void( std::unique_ptr<Utilities::Message::CStatusMessage> )> messageFromDetectorCallback, const unsigned int& numThreads = 0 );
+		Middleware_API virtual ~CExecutionServerRuntime(void);
+		Middleware_API virtual void Run(void);
+	private:
+		Middleware_API virtual void OnProcessingSequence(const Utilities::CSeqData& sequence);
+		void ServerThread(void);
+
+		std::mutex serverMutex;
+		Networking::CFMEServer server;
+		std::unique_ptr<std::thread> serverThread;
+		std::mutex deduplicatorMutex;
+		std::unique_ptr<CSequenceDeduplicator> deduplicator;
+		std::shared_ptr<Utilities::Metrics::CCounter> receivedMetric;
+		std::shared_ptr<Utilities::Metrics::CCounter> duplicatesMetric;
+	};
+}
+/*@}*/
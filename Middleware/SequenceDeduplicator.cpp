@@ -0,0 +1,133 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define Middleware_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define Middleware_API __declspec(dllexport)
+	#endif
+#endif
+
+#include <stdexcept>
+#include "SequenceDeduplicator.h"
+
+
+
+/**	@brief		Constructor
+*	@param		window								Two sequences with the same code are regarded as the same alarm if their reference timestamps differ by less than this time span
+*	@exception	std::invalid_argument				Thrown if the time window is not positive
+*	@remarks 										None
+*/
+Middleware::CSequenceDeduplicator::CSequenceDeduplicator( const boost::posix_time::time_duration& window )
+	: window( window )
+{
+	if ( window.is_special() || ( window <= boost::posix_time::time_duration() ) ) {
+		throw std::invalid_argument( "The de-duplication time window must be positive." );
+	}
+}
+
+
+
+/**	@brief		Checks if a sequence has already been accepted within the time window and stores it otherwise
+*	@param		code								Code of the sequence
+*	@param		time								Reference timestamp of the sequence as set by the detector
+*	@param		receiveTime							Time of the local clock when the sequence was received (in the same time zone as the reference timestamp)
+*	@return 										True if the sequence is a duplicate of an accepted sequence, false if it is new and has been stored
+*	@exception										None
+*	@remarks 										Duplicates do not extend the time window, it remains anchored at the accepted sequence. Sequences without a valid timestamp are never regarded as duplicates.
+*													Timestamps ahead of the receive time by more than the time window are limited to this value. Sequences with timestamps more than twice the time window behind
+*													the latest receive time are always accepted, because the store does not reach back that far.
+*/
+bool Middleware::CSequenceDeduplicator::IsDuplicate( const std::vector<int>& code, const boost::posix_time::ptime& time, const boost::posix_time::ptime& receiveTime )
+{
+	if ( time.is_special() ) {
+		return false;
+	}
+
+	// a sequence from a site with a clock running ahead would otherwise stay in the store until the local clock reaches its timestamp
+	auto refTime = time;
+	if ( !receiveTime.is_special() && ( refTime > receiveTime + window ) ) {
+		refTime = receiveTime + window;
+	}
+
+	// the sequences can arrive in any order from different sites, therefore the window extends in both directions
+	auto codeIt = codeIndex.find( code );
+	if ( codeIt != codeIndex.end() ) {
+		auto timeIt = codeIt->second.upper_bound( refTime - window );
+		if ( ( timeIt != codeIt->second.end() ) && ( *timeIt < refTime + window ) ) {
+			return true;
+		}
+	}
+
+	codeIndex[code].insert( refTime );
+	timeIndex.emplace( refTime, code );
+	if ( !receiveTime.is_special() && ( latestReceiveTime.is_special() || ( receiveTime > latestReceiveTime ) ) ) {
+		latestReceiveTime = receiveTime;
+	}
+	RemoveExpired();
+
+	return false;
+}
+
+
+
+/**	@brief		Removes all sequences that cannot be matched by any newly arriving sequence anymore
+*	@return 										None
+*	@exception										None
+*	@remarks 										Sequences are kept for twice the time window after the latest receive time to match sequences arriving late from slow sites
+*/
+void Middleware::CSequenceDeduplicator::RemoveExpired(void)
+{
+	if ( latestReceiveTime.is_special() ) {
+		return;
+	}
+
+	auto limit = latestReceiveTime - window - window;
+	while ( !timeIndex.empty() && ( timeIndex.begin()->first < limit ) ) {
+		auto codeIt = codeIndex.find( timeIndex.begin()->second );
+		codeIt->second.erase( timeIndex.begin()->first );
+		if ( codeIt->second.empty() ) {
+			codeIndex.erase( codeIt );
+		}
+		timeIndex.erase( timeIndex.begin() );
+	}
+}
+
+
+
+/**	@brief		Number of sequences currently stored
+*	@return 										Number of sequences in the store
+*	@exception										None
+*	@remarks 										None
+*/
+size_t Middleware::CSequenceDeduplicator::Size(void) const
+{
+	return timeIndex.size();
+}
+
+
+
+/**	@brief		Obtains the time window
+*	@return 										Time window within which sequences with the same code are regarded as duplicates
+*	@exception										None
+*	@remarks 										None
+*/
+boost::posix_time::time_duration Middleware::CSequenceDeduplicator::GetWindow(void) const
+{
+	return window;
+}
@@ -0,0 +1,75 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <vector>
+#include <set>
+#include <map>
+#include <unordered_map>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/functional/hash.hpp>
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef Middleware_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define Middleware_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define Middleware_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define Middleware_API __attribute__ ((visibility ("default")))
+	#else
+		#define Middleware_API
+	#endif		
+#endif
+
+/*@{*/
+/** \ingroup Middleware
+*/
+namespace Middleware {
+	/** \ingroup Middleware
+	*	Class identifying sequences that have already been received within a time window, for example from another detector site.
+	*	The sequences are compared by their code and the reference timestamp set by the detector. The accepted sequences are kept
+	*	in a sliding time-indexed store that is cut back with the local receive time, therefore the memory usage only depends on the event rate
+	*	and a site with a wrong clock cannot remove the sequences of the other sites.
+	*	The class is not thread-safe.
+	*/
+	class CSequenceDeduplicator
+	{
+	public:
+		Middleware_API CSequenceDeduplicator( const boost::posix_time::time_duration& window );
+		Middleware_API bool IsDuplicate( const std::vector<int>& code, const boost::posix_time::ptime& time, const boost::posix_time::ptime& receiveTime );
+		Middleware_API size_t Size(void) const;
+		Middleware_API boost::posix_time::time_duration GetWindow(void) const;
+	private:
+		void RemoveExpired(void);
+
+		boost::posix_time::time_duration window;
+		boost::posix_time::ptime latestReceiveTime;
+		std::multimap< boost::posix_time::ptime, std::vector<int> > timeIndex;
+		std::unordered_map< std::vector<int>, std::set<boost::posix_time::ptime>, boost::hash< std::vector<int> > > codeIndex;
+	};
+}
+/*@}*/
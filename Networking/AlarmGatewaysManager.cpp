@@ -27,6 +27,14 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 	#include "stdafx.h"
 #endif
 #include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <typeinfo>
+#include <chrono>
+#include <boost/core/demangle.hpp>
+#include "GeneralStatusMessage.h"
+#include "BoostStdTimeConverter.h"
+#include "LatencyProbe.h"
 #include "InfoalarmMessageDecorator.h"
 #include "AlarmGatewaysManager.h"
 
@@ -38,11 +46,12 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 *	@remarks										None
 */
 External::CAlarmGatewaysManager::CAlarmGatewaysManager( std::function<void( std::unique_ptr<Utilities::Message::CStatusMessage> )> statusCallback, std::function<void( const std::exception_ptr& )> exceptionCallback )
-	: isLoginDatabaseLoaded( false ),
-	  isAlarmMessagesDatabaseLoaded( false ),
-	  statusCallback( statusCallback ),
-	  exceptionCallback( exceptionCallback )
+	: statusCallback( statusCallback ),
+	  exceptionCallback( exceptionCallback ),
+	  isPrecomputeRequested( false ),
+	  isTerminatePrecompute( false )
 {
+	precomputeThread = std::thread( &CAlarmGatewaysManager::PrecomputeThread, this );
 }
 
 
@@ -51,6 +60,16 @@ External::CAlarmGatewaysManager::CAlarmGatewaysManager( std::function<void( std:
 */
 External::CAlarmGatewaysManager::~CAlarmGatewaysManager(void)
 {
+	{
+		std::lock_guard<std::mutex> lockDatabase( databaseMutex );
+		isTerminatePrecompute = true;
+	}
+	precomputeCondition.notify_all();
+	precomputeThread.join();
+
+	// the last connection managers are released to the retired snapshots and destroyed with them
+	std::atomic_store( &gateways, std::shared_ptr<const GatewaysSnapshot>() );
+	retiredGateways.clear();
 }
 
 
@@ -64,7 +83,7 @@ External::CAlarmGatewaysManager::~CAlarmGatewaysManager(void)
 *	@exception	std::logic_error					Thrown if the given code is not existing in the database
 *	@exception	std::range_error					Thrown if there are no message for the given code (at the given time)
 *	@exception	std::runtime_error					Thrown if the alarm messages or the login database have not been loaded
-*	@remarks										None
+*	@remarks										The method works on the current snapshots of the databases without locking, it may be called concurrently
 */
 void External::CAlarmGatewaysManager::Send(const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const Utilities::CMediaFile& audioFile, const bool& state)
 {
@@ -76,18 +95,21 @@ void External::CAlarmGatewaysManager::Send(const std::vector<int>& code, const U
 	unique_ptr<CGatewayLoginData> loginData;
 	vector< shared_ptr< External::CAlarmMessage > > messageList;
 
-	std::lock_guard<std::mutex> lockDatabase( databaseMutex );
-	if ( !isLoginDatabaseLoaded || !isAlarmMessagesDatabaseLoaded ) {
+	// a concurrent reset of the databases does not affect the snapshots used for this alarm
+	auto currGateways = atomic_load( &gateways );
+	auto currAlarmMessagesDatabase = atomic_load( &alarmMessagesDatabase );
+	if ( !currGateways || !currAlarmMessagesDatabase ) {
 		throw std::runtime_error( "Not all settings required for sending an alarm via a gateway have been set." );
 	}
 
-	messageList = alarmMessagesDatabase.Search( code, alarmTime, isRealAlarm ); // the method can throw exceptions (std::logic_error in case of not existing code), it is guaranteed that all alarm datasets are not empty
+	messageList = currAlarmMessagesDatabase->Search( code, alarmTime, isRealAlarm ); // the method can throw exceptions (std::logic_error in case of not existing code), it is guaranteed that all alarm datasets are not empty
 
 	if ( messageList.empty() ) {
 		throw std::range_error( "There are no messages for this alarm code (at the given time)." );
 	}
 
-	for (auto const& message : messageList) {
+	for ( size_t messageIndex = 0; messageIndex < messageList.size(); messageIndex++ ) {
+		const auto& message = messageList[messageIndex];
 		if ( message->RequiredState() == state ) {
 			auto thisMessage = message->Clone();
 
@@ -96,10 +118,11 @@ void External::CAlarmGatewaysManager::Send(const std::vector<int>& code, const U
 				dynamic_cast<CInfoalarmMessageDecorator&>( *thisMessage ).SetOtherMessages( messageList );
 			}
 
-			loginData = loginDatabase.Search( thisMessage->GetGatewayType() ); // the method can throw exceptions (std::runtime_error if the gateway type has not been loaded in the database)
+			loginData = currGateways->loginDatabase.Search( thisMessage->GetGatewayType() ); // the method can throw exceptions (std::runtime_error if the gateway type has not been loaded in the database)
 
 			// send the message asynchronously
-			connectionManagers.at( thisMessage->GetGatewayType() )->AddMessage( code, alarmTime, isRealAlarm, move( thisMessage ), audioFile );
+			currGateways->connectionManagers.at( thisMessage->GetGatewayType() )->AddMessage( code, alarmTime, isRealAlarm, move( thisMessage ), audioFile, static_cast<unsigned int>( messageIndex ) );
+			Utilities::Latency::CLatencyProbe::Instance().Mark( code, alarmTime, Utilities::Latency::ALARM_ENQUEUED );
 		}
 	}
 }
@@ -110,24 +133,54 @@ void External::CAlarmGatewaysManager::Send(const std::vector<int>& code, const U
 *	@param		newDatabase					New database storing the gateway login informations
 *	@return									None
 *	@exception								None
-*	@remarks								None
+*	@remarks								Alarms being sent concurrently still use the previous connection managers. They are destroyed as soon as these alarms have been passed on,
+*											only then the journals are reopened. Alarms sent within this short period are not journaled.
+*											Only the journaled messages the previous connection managers have not dispatched are resent by the new ones.
+*											If a journal cannot be reopened, the new connection managers are kept and send without persistence.
 */
 void External::CAlarmGatewaysManager::ResetGatewayLoginDatabase(const CGatewayLoginDatabase& newDatabase)
 {
 	using namespace std;
+	using namespace boost::posix_time;
+	using namespace Utilities::Message;
 
 	vector<GatewayDatasetType> requiredGateways;
+	vector< unique_ptr<const GatewaysSnapshot> > previousSnapshots;
+	auto newGateways = make_unique<GatewaysSnapshot>();
 
-	std::lock_guard<std::mutex> lockDatabase( databaseMutex );
-	loginDatabase = newDatabase;	
-	isLoginDatabaseLoaded = true;
-
-	connectionManagers.clear();
+	lock_guard<mutex> lockReset( resetMutex );
+	newGateways->loginDatabase = newDatabase;
 	requiredGateways = newDatabase.GetAllGateways();
 	for ( auto& gateway : requiredGateways ) {
 		auto type = gateway.first;
-		auto login = loginDatabase.Search( type )->Clone();
-		connectionManagers[ type ] = make_unique<CConnectionManager>( move( gateway.second ), move( login ), statusCallback, exceptionCallback );
+		auto login = newGateways->loginDatabase.Search( type )->Clone();
+		newGateways->connectionManagers[ type ] = make_unique<CConnectionManager>( move( gateway.second ), move( login ), statusCallback, exceptionCallback );
+	}
+
+	// the snapshot is handed over to this thread as soon as the last alarm being sent concurrently has released it
+	shared_ptr<const GatewaysSnapshot> snapshot( newGateways.release(), [this]( const GatewaysSnapshot* released ) { ReleaseGateways( released ); } );
+	auto previousGateways = atomic_exchange( &gateways, move( snapshot ) );
+	bool isReplaced = static_cast<bool>( previousGateways );
+
+	// the previous connection managers are destroyed without any lock held, this drains their running sending trials into the journals
+	if ( isReplaced ) {
+		auto previousSnapshot = previousGateways.get();
+		previousGateways.reset();
+		{
+			unique_lock<mutex> lockRetired( retiredGatewaysMutex );
+			retiredGatewaysCondition.wait( lockRetired, [&]() { return any_of( begin( retiredGateways ), end( retiredGateways ), [&]( const auto& retired ) { return retired.get() == previousSnapshot; } ); } );
+			previousSnapshots.swap( retiredGateways );
+		}
+		previousSnapshots.clear();
+	}
+
+	// the messages not dispatched by the previous connection managers are restored from their journals
+	if ( !journalDir.empty() ) {
+		try {
+			OpenJournals( !isReplaced );
+		} catch ( std::exception& e ) {
+			statusCallback( make_unique<CGeneralStatusMessage>( MESSAGE_ERROR, ptime( microsec_clock::universal_time() ), u8"Das Nachrichtenjournal kann nach dem Ändern der Zugangsdaten nicht geöffnet werden: " + string( e.what() ) ) );
+		}
 	}
 }
 
@@ -141,14 +194,14 @@ void External::CAlarmGatewaysManager::ResetGatewayLoginDatabase(const CGatewayLo
 */
 void External::CAlarmGatewaysManager::GetGatewayLoginDatabase(CGatewayLoginDatabase& database)
 {
-	std::lock_guard<std::mutex> lockDatabase( databaseMutex );
+	auto currGateways = std::atomic_load( &gateways );
 
 	// check if a database was loaded
-	if ( !isLoginDatabaseLoaded ) {
+	if ( !currGateways ) {
 		throw std::logic_error( "Login database has not been loaded." );
 	}
 
-	database = loginDatabase;
+	database = currGateways->loginDatabase;
 }
 
 
@@ -157,13 +210,23 @@ void External::CAlarmGatewaysManager::GetGatewayLoginDatabase(CGatewayLoginDatab
 *	@param		newDatabase					New database storing the codes and parameters
 *	@return									None
 *	@exception								None
-*	@remarks								None
+*	@remarks								The alarms of the current month are compiled immediately, those of the next month in the background
 */
 void External::CAlarmGatewaysManager::ResetAlarmMessagesDatabase(const CAlarmMessageDatabase& newDatabase)
 {
-	std::lock_guard<std::mutex> lockDatabase( databaseMutex );
-	alarmMessagesDatabase = newDatabase;	
-	isAlarmMessagesDatabaseLoaded = true;
+	using namespace boost::posix_time;
+	using namespace Utilities::Time;
+
+	// the current month is compiled before publishing the database not to delay the next alarm
+	auto database = std::make_shared<const CAlarmMessageDatabase>( newDatabase );
+	database->InstallValidities( database->CompileValidities( CBoostStdTimeConverter::ConvertToStdTime( microsec_clock::universal_time() ) ) );
+
+	{
+		std::lock_guard<std::mutex> lockDatabase( databaseMutex );
+		std::atomic_store( &alarmMessagesDatabase, database );
+		isPrecomputeRequested = true;
+	}
+	precomputeCondition.notify_all();
 }
 
 
@@ -176,12 +239,179 @@ void External::CAlarmGatewaysManager::ResetAlarmMessagesDatabase(const CAlarmMes
 */
 void External::CAlarmGatewaysManager::GetAlarmMessagesDatabase(CAlarmMessageDatabase& database)
 {
-	std::lock_guard<std::mutex> lockDatabase( databaseMutex );
+	auto currAlarmMessagesDatabase = std::atomic_load( &alarmMessagesDatabase );
 
 	// check if a database was loaded
-	if ( !isAlarmMessagesDatabaseLoaded ) {
+	if ( !currAlarmMessagesDatabase ) {
 		throw std::logic_error( "Alarm messages database has not been loaded." );
 	}
 
-	database = alarmMessagesDatabase;
+	database = *currAlarmMessagesDatabase;
+}
+
+
+
+/** @brief		Enables the persistent journal of the messages of all alarm gateways
+*	@param		journalDir					Directory for the journal files (one file per gateway type). It is created if required.
+*	@return									None
+*	@exception	std::runtime_error			Thrown if the journal files cannot be opened
+*	@remarks								All messages that have not been completed before the last shutdown are resent. This requires the loaded alarm messages database.
+*/
+void External::CAlarmGatewaysManager::SetJournalDirectory( const boost::filesystem::path& journalDir )
+{
+	std::lock_guard<std::mutex> lockReset( resetMutex );
+	boost::filesystem::create_directories( journalDir );
+	CAlarmGatewaysManager::journalDir = journalDir;
+	OpenJournals( true );
+}
+
+
+
+/** @brief		Takes over the connection managers of a snapshot of the gateways which is not used anymore
+*	@param		snapshot					Snapshot released by its last user
+*	@return									None
+*	@exception								None
+*	@remarks								The snapshot is destroyed by CAlarmGatewaysManager::ResetGatewayLoginDatabase, this never blocks the thread having sent the last alarm with it
+*/
+void External::CAlarmGatewaysManager::ReleaseGateways( const GatewaysSnapshot* snapshot )
+{
+	{
+		std::lock_guard<std::mutex> lockRetired( retiredGatewaysMutex );
+		retiredGateways.emplace_back( snapshot );
+	}
+	retiredGatewaysCondition.notify_all();
+}
+
+
+
+/** @brief		Opens the journals of all connection managers and restores their pending messages
+*	@param		isRestoreInFlight			Flag stating if the messages dispatched but not completed are resent as well (after a restart), otherwise they are discarded (after the previous connection managers have finished them)
+*	@return									None
+*	@exception	std::runtime_error			Thrown if the journal files cannot be opened
+*	@remarks								The alarm messages are obtained again from the alarm messages database, a journaled message that is not existing anymore is discarded.
+*											A journal that cannot be opened does not prevent the others from being opened, the first error is thrown afterwards.
+*											The reset mutex must be locked by the caller.
+*/
+void External::CAlarmGatewaysManager::OpenJournals( const bool& isRestoreInFlight )
+{
+	using namespace std;
+	using namespace boost::posix_time;
+	using namespace Infoalarm;
+	using namespace Utilities::Message;
+
+	bool isDefaultDataset;
+	unsigned int numRestored = 0;
+	exception_ptr journalError;
+
+	auto currGateways = atomic_load( &gateways );
+	auto currAlarmMessagesDatabase = atomic_load( &alarmMessagesDatabase );
+	if ( !currGateways ) {
+		return;
+	}
+
+	for ( auto& manager : currGateways->connectionManagers ) {
+		// the file name is derived from the gateway type (only characters valid on all platforms)
+		auto gatewayName = boost::core::demangle( manager.first.name() );
+		replace_if( begin( gatewayName ), end( gatewayName ), []( char c ) { return !isalnum( static_cast<unsigned char>( c ) ); }, '_' );
+
+		map<uint64_t, JournalEntry> pendingEntries;
+		try {
+			pendingEntries = manager.second->OpenJournal( journalDir / ( "journal_" + gatewayName + ".dat" ) );
+		} catch ( ... ) {
+			if ( !journalError ) {
+				journalError = current_exception();
+			}
+			continue;
+		}
+
+		for ( const auto& entry : pendingEntries ) {
+			if ( entry.second.isInFlight && !isRestoreInFlight ) {
+				manager.second->DiscardMessage( entry.first );
+				continue;
+			}
+
+			try {
+				if ( !currAlarmMessagesDatabase ) {
+					throw std::runtime_error( "The alarm messages database has not been loaded." );
+				}
+				auto messageList = currAlarmMessagesDatabase->Search( entry.second.sequence, entry.second.time, isDefaultDataset );
+				auto thisMessage = messageList.at( entry.second.messageIndex )->Clone();
+				if ( thisMessage->GetGatewayType() != manager.first ) {
+					throw std::runtime_error( "The alarm messages database has been changed." );
+				}
+				if ( typeid( *thisMessage ) == typeid( CInfoalarmMessageDecorator ) ) {
+					dynamic_cast<CInfoalarmMessageDecorator&>( *thisMessage ).SetOtherMessages( messageList );
+				}
+				manager.second->RestoreMessage( entry.first, entry.second, move( thisMessage ) );
+				numRestored++;
+			} catch ( std::exception& ) {
+				stringstream codeStream;
+				for ( auto val : entry.second.sequence ) { codeStream << val; };
+				manager.second->DiscardMessage( entry.first );
+				statusCallback( make_unique<CGeneralStatusMessage>( MESSAGE_ERROR, ptime( microsec_clock::universal_time() ), u8"Die ausstehende Alarmierung für Schleife " + codeStream.str() + u8" kann nach dem Neustart nicht wiederhergestellt werden." ) );
+			}
+		}
+	}
+
+	if ( numRestored > 0 ) {
+		statusCallback( make_unique<CGeneralStatusMessage>( MESSAGE_SUCCESS, ptime( microsec_clock::universal_time() ), to_string( numRestored ) + u8" ausstehende Nachrichten wurden aus dem Journal wiederhergestellt." ) );
+	}
+
+	if ( journalError ) {
+		rethrow_exception( journalError );
+	}
+}
+
+
+
+/** @brief		Background thread compiling the alarms of the next month in advance
+*	@return									None
+*	@exception								None
+*	@remarks								The compilation is repeated at the beginning of each month and whenever the alarm messages database has been reset.
+*											It is performed on the immutable snapshot of the database, which can be safely shared with the sending of alarms.
+*/
+void External::CAlarmGatewaysManager::PrecomputeThread()
+{
+	using namespace std;
+	using namespace boost::gregorian;
+	using namespace boost::posix_time;
+	using namespace Utilities::Time;
+
+	bool hasWakeupTime = false;
+	chrono::steady_clock::time_point wakeupTime;
+
+	unique_lock<mutex> lockDatabase( databaseMutex );
+	while ( true ) {
+		auto isWakeup = [this]() { return ( isPrecomputeRequested || isTerminatePrecompute ); };
+		if ( hasWakeupTime ) {
+			precomputeCondition.wait_until( lockDatabase, wakeupTime, isWakeup );
+		} else {
+			precomputeCondition.wait( lockDatabase, isWakeup );
+		}
+		if ( isTerminatePrecompute ) {
+			break;
+		}
+
+		isPrecomputeRequested = false;
+		auto database = atomic_load( &alarmMessagesDatabase );
+		if ( !database ) {
+			hasWakeupTime = false;
+			continue;
+		}
+		lockDatabase.unlock();
+
+		// compile the next month (UTC-time) and wake up again directly after its begin
+		auto currTime = microsec_clock::universal_time();
+		auto nextMonthBegin = ptime( currTime.date().end_of_month() + days( 1 ) );
+		try {
+			database->InstallValidities( database->CompileValidities( CBoostStdTimeConverter::ConvertToStdTime( nextMonthBegin ) ) );
+		} catch ( ... ) {
+			exceptionCallback( current_exception() );
+		}
+		hasWakeupTime = true;
+		wakeupTime = chrono::steady_clock::now() + chrono::milliseconds( ( nextMonthBegin - currTime ).total_milliseconds() ) + chrono::seconds( 1 );
+
+		database.reset();
+		lockDatabase.lock();
+	}
 }
@@ -19,6 +19,10 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <string>
 #include <map>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <boost/filesystem.hpp>
 #include "GatewayLoginDatabase.h"
 #include "AlarmMessagesDatabase.h"
 #include "StatusMessage.h"
@@ -54,6 +58,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 namespace External {
 	/**	\ingroup Networking
 	*	Class implementing the access to the alarm gateways (for example: messenger app gateway, e-mail ...).
+	*	The databases are published as immutable snapshots, so sending alarms is never blocked by resetting the databases.
 	*/
 	class CAlarmGatewaysManager
 	{
@@ -65,15 +70,34 @@ namespace External {
 		NETWORKING_API virtual void GetGatewayLoginDatabase( CGatewayLoginDatabase& database );
 		NETWORKING_API virtual void ResetAlarmMessagesDatabase( const CAlarmMessageDatabase& newDatabase );
 		NETWORKING_API virtual void GetAlarmMessagesDatabase( CAlarmMessageDatabase& database );
+		NETWORKING_API virtual void SetJournalDirectory( const boost::filesystem::path& journalDir );
 	private:
+		/**	\ingroup Networking
+		*	Immutable snapshot of the gateway login database together with the connection managers of the gateways
+		*/
+		struct GatewaysSnapshot {
+			CGatewayLoginDatabase loginDatabase;
+			std::map< std::type_index, std::unique_ptr<CConnectionManager> > connectionManagers;
+		};
+
+		void OpenJournals( const bool& isRestoreInFlight );
+		void ReleaseGateways( const GatewaysSnapshot* snapshot );
+		void PrecomputeThread();
+
 		std::mutex databaseMutex;
-		CGatewayLoginDatabase loginDatabase;
-		CAlarmMessageDatabase alarmMessagesDatabase;
-		std::map< std::type_index, std::unique_ptr<CConnectionManager> > connectionManagers;
-		bool isLoginDatabaseLoaded;
-		bool isAlarmMessagesDatabaseLoaded;
+		std::mutex resetMutex;
+		std::mutex retiredGatewaysMutex;
+		std::condition_variable retiredGatewaysCondition;
+		std::vector< std::unique_ptr<const GatewaysSnapshot> > retiredGateways;
+		std::shared_ptr<const GatewaysSnapshot> gateways;
+		std::shared_ptr<const CAlarmMessageDatabase> alarmMessagesDatabase;
+		boost::filesystem::path journalDir;
 		std::function<void( std::unique_ptr<Utilities::Message::CStatusMessage> )> statusCallback;
 		std::function<void( const std::exception_ptr& )> exceptionCallback;
+		bool isPrecomputeRequested;
+		bool isTerminatePrecompute;
+		std::condition_variable precomputeCondition;
+		std::thread precomputeThread;
 	};
 }
 /*@}*/
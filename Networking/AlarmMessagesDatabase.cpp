@@ -23,6 +23,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 	#endif
 #endif
 
+#include <algorithm>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include "DefaultValidity.h"
@@ -75,11 +76,6 @@ bool External::operator!=(const External::CAlarmMessageDatabase& lhs, const Exte
 }
 
 
-/** \ingroup Networking
-*	Constant for invalid time point
-*/
-const Utilities::CDateTime INVALID_TIMEPOINT = Utilities::CDateTime();
-
 const std::function< Utilities::CDateTime(const boost::posix_time::ptime&) > ToStdTime = &Utilities::Time::CBoostStdTimeConverter::ConvertToStdTime;
 const std::function< boost::posix_time::ptime(const Utilities::CDateTime&) > ToBoostTime = &Utilities::Time::CBoostStdTimeConverter::ConvertToBoostTime;
 
@@ -88,8 +84,6 @@ const std::function< boost::posix_time::ptime(const Utilities::CDateTime&) > ToB
 *	@remarks									None
 */
 External::CAlarmMessageDatabase::CAlarmMessageDatabase(void)
-	: noneDefaultDatasetsValidityBegin( INVALID_TIMEPOINT ),
-	  noneDefaultDatasetsValidityEnd( INVALID_TIMEPOINT )
 {
 }
 
@@ -137,6 +131,11 @@ void External::CAlarmMessageDatabase::CopyFrom( const CAlarmMessageDatabase& src
 
 	alarmsForAll = src.GetAlarmsForAllCodes();
 	alarmsFallback = src.GetFallbackAlarms();
+
+	// the compiled validities are immutable and can therefore be shared with the identical source
+	for ( size_t i = 0; i < compiledMonths.size(); i++ ) {
+		compiledMonths[i] = std::atomic_load( &src.compiledMonths[i] );
+	}
 }
 
 
@@ -214,8 +213,7 @@ void External::CAlarmMessageDatabase::Add(const std::vector<int>& code, const st
 	alarmDatabase[ code ] = currDataset;
 
 	// invalidate the database settings forcing new calculation in case of the next search call of a client
-	noneDefaultDatasetsValidityBegin = INVALID_TIMEPOINT;
-	noneDefaultDatasetsValidityEnd = INVALID_TIMEPOINT;
+	compiledMonths.fill( nullptr );
 }
 
 
@@ -243,8 +241,7 @@ void External::CAlarmMessageDatabase::Add(const std::vector<int>& code, const CA
 	alarmDatabase[ code ] = alarmDataset;
 
 	// invalidate the database settings forcing new calculation in case of the next search call of a client
-	noneDefaultDatasetsValidityBegin = INVALID_TIMEPOINT;
-	noneDefaultDatasetsValidityEnd = INVALID_TIMEPOINT;
+	compiledMonths.fill( nullptr );
 }
 
 
@@ -264,8 +261,7 @@ void External::CAlarmMessageDatabase::ReplaceForAllCodes( const CAlarmValidities
 	alarmsForAll = alarmDataset;
 
 	// invalidate the database settings forcing new calculation in case of the next search call of a client
-	noneDefaultDatasetsValidityBegin = INVALID_TIMEPOINT;
-	noneDefaultDatasetsValidityEnd = INVALID_TIMEPOINT;
+	compiledMonths.fill( nullptr );
 }
 
 
@@ -285,8 +281,7 @@ void External::CAlarmMessageDatabase::ReplaceFallback( const CAlarmValidities& a
 	alarmsFallback = alarmDataset;
 
 	// invalidate the database settings forcing new calculation in case of the next search call of a client
-	noneDefaultDatasetsValidityBegin = INVALID_TIMEPOINT;
-	noneDefaultDatasetsValidityEnd = INVALID_TIMEPOINT;
+	compiledMonths.fill( nullptr );
 }
 
 
@@ -303,8 +298,7 @@ void External::CAlarmMessageDatabase::Remove(const std::vector<int>& code)
 	}
 
 	// invalidate the database settings forcing new calculation in case of the next search call of a client
-	noneDefaultDatasetsValidityBegin = INVALID_TIMEPOINT;
-	noneDefaultDatasetsValidityEnd = INVALID_TIMEPOINT;
+	compiledMonths.fill( nullptr );
 }
 
 
@@ -344,8 +338,7 @@ void External::CAlarmMessageDatabase::Remove(const std::vector<int>& code, const
 	}
 
 	// invalidate the database settings forcing new calculation in case of the next search call of a client
-	noneDefaultDatasetsValidityBegin = INVALID_TIMEPOINT;
-	noneDefaultDatasetsValidityEnd = INVALID_TIMEPOINT;
+	compiledMonths.fill( nullptr );
 }
 
 
@@ -389,56 +382,143 @@ void External::CAlarmMessageDatabase::GetAlarmsFromValidities(const External::CA
 }
 
 
-/**	@brief		Recalculates the information on the alarm datasets in dependency of time
-*	@param		newGoalTime						The recalculation will be performed for the whole month of 'goalTime' (UTC-time)
-*	@return										None
+/**	@brief		Compiles the alarms of the complete database for one month
+*	@param		goalTime						The compilation will be performed for the whole month of 'goalTime' (UTC-time)
+*	@return										Compiled alarms for the month. They can be installed in this or an identical database by CAlarmMessageDatabase::InstallValidities.
 *	@exception									None
-*	@remarks									Call this function after any change of the database or if the stored information got invalid
+*	@remarks									The database is not changed, so the method can run on a worker thread as long as the database is not modified meanwhile
 */
-void External::CAlarmMessageDatabase::RecalculateValidityTimes(const Utilities::CDateTime& newGoalTime) const
+std::shared_ptr<const External::CAlarmMessageDatabase::CompiledValidities> External::CAlarmMessageDatabase::CompileValidities(const Utilities::CDateTime& goalTime) const
 {
 	using namespace std;
 	using namespace boost::gregorian;
 	using namespace boost::posix_time;
 	using namespace Utilities;
 
-	vector<int> code;
 	vector< shared_ptr<CAlarmMessage> > currDefaultAlarmDataset;
 	vector<Types::AlarmExceptionPeriodType> currNoneDefaultDatasets;
-	ptime goalTime;
-
-	// delete the old databases
-	defaultDatasets.clear();
-	defaultDatasetsForAll.clear();
-	defaultDatasetsFallback.clear();
-	noneDefaultDatasets.clear();
-	noneDefaultDatasetsForAll.clear();
-	noneDefaultDatasetsFallback.clear();
+	ptime boostGoalTime;
+	auto compiled = make_shared<CompiledValidities>();
 
 	// determine the required time period (always one month)
-	goalTime = ToBoostTime( newGoalTime );
-	noneDefaultDatasetsValidityBegin = ToStdTime( ptime( goalTime.date().end_of_month() + days(1) - months(1) ) );	// UTC-time
-	noneDefaultDatasetsValidityEnd = ToStdTime( ptime( goalTime.date().end_of_month() + days(1) ) );				// UTC-time
+	boostGoalTime = ToBoostTime( goalTime );
+	compiled->validityBegin = ToTimestamp( ToStdTime( ptime( boostGoalTime.date().end_of_month() + days(1) - months(1) ) ) );	// UTC-time
+	compiled->validityEnd = ToTimestamp( ToStdTime( ptime( boostGoalTime.date().end_of_month() + days(1) ) ) );				// UTC-time
 
 	// for specific codes
+	compiled->codeAlarms.reserve( alarmDatabase.size() );
 	for ( auto const& item : alarmDatabase ) {
-		code = item.first;		
-		auto currDataset = item.second;
-
-		currDefaultAlarmDataset.clear();
-		currNoneDefaultDatasets.clear();
-		GetAlarmsFromValidities( currDataset, newGoalTime, currDefaultAlarmDataset, currNoneDefaultDatasets );
-		defaultDatasets.insert( make_pair( code, currDefaultAlarmDataset ) );
-		for ( auto const& currNoneDefaultDataset : currNoneDefaultDatasets ) {
-			noneDefaultDatasets.insert( make_pair( code, currNoneDefaultDataset ) );
-		}
+		GetAlarmsFromValidities( item.second, goalTime, currDefaultAlarmDataset, currNoneDefaultDatasets );
+		compiled->codeAlarms[item.first] = CompileAlarms( currDefaultAlarmDataset, currNoneDefaultDatasets );
 	}
 
 	// for all codes
-	GetAlarmsFromValidities( alarmsForAll, newGoalTime, defaultDatasetsForAll, noneDefaultDatasetsForAll );
+	GetAlarmsFromValidities( alarmsForAll, goalTime, currDefaultAlarmDataset, currNoneDefaultDatasets );
+	compiled->alarmsForAll = CompileAlarms( currDefaultAlarmDataset, currNoneDefaultDatasets );
 
 	// as fallback if no code is matched
-	GetAlarmsFromValidities( alarmsFallback, newGoalTime, defaultDatasetsFallback, noneDefaultDatasetsFallback );
+	GetAlarmsFromValidities( alarmsFallback, goalTime, currDefaultAlarmDataset, currNoneDefaultDatasets );
+	compiled->alarmsFallback = CompileAlarms( currDefaultAlarmDataset, currNoneDefaultDatasets );
+
+	return compiled;
+}
+
+
+/**	@brief		Installs precompiled alarms for a month, they are used by all following searches within that month
+*	@param		compiledValidities				Compiled alarms obtained from CAlarmMessageDatabase::CompileValidities of this or an identical database
+*	@return										None
+*	@exception	std::invalid_argument			Thrown if the compiled alarms are empty
+*	@remarks									The alarms are swapped in atomically, so the method can be called concurrently to CAlarmMessageDatabase::Search. The two most recently installed months are kept.
+*												The compiled alarms are only a cache of the database, so this method is const.
+*/
+void External::CAlarmMessageDatabase::InstallValidities(const std::shared_ptr<const CompiledValidities>& compiledValidities) const
+{
+	using namespace std;
+
+	if ( !compiledValidities ) {
+		throw std::invalid_argument( "The compiled validities are empty." );
+	}
+
+	auto firstMonth = atomic_load( &compiledMonths[0] );
+	auto secondMonth = atomic_load( &compiledMonths[1] );
+
+	size_t slot;
+	if ( !firstMonth || ( firstMonth->validityBegin == compiledValidities->validityBegin ) ) {
+		slot = 0;
+	} else if ( !secondMonth || ( secondMonth->validityBegin == compiledValidities->validityBegin ) ) {
+		slot = 1;
+	} else if ( firstMonth->validityBegin < secondMonth->validityBegin ) {
+		slot = 0;
+	} else {
+		slot = 1;
+	}
+
+	atomic_store( &compiledMonths[slot], compiledValidities );
+}
+
+
+/**	@brief		Compiles the alarms of a code for fast searching
+*	@param		currDefaultDataset				Default alarms
+*	@param		currNoneDefaultDatasets			Exception alarms, the periods may overlap
+*	@return										Compiled alarms. Within each segment, the exception alarms keep the order of the exception periods.
+*	@exception									None
+*	@remarks									All time conversions are performed here, so that the search does not need to convert any times
+*/
+External::CAlarmMessageDatabase::CompiledAlarms External::CAlarmMessageDatabase::CompileAlarms( const std::vector< std::shared_ptr<CAlarmMessage> >& currDefaultDataset, const std::vector<Types::AlarmExceptionPeriodType>& currNoneDefaultDatasets )
+{
+	using namespace std;
+
+	CompiledAlarms compiled;
+	vector< tuple< int64_t, int64_t, const vector< shared_ptr<CAlarmMessage> >* > > exceptionPeriods;
+
+	compiled.defaultAlarms = currDefaultDataset;
+
+	// convert the exception periods, empty periods never contain any time
+	for ( const auto& exception : currNoneDefaultDatasets ) {
+		auto periodBegin = ToTimestamp( get<0>( exception ) );
+		auto periodEnd = ToTimestamp( get<1>( exception ) );
+		if ( periodBegin < periodEnd ) {
+			exceptionPeriods.push_back( make_tuple( periodBegin, periodEnd, &get<2>( exception ) ) );
+			compiled.segmentBoundaries.push_back( periodBegin );
+			compiled.segmentBoundaries.push_back( periodEnd );
+		}
+	}
+
+	sort( begin( compiled.segmentBoundaries ), end( compiled.segmentBoundaries ) );
+	compiled.segmentBoundaries.erase( unique( begin( compiled.segmentBoundaries ), end( compiled.segmentBoundaries ) ), end( compiled.segmentBoundaries ) );
+
+	// collect the alarms of all exception periods covering a segment
+	if ( !compiled.segmentBoundaries.empty() ) {
+		compiled.segments.resize( compiled.segmentBoundaries.size() - 1 );
+	}
+	for ( size_t i = 0; i < compiled.segments.size(); i++ ) {
+		auto& segment = compiled.segments[i];
+		segment.isException = false;
+		for ( const auto& period : exceptionPeriods ) {
+			if ( ( get<0>( period ) <= compiled.segmentBoundaries[i] ) && ( compiled.segmentBoundaries[i] < get<1>( period ) ) ) {
+				segment.alarms.insert( end( segment.alarms ), begin( *get<2>( period ) ), end( *get<2>( period ) ) );
+				segment.isException = true;
+			}
+		}
+	}
+
+	return compiled;
+}
+
+
+/**	@brief		Converts a time into a timestamp used in the compiled alarms
+*	@param		time							UTC-time
+*	@return										Microseconds since 1970-01-01 00:00 UTC
+*	@exception									None
+*	@remarks									None
+*/
+std::int64_t External::CAlarmMessageDatabase::ToTimestamp( const Utilities::CDateTime& time )
+{
+	using namespace boost::posix_time;
+
+	static const ptime epoch( boost::gregorian::date( 1970, 1, 1 ) );
+
+	return ( ToBoostTime( time ) - epoch ).total_microseconds();
 }
 
 
@@ -459,37 +539,32 @@ std::vector< std::shared_ptr< External::CAlarmMessage > > External::CAlarmMessag
 
 /**	@brief		Obtains the valid alarms for a certain UTC time
 *	@param		currAlarmDataset				Containing all alarms valid for the specified time, the found valid alarms will be added to that container
-*	@param		currAlarmTime					UTC time of the alarm - required for determining the correct alarm dataset
-*	@param		currDefaultDatasets				Default alarms
-*	@param		currNoneDefaultDatasets			Exception alarms
+*	@param		alarmTimestamp					UTC timestamp of the alarm (see CAlarmMessageDatabase::ToTimestamp) - required for determining the correct alarm dataset
+*	@param		compiledAlarms					Compiled default and exception alarms
 *	@return										True if the default alarm is valid (or no alarm at all), false if an exception alarm is valid
 *	@exception									None
-*	@remarks									None
+*	@remarks									The search is a binary search over the segment boundaries
 */
-bool External::CAlarmMessageDatabase::GetValidAlarmsForTime( std::vector< std::shared_ptr<CAlarmMessage> >& currAlarmDataset, const Utilities::CDateTime& currAlarmTime, const std::vector< std::shared_ptr<CAlarmMessage> >& currDefaultDatasets, const std::vector<Types::AlarmExceptionPeriodType>& currNoneDefaultDatasets )
+bool External::CAlarmMessageDatabase::GetValidAlarmsForTime( std::vector< std::shared_ptr<CAlarmMessage> >& currAlarmDataset, const std::int64_t& alarmTimestamp, const CompiledAlarms& compiledAlarms )
 {
 	using namespace std;
-	using namespace boost::posix_time;
-
-	ptime alarmTime;
-	bool noExceptions = true;
 
-	alarmTime = ToBoostTime( currAlarmTime );
+	const auto& boundaries = compiledAlarms.segmentBoundaries;
 
 	// set exception datasets if the UTC-alarm time is within any exception time period
-	for ( auto exception : currNoneDefaultDatasets ) {
-		if ( time_period( ToBoostTime( get<0>( exception ) ), ToBoostTime( get<1>( exception ) ) ).contains( alarmTime ) ) { // searching for UTC-times
-			currAlarmDataset.insert( end( currAlarmDataset ), begin( get<2>( exception ) ), end( get<2>( exception ) ) );
-			noExceptions = false;
+	auto boundaryIt = upper_bound( begin( boundaries ), end( boundaries ), alarmTimestamp );
+	if ( ( boundaryIt != begin( boundaries ) ) && ( boundaryIt != end( boundaries ) ) ) {
+		const auto& segment = compiledAlarms.segments[ distance( begin( boundaries ), boundaryIt ) - 1 ];
+		if ( segment.isException ) {
+			currAlarmDataset.insert( end( currAlarmDataset ), begin( segment.alarms ), end( segment.alarms ) );
+			return false;
 		}
 	}
 
 	// set the default dataset if no exceptions have been found
-	if ( noExceptions ) {
-		currAlarmDataset.insert( end( currAlarmDataset ), begin( currDefaultDatasets ), end( currDefaultDatasets ) );
-	}
+	currAlarmDataset.insert( end( currAlarmDataset ), begin( compiledAlarms.defaultAlarms ), end( compiledAlarms.defaultAlarms ) );
 
-	return noExceptions;
+	return true;
 }
 
 
@@ -507,32 +582,37 @@ std::vector< std::shared_ptr<External::CAlarmMessage> > External::CAlarmMessageD
 	using namespace boost::posix_time;
 	using namespace Utilities;
 
-	ptime alarmTime;
 	bool noExceptionsForCode, noExceptionsAsFallback;
-	vector< shared_ptr<CAlarmMessage> > currAlarmDataset, currDefaultDatasetForCode;
-	vector<Types::AlarmExceptionPeriodType> currNoneDefaultDatasetForCode;
+	vector< shared_ptr<CAlarmMessage> > currAlarmDataset;
+	shared_ptr<const CompiledValidities> compiled;
+
+	// use the compiled alarms valid for the alarm time
+	auto alarmTimestamp = ToTimestamp( currAlarmTime );
+	for ( const auto& compiledMonth : compiledMonths ) {
+		auto currCompiled = atomic_load( &compiledMonth );
+		if ( currCompiled && ( alarmTimestamp >= currCompiled->validityBegin ) && ( alarmTimestamp < currCompiled->validityEnd ) ) {
+			compiled = currCompiled;
+			break;
+		}
+	}
 
-	// check if the current exception time periods are valid - recalculate for the current month otherwise
-	alarmTime = ToBoostTime( currAlarmTime );
-	if ( !time_period( ToBoostTime( noneDefaultDatasetsValidityBegin ), ToBoostTime( noneDefaultDatasetsValidityEnd ) ).contains( alarmTime ) ) {
-		RecalculateValidityTimes( currAlarmTime );
+	// compile the month of the alarm if it has not been precompiled (i.e. CAlarmMessageDatabase::InstallValidities has not been used in advance)
+	if ( !compiled ) {
+		compiled = CompileValidities( currAlarmTime );
+		InstallValidities( compiled );
 	}
 
 	// specific for the FME-code
-	auto exceptionDatasetIt = noneDefaultDatasets.equal_range( code );
-	currNoneDefaultDatasetForCode.resize( noneDefaultDatasets.count( code ) );
-	transform( exceptionDatasetIt.first, exceptionDatasetIt.second, begin( currNoneDefaultDatasetForCode ), []( auto const& data ) { return data.second; } );
-	
-	auto defaultAlarmDatasetIt = defaultDatasets.find( code );
-	if ( defaultAlarmDatasetIt != end( defaultDatasets ) ) {
-		currDefaultDatasetForCode = defaultAlarmDatasetIt->second;
+	auto compiledAlarmsIt = compiled->codeAlarms.find( code );
+	if ( compiledAlarmsIt != end( compiled->codeAlarms ) ) {
+		noExceptionsForCode = GetValidAlarmsForTime( currAlarmDataset, alarmTimestamp, compiledAlarmsIt->second );
+	} else {
+		noExceptionsForCode = true;
 	}
 
-	noExceptionsForCode = GetValidAlarmsForTime( currAlarmDataset, currAlarmTime, currDefaultDatasetForCode, currNoneDefaultDatasetForCode );
-
 	if ( currAlarmDataset.empty() ) {
 		// as a fallback if no alarm has been specified for the code
-		noExceptionsAsFallback = GetValidAlarmsForTime( currAlarmDataset, currAlarmTime, defaultDatasetsFallback, noneDefaultDatasetsFallback );
+		noExceptionsAsFallback = GetValidAlarmsForTime( currAlarmDataset, alarmTimestamp, compiled->alarmsFallback );
 	} else {
 		noExceptionsAsFallback = true;
 	}
@@ -541,7 +621,7 @@ std::vector< std::shared_ptr<External::CAlarmMessage> > External::CAlarmMessageD
 	isDefaultDataset = noExceptionsForCode && noExceptionsAsFallback;
 
 	// for all alarms
-	GetValidAlarmsForTime( currAlarmDataset, currAlarmTime, defaultDatasetsForAll, noneDefaultDatasetsForAll );
+	GetValidAlarmsForTime( currAlarmDataset, alarmTimestamp, compiled->alarmsForAll );
 
 	if ( currAlarmDataset.empty() ) {
 		throw std::logic_error( "No alarm message valid for this code during the alarm time." );
@@ -624,16 +704,7 @@ void External::CAlarmMessageDatabase::Clear(void)
 	alarmsForAll.Clear();
 	alarmsFallback.Clear();
 
-	defaultDatasets.clear();
-	defaultDatasetsForAll.clear();
-	defaultDatasetsFallback.clear();
-
-	noneDefaultDatasets.clear();
-	noneDefaultDatasetsForAll.clear();
-	noneDefaultDatasetsFallback.clear();
-
-	noneDefaultDatasetsValidityBegin = INVALID_TIMEPOINT;
-	noneDefaultDatasetsValidityEnd = INVALID_TIMEPOINT;
+	compiledMonths.fill( nullptr );
 }
 
 
@@ -17,9 +17,13 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #pragma once
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <memory>
+#include <array>
 #include <tuple>
+#include <cstdint>
+#include <boost/functional/hash.hpp>
 #include "DateTime.h"
 #include "AlarmValidities.h"
 
@@ -67,11 +71,13 @@ namespace External {
 
 	/**	\ingroup Networking
 	*	Class implementing a database connecting alarm codes with the stored alarm messages (for different gateways) considering the alarm timepoint. Any entry has at least a default dataset. 
-	*	This class is not thread-safe.
+	*	This class is not thread-safe, except that all const methods may be called concurrently. The compiled alarms are only a cache, so an immutable database can be shared between threads.
 	*/
 	class CAlarmMessageDatabase
 	{
 	public:
+		struct CompiledValidities;
+
 		NETWORKING_API CAlarmMessageDatabase();
 		NETWORKING_API CAlarmMessageDatabase( const CAlarmMessageDatabase& );
 		NETWORKING_API CAlarmMessageDatabase& operator=( const CAlarmMessageDatabase& );
@@ -90,28 +96,54 @@ namespace External {
 		NETWORKING_API std::vector< std::vector<int> > GetAllCodes() const;
 		NETWORKING_API std::vector< std::shared_ptr<CAlarmMessage> > Search(const std::vector<int>& code, const Utilities::CDateTime& currAlarmTime) const;
 		NETWORKING_API std::vector< std::shared_ptr<CAlarmMessage> > Search(const std::vector<int>& code, const Utilities::CDateTime& currAlarmTime, bool& isDefaultDataset) const;
+		NETWORKING_API std::shared_ptr<const CompiledValidities> CompileValidities(const Utilities::CDateTime& goalTime) const;
+		NETWORKING_API void InstallValidities(const std::shared_ptr<const CompiledValidities>& compiledValidities) const;
 		NETWORKING_API void Clear(void);
 		NETWORKING_API int Size(void) const;
 		NETWORKING_API friend bool operator==(const CAlarmMessageDatabase& lhs, const CAlarmMessageDatabase& rhs);
 		NETWORKING_API friend bool operator!=(const CAlarmMessageDatabase& lhs, const CAlarmMessageDatabase& rhs);
 	protected:
-		void RecalculateValidityTimes(const Utilities::CDateTime& newGoalTime) const;
+		/** \ingroup Networking
+		*	Time segment between two neighbouring boundaries of the exception periods of a code
+		*/
+		struct CompiledSegment {
+			bool isException;
+			std::vector< std::shared_ptr<CAlarmMessage> > alarms;
+		};
+
+		/** \ingroup Networking
+		*	Alarms of a code compiled for the current month. The exception periods are split at all their boundaries into disjoint segments, so that a search requires only a binary search.
+		*/
+		struct CompiledAlarms {
+			std::vector< std::shared_ptr<CAlarmMessage> > defaultAlarms;
+			std::vector<std::int64_t> segmentBoundaries;	// UTC-timestamps in microseconds, sorted in ascending order
+			std::vector<CompiledSegment> segments;			// segment i is valid in [segmentBoundaries[i], segmentBoundaries[i + 1])
+		};
+
+		using CompiledAlarmsMap = std::unordered_map< std::vector<int>, CompiledAlarms, boost::hash< std::vector<int> > >;
+
 		void CopyFrom( const CAlarmMessageDatabase& src );		
 		static void GetMessageTypesInValidities(const External::CAlarmValidities& validities, std::map<std::type_index, unsigned int>& messageTypes);
 		static void GetAlarmsFromValidities(const External::CAlarmValidities& alarmValidities, const Utilities::CDateTime& newGoalTime, std::vector< std::shared_ptr<CAlarmMessage> >& currDefaultDataset, std::vector<Types::AlarmExceptionPeriodType>& currNoneDefaultDataset );
-		static bool GetValidAlarmsForTime( std::vector< std::shared_ptr<CAlarmMessage> >& currAlarmDataset, const Utilities::CDateTime& currAlarmTime, const std::vector< std::shared_ptr<CAlarmMessage> >& currDefaultDatasets, const std::vector<Types::AlarmExceptionPeriodType>& currNoneDefaultDatasets );
+		static CompiledAlarms CompileAlarms( const std::vector< std::shared_ptr<CAlarmMessage> >& currDefaultDataset, const std::vector<Types::AlarmExceptionPeriodType>& currNoneDefaultDatasets );
+		static bool GetValidAlarmsForTime( std::vector< std::shared_ptr<CAlarmMessage> >& currAlarmDataset, const std::int64_t& alarmTimestamp, const CompiledAlarms& compiledAlarms );
+		static std::int64_t ToTimestamp( const Utilities::CDateTime& time );
 	private:
 		Types::AlarmDatabaseType alarmDatabase;
 		CAlarmValidities alarmsForAll;
 		CAlarmValidities alarmsFallback;
-		mutable std::map< std::vector<int>, std::vector< std::shared_ptr<CAlarmMessage> > > defaultDatasets;
-		mutable std::multimap< std::vector<int>, Types::AlarmExceptionPeriodType > noneDefaultDatasets;
-		mutable std::vector< std::shared_ptr<CAlarmMessage> > defaultDatasetsForAll;
-		mutable std::vector< std::shared_ptr<CAlarmMessage> > defaultDatasetsFallback;
-		mutable std::vector<Types::AlarmExceptionPeriodType> noneDefaultDatasetsForAll;
-		mutable std::vector<Types::AlarmExceptionPeriodType> noneDefaultDatasetsFallback;
-		mutable Utilities::CDateTime noneDefaultDatasetsValidityBegin;
-		mutable Utilities::CDateTime noneDefaultDatasetsValidityEnd;
+		mutable std::array< std::shared_ptr<const CompiledValidities>, 2 > compiledMonths;	// the two most recently compiled months, they are accessed atomically
+	};
+
+	/**	\ingroup Networking
+	*	Alarms of the complete database compiled for one month (UTC). The object is immutable once it has been created.
+	*/
+	struct CAlarmMessageDatabase::CompiledValidities {
+		std::int64_t validityBegin;		// UTC-timestamp in microseconds
+		std::int64_t validityEnd;		// UTC-timestamp in microseconds (excluded)
+		CompiledAlarmsMap codeAlarms;
+		CompiledAlarms alarmsForAll;
+		CompiledAlarms alarmsFallback;
 	};
 
 	NETWORKING_API bool operator==(const CAlarmMessageDatabase& lhs, const CAlarmMessageDatabase& rhs);
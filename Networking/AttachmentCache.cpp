@@ -0,0 +1,71 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define NETWORKING_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define NETWORKING_API __declspec(dllexport)
+	#endif
+#endif
+
+#if defined _WIN32
+	#include "stdafx.h"
+#endif
+#include <fstream>
+#include <iterator>
+#include <Poco/Exception.h>
+#include "AttachmentCache.h"
+
+
+/**	@brief		Constructor
+*	@param		timeToLive				Time after which a cached file content expires. The attachments of an alarm are only required until all its e-mails have been sent.
+*	@remarks							None
+*/
+External::Email::CAttachmentCache::CAttachmentCache( const std::chrono::steady_clock::duration& timeToLive )
+	: cache( timeToLive )
+{
+}
+
+
+
+/**	@brief		Reads an audio file to be attached to the alarm e-mails
+*	@param		filePath				Path of the audio file
+*	@return								Binary content of the file
+*	@exception	Poco::OpenFileException	Thrown if the file could not be opened
+*	@exception	boost::filesystem::filesystem_error		Thrown if the file is not existing
+*	@remarks							The file is read from the disk only once for all e-mails of an alarm. A file with a changed modification time or size is read again.
+*/
+std::shared_ptr<const std::string> External::Email::CAttachmentCache::Read( const boost::filesystem::path& filePath )
+{
+	using namespace std;
+
+	shared_ptr<const string> attachmentData;
+	auto key = make_tuple( filePath.string(), boost::filesystem::last_write_time( filePath ), boost::filesystem::file_size( filePath ) );
+	if ( cache.Get( key, attachmentData ) ) {
+		return attachmentData;
+	}
+
+	ifstream file( filePath.string(), ios::binary );
+	if ( !file ) {
+		throw Poco::OpenFileException( filePath.string() );
+	}
+	attachmentData = make_shared<const string>( istreambuf_iterator<char>( file ), istreambuf_iterator<char>() );
+	cache.Put( key, attachmentData );
+
+	return attachmentData;
+}
@@ -0,0 +1,76 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <string>
+#include <tuple>
+#include <ctime>
+#include <cstdint>
+#include <chrono>
+#include <boost/filesystem.hpp>
+#include "LookupCache.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef NETWORKING_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define NETWORKING_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define NETWORKING_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define NETWORKING_API __attribute__ ((visibility ("default")))
+	#else
+		#define NETWORKING_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	namespace Email {
+		/**	\ingroup Networking
+		*	Class implementing a cache for the content of the audio files attached to the alarm e-mails.
+		*	The entries are identified by the path, modification time and size of the file, so a modified file is read again.
+		*/
+		class CAttachmentCache
+		{
+		public:
+			NETWORKING_API CAttachmentCache( const std::chrono::steady_clock::duration& timeToLive );
+			NETWORKING_API virtual ~CAttachmentCache() {};
+			NETWORKING_API std::shared_ptr<const std::string> Read( const boost::filesystem::path& filePath );
+		private:
+			using AttachmentKey = std::tuple<std::string, std::time_t, std::uintmax_t>;
+
+			CAttachmentCache( const CAttachmentCache& ) = delete;
+			CAttachmentCache& operator=( const CAttachmentCache& ) = delete;
+
+			CLookupCache<AttachmentKey, std::shared_ptr<const std::string>> cache;
+		};
+	}
+}
+/*@}*/
@@ -23,7 +23,11 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 	#endif
 #endif
 
+#include <typeinfo>
+#include <algorithm>
 #include <boost/date_time/posix_time/ptime.hpp>
+#include <boost/core/demangle.hpp>
+#include "GeneralStatusMessage.h"
 #include "ConnectionManager.h"
 
 
@@ -51,6 +55,13 @@ External::CConnectionManager::CConnectionManager( std::unique_ptr<CAlarmGateway>
 
 	CConnectionManager::login->GetConnectionTrialInfos( numTrials, timeDistTrial, maxNumConnections );
 
+	// register the metrics of the gateway
+	Utilities::Metrics::MetricLabels labels = { { "gateway", boost::core::demangle( typeid( *gateway ).name() ) } };
+	queueLengthMetric = Utilities::Metrics::CMetricsRegistry::Instance().GetGauge( "personalfme_gateway_queue_length", "Number of messages waiting for sending via an alarm gateway", labels );
+	successMetric = Utilities::Metrics::CMetricsRegistry::Instance().GetCounter( "personalfme_gateway_sent_total", "Number of messages successfully sent via an alarm gateway", labels );
+	retryMetric = Utilities::Metrics::CMetricsRegistry::Instance().GetCounter( "personalfme_gateway_retries_total", "Number of repeated sending trials after a non-fatal failure of an alarm gateway", labels );
+	failureMetric = Utilities::Metrics::CMetricsRegistry::Instance().GetCounter( "personalfme_gateway_failed_total", "Number of messages finally failed to be sent via an alarm gateway", labels );
+
 	// construct the connections
 	for ( size_t ID = 0; ID < maxNumConnections; ID++ ) {
 		availableConnections.push_back( std::make_unique< CConnectionThread >( gateway->Clone(), std::bind( &CConnectionManager::OnConnectionFinished, this ), exceptionCallback ) );
@@ -61,18 +72,33 @@ External::CConnectionManager::CConnectionManager( std::unique_ptr<CAlarmGateway>
 
 
 /**	@brief		Destructor
-*	@remarks 										None
+*	@remarks 										Waits until the currently running sending trials have been finished. Their results are journaled, otherwise already delivered messages would be sent again after a restart.
 */
 External::CConnectionManager::~CConnectionManager()
 {
+	using namespace std;
+
+	float timeDistTrialsFloat;
+	unsigned int maxNumTrials, maxNumConnections;
+
 	{
-		std::lock_guard<std::mutex> lock( managerThreadMutex );
+		lock_guard<mutex> lock( managerThreadMutex );
 		isTerminateThread = true;
 		isResumeThread = true;
 	}
 	managerThreadWaitCondition.notify_all();
 
 	managerThread.join();
+
+	// drain the connections still sending (no new messages are dispatched after the manager thread has stopped)
+	try {
+		login->GetConnectionTrialInfos( maxNumTrials, timeDistTrialsFloat, maxNumConnections );
+		unique_lock<mutex> lock( managerThreadMutex );
+		managerThreadWaitCondition.wait( lock, [this]() { return IsAllConnectionsFinished(); } );
+		RegainFinishedConnections( maxNumTrials, chrono::milliseconds( static_cast<long long>( timeDistTrialsFloat * 1000 ) ) );
+	} catch ( ... ) {
+		exceptionCallback( current_exception() );
+	}
 }
 
 
@@ -82,11 +108,12 @@ External::CConnectionManager::~CConnectionManager()
 *	@param		isRealAlarm							Flag stating if this is a real (default) or test alarm
 *	@param		alarmMessageDataset					Alarm message dataset. The caller must ensure that it is of the correct type for the present gateway.
 *	@param		audioFile							Audio file of the alarm message
+*	@param		messageIndex						Index of the alarm message within the result of CAlarmMessageDatabase::Search for the code. It is only required for restoring the message from the journal after a restart.
 *	@return 										None
 *	@exception 	std::runtime_error					Thrown if either "time" or "alarmMessageDataset" is empty
 *	@remarks 										The message will be automatically deleted. It will be finished when either the sending was successful or if it has been finally aborted.
 */
-void External::CConnectionManager::AddMessage( const std::vector<int>& newSequence, const Utilities::CDateTime & time, const bool & isRealAlarm, std::unique_ptr<CAlarmMessage> alarmMessageDataset, const Utilities::CMediaFile& audioFile )
+void External::CConnectionManager::AddMessage( const std::vector<int>& newSequence, const Utilities::CDateTime & time, const bool & isRealAlarm, std::unique_ptr<CAlarmMessage> alarmMessageDataset, const Utilities::CMediaFile& audioFile, const unsigned int& messageIndex )
 {
 	using namespace std;
 
@@ -102,16 +129,106 @@ void External::CConnectionManager::AddMessage( const std::vector<int>& newSequen
 	newMessage->message = move( alarmMessageDataset );
 	newMessage->login = login->Clone();
 	newMessage->audioFile = audioFile;
+	newMessage->journalID = 0;
+
+	{
+		lock_guard<mutex> lock( managerThreadMutex );
+		if ( journal ) {
+			newMessage->journalID = journal->AddEnqueued( JournalEntry{ newSequence, time, isRealAlarm, messageIndex, audioFile, 0, false } );
+		}
+		messageQueue.Push( move( newMessage ), 0, chrono::steady_clock::now() );
+		queueLengthMetric->Set( static_cast<std::int64_t>( messageQueue.Size() ) );
+		isResumeThread = true;
+	}
+	managerThreadWaitCondition.notify_all();
+}
+
+
+/**	@brief		Opens the journal of the connection manager, all messages added afterwards will be persistently journaled
+*	@param		journalFile							Journal file. If it is already existing, it is replayed.
+*	@return 										Messages from the journal that were not completed before the last shutdown. They need to be restored by CConnectionManager::RestoreMessage or discarded by CConnectionManager::DiscardMessage.
+*	@exception 	std::runtime_error					Thrown if the journal file cannot be opened
+*	@remarks 										A previously opened journal is closed
+*/
+std::map<std::uint64_t, External::JournalEntry> External::CConnectionManager::OpenJournal( const boost::filesystem::path& journalFile )
+{
+	std::lock_guard<std::mutex> lock( managerThreadMutex );
+	journal.reset();
+	journal = std::make_unique<CMessageJournal>( journalFile, std::bind( &CConnectionManager::OnJournalError, this, std::placeholders::_1 ) );
+
+	return journal->GetPendingEntries();
+}
+
+
+
+/**	@brief		Restores a message from the journal into the queue of the connection manager
+*	@param		journalID							Journal ID of the message
+*	@param		entry								Journaled data of the message
+*	@param		alarmMessageDataset					Alarm message dataset corresponding to the journaled data. The caller must ensure that it is of the correct type for the present gateway.
+*	@return 										None
+*	@exception 	std::runtime_error					Thrown if either the time of the entry or "alarmMessageDataset" is empty
+*	@remarks 										The number of already performed sending trials is preserved
+*/
+void External::CConnectionManager::RestoreMessage( const std::uint64_t& journalID, const JournalEntry& entry, std::unique_ptr<CAlarmMessage> alarmMessageDataset )
+{
+	using namespace std;
+
+	if ( ( !entry.time.IsValid() ) || ( alarmMessageDataset == nullptr ) ) {
+		throw std::runtime_error( "Input parameters time or alarmMessageDataset are empty." );
+	}
+
+	unique_ptr<Message> newMessage{ new Message };
+
+	newMessage->sequence = entry.sequence;
+	newMessage->time = entry.time;
+	newMessage->isRealAlarm = entry.isRealAlarm;
+	newMessage->message = move( alarmMessageDataset );
+	newMessage->login = login->Clone();
+	newMessage->audioFile = entry.audioFile;
+	newMessage->journalID = journalID;
 
 	{
 		lock_guard<mutex> lock( managerThreadMutex );
-		messageQueue[chrono::steady_clock::now()] = make_pair( move( newMessage ), 0 );
+		messageQueue.Push( move( newMessage ), entry.numTrials, chrono::steady_clock::now() );
+		queueLengthMetric->Set( static_cast<std::int64_t>( messageQueue.Size() ) );
 		isResumeThread = true;
 	}
 	managerThreadWaitCondition.notify_all();
 }
 
 
+
+/**	@brief		Discards a message from the journal that cannot be restored
+*	@param		journalID							Journal ID of the message
+*	@return 										None
+*	@exception 										None
+*	@remarks 										None
+*/
+void External::CConnectionManager::DiscardMessage( const std::uint64_t& journalID )
+{
+	std::lock_guard<std::mutex> lock( managerThreadMutex );
+	if ( journal ) {
+		journal->AddCompleted( journalID );
+	}
+}
+
+
+
+/**	@brief		Callback method signalling that writing of the journal has failed
+*	@param		errorText							Description of the error
+*	@return 										None
+*	@exception 										None
+*	@remarks 										The message sending is continued without persistence
+*/
+void External::CConnectionManager::OnJournalError( const std::string& errorText )
+{
+	using namespace boost::posix_time;
+
+	statusCallback( std::make_unique<Utilities::Message::CGeneralStatusMessage>( Utilities::Message::MESSAGE_ERROR, ptime( microsec_clock::universal_time() ), u8"Das Nachrichtenjournal kann nicht geschrieben werden: " + errorText ) );
+}
+
+
+
 /**	@brief		Callback method signalling that a connection thread has finished its sending trial
 *	@return 										None
 *	@exception 										None
@@ -127,6 +244,23 @@ void External::CConnectionManager::OnConnectionFinished()
 }
 
 
+/**	@brief		Checks if all connections have finished their sending trials
+*	@return 										True if no connection is sending anymore, false otherwise
+*	@exception 										None
+*	@remarks 										This method is not thread-safe by itself
+*/
+bool External::CConnectionManager::IsAllConnectionsFinished()
+{
+	Utilities::Message::SendStatus status;
+	Utilities::CDateTime time;
+	std::vector<int> code;
+	unsigned int numTrials;
+	std::unique_ptr<Message> currMessage;
+
+	return std::all_of( begin( unavailableConnections ), end( unavailableConnections ), [&]( auto&& connection ) { return connection->GetStatus( status, time, code, numTrials, currMessage ); } );
+}
+
+
 /**	@brief		Regains the finished connections within the manager thread
 *	@param		maxNumTrials						Maximum number of connections trials until the message sending is assumed to have failed
 *	@param		timeDistTrials						Time between the connection trials
@@ -161,11 +295,24 @@ void External::CConnectionManager::RegainFinishedConnections( const unsigned int
 			currAlarmMessage = currMessage->message->Clone();
 			if ( status.code == NONFATAL_FAILURE ) {
 				if ( currNumTrials < maxNumTrials ) {
-					messageQueue[steady_clock::now() + timeDistTrials] = make_pair( move( currMessage ), currNumTrials );
+					if ( journal ) {
+						journal->AddRetry( currMessage->journalID, currNumTrials );
+					}
+					messageQueue.Push( move( currMessage ), currNumTrials, steady_clock::now() + timeDistTrials );
+					queueLengthMetric->Set( static_cast<std::int64_t>( messageQueue.Size() ) );
+					retryMetric->Increment();
 				} else {
 					status.code = TIMEOUT_FAILURE;
 				}
 			}
+			if ( journal && ( status.code != NONFATAL_FAILURE ) ) {
+				journal->AddCompleted( currMessage->journalID );
+			}
+			if ( status.code == SUCCESS ) {
+				successMetric->Increment();
+			} else if ( ( status.code == FATAL_FAILURE ) || ( status.code == TIMEOUT_FAILURE ) ) {
+				failureMetric->Increment();
+			}
 
 			// send the status information to the caller
 			statusCallback( make_unique<CSendStatusMessage<CAlarmMessage> >( ptime( microsec_clock::universal_time() ), time, code, move( currAlarmMessage ), status, currNumTrials, duration_cast<chrono::seconds>( timeDistTrials ) ) );
@@ -177,42 +324,34 @@ void External::CConnectionManager::RegainFinishedConnections( const unsigned int
 }
 
 
-/**	@brief		Sends the next due message (i.e. the first message within the queue) within the manager thread
-*	@return 										Flag stating true if no available connection was found, false otherwise
+/**	@brief		Sends all due messages within the manager thread, as long as connections are available
+*	@return 										Flag stating true if due messages are left because no available connection was found, false otherwise
 *	@exception 										None
-*	@remarks 										This method is not thread-safe by itself
+*	@remarks 										This method is not thread-safe by itself. The messages are sent in the order of their priority.
 */
-bool External::CConnectionManager::SendNextDueMessage()
+bool External::CConnectionManager::SendDueMessages()
 {
 	using namespace std;
 	using namespace std::chrono;
 
-	bool isNoConnectionsAvailable = false;
-	unsigned int currNumTrials;
-	unique_ptr<Message> currMessage;
 	unique_ptr<CConnectionThread> currConnection;
-	time_point<steady_clock> currMessageTimepoint;
+	auto currTime = steady_clock::now(); // preemptive wake-ups of the manager thread (due to finish message sending messages) have no effect
 
-	if ( !messageQueue.empty() ) {
-		currMessageTimepoint = begin( messageQueue )->first;
-		if ( ( steady_clock::now() - currMessageTimepoint ) >= 0ms ) { // ensures that preemptive wake-ups of the manager thread (due to finish message sending messages) have no effect
-			if ( !availableConnections.empty() ) {
-				currMessage = move( get< unique_ptr<Message> >( messageQueue.at( currMessageTimepoint ) ) );
-				currNumTrials = get<unsigned int>( messageQueue.at( currMessageTimepoint ) );
-				messageQueue.erase( currMessageTimepoint );
-
-				// obtain a connection thread from the list of available threads
-				currConnection = move( availableConnections.front() );
-				availableConnections.pop_front();
-				currConnection->SendMessage( move( currMessage ), currNumTrials ); // returns immediately because it is ensured that always the connection is only used once at a time
-				unavailableConnections.push_back( move( currConnection ) );
-			} else {
-				isNoConnectionsAvailable = true; // wait until a connection has been finished
-			}
+	while ( !availableConnections.empty() && messageQueue.HasDueMessage( currTime ) ) {
+		auto dueMessage = messageQueue.PopDueMessage( currTime );
+		queueLengthMetric->Set( static_cast<std::int64_t>( messageQueue.Size() ) );
+
+		// obtain a connection thread from the list of available threads
+		currConnection = move( availableConnections.front() );
+		availableConnections.pop_front();
+		if ( journal ) {
+			journal->AddDispatched( dueMessage.first->journalID );
 		}
+		currConnection->SendMessage( move( dueMessage.first ), dueMessage.second ); // returns immediately because it is ensured that always the connection is only used once at a time
+		unavailableConnections.push_back( move( currConnection ) );
 	}
 
-	return isNoConnectionsAvailable;
+	return messageQueue.HasDueMessage( currTime ); // if true, wait until a connection has been finished
 }
 
 
@@ -229,7 +368,6 @@ void External::CConnectionManager::ManagerThread()
 	float timeDistTrialsFloat;
 	chrono::milliseconds timeDistTrials;
 	unsigned int maxNumTrials, maxNumConnections;
-	nanoseconds currSleepDuration;
 	bool isNoConnectionsAvailable = false;
 
 	try {
@@ -239,9 +377,8 @@ void External::CConnectionManager::ManagerThread()
 		while ( true ) {
 			// sleeping of the thread (the thread will be reactivated if either the next message is due, a new message has been added, a connection thread has finished or in case of terminating)
 			std::unique_lock<mutex> lock( managerThreadMutex );
-			if ( !messageQueue.empty() && !isNoConnectionsAvailable ) {
-				currSleepDuration = begin( messageQueue )->first - steady_clock::now();
-				managerThreadWaitCondition.wait_for( lock, currSleepDuration, [=]() { return isResumeThread; } );
+			if ( !messageQueue.IsEmpty() && !isNoConnectionsAvailable ) {
+				managerThreadWaitCondition.wait_until( lock, messageQueue.GetNextDueTime(), [=]() { return isResumeThread; } );
 			} else {
 				managerThreadWaitCondition.wait( lock, [=]() { return isResumeThread; } );
 			}
@@ -254,8 +391,8 @@ void External::CConnectionManager::ManagerThread()
 			// regain finished (i.e. again available) connections
 			RegainFinishedConnections( maxNumTrials, timeDistTrials );
 
-			// send the currently due message (i.e. the first in the queue)
-			isNoConnectionsAvailable = SendNextDueMessage();
+			// send all currently due messages as long as connections are available
+			isNoConnectionsAvailable = SendDueMessages();
 		}
 	} catch ( ... ) {
 		// inform the caller about the exception before terminating the thread
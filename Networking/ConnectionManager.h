@@ -25,10 +25,14 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <chrono>
 #include <functional>
 #include <exception>
+#include <boost/filesystem.hpp>
 #include "ConnectionThread.h"
+#include "MessageJournal.h"
+#include "MessageScheduler.h"
 #include "StatusMessage.h"
 #include "AlarmMessage.h"
 #include "GatewayLoginData.h"
+#include "MetricsRegistry.h"
 
 
 #if defined _WIN32 || defined __CYGWIN__
@@ -67,17 +71,22 @@ namespace External {
 	public:
 		NETWORKING_API CConnectionManager( std::unique_ptr<CAlarmGateway> gateway, std::unique_ptr<CGatewayLoginData> login, std::function<void( std::unique_ptr<Utilities::Message::CStatusMessage> )> statusCallback, std::function<void( const std::exception_ptr& )> exceptionCallback );
 		NETWORKING_API virtual ~CConnectionManager( void );
-		NETWORKING_API virtual void AddMessage( const std::vector<int>& newSequence, const Utilities::CDateTime& time, const bool& isRealAlarm, std::unique_ptr< CAlarmMessage > alarmMessageDataset, const Utilities::CMediaFile& audioFile );
+		NETWORKING_API virtual void AddMessage( const std::vector<int>& newSequence, const Utilities::CDateTime& time, const bool& isRealAlarm, std::unique_ptr< CAlarmMessage > alarmMessageDataset, const Utilities::CMediaFile& audioFile, const unsigned int& messageIndex = 0 );
+		NETWORKING_API virtual std::map<std::uint64_t, JournalEntry> OpenJournal( const boost::filesystem::path& journalFile );
+		NETWORKING_API virtual void RestoreMessage( const std::uint64_t& journalID, const JournalEntry& entry, std::unique_ptr< CAlarmMessage > alarmMessageDataset );
+		NETWORKING_API virtual void DiscardMessage( const std::uint64_t& journalID );
 	private:
 		CConnectionManager( const CConnectionManager& ) = delete;
 		CConnectionManager& operator= ( const CConnectionManager& ) = delete;
 		virtual void ManagerThread();
 		virtual void RegainFinishedConnections( const unsigned int& maxNumTrials, const std::chrono::milliseconds& timeDistTrials );
-		virtual bool SendNextDueMessage();
+		virtual bool SendDueMessages();
+		virtual bool IsAllConnectionsFinished();
 		virtual void OnConnectionFinished();
+		virtual void OnJournalError( const std::string& errorText );
 		
 		std::unique_ptr<CGatewayLoginData> login;
-		std::map< std::chrono::time_point< std::chrono::steady_clock >, std::pair< std::unique_ptr<Message>, unsigned int > > messageQueue;
+		CMessageScheduler messageQueue;
 		std::thread managerThread;
 		std::condition_variable managerThreadWaitCondition;
 		std::mutex managerThreadMutex;
@@ -87,6 +96,11 @@ namespace External {
 		std::function<void( const std::exception_ptr& )> exceptionCallback;
 		std::deque< std::unique_ptr< CConnectionThread > > availableConnections;
 		std::deque< std::unique_ptr< CConnectionThread > > unavailableConnections;
+		std::shared_ptr<Utilities::Metrics::CGauge> queueLengthMetric;
+		std::shared_ptr<Utilities::Metrics::CCounter> successMetric;
+		std::shared_ptr<Utilities::Metrics::CCounter> retryMetric;
+		std::shared_ptr<Utilities::Metrics::CCounter> failureMetric;
+		std::unique_ptr<CMessageJournal> journal;
 	};
 }
 /*@}*/
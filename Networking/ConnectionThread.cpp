@@ -23,20 +23,27 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 	#endif
 #endif
 
+#include <typeinfo>
+#include <boost/core/demangle.hpp>
+#include "LatencyProbe.h"
+#include "MetricsRegistry.h"
 #include "ConnectionThread.h"
 
 
 /**	@brief		Constructor
-*	@param		connection							Object containing the gateway connection that will be used by the thread. It will be persistent during the whole lifetime of the object.
-*	@param		finishedSendingCallback				Callback function which is called whenever the connection has finished a sending trial
-*	@param		exceptionCallback					Callback function which is called when an exception has occured in the thread (and the thread has finished silently)
+*	@param		connection							Object containing the gateway connection that will be used by the connection. It will be persistent during the whole lifetime of the object.
+*	@param		finishedSendingCallback				Callback function which is called whenever the connection has finished a sending trial. It is called from a worker thread of the shared executor.
+*	@param		exceptionCallback					Callback function which is called when an exception has occured during the sending
 *	@exception	std::runtime_error					Thrown if one of input parameters is an invalid pointer
 *	@remarks 										None
 */
 External::CConnectionThread::CConnectionThread( std::unique_ptr<CAlarmGateway> connection, std::function<void()> finishedSendingCallback, std::function<void( const std::exception_ptr& )> exceptionCallback )
-	: connection( std::move( connection ) ),
-	isNewMessageReceived( false ),
-	isTerminateThread( false ),
+	: executor( CGatewayExecutor::Instance() ),
+	connection( std::move( connection ) ),
+	journalID( 0 ),
+	numTrials( 0 ),
+	isSending( false ),
+	numActiveTasks( 0 ),
 	finishedSendingCallback( finishedSendingCallback ),
 	exceptionCallback( exceptionCallback )
 {
@@ -47,23 +54,18 @@ External::CConnectionThread::CConnectionThread( std::unique_ptr<CAlarmGateway> c
 		throw std::runtime_error( "The callback functions must not be empty." );
 	}
 
-	connectionThread = std::thread( [&]() { CConnectionThread::ConnectionThread(); } );
+	gatewayName = boost::core::demangle( typeid( *CConnectionThread::connection ).name() );
+	sendDurationMetric = Utilities::Metrics::CMetricsRegistry::Instance().GetHistogram( "personalfme_gateway_send_duration_seconds", "Duration of a single sending trial via an alarm gateway", { { "gateway", gatewayName } } );
 }
 
 
 /**	@brief		Destructor
-*	@remarks 										None
+*	@remarks 										Waits until a currently running sending trial has been finished
 */
 External::CConnectionThread::~CConnectionThread()
 {
-	{
-		std::lock_guard<std::mutex> lock( messageProcessingMutex );
-		isTerminateThread = true;
-		isNewMessageReceived = true;
-	}
-	newMessageReceived.notify_all();
-
-	connectionThread.join();
+	std::unique_lock<std::mutex> lock( dataMutex );
+	sendingFinishedCondition.wait( lock, [this]() { return ( numActiveTasks == 0 ); } );
 }
 
 
@@ -81,11 +83,11 @@ void External::CConnectionThread::SendMessage( std::unique_ptr<Message> message,
 	}
 
 	{
-		std::lock( messageProcessingMutex, dataMutex );
-		std::lock_guard<std::mutex> lock( messageProcessingMutex, std::adopt_lock );
-		std::lock_guard<std::mutex> dataLock( dataMutex, std::adopt_lock );
+		std::unique_lock<std::mutex> dataLock( dataMutex );
+		sendingFinishedCondition.wait( dataLock, [this]() { return !isSending; } );
 		CConnectionThread::message = std::move( message );
-		isNewMessageReceived = true;
+		isSending = true;
+		numActiveTasks++;
 		status.code = Utilities::Message::IN_PROCESSING;
 		status.text.clear();
 		sequence = CConnectionThread::message->sequence;
@@ -94,9 +96,11 @@ void External::CConnectionThread::SendMessage( std::unique_ptr<Message> message,
 		messageData = CConnectionThread::message->message->Clone();
 		login = CConnectionThread::message->login->Clone();
 		audioFile = CConnectionThread::message->audioFile;
+		journalID = CConnectionThread::message->journalID;
 		CConnectionThread::numTrials = numTrials + 1;
 	}
-	newMessageReceived.notify_all();
+
+	executor->Submit( [this]() { PerformSending(); } );
 }
 
 
@@ -125,6 +129,7 @@ bool External::CConnectionThread::GetStatus( Utilities::Message::SendStatus& sta
 	currMessage->message = CConnectionThread::messageData->Clone();
 	currMessage->sequence = CConnectionThread::sequence;
 	currMessage->time = CConnectionThread::time;
+	currMessage->journalID = CConnectionThread::journalID;
 
 	if ( status.code == Utilities::Message::IN_PROCESSING ) {
 		return false;
@@ -134,52 +139,53 @@ bool External::CConnectionThread::GetStatus( Utilities::Message::SendStatus& sta
 }
 
 
-/**	@brief		Thread implementing the access to the network resource
+/**	@brief		Task implementing a single sending trial via the network resource
 *	@return 										None
 *	@exception 										None
-*	@remarks 										None
+*	@remarks 										The task is executed by a worker thread of the shared executor. The message is not modified by other threads during the sending.
 */
-void External::CConnectionThread::ConnectionThread()
+void External::CConnectionThread::PerformSending()
 {
 	using namespace std;
 	using namespace Utilities::Message;
 
 	SendStatus currStatus;
+	chrono::steady_clock::time_point startTime;
 
 	try {
-		while ( true ) {
-			unique_lock<mutex> lock( messageProcessingMutex );
-			newMessageReceived.wait( lock, [=]() { return isNewMessageReceived; } );
-			isNewMessageReceived = false;
-			if ( isTerminateThread ) {
-				break;
-			}
-
-			try {
-				// send the alarm via the gateway
-				connection->Send( message->sequence, message->time, message->isRealAlarm, message->login->Clone(), message->message->Clone(), message->audioFile ); // the function can throw exceptions (std::domain_error in case of missing internet connection)
-				currStatus.code = SUCCESS;
-				currStatus.text = "";
-			} catch ( std::domain_error& e ) {
-				// internet connection error
-				currStatus.code = NONFATAL_FAILURE;		// non-fatal error - further trials are possible
-				currStatus.text = e.what();
-			} catch ( std::exception& e ) {
-				// any other error
-				currStatus.code = FATAL_FAILURE;		// fatal error - stop trials immediately
-				currStatus.text = e.what();
-			}
-
-			{
-				lock_guard<mutex> dataLock( dataMutex );
-				status = currStatus;
-			}
-
-			callbackFutures.erase( remove_if( begin( callbackFutures ), end( callbackFutures ), []( auto&& currFuture ) { return( currFuture.wait_for( 0s ) == future_status::ready ); } ), callbackFutures.end() );
-			callbackFutures.push_back( async( launch::async, finishedSendingCallback ) );
-		}
+		// send the alarm via the gateway
+		Utilities::Latency::CLatencyProbe::Instance().MarkGatewayHandoff( message->sequence, message->time, gatewayName );
+		startTime = chrono::steady_clock::now();
+		connection->Send( message->sequence, message->time, message->isRealAlarm, message->login->Clone(), message->message->Clone(), message->audioFile ); // the function can throw exceptions (std::domain_error in case of missing internet connection)
+		currStatus.code = SUCCESS;
+		currStatus.text = "";
+	} catch ( std::domain_error& e ) {
+		// internet connection error
+		currStatus.code = NONFATAL_FAILURE;		// non-fatal error - further trials are possible
+		currStatus.text = e.what();
+	} catch ( std::exception& e ) {
+		// any other error
+		currStatus.code = FATAL_FAILURE;		// fatal error - stop trials immediately
+		currStatus.text = e.what();
+	}
+	sendDurationMetric->Observe( chrono::steady_clock::now() - startTime );
+
+	{
+		lock_guard<mutex> dataLock( dataMutex );
+		status = currStatus;
+		isSending = false;
+	}
+	sendingFinishedCondition.notify_all();
+
+	// the callback is called without holding any lock of the connection, the next message can already be sent during the callback
+	try {
+		finishedSendingCallback();
 	} catch ( ... ) {
-		// inform the caller about the exception before terminating the thread
 		exceptionCallback( current_exception() );
 	}
+
+	// the notification is performed under the lock, because the object may be destroyed immediately afterwards
+	lock_guard<mutex> dataLock( dataMutex );
+	numActiveTasks--;
+	sendingFinishedCondition.notify_all();
 }
@@ -16,10 +16,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 #pragma once
 #include <memory>
+#include <cstdint>
 #include <string>
-#include <thread>
 #include <mutex>
-#include <future>
 #include <vector>
 #include <condition_variable>
 #include <functional>
@@ -29,6 +28,8 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "SendStatusMessage.h"
 #include "AlarmGateway.h"
 #include "GatewayLoginData.h"
+#include "GatewayExecutor.h"
+#include "MetricsRegistry.h"
 
 
 #if defined _WIN32 || defined __CYGWIN__
@@ -69,11 +70,12 @@ namespace External {
 		std::unique_ptr< CAlarmMessage > message;
 		std::unique_ptr< CGatewayLoginData > login;
 		Utilities::CMediaFile audioFile;
+		std::uint64_t journalID;
 	};
 
 
 	/**	\ingroup Networking
-	*	Class implementing a thread containing a single connection to a gateway resource
+	*	Class implementing a single connection slot to a gateway resource. The sending is performed by the worker threads of the CGatewayExecutor shared by all gateways.
 	*/
 	class CConnectionThread
 	{
@@ -83,11 +85,12 @@ namespace External {
 		NETWORKING_API virtual void SendMessage( std::unique_ptr<Message> message, const unsigned int& numTrials );
 		NETWORKING_API virtual bool GetStatus( Utilities::Message::SendStatus& status, Utilities::CDateTime& time, std::vector<int>& sequence, unsigned int& numTrials, std::unique_ptr<Message>& currMessage );
 	private:
-		virtual void ConnectionThread();
+		virtual void PerformSending();
 
-		std::thread connectionThread;
+		std::shared_ptr<CGatewayExecutor> executor;
 		std::unique_ptr<CAlarmGateway> connection;
-		std::vector< std::future<void> > callbackFutures;
+		std::string gatewayName;
+		std::shared_ptr<Utilities::Metrics::CHistogram> sendDurationMetric;
 		std::unique_ptr<Message> message;
 		Utilities::CDateTime time;
 		std::vector<int> sequence;
@@ -95,13 +98,13 @@ namespace External {
 		std::unique_ptr< CAlarmMessage > messageData;
 		std::unique_ptr< CGatewayLoginData > login;
 		Utilities::CMediaFile audioFile;
+		std::uint64_t journalID;
 		unsigned int numTrials;
 		Utilities::Message::SendStatus status;
 		std::mutex dataMutex;
-		std::condition_variable newMessageReceived;
-		bool isNewMessageReceived;
-		std::mutex messageProcessingMutex;
-		bool isTerminateThread;
+		std::condition_variable sendingFinishedCondition;
+		bool isSending;
+		unsigned int numActiveTasks;
 		std::function<void()> finishedSendingCallback;
 		std::function<void(const std::exception_ptr&)> exceptionCallback;
 	};
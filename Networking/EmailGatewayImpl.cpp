@@ -26,11 +26,11 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <regex>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
+#include <Poco/Exception.h>
 #include <Poco/SharedPtr.h>
 #include <Poco/Path.h>
 #include <Poco/Net/SecureSMTPClientSession.h>
 #include <Poco/Net/StringPartSource.h>
-#include <Poco/Net/FilePartSource.h>
 #include <Poco/Net/SSLManager.h>
 #include <Poco/Net/SecureStreamSocket.h>
 #include <Poco/Net/KeyConsoleHandler.h>
@@ -51,6 +51,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 *	@remarks								The used SSL-manager of Poco is a singleton. If other classes within the program use different settings, they are overwritten by the present constructor.
 */
 External::Email::CEmailGateway::CEmailGatewayImpl::CEmailGatewayImpl( void )
+	: sessionPool( CSMTPSessionPool::Instance() )
 {
 	// the SSL system should only be initiated once in the program
 	std::call_once( rootCertificatesLoadOnceFlag, &CEmailGatewayImpl::LoadRootCertificatesFromOSTrustStore );
@@ -87,16 +88,15 @@ void External::Email::CEmailGateway::CEmailGatewayImpl::LoadRootCertificatesFrom
 
 
 
-/** @brief		Send an e-mail message with the SMTP-protocol
-*	@param		message						Message to be sent
+/** @brief		Opens a new authenticated SMTP-session to the e-mail server
 *	@param		loginData					Login data for the e-mail server
-*	@return									None
+*	@return									Authenticated session ready for sending messages
 *	@exception	NetException				Thrown if the internet connection was missing (or if the host is unknown)
 *	@exception	SSLException				Thrown if an error occured during setting up the TLS/SSL-connection
-*	@exception	SMTPException				Thrown if the e-mail-sending failed due to a SMTP-connection error
-*	@remarks								None
+*	@exception	SMTPException				Thrown if the login failed due to a SMTP-connection error
+*	@remarks								All configured login methods of the authentification type are tried
 */
-void External::Email::CEmailGateway::CEmailGatewayImpl::SendSMTP( const Poco::Net::MailMessage& message, std::unique_ptr<CGatewayLoginData> loginData )
+std::unique_ptr<Poco::Net::SMTPClientSession> External::Email::CEmailGateway::CEmailGatewayImpl::OpenSMTPSession( const CEmailLoginData& loginData )
 {
 	using namespace std;
 	using namespace Poco::Net;
@@ -117,8 +117,8 @@ void External::Email::CEmailGateway::CEmailGatewayImpl::SendSMTP( const Poco::Ne
 	possibleLoginMethods[ENCRYPTED_AUTH].push_back( SMTPClientSession::AUTH_CRAM_SHA1 );
 	possibleLoginMethods[ENCRYPTED_AUTH].push_back( SMTPClientSession::AUTH_CRAM_MD5 );
 
-	dynamic_cast< const Email::CEmailLoginData& >( *loginData ).GetServerInformation( connectionType, hostName, port );
-	dynamic_cast< const Email::CEmailLoginData& >( *loginData ).GetLoginInformation( senderAddress, authType, userName, password );
+	loginData.GetServerInformation( connectionType, hostName, port );
+	loginData.GetLoginInformation( senderAddress, authType, userName, password );
 
 	if ( port == DEFAULT_PORT ) {
 		currPort = CEmailLoginData::GetDefaultPort( connectionType, authType );
@@ -167,9 +167,46 @@ void External::Email::CEmailGateway::CEmailGatewayImpl::SendSMTP( const Poco::Ne
 		throw SMTPException( errors.str() );
 	}
 
-	// send the message
+	return mailSession;
+}
+
+
+
+/** @brief		Send an e-mail message with the SMTP-protocol
+*	@param		message						Message to be sent
+*	@param		loginData					Login data for the e-mail server
+*	@return									None
+*	@exception	NetException				Thrown if the internet connection was missing (or if the host is unknown)
+*	@exception	SSLException				Thrown if an error occured during setting up the TLS/SSL-connection
+*	@exception	SMTPException				Thrown if the e-mail-sending failed due to a SMTP-connection error
+*	@remarks								An authenticated session to the same server is reused if available. If it has been lost in the meantime, a new session is opened transparently.
+*/
+void External::Email::CEmailGateway::CEmailGatewayImpl::SendSMTP( const Poco::Net::MailMessage& message, std::unique_ptr<CGatewayLoginData> loginData )
+{
+	using namespace std;
+	using namespace Poco::Net;
+
+	const auto& emailLoginData = dynamic_cast< const Email::CEmailLoginData& >( *loginData );
+
+	auto mailSession = sessionPool->Acquire( emailLoginData );
+	if ( mailSession ) {
+		try {
+			mailSession->sendMessage( message );
+			sessionPool->Release( emailLoginData, move( mailSession ) );
+			return;
+		}
+		catch ( SMTPException& ) {
+			throw; // the server has rejected the message
+		}
+		catch ( NetException& ) {
+			// the connection of the cached session has been lost, a new session is opened
+			mailSession.reset();
+		}
+	}
+
+	mailSession = OpenSMTPSession( emailLoginData );
 	mailSession->sendMessage( message );
-	mailSession->close();
+	sessionPool->Release( emailLoginData, move( mailSession ) );
 }
 
 
@@ -260,7 +297,9 @@ void External::Email::CEmailGateway::CEmailGatewayImpl::Send( const std::vector<
 		mailMessage.setSubject( MailMessage::encodeWord( alarmTypeString + " " + siteID + ", " + alarmID, "UTF-8" ) );
 		mailMessage.addContent( new StringPartSource( contentStream.str(), "text/plain; charset=UTF-8" ) ); // ownership of the pointer is taken over by mailMessage
 		if ( !audioFile.IsEmpty() ) {
-			mailMessage.addAttachment( audioFile.GetFilePath().filename().string(), new FilePartSource( audioFile.GetFilePath().string(), audioFile.GetFilePath().filename().string(), audioFile.GetMIMEtype() ) );
+			// the audio file is read only once for all e-mails of the alarm
+			auto attachmentData = GetAttachmentCache().Read( audioFile.GetFilePath() );
+			mailMessage.addAttachment( audioFile.GetFilePath().filename().string(), new StringPartSource( *attachmentData, audioFile.GetMIMEtype(), audioFile.GetFilePath().filename().string() ) );
 		}
 
 		// send the e-mail
@@ -299,6 +338,18 @@ bool External::Email::CEmailGateway::CEmailGatewayImpl::IsTemporarySMTPServerErr
 }
 
 
+/** @brief		Access to the cache of the e-mail attachments
+*	@return									Cache shared by all e-mail gateway connections
+*	@exception								None
+*	@remarks								The attachments of an alarm are only required until all its e-mails have been sent
+*/
+External::Email::CAttachmentCache& External::Email::CEmailGateway::CEmailGatewayImpl::GetAttachmentCache()
+{
+	static CAttachmentCache attachmentCache( std::chrono::minutes( 5 ) );
+	return attachmentCache;
+}
+
+
 /** @brief		Provides a string containing a summary of the alarms corresponding to the infoalarm
 *	@param		infoalarmMessage			Infoalarm message
 *	@return									Summary string containing the alarms corresponding to the infoalarm
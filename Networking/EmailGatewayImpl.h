@@ -18,9 +18,11 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <boost/filesystem.hpp>
 #include <Poco/Net/SSLManager.h>
 #include <Poco/Net/Context.h>
 #include <Poco/Net/MailMessage.h>
+#include <Poco/Net/SMTPClientSession.h>
 #include <Poco/Net/NetException.h>
 #ifndef _WIN32
 	#include <openssl/err.h>
@@ -31,6 +33,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "Groupalarm2Message.h"
 #include "ExternalProgramMessage.h"
 #include "GatewayLoginData.h"
+#include "EmailLoginData.h"
+#include "SMTPSessionPool.h"
+#include "AttachmentCache.h"
 #include "InfoalarmMessageDecorator.h"
 #include "EmailGateway.h"
 
@@ -95,6 +100,7 @@ public:
 	void Send( const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const bool& isRealAlarm, std::unique_ptr<CGatewayLoginData> loginData, std::unique_ptr<CAlarmMessage> message, const Utilities::CMediaFile& audioFile );
 protected:
 	static void LoadRootCertificatesFromOSTrustStore();
+	std::unique_ptr<Poco::Net::SMTPClientSession> OpenSMTPSession( const CEmailLoginData& loginData );
 	void SendSMTP( const Poco::Net::MailMessage& message, std::unique_ptr<CGatewayLoginData> loginData );
 	bool IsTemporarySMTPServerError( const Poco::Net::SMTPException& e );
 	static std::string CreateOtherMessagesInfo( const Infoalarm::CInfoalarmMessageDecorator& infoalarmMessage );
@@ -102,7 +108,10 @@ protected:
 	static std::string CreateGroupalarmMessageInfo( const External::Groupalarm::CGroupalarm2Message& message );
 	static std::string CreateExternalProgramMessageInfo( const External::ExternalProgram::CExternalProgramMessage& message );
 private:
+	static CAttachmentCache& GetAttachmentCache();
+
 	static std::unique_ptr<SSLInitializer> sslInitializer;
 	static std::once_flag rootCertificatesLoadOnceFlag;
+	std::shared_ptr<CSMTPSessionPool> sessionPool;
 };
 /*@}*/
@@ -31,6 +31,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 External::Email::CEmailLoginData::CEmailLoginData(void)
 	: CGatewayLoginData(),
+	  sessionIdleTime( DEFAULT_SESSION_IDLE_TIME ),
 	  isServerSet( false ),
 	  isLoginSet( false )
 {
@@ -168,6 +169,31 @@ void External::Email::CEmailLoginData::SetLoginInformation(const std::string& se
 
 
 
+/**	@brief		Setting the time an authenticated session to the e-mail server is kept open for further messages
+*	@param		sessionIdleTime					Maximum idle time of a session (in s). Sessions are not reused at all if it is zero.
+*	@return										None
+*	@exception									None
+*	@remarks									The time should be shorter than the timeout of the e-mail server
+*/
+void External::Email::CEmailLoginData::SetSessionIdleTime(const unsigned int& sessionIdleTime)
+{
+	CEmailLoginData::sessionIdleTime = sessionIdleTime;
+}
+
+
+
+/**	@brief		Getting the time an authenticated session to the e-mail server is kept open for further messages
+*	@return										Maximum idle time of a session (in s)
+*	@exception									None
+*	@remarks									None
+*/
+unsigned int External::Email::CEmailLoginData::GetSessionIdleTime() const
+{
+	return sessionIdleTime;
+}
+
+
+
 /**	@brief		Determines if the current login data is valid
 *	@return										True if the login data is valid, false otherwise
 *	@exception									None
@@ -236,6 +262,9 @@ bool External::Email::CEmailLoginData::IsEqual( const CGatewayLoginData& rhs ) c
 			if ( port != rhsPort ) {
 				return false;
 			}
+			if ( sessionIdleTime != derivRhs.GetSessionIdleTime() ) {
+				return false;
+			}
 		}
 	} catch ( std::bad_cast e ) {
 		return false;
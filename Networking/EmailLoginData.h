@@ -63,6 +63,11 @@ namespace External {
 		*/
 		const unsigned short DEFAULT_PORT = 0;
 
+		/**		\ingroup Networking
+		*		Default time (in s) an authenticated session to the e-mail server is kept open for further messages, it is well below the minimum server timeout of 5 minutes (RFC 5321)
+		*/
+		const unsigned int DEFAULT_SESSION_IDLE_TIME = 60;
+
 		/** \ingroup Networking
 		*	Class representing the login data for sending alarms via e-mail
 		*/
@@ -76,6 +81,8 @@ namespace External {
 			NETWORKING_API virtual void SetLoginInformation(const std::string& senderAddress, const AuthType& authType, const std::string& userName = std::string(), const std::string& password = std::string());
 			NETWORKING_API virtual void GetServerInformation(ConnectionType& connectionType, std::string& hostName, unsigned short& port) const;
 			NETWORKING_API virtual void GetLoginInformation(std::string& senderAddress, AuthType& authType, std::string& userName, std::string& password) const;
+			NETWORKING_API virtual void SetSessionIdleTime(const unsigned int& sessionIdleTime);
+			NETWORKING_API virtual unsigned int GetSessionIdleTime() const;
 			NETWORKING_API static unsigned short GetDefaultPort(const ConnectionType& connectionType, const AuthType& authType);
 			NETWORKING_API virtual bool IsValid() const;
 		protected:
@@ -88,6 +95,7 @@ namespace External {
 			AuthType authType;
 			std::string userName;
 			std::string password;
+			unsigned int sessionIdleTime;
 			bool isServerSet;
 			bool isLoginSet;
 		};
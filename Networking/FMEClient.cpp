@@ -72,14 +72,17 @@ Networking::CFMEClient::CFMEClient(std::string serverAddress, unsigned short por
 *	@return								None
 *	@exception	std::runtime_error		Thrown if the server for the given address and port is not available
 *	@remarks							IPv4- as well as IPv6-addresses might be used. This function can be called for complete and safe reinitialization of the class.
+*										A server that replied to the handshake as a server of protocol version 1 is contacted with protocol version 1 until the next call of this function.
 */
 void Networking::CFMEClient::Init(std::string serverAddress, unsigned short port)
 {
 	using boost::asio::ip::tcp;
 
+	privHandle->CloseActiveConnection();
 	privHandle->serverAddress = serverAddress;
 	privHandle->port = port;
 	privHandle->isValidEndpoint = false;
+	privHandle->isLegacyServer = false;
 		
 	// resolving server address with DNS
 	try {
@@ -116,6 +119,9 @@ Networking::CFMEClient::FMEClientPrivImplementation::FMEClientPrivImplementation
 	  sessionManager( new Session::CFMESessionManager<float>() ),
 	  newConnection( new Session::CFMESession<float>( ioService, sessionManager, dummy ) )
 {
+	isValidEndpoint = false;
+	isLegacyServer = false;
+	isReusedConnection = false;
 	isInit = false;
 }
 
@@ -133,6 +139,7 @@ Networking::CFMEClient::~CFMEClient(void)
 *	@return								True in case of successfull data transmission and false in case of any failure
 *	@exception	std::runtime_error		Thrown if neither the full constructor nor CFMEClient::Init() were used for initalizing the function
 *	@remarks							The network communication is only performed during calling this function. It will return after finishing all work. It might safely be called several times.
+*										With protocol version 2 the connection to the server stays open between the calls and the transmission is only successful if the server acknowledged the sequence.
 */
 bool Networking::CFMEClient::Run(void)
 {
@@ -150,6 +157,7 @@ bool Networking::CFMEClient::Run(void)
 		privHandle->ioService.run();
 	} catch (...) {
 		// reset for further trials
+		privHandle->CloseActiveConnection();
 		privHandle->newConnection->Socket().close();
 		privHandle->hostEndpointIt = privHandle->originalHostEndpointIt;
 		privHandle->isValidEndpoint = false;
@@ -187,6 +195,17 @@ void Networking::CFMEClient::FMEClientPrivImplementation::PerformSending(void)
 {
 	using namespace boost::asio::placeholders;
 
+	if ( activeConnection && activeConnection->Socket().is_open() ) {
+		isReusedConnection = true;
+		if ( std::chrono::steady_clock::now() - lastActivityTime > std::chrono::seconds( Session::heartbeatInterval ) ) {
+			// the server might have closed the idle connection in the meantime
+			activeConnection->StartHeartbeat( [this]( bool isAlive ) { HandleHeartbeat( isAlive ); } );
+		} else {
+			SendOnActiveConnection();
+		}
+		return;
+	}
+
 	if ( !( isValidEndpoint ) ) {
 		// no valid server endpoint was found up to now
 		hostEndpoint = *( hostEndpointIt );
@@ -236,10 +255,17 @@ void Networking::CFMEClient::FMEClientPrivImplementation::HandleDirectConnect(co
 		// connection to the server is standing
 		isValidEndpoint = true;
 
-		// start managing connection and sending data to the server
-		sessionManager->StartWrite( newConnection, sequence );
-
-		// prepare the new connection which will be used for the transmission of the sequence
+		if ( isLegacyServer ) {
+			// protocol version 1 uses a separate connection for each sequence
+			WriteSequence( newConnection );
+		} else {
+			// request protocol version 2 with a long-lived connection
+			activeConnection = newConnection;
+			isReusedConnection = false;
+			activeConnection->StartHandshake( [this]( int protocolVersion ) { HandleHandshake( protocolVersion ); } );
+		}
+
+		// prepare the new connection which will be used for the next connection
 		ResetConnection();	
 	} else {
 		// connection could not be established
@@ -249,6 +275,109 @@ void Networking::CFMEClient::FMEClientPrivImplementation::HandleDirectConnect(co
 
 
 
+/** @brief		Handler for the result of the request for protocol version 2
+*	@param		protocolVersion			Protocol version supported by the server (0 if it is unknown)
+*	@return								None
+*	@exception	std::runtime_error		Thrown if the server did not answer the request
+*	@remarks							Only if the server replied as a server of protocol version 1, the sequence is sent with this version on a new connection.
+*										A missing answer might be caused by a transient failure, the protocol version is requested again in the next trial.
+*/
+void Networking::CFMEClient::FMEClientPrivImplementation::HandleHandshake(int protocolVersion)
+{
+	if ( protocolVersion == 2 ) {
+		SendOnActiveConnection();
+	} else if ( protocolVersion == 1 ) {
+		isLegacyServer = true;
+		CloseActiveConnection();
+		PerformSending();
+	} else {
+		CloseActiveConnection();
+		throw std::runtime_error( "The server did not answer the request for the protocol version." );
+	}
+}
+
+
+
+/** @brief		Handler for the result of the heartbeat checking an idle connection
+*	@param		isAlive					Flag stating if the server answered the heartbeat
+*	@return								None
+*	@exception							None
+*	@remarks							If the connection is broken, the sequence is sent on a new connection
+*/
+void Networking::CFMEClient::FMEClientPrivImplementation::HandleHeartbeat(bool isAlive)
+{
+	if ( isAlive ) {
+		SendOnActiveConnection();
+	} else {
+		CloseActiveConnection();
+		PerformSending();
+	}
+}
+
+
+
+/** @brief		Handler for the acknowledgement of the sequence sent on the long-lived connection of protocol version 2
+*	@param		isAcknowledged			Flag stating if the server acknowledged the sequence
+*	@return								None
+*	@exception	std::runtime_error		Thrown if the sequence was not acknowledged on a new connection
+*	@remarks							A reused connection might have been broken without notice, in this case the sequence is sent once more on a new connection
+*/
+void Networking::CFMEClient::FMEClientPrivImplementation::HandleAcknowledge(bool isAcknowledged)
+{
+	if ( isAcknowledged ) {
+		lastActivityTime = std::chrono::steady_clock::now();
+	} else if ( isReusedConnection ) {
+		CloseActiveConnection();
+		PerformSending();
+	} else {
+		CloseActiveConnection();
+		throw std::runtime_error( "The server did not acknowledge the sequence." );
+	}
+}
+
+
+
+/** @brief		Starting the transmission of the sequence on the long-lived connection of protocol version 2
+*	@return								None
+*	@exception							None
+*	@remarks							The transmission is completed by the acknowledgement of the server
+*/
+void Networking::CFMEClient::FMEClientPrivImplementation::SendOnActiveConnection(void)
+{
+	activeConnection->StartWriteAcknowledged( sequence, [this]( bool isAcknowledged ) { HandleAcknowledge( isAcknowledged ); } );
+}
+
+
+
+/** @brief		Closing the long-lived connection of protocol version 2
+*	@return								None
+*	@exception							None
+*	@remarks							The function does nothing if no such connection exists
+*/
+void Networking::CFMEClient::FMEClientPrivImplementation::CloseActiveConnection(void)
+{
+	if ( activeConnection ) {
+		sessionManager->Stop( activeConnection );
+		activeConnection.reset();
+	}
+}
+
+
+
+/** @brief		Starting the transmission of the sequence on an established connection
+*	@param		connection				Connection to the server
+*	@return								None
+*	@exception							None
+*	@remarks							None
+*/
+void Networking::CFMEClient::FMEClientPrivImplementation::WriteSequence(std::shared_ptr< Session::CFMESession<float> > connection)
+{
+	// start managing connection and sending data to the server
+	sessionManager->StartWrite( connection, sequence );
+}
+
+
+
 /** @brief		Obtain standard port for the protocol.
 *	@return								Standard port
 *	@exception							None
@@ -118,25 +118,14 @@ void Networking::CFMEClientDebug::FMEClientPrivImplDebug::ResetConnection(void)
 
 
 
-/** @brief		Starting data transmission to the server for debug sequence information.
-*	@param		error					Error code from Boost ASIO library for the asynchronous connect operation
+/** @brief		Starting the transmission of the debug sequence information on an established connection
+*	@param		connection				Connection to the server
 *	@return								None
-*	@exception	std::runtime_error		Thrown if the connect operation finally failed
-*	@remarks							This a handler for Boost ASIO asynchronous operations.
+*	@exception							None
+*	@remarks							None
 */
-void Networking::CFMEClientDebug::FMEClientPrivImplDebug::HandleDirectConnect(const boost::system::error_code& error)
+void Networking::CFMEClientDebug::FMEClientPrivImplDebug::WriteSequence(std::shared_ptr< Session::CFMESession<float> > connection)
 {
-	if ( !(error) ) {
-		// connection to server is standing
-		isValidEndpoint = true;
-
-		// start managing connection and sending data to the server
-		std::dynamic_pointer_cast< Session::CFMESessionManagerDebug<float> >( sessionManager )->StartWrite( newConnection, sequenceDebug );
-
-		// prepare the new connection which will be used for the transmission of the sequence
-		ResetConnection();	
-	} else {
-		// connection could not be established
-		throw std::runtime_error( error.message() );
-    }
+	// start managing connection and sending data to the server
+	std::dynamic_pointer_cast< Session::CFMESessionManagerDebug<float> >( sessionManager )->StartWrite( connection, sequenceDebug );
 }
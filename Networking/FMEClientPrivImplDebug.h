@@ -33,7 +33,7 @@ class Networking::CFMEClientDebug::FMEClientPrivImplDebug :
 public:
 	FMEClientPrivImplDebug(void){};
 	virtual ~FMEClientPrivImplDebug(void){};
-	virtual void HandleDirectConnect(const boost::system::error_code& err);
+	virtual void WriteSequence(std::shared_ptr< Session::CFMESession<float> > connection);
 	virtual void ResetConnection(void);
 
 	Utilities::CSeqDataComplete<float> sequenceDebug;
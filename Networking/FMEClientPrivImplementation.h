@@ -16,6 +16,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 #pragma once
 
+#include <chrono>
 #include <boost/asio.hpp>
 #include "FMESession.h"
 #include "FMESessionManager.h"
@@ -35,7 +36,13 @@ public:
 	virtual ~FMEClientPrivImplementation(void){};
 	void PerformSending(void);
 	void HandleConnect(const boost::system::error_code& error, boost::asio::ip::tcp::resolver::iterator endpointIt);
-	virtual void HandleDirectConnect(const boost::system::error_code& error);
+	void HandleDirectConnect(const boost::system::error_code& error);
+	void HandleHandshake(int protocolVersion);
+	void HandleHeartbeat(bool isAlive);
+	void HandleAcknowledge(bool isAcknowledged);
+	void SendOnActiveConnection(void);
+	void CloseActiveConnection(void);
+	virtual void WriteSequence(std::shared_ptr< Session::CFMESession<float> > connection);
 	virtual void ResetConnection(void);
 
 	boost::asio::io_service ioService;
@@ -45,9 +52,13 @@ public:
 	std::shared_ptr< Session::CFMESessionManager<float> > sessionManager;
 	Utilities::CSeqData sequence;
 	std::shared_ptr< Session::CFMESession<float> > newConnection;
+	std::shared_ptr< Session::CFMESession<float> > activeConnection;
+	std::chrono::steady_clock::time_point lastActivityTime;
 	std::string serverAddress;
 	unsigned short port;
 	bool isValidEndpoint;
+	bool isLegacyServer;
+	bool isReusedConnection;
 	bool isInit;
 };
 
@@ -0,0 +1,566 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include "SeqData.h"
+#include "SeqDataComplete.h"
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+
+namespace Networking {
+	namespace Session {
+		namespace Codec {
+			/** @param	frameHeaderSize		Size of the frame header of protocol version 2: frame type (1 byte) and payload length (4 bytes) */
+			const size_t frameHeaderSize = 5;
+			/** @param	maxFrameLength		Maximum accepted payload length of a single frame [bytes] */
+			const std::uint32_t maxFrameLength = 1 << 20;
+
+			/**	\ingroup Networking
+			*	Types of the frames of protocol version 2. The server confirms each received sequence frame by an acknowledgement frame.
+			*/
+			enum FrameType : std::uint8_t { SEQUENCE_FRAME = 1, HEARTBEAT_FRAME = 2, SUBSCRIBE_FRAME = 3, ACK_FRAME = 4 };
+
+			/**	\ingroup Networking
+			*	Behaviour of the publishing server if a subscriber cannot keep up with the published sequences
+			*/
+			enum SlowSubscriberPolicy : std::uint8_t { DROP_SEQUENCES = 1, DISCONNECT_SUBSCRIBER = 2 };
+
+			/**	\ingroup Networking
+			*	Appends values in the compact binary format of protocol version 2 to a buffer. All integers are stored in little-endian byte order.
+			*/
+			class CBinaryWriter
+			{
+			public:
+				void WriteUInt( const std::uint64_t& value, const size_t& numBytes );
+				void WriteInt( const int& value );
+				template <class T> void WriteReal( const T& value );
+				void WriteString( const std::string& value );
+				void WriteDateTime( const Utilities::CDateTime& dateTime );
+				const std::string& Data() const;
+			private:
+				std::string buffer;
+			};
+
+			/**	\ingroup Networking
+			*	Reads values in the compact binary format of protocol version 2 from a buffer
+			*/
+			class CBinaryReader
+			{
+			public:
+				CBinaryReader( const char* data, const size_t& dataLength );
+				std::uint64_t ReadUInt( const size_t& numBytes );
+				int ReadInt();
+				template <class T> T ReadReal();
+				std::string ReadString();
+				Utilities::CDateTime ReadDateTime();
+				bool IsAtEnd() const;
+			private:
+				void Require( const size_t& numBytes ) const;
+
+				const unsigned char* data;
+				size_t dataLength;
+				size_t position;
+			};
+
+			std::string EncodeFrame( const FrameType& frameType, const std::string& payload );
+			void DecodeFrameHeader( const std::array<unsigned char, frameHeaderSize>& header, FrameType& frameType, std::uint32_t& payloadLength );
+			std::string EncodeSequence( const Utilities::CSeqData& sequence );
+			void DecodeSequence( const char* data, const size_t& dataLength, Utilities::CSeqData& sequence );
+			template <class T> std::string EncodeSequence( const Utilities::CSeqDataComplete<T>& sequence );
+			template <class T> void DecodeSequence( const char* data, const size_t& dataLength, Utilities::CSeqDataComplete<T>& sequence );
+			std::string EncodeSubscription( const SlowSubscriberPolicy& policy, const std::vector<int>& codePrefix );
+			void DecodeSubscription( const char* data, const size_t& dataLength, SlowSubscriberPolicy& policy, std::vector<int>& codePrefix );
+		}
+	}
+}
+/*@}*/
+
+
+
+/**	@brief		Appends an unsigned integer
+*	@param		value					Value to be written
+*	@param		numBytes				Number of bytes used for storing the value (1 - 8)
+*	@return								None
+*	@exception							None
+*	@remarks							None
+*/
+inline void Networking::Session::Codec::CBinaryWriter::WriteUInt( const std::uint64_t& value, const size_t& numBytes )
+{
+	for ( size_t i = 0; i < numBytes; i++ ) {
+		buffer.push_back( static_cast<char>( ( value >> ( 8 * i ) ) & 0xFF ) );
+	}
+}
+
+
+
+/**	@brief		Appends a signed integer
+*	@param		value					Value to be written, it is stored with 4 bytes
+*	@return								None
+*	@exception							None
+*	@remarks							None
+*/
+inline void Networking::Session::Codec::CBinaryWriter::WriteInt( const int& value )
+{
+	WriteUInt( static_cast<std::uint32_t>( static_cast<std::int32_t>( value ) ), 4 );
+}
+
+
+
+/**	@brief		Appends a floating point number
+*	@param		value					Value to be written, it is stored in its IEEE-754 representation
+*	@return								None
+*	@exception							None
+*	@remarks							None
+*/
+template <class T> void Networking::Session::Codec::CBinaryWriter::WriteReal( const T& value )
+{
+	static_assert( std::is_floating_point<T>::value && ( ( sizeof( T ) == 4 ) || ( sizeof( T ) == 8 ) ), "no supported type" );
+
+	typename std::conditional< sizeof( T ) == 4, std::uint32_t, std::uint64_t >::type bits;
+	std::memcpy( &bits, &value, sizeof( T ) );
+	WriteUInt( bits, sizeof( T ) );
+}
+
+
+
+/**	@brief		Appends a string, it is preceded by its length
+*	@param		value					String to be written
+*	@return								None
+*	@exception	std::length_error		Thrown if the string is longer than the maximum frame length
+*	@remarks							None
+*/
+inline void Networking::Session::Codec::CBinaryWriter::WriteString( const std::string& value )
+{
+	if ( value.size() > maxFrameLength ) {
+		throw std::length_error( "The string is too long for the transmission." );
+	}
+
+	WriteUInt( value.size(), 4 );
+	buffer.append( value );
+}
+
+
+
+/**	@brief		Appends a date, invalid dates are marked by a flag
+*	@param		dateTime				Date to be written
+*	@return								None
+*	@exception							None
+*	@remarks							None
+*/
+inline void Networking::Session::Codec::CBinaryWriter::WriteDateTime( const Utilities::CDateTime& dateTime )
+{
+	WriteUInt( dateTime.IsValid(), 1 );
+	if ( dateTime.IsValid() ) {
+		WriteUInt( dateTime.Day(), 1 );
+		WriteUInt( dateTime.Month(), 1 );
+		WriteInt( dateTime.Year() );
+
+		WriteUInt( dateTime.TimeOfDay().Hour(), 1 );
+		WriteUInt( dateTime.TimeOfDay().Minute(), 1 );
+		WriteUInt( dateTime.TimeOfDay().Second(), 1 );
+		WriteUInt( dateTime.TimeOfDay().Millisec(), 2 );
+	}
+}
+
+
+
+/**	@brief		Obtains the written data
+*	@return								Buffer containing all data written so far
+*	@exception							None
+*	@remarks							None
+*/
+inline const std::string& Networking::Session::Codec::CBinaryWriter::Data() const
+{
+	return buffer;
+}
+
+
+
+/**	@brief		Constructor
+*	@param		data					Pointer to the beginning of the data to be read. The buffer must exist during the lifetime of the reader.
+*	@param		dataLength				Length of the data [bytes]
+*	@exception							None
+*	@remarks							None
+*/
+inline Networking::Session::Codec::CBinaryReader::CBinaryReader( const char* data, const size_t& dataLength )
+	: data( reinterpret_cast<const unsigned char*>( data ) ),
+	  dataLength( dataLength ),
+	  position( 0 )
+{
+}
+
+
+
+/**	@brief		Checks that the requested number of bytes is still available
+*	@param		numBytes				Number of bytes to be read
+*	@return								None
+*	@exception	std::length_error		Thrown if the data is too short
+*	@remarks							None
+*/
+inline void Networking::Session::Codec::CBinaryReader::Require( const size_t& numBytes ) const
+{
+	if ( numBytes > dataLength - position ) {
+		throw std::length_error( "Received data has wrong length." );
+	}
+}
+
+
+
+/**	@brief		Reads an unsigned integer
+*	@param		numBytes				Number of bytes used for storing the value (1 - 8)
+*	@return								Value read
+*	@exception	std::length_error		Thrown if the data is too short
+*	@remarks							None
+*/
+inline std::uint64_t Networking::Session::Codec::CBinaryReader::ReadUInt( const size_t& numBytes )
+{
+	std::uint64_t value = 0;
+
+	Require( numBytes );
+	for ( size_t i = 0; i < numBytes; i++ ) {
+		value |= static_cast<std::uint64_t>( data[position++] ) << ( 8 * i );
+	}
+
+	return value;
+}
+
+
+
+/**	@brief		Reads a signed integer stored with 4 bytes
+*	@return								Value read
+*	@exception	std::length_error		Thrown if the data is too short
+*	@remarks							None
+*/
+inline int Networking::Session::Codec::CBinaryReader::ReadInt()
+{
+	return static_cast<std::int32_t>( static_cast<std::uint32_t>( ReadUInt( 4 ) ) );
+}
+
+
+
+/**	@brief		Reads a floating point number
+*	@return								Value read
+*	@exception	std::length_error		Thrown if the data is too short
+*	@remarks							None
+*/
+template <class T> T Networking::Session::Codec::CBinaryReader::ReadReal()
+{
+	static_assert( std::is_floating_point<T>::value && ( ( sizeof( T ) == 4 ) || ( sizeof( T ) == 8 ) ), "no supported type" );
+
+	T value;
+	typename std::conditional< sizeof( T ) == 4, std::uint32_t, std::uint64_t >::type bits;
+	bits = static_cast<decltype( bits )>( ReadUInt( sizeof( T ) ) );
+	std::memcpy( &value, &bits, sizeof( T ) );
+
+	return value;
+}
+
+
+
+/**	@brief		Reads a string preceded by its length
+*	@return								String read
+*	@exception	std::length_error		Thrown if the data is too short
+*	@remarks							None
+*/
+inline std::string Networking::Session::Codec::CBinaryReader::ReadString()
+{
+	size_t length = static_cast<size_t>( ReadUInt( 4 ) );
+	Require( length );
+	std::string value( reinterpret_cast<const char*>( data + position ), length );
+	position += length;
+
+	return value;
+}
+
+
+
+/**	@brief		Reads a date
+*	@return								Date read, it is invalid if an invalid date was transmitted
+*	@exception	std::length_error		Thrown if the data is too short
+*	@exception	std::out_of_range		Thrown if the transmitted date is not valid
+*	@remarks							None
+*/
+inline Utilities::CDateTime Networking::Session::Codec::CBinaryReader::ReadDateTime()
+{
+	int day, month, year, hour, minute, second, millisec;
+
+	if ( ReadUInt( 1 ) == 0 ) {
+		return Utilities::CDateTime();
+	}
+
+	day = static_cast<int>( ReadUInt( 1 ) );
+	month = static_cast<int>( ReadUInt( 1 ) );
+	year = ReadInt();
+	hour = static_cast<int>( ReadUInt( 1 ) );
+	minute = static_cast<int>( ReadUInt( 1 ) );
+	second = static_cast<int>( ReadUInt( 1 ) );
+	millisec = static_cast<int>( ReadUInt( 2 ) );
+
+	return Utilities::CDateTime( day, month, year, Utilities::CTime( hour, minute, second, millisec ) );
+}
+
+
+
+/**	@brief		Checks if all data has been read
+*	@return								True if all data has been read, false otherwise
+*	@exception							None
+*	@remarks							None
+*/
+inline bool Networking::Session::Codec::CBinaryReader::IsAtEnd() const
+{
+	return ( position == dataLength );
+}
+
+
+
+/**	@brief		Generates a frame of protocol version 2
+*	@param		frameType				Type of the frame
+*	@param		payload					Payload of the frame, it may be empty
+*	@return								Frame consisting of the frame header followed by the payload
+*	@exception	std::length_error		Thrown if the payload is longer than the maximum frame length
+*	@remarks							None
+*/
+inline std::string Networking::Session::Codec::EncodeFrame( const FrameType& frameType, const std::string& payload )
+{
+	CBinaryWriter writer;
+
+	if ( payload.size() > maxFrameLength ) {
+		throw std::length_error( "The frame is too long for the transmission." );
+	}
+
+	writer.WriteUInt( frameType, 1 );
+	writer.WriteUInt( payload.size(), 4 );
+
+	return writer.Data() + payload;
+}
+
+
+
+/**	@brief		Decodes the header of a frame of protocol version 2
+*	@param		header					Frame header as received
+*	@param		frameType				Type of the frame
+*	@param		payloadLength			Length of the payload following the header [bytes]
+*	@return								None
+*	@exception	std::domain_error		Thrown if the frame type is unknown
+*	@exception	std::length_error		Thrown if the payload is longer than the maximum frame length
+*	@remarks							None
+*/
+inline void Networking::Session::Codec::DecodeFrameHeader( const std::array<unsigned char, frameHeaderSize>& header, FrameType& frameType, std::uint32_t& payloadLength )
+{
+	CBinaryReader reader( reinterpret_cast<const char*>( header.data() ), header.size() );
+
+	auto type = reader.ReadUInt( 1 );
+	if ( ( type != SEQUENCE_FRAME ) && ( type != HEARTBEAT_FRAME ) && ( type != SUBSCRIBE_FRAME ) && ( type != ACK_FRAME ) ) {
+		throw std::domain_error( "Unknown frame type." );
+	}
+	frameType = static_cast<FrameType>( type );
+
+	payloadLength = static_cast<std::uint32_t>( reader.ReadUInt( 4 ) );
+	if ( payloadLength > maxFrameLength ) {
+		throw std::length_error( "Received frame is too long." );
+	}
+}
+
+
+
+/**	@brief		Binary encoding of a sequence (based on CFMEAudioInput)
+*	@param		sequence				Sequence to be encoded
+*	@return								Encoded sequence
+*	@exception	std::length_error		Thrown if the sequence is too large for the transmission
+*	@remarks							None
+*/
+inline std::string Networking::Session::Codec::EncodeSequence( const Utilities::CSeqData& sequence )
+{
+	CBinaryWriter writer;
+
+	writer.WriteDateTime( sequence.GetStartTime() );
+	writer.WriteUInt( sequence.GetCode().size(), 4 );
+	for ( auto tone : sequence.GetCode() ) {
+		writer.WriteInt( tone );
+	}
+	writer.WriteString( sequence.GetInfoString() );
+
+	return writer.Data();
+}
+
+
+
+/**	@brief		Decoding of a binary encoded sequence (based on CFMEAudioInput)
+*	@param		data					Pointer to the beginning of the encoded sequence
+*	@param		dataLength				Length of the encoded sequence [bytes]
+*	@param		sequence				Decoded sequence
+*	@return								None
+*	@exception	std::length_error		Thrown if the length of the data does not match the encoded sequence
+*	@exception	std::out_of_range		Thrown if the encoded date is not valid
+*	@remarks							None
+*/
+inline void Networking::Session::Codec::DecodeSequence( const char* data, const size_t& dataLength, Utilities::CSeqData& sequence )
+{
+	CBinaryReader reader( data, dataLength );
+	std::vector<int> code;
+
+	auto startTime = reader.ReadDateTime();
+	auto numTones = reader.ReadUInt( 4 );
+	if ( numTones > dataLength ) {
+		throw std::length_error( "Received data has wrong length." );
+	}
+	for ( std::uint64_t i = 0; i < numTones; i++ ) {
+		code.push_back( reader.ReadInt() );
+	}
+	auto infoString = reader.ReadString();
+	if ( !reader.IsAtEnd() ) {
+		throw std::length_error( "Received data has wrong length." );
+	}
+
+	sequence.Set( startTime, code, infoString );
+}
+
+
+
+/**	@brief		Binary encoding of a sequence with the full tone information (based on CFMEAudioInputDebug)
+*	@param		sequence				Sequence to be encoded
+*	@return								Encoded sequence
+*	@exception	std::length_error		Thrown if the sequence is too large for the transmission
+*	@remarks							None
+*/
+template <class T> std::string Networking::Session::Codec::EncodeSequence( const Utilities::CSeqDataComplete<T>& sequence )
+{
+	CBinaryWriter writer;
+	std::vector<int> tones;
+	std::vector<T> toneLengths, tonePeriods, toneFrequencies, absToneLevels;
+
+	sequence.GetCodeData().Get( tones, toneLengths, tonePeriods, toneFrequencies, absToneLevels );
+
+	writer.WriteDateTime( sequence.GetStartTime() );
+	writer.WriteUInt( tones.size(), 4 );
+	for ( size_t i = 0; i < tones.size(); i++ ) {
+		writer.WriteInt( tones[i] );
+		writer.WriteReal( toneLengths[i] );
+		writer.WriteReal( tonePeriods[i] );
+		writer.WriteReal( toneFrequencies[i] );
+		writer.WriteReal( absToneLevels[i] );
+	}
+	writer.WriteString( sequence.GetInfoString() );
+
+	return writer.Data();
+}
+
+
+
+/**	@brief		Decoding of a binary encoded sequence with the full tone information (based on CFMEAudioInputDebug)
+*	@param		data					Pointer to the beginning of the encoded sequence
+*	@param		dataLength				Length of the encoded sequence [bytes]
+*	@param		sequence				Decoded sequence
+*	@return								None
+*	@exception	std::length_error		Thrown if the length of the data does not match the encoded sequence
+*	@exception	std::out_of_range		Thrown if the encoded date is not valid
+*	@remarks							None
+*/
+template <class T> void Networking::Session::Codec::DecodeSequence( const char* data, const size_t& dataLength, Utilities::CSeqDataComplete<T>& sequence )
+{
+	CBinaryReader reader( data, dataLength );
+	Utilities::CCodeData<T> codeData;
+	int tone;
+	T toneLength, tonePeriod, toneFrequency, absToneLevel;
+
+	auto startTime = reader.ReadDateTime();
+	auto numTones = reader.ReadUInt( 4 );
+	if ( numTones > dataLength ) {
+		throw std::length_error( "Received data has wrong length." );
+	}
+	for ( std::uint64_t i = 0; i < numTones; i++ ) {
+		tone = reader.ReadInt();
+		toneLength = reader.ReadReal<T>();
+		tonePeriod = reader.ReadReal<T>();
+		toneFrequency = reader.ReadReal<T>();
+		absToneLevel = reader.ReadReal<T>();
+		codeData.AddOneTone( tone, toneLength, tonePeriod, toneFrequency, absToneLevel );
+	}
+	auto infoString = reader.ReadString();
+	if ( !reader.IsAtEnd() ) {
+		throw std::length_error( "Received data has wrong length." );
+	}
+
+	sequence.Set( startTime, codeData, infoString );
+}
+
+
+
+/**	@brief		Binary encoding of a subscription request for the publishing server
+*	@param		policy					Behaviour of the server if the subscriber cannot keep up with the published sequences
+*	@param		codePrefix				Only sequences starting with these tones are delivered. If it is empty, all sequences are delivered.
+*	@return								Encoded subscription
+*	@exception							None
+*	@remarks							None
+*/
+inline std::string Networking::Session::Codec::EncodeSubscription( const SlowSubscriberPolicy& policy, const std::vector<int>& codePrefix )
+{
+	CBinaryWriter writer;
+
+	writer.WriteUInt( policy, 1 );
+	writer.WriteUInt( codePrefix.size(), 4 );
+	for ( auto tone : codePrefix ) {
+		writer.WriteInt( tone );
+	}
+
+	return writer.Data();
+}
+
+
+
+/**	@brief		Decoding of a binary encoded subscription request
+*	@param		data					Pointer to the beginning of the encoded subscription
+*	@param		dataLength				Length of the encoded subscription [bytes]
+*	@param		policy					Behaviour of the server if the subscriber cannot keep up with the published sequences
+*	@param		codePrefix				Only sequences starting with these tones are delivered. If it is empty, all sequences are delivered.
+*	@return								None
+*	@exception	std::length_error		Thrown if the length of the data does not match the encoded subscription
+*	@exception	std::domain_error		Thrown if the policy is unknown
+*	@remarks							None
+*/
+inline void Networking::Session::Codec::DecodeSubscription( const char* data, const size_t& dataLength, SlowSubscriberPolicy& policy, std::vector<int>& codePrefix )
+{
+	CBinaryReader reader( data, dataLength );
+
+	auto policyValue = reader.ReadUInt( 1 );
+	if ( ( policyValue != DROP_SEQUENCES ) && ( policyValue != DISCONNECT_SUBSCRIBER ) ) {
+		throw std::domain_error( "Unknown subscriber policy." );
+	}
+	policy = static_cast<SlowSubscriberPolicy>( policyValue );
+
+	auto numTones = reader.ReadUInt( 4 );
+	if ( numTones > dataLength ) {
+		throw std::length_error( "Received data has wrong length." );
+	}
+	codePrefix.clear();
+	for ( std::uint64_t i = 0; i < numTones; i++ ) {
+		codePrefix.push_back( reader.ReadInt() );
+	}
+	if ( !reader.IsAtEnd() ) {
+		throw std::length_error( "Received data has wrong length." );
+	}
+}
@@ -0,0 +1,641 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define NETWORKING_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define NETWORKING_API __declspec(dllexport)
+	#endif
+#endif
+
+#if defined _WIN32
+	#include "stdafx.h"
+#endif
+#include <algorithm>
+#include <stdexcept>
+#include "FMEPublisher.h"
+#include "FMEPublisherPrivImplementation.h"
+
+
+/**	@brief		Constructor
+*	@param		port								TCP port of the server. The server is listening on all network interfaces, both for IPv6 and IPv4.
+*	@param		ringCapacity						Number of sequences kept for the subscribers. A subscriber falling behind by more sequences is regarded as too slow.
+*	@exception	std::invalid_argument				Thrown if the ring capacity is zero
+*	@remarks										The server is only started by CFMEPublisher::Start()
+*/
+Networking::CFMEPublisher::CFMEPublisher( const unsigned short& port, const size_t& ringCapacity )
+{
+	if ( ringCapacity == 0 ) {
+		throw std::invalid_argument( "The ring capacity of the publishing server must be positive." );
+	}
+
+	privHandle = std::make_unique<FMEPublisherPrivImplementation>( port, ringCapacity );
+}
+
+
+
+/**	@brief		Destructor
+*/
+Networking::CFMEPublisher::~CFMEPublisher()
+{
+	Stop();
+}
+
+
+
+/**	@brief		Starts the server in a background thread
+*	@return											None
+*	@exception	std::logic_error					Thrown if the server is already running
+*	@exception	std::runtime_error					Thrown if the port could not be opened
+*	@remarks										All subscribers are served by this single thread
+*/
+void Networking::CFMEPublisher::Start()
+{
+	using boost::asio::ip::tcp;
+
+	std::lock_guard<std::mutex> lock( privHandle->threadMutex );
+	if ( privHandle->thread ) {
+		throw std::logic_error( "The publishing server is already running." );
+	}
+
+	try {
+		// listening on IPv6 and IPv4 with a single socket, only if IPv6 is not available on the system the server is restricted to IPv4
+		tcp::endpoint endpoint( tcp::v6(), privHandle->port );
+		boost::system::error_code openError;
+		privHandle->acceptor.open( endpoint.protocol(), openError );
+		if ( !openError ) {
+			privHandle->acceptor.set_option( boost::asio::ip::v6_only( false ), openError );
+		}
+		if ( openError ) {
+			privHandle->acceptor.close( openError );
+			endpoint = tcp::endpoint( tcp::v4(), privHandle->port );
+			privHandle->acceptor.open( endpoint.protocol() );
+		}
+		privHandle->acceptor.set_option( tcp::acceptor::reuse_address( true ) );
+		privHandle->acceptor.bind( endpoint );
+		privHandle->acceptor.listen();
+	} catch ( boost::system::system_error& e ) {
+		boost::system::error_code ignoredError;
+		privHandle->acceptor.close( ignoredError );
+		throw std::runtime_error( u8"Der Server zur Verteilung der Alarme kann nicht auf Port " + std::to_string( privHandle->port ) + u8" gestartet werden: " + e.what() );
+	}
+
+	privHandle->ioService.reset();
+	privHandle->StartAccept();
+	privHandle->StartHeartbeatTimer();
+
+	auto impl = privHandle.get();
+	privHandle->thread = std::make_unique<std::thread>( [impl]() {
+		try {
+			impl->ioService.run();
+		} catch ( std::exception& ) {
+			// a failure of the distribution must never affect the detection
+		}
+	} );
+}
+
+
+
+/**	@brief		Stops the server
+*	@return											None
+*	@exception										None
+*	@remarks										All subscribers are disconnected. Calling the method for a stopped server has no effect.
+*/
+void Networking::CFMEPublisher::Stop()
+{
+	std::lock_guard<std::mutex> lock( privHandle->threadMutex );
+	if ( !privHandle->thread ) {
+		return;
+	}
+
+	// the IO service finishes by itself after all connections are closed
+	auto impl = privHandle.get();
+	privHandle->ioService.post( [impl]() { impl->DisconnectAll(); } );
+	privHandle->thread->join();
+	privHandle->thread.reset();
+}
+
+
+
+/**	@brief		Returns if the server is running or not
+*	@return											True if the server is running, otherwise false
+*	@exception										None
+*	@remarks										None
+*/
+bool Networking::CFMEPublisher::IsRunning() const
+{
+	std::lock_guard<std::mutex> lock( privHandle->threadMutex );
+	return ( privHandle->thread != nullptr );
+}
+
+
+
+/**	@brief		Distributes a sequence to all subscribers
+*	@param		sequence							Detected sequence
+*	@return											None
+*	@exception	std::length_error					Thrown if the sequence is too large for the transmission
+*	@remarks										The method is thread-safe and returns immediately, the sequence is encoded only once for all subscribers. It has no effect if the server is not running.
+*/
+void Networking::CFMEPublisher::Publish( const Utilities::CSeqData& sequence )
+{
+	using namespace Session;
+
+	if ( !IsRunning() ) {
+		return;
+	}
+
+	auto frame = std::make_shared<const std::string>( Codec::EncodeFrame( Codec::SEQUENCE_FRAME, Codec::EncodeSequence( sequence ) ) );
+	auto code = sequence.GetCode();
+	auto impl = privHandle.get();
+	privHandle->ioService.post( [impl, code, frame]() { impl->AddSequence( code, frame ); } );
+}
+
+
+
+/**	@brief		Obtains the number of currently subscribed clients
+*	@return											Number of subscribers
+*	@exception										None
+*	@remarks										None
+*/
+size_t Networking::CFMEPublisher::GetNumSubscribers() const
+{
+	return privHandle->numSubscribers;
+}
+
+
+
+/**	@brief		Constructor
+*	@param		ioService							Boost ASIO IO service for the network connection
+*	@exception										None
+*	@remarks										None
+*/
+Networking::Publisher::CSubscriber::CSubscriber( boost::asio::io_service& ioService )
+	: socket( ioService ),
+	  policy( Session::Codec::DROP_SEQUENCES ),
+	  cursor( 0 ),
+	  lastActivityTime( std::chrono::steady_clock::now() ),
+	  isSubscribed( false ),
+	  isWriting( false )
+{
+}
+
+
+
+/**	@brief		Constructor
+*	@param		port								TCP port of the server
+*	@param		ringCapacity						Number of sequences kept for the subscribers
+*	@exception										None
+*	@remarks										None
+*/
+Networking::CFMEPublisher::FMEPublisherPrivImplementation::FMEPublisherPrivImplementation( const unsigned short& port, const size_t& ringCapacity )
+	: ioService(),
+	  acceptor( ioService ),
+	  heartbeatTimer( ioService ),
+	  port( port ),
+	  ring( ringCapacity ),
+	  nextIndex( 0 ),
+	  numSubscribers( 0 ),
+	  handshakeReply( std::make_shared<const std::string>( Session::handshakeID ) ),
+	  heartbeatFrame( std::make_shared<const std::string>( Session::Codec::EncodeFrame( Session::Codec::HEARTBEAT_FRAME, std::string() ) ) )
+{
+	using namespace Utilities::Metrics;
+
+	subscribersMetric = CMetricsRegistry::Instance().GetGauge( "personalfme_publisher_subscribers", "Number of clients subscribed to the detected sequences" );
+	droppedMetric = CMetricsRegistry::Instance().GetCounter( "personalfme_publisher_dropped_total", "Number of sequences not delivered to subscribers that were too slow" );
+	disconnectedMetric = CMetricsRegistry::Instance().GetCounter( "personalfme_publisher_disconnected_total", "Number of subscribers disconnected because they were too slow or not responding" );
+}
+
+
+
+/** @brief		Waiting for the next subscriber
+*	@return								None
+*	@exception							None
+*	@remarks							None
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::StartAccept()
+{
+	auto subscriber = std::make_shared<Publisher::CSubscriber>( ioService );
+	acceptor.async_accept( subscriber->socket, [this, subscriber]( const boost::system::error_code& error ) { HandleAccept( subscriber, error ); } );
+}
+
+
+
+/** @brief		Handler for the connection request of a new subscriber
+*	@param		subscriber				New subscriber
+*	@param		error					Error code from Boost ASIO library for the asynchronous accept operation
+*	@return								None
+*	@exception							None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The subscriber first has to send the preamble of protocol version 2.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::HandleAccept( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error )
+{
+	if ( error == boost::asio::error::operation_aborted ) {
+		return;
+	}
+
+	if ( !error ) {
+		subscribers.insert( subscriber );
+		subscriber->lastActivityTime = std::chrono::steady_clock::now();
+		subscriber->inboundData.resize( Session::handshakeID.size() );
+		boost::asio::async_read( subscriber->socket, boost::asio::buffer( subscriber->inboundData ), [this, subscriber]( const boost::system::error_code& error, size_t ) { HandleReadHandshake( subscriber, error ); } );
+	}
+
+	// wait for next subscriber
+	StartAccept();
+}
+
+
+
+/** @brief		Handler for the received preamble of a new subscriber
+*	@param		subscriber				Subscriber
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@exception							None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The subscriber is disconnected if it does not use protocol version 2.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::HandleReadHandshake( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error )
+{
+	if ( error || ( std::string( subscriber->inboundData.begin(), subscriber->inboundData.end() ) != Session::handshakeID ) ) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	boost::asio::async_read( subscriber->socket, boost::asio::buffer( subscriber->frameHeader ), [this, subscriber]( const boost::system::error_code& error, size_t ) { HandleReadSubscriptionHeader( subscriber, error ); } );
+}
+
+
+
+/** @brief		Handler for the received frame header of the subscription request
+*	@param		subscriber				Subscriber
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@exception							None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The subscriber is disconnected if the frame is not a valid subscription request.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::HandleReadSubscriptionHeader( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error )
+{
+	Session::Codec::FrameType frameType;
+	std::uint32_t payloadLength;
+
+	if ( error ) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	try {
+		Session::Codec::DecodeFrameHeader( subscriber->frameHeader, frameType, payloadLength );
+	} catch (...) {
+		Disconnect( subscriber );
+		return;
+	}
+	if ( ( frameType != Session::Codec::SUBSCRIBE_FRAME ) || ( payloadLength > Publisher::maxSubscriptionLength ) ) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	subscriber->inboundData.resize( payloadLength );
+	boost::asio::async_read( subscriber->socket, boost::asio::buffer( subscriber->inboundData ), [this, subscriber]( const boost::system::error_code& error, size_t ) { HandleReadSubscription( subscriber, error ); } );
+}
+
+
+
+/** @brief		Handler for the received subscription request
+*	@param		subscriber				Subscriber
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@exception							None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The subscription is confirmed by returning the preamble of protocol version 2,
+*										afterwards all sequences published from now on and matching the requested code prefix are delivered.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::HandleReadSubscription( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error )
+{
+	if ( error ) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	try {
+		Session::Codec::DecodeSubscription( subscriber->inboundData.data(), subscriber->inboundData.size(), subscriber->policy, subscriber->codePrefix );
+	} catch (...) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	subscriber->isSubscribed = true;
+	subscriber->cursor = nextIndex;
+	numSubscribers++;
+	subscribersMetric->Add( 1 );
+
+	subscriber->outboundFrames.push_back( handshakeReply );
+	StartWrite( subscriber );
+	StartReadFrame( subscriber );
+}
+
+
+
+/** @brief		Waiting for the next frame sent by a subscriber
+*	@param		subscriber				Subscriber
+*	@return								None
+*	@exception							None
+*	@remarks							The received frames are ignored, the pending read operation only detects closed connections
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::StartReadFrame( std::shared_ptr<Publisher::CSubscriber> subscriber )
+{
+	boost::asio::async_read( subscriber->socket, boost::asio::buffer( subscriber->frameHeader ), [this, subscriber]( const boost::system::error_code& error, size_t ) { HandleReadFrameHeader( subscriber, error ); } );
+}
+
+
+
+/** @brief		Handler for the received header of a frame sent by a subscriber
+*	@param		subscriber				Subscriber
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@exception							None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The subscriber is disconnected if the connection is closed or the frame is invalid.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::HandleReadFrameHeader( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error )
+{
+	Session::Codec::FrameType frameType;
+	std::uint32_t payloadLength;
+
+	if ( error ) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	try {
+		Session::Codec::DecodeFrameHeader( subscriber->frameHeader, frameType, payloadLength );
+	} catch (...) {
+		Disconnect( subscriber );
+		return;
+	}
+	if ( payloadLength > Publisher::maxSubscriptionLength ) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	subscriber->inboundData.resize( payloadLength );
+	boost::asio::async_read( subscriber->socket, boost::asio::buffer( subscriber->inboundData ), [this, subscriber]( const boost::system::error_code& error, size_t ) { HandleReadFrameData( subscriber, error ); } );
+}
+
+
+
+/** @brief		Handler for the received payload of a frame sent by a subscriber
+*	@param		subscriber				Subscriber
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@exception							None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The subscriber is disconnected if the connection is closed.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::HandleReadFrameData( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error )
+{
+	if ( error ) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	StartReadFrame( subscriber );
+}
+
+
+
+/** @brief		Stores a new sequence in the ring and starts its delivery to all subscribers
+*	@param		code					Code of the sequence, required for filtering
+*	@param		frame					Complete frame containing the encoded sequence
+*	@return								None
+*	@exception							None
+*	@remarks							The oldest sequence in the ring is overwritten
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::AddSequence( const std::vector<int>& code, std::shared_ptr<const std::string> frame )
+{
+	auto& entry = ring[ nextIndex % ring.size() ];
+	entry.code = code;
+	entry.frame = frame;
+	nextIndex++;
+
+	for ( auto it = subscribers.begin(); it != subscribers.end(); ) {
+		// the subscriber may be removed from the set during the delivery
+		auto subscriber = *it++;
+		Deliver( subscriber );
+	}
+}
+
+
+
+/** @brief		Sends the pending sequences to a subscriber
+*	@param		subscriber				Subscriber
+*	@return								None
+*	@exception							None
+*	@remarks							A subscriber overtaken by the ring either skips the overwritten sequences or it is disconnected, depending on its subscription.
+*										At most one write operation per subscriber is active, a slow subscriber therefore never delays the others.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::Deliver( std::shared_ptr<Publisher::CSubscriber> subscriber )
+{
+	if ( !subscriber->isSubscribed || !subscriber->socket.is_open() ) {
+		return;
+	}
+
+	// check if sequences for the subscriber have already been overwritten
+	std::uint64_t oldestIndex = ( nextIndex > ring.size() ) ? ( nextIndex - ring.size() ) : 0;
+	if ( subscriber->cursor < oldestIndex ) {
+		if ( subscriber->policy == Session::Codec::DISCONNECT_SUBSCRIBER ) {
+			disconnectedMetric->Increment();
+			Disconnect( subscriber );
+			return;
+		}
+		if ( !subscriber->isWriting ) {
+			droppedMetric->Increment( oldestIndex - subscriber->cursor );
+			subscriber->cursor = oldestIndex;
+		}
+	}
+
+	if ( subscriber->isWriting ) {
+		return;
+	}
+
+	while ( ( subscriber->cursor < nextIndex ) && ( subscriber->outboundFrames.size() < Publisher::maxFramesPerWrite ) ) {
+		const auto& entry = ring[ subscriber->cursor % ring.size() ];
+		subscriber->cursor++;
+		if ( IsMatching( entry.code, subscriber->codePrefix ) ) {
+			subscriber->outboundFrames.push_back( entry.frame );
+		}
+	}
+
+	if ( !subscriber->outboundFrames.empty() ) {
+		StartWrite( subscriber );
+	}
+}
+
+
+
+/** @brief		Sends all frames prepared for a subscriber with a single write operation
+*	@param		subscriber				Subscriber
+*	@return								None
+*	@exception							None
+*	@remarks							The frames are shared with the ring and the other subscribers, they are not copied
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::StartWrite( std::shared_ptr<Publisher::CSubscriber> subscriber )
+{
+	std::vector<boost::asio::const_buffer> buffers;
+
+	for ( const auto& frame : subscriber->outboundFrames ) {
+		buffers.push_back( boost::asio::buffer( *frame ) );
+	}
+
+	subscriber->isWriting = true;
+	subscriber->lastActivityTime = std::chrono::steady_clock::now();
+	boost::asio::async_write( subscriber->socket, buffers, [this, subscriber]( const boost::system::error_code& error, size_t ) { HandleWrite( subscriber, error ); } );
+}
+
+
+
+/** @brief		Handler for the finished write operation to a subscriber
+*	@param		subscriber				Subscriber
+*	@param		error					Error code from Boost ASIO library for the asynchronous write operation
+*	@return								None
+*	@exception							None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. Sequences published in the meantime are sent immediately.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::HandleWrite( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error )
+{
+	subscriber->isWriting = false;
+	subscriber->outboundFrames.clear();
+
+	if ( error ) {
+		Disconnect( subscriber );
+		return;
+	}
+
+	subscriber->lastActivityTime = std::chrono::steady_clock::now();
+	Deliver( subscriber );
+}
+
+
+
+/** @brief		Starts the timer for the periodic check of all connections
+*	@return								None
+*	@exception							None
+*	@remarks							None
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::StartHeartbeatTimer()
+{
+	heartbeatTimer.expires_from_now( boost::posix_time::seconds( Session::heartbeatInterval ) );
+	heartbeatTimer.async_wait( [this]( const boost::system::error_code& error ) { HandleHeartbeatTimer( error ); } );
+}
+
+
+
+/** @brief		Periodic check of all connections
+*	@param		error					Error code from Boost ASIO library for the asynchronous wait operation
+*	@return								None
+*	@exception							None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. Idle subscribers receive a heartbeat so that closed connections are detected.
+*										Connections that do not subscribe in time or whose write operation is stuck are closed.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::HandleHeartbeatTimer( const boost::system::error_code& error )
+{
+	using namespace std::chrono;
+
+	if ( error == boost::asio::error::operation_aborted ) {
+		return;
+	}
+
+	auto now = steady_clock::now();
+	for ( auto it = subscribers.begin(); it != subscribers.end(); ) {
+		// the subscriber may be removed from the set
+		auto subscriber = *it++;
+		auto idleTime = now - subscriber->lastActivityTime;
+
+		if ( !subscriber->isSubscribed ) {
+			if ( idleTime > seconds( Publisher::maxHandshakeTime ) ) {
+				Disconnect( subscriber );
+			}
+		} else if ( subscriber->isWriting ) {
+			if ( idleTime > seconds( Session::idleTimeout ) ) {
+				disconnectedMetric->Increment();
+				Disconnect( subscriber );
+			}
+		} else if ( idleTime >= seconds( Session::heartbeatInterval ) ) {
+			subscriber->outboundFrames.push_back( heartbeatFrame );
+			StartWrite( subscriber );
+		}
+	}
+
+	StartHeartbeatTimer();
+}
+
+
+
+/** @brief		Closes the connection to a subscriber
+*	@param		subscriber				Subscriber
+*	@return								None
+*	@exception							None
+*	@remarks							All pending operations of the subscriber are aborted. Calling the method for an already closed connection has no effect.
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::Disconnect( std::shared_ptr<Publisher::CSubscriber> subscriber )
+{
+	boost::system::error_code ignoredError;
+
+	if ( subscribers.erase( subscriber ) == 0 ) {
+		return;
+	}
+
+	if ( subscriber->isSubscribed ) {
+		numSubscribers--;
+		subscribersMetric->Add( -1 );
+	}
+
+	subscriber->socket.shutdown( boost::asio::ip::tcp::socket::shutdown_both, ignoredError );
+	subscriber->socket.close( ignoredError );
+}
+
+
+
+/** @brief		Closes all connections and stops waiting for new subscribers
+*	@return								None
+*	@exception							None
+*	@remarks							The IO service finishes after all aborted operations have been handled
+*/
+void Networking::CFMEPublisher::FMEPublisherPrivImplementation::DisconnectAll()
+{
+	boost::system::error_code ignoredError;
+
+	acceptor.close( ignoredError );
+	heartbeatTimer.cancel( ignoredError );
+	while ( !subscribers.empty() ) {
+		Disconnect( *subscribers.begin() );
+	}
+}
+
+
+
+/** @brief		Checks if a sequence is requested by a subscriber
+*	@param		code					Code of the sequence
+*	@param		codePrefix				Code prefix requested by the subscriber, an empty prefix matches all sequences
+*	@return								True if the code starts with the prefix, false otherwise
+*	@exception							None
+*	@remarks							None
+*/
+bool Networking::CFMEPublisher::FMEPublisherPrivImplementation::IsMatching( const std::vector<int>& code, const std::vector<int>& codePrefix )
+{
+	if ( codePrefix.size() > code.size() ) {
+		return false;
+	}
+
+	return std::equal( codePrefix.begin(), codePrefix.end(), code.begin() );
+}
@@ -0,0 +1,77 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+
+#include <string>
+#include <memory>
+#include "SeqData.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef NETWORKING_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define NETWORKING_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define NETWORKING_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define NETWORKING_API __attribute__ ((visibility ("default")))
+	#else
+		#define NETWORKING_API
+	#endif		
+#endif
+
+/*@{*/
+/** \ingroup Networking
+*/
+
+
+namespace Networking {
+	/**	\ingroup Networking
+	*	Server distributing the detected sequences to any number of subscribed clients (publish / subscribe mode of protocol version 2).
+	*	Every sequence is encoded only once and stored in a ring buffer shared by all subscribers, each subscriber reads it with its own cursor.
+	*	A subscriber that cannot keep up never delays the others: depending on its subscription, it loses the overwritten sequences or it is disconnected.
+	*/
+	class CFMEPublisher
+	{
+	public:
+		NETWORKING_API CFMEPublisher( const unsigned short& port, const size_t& ringCapacity = 256 );
+		NETWORKING_API ~CFMEPublisher();
+		NETWORKING_API void Start();
+		NETWORKING_API void Stop();
+		NETWORKING_API bool IsRunning() const;
+		NETWORKING_API void Publish( const Utilities::CSeqData& sequence );
+		NETWORKING_API size_t GetNumSubscribers() const;
+	protected:
+		class FMEPublisherPrivImplementation;
+		std::unique_ptr<FMEPublisherPrivImplementation> privHandle;
+	private:
+		CFMEPublisher( const CFMEPublisher& );					// prevent copying
+		CFMEPublisher& operator=( const CFMEPublisher& );		// prevent assignment
+	};
+}
+
+
+/*@}*/
@@ -0,0 +1,119 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+
+#include <set>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <boost/asio.hpp>
+#include "FMESession.h"
+#include "FMEFrameCodec.h"
+#include "MetricsRegistry.h"
+#include "FMEPublisher.h"
+
+/*@{*/
+/** \ingroup Networking
+*/
+
+namespace Networking {
+	namespace Publisher {
+		/** @param	maxFramesPerWrite		Maximum number of frames sent to a subscriber with a single write operation */
+		const size_t maxFramesPerWrite = 64;
+		/** @param	maxSubscriptionLength	Maximum accepted length of a subscription request or any other frame sent by a subscriber [bytes] */
+		const std::uint32_t maxSubscriptionLength = 1024;
+		/** @param	maxHandshakeTime		Time within which a new subscriber has to complete its subscription [s] */
+		const long maxHandshakeTime = 30;
+
+		/**	\ingroup Networking
+		*	Sequence stored in the ring buffer of the publishing server
+		*/
+		struct CRingEntry
+		{
+			std::vector<int> code;
+			std::shared_ptr<const std::string> frame;
+		};
+
+		/**	\ingroup Networking
+		*	State of the connection to a single subscriber. It is only accessed by the thread of the publishing server.
+		*/
+		struct CSubscriber
+		{
+			CSubscriber( boost::asio::io_service& ioService );
+
+			boost::asio::ip::tcp::socket socket;
+			std::vector<char> inboundData;
+			std::array< unsigned char, Session::Codec::frameHeaderSize > frameHeader;
+			Session::Codec::SlowSubscriberPolicy policy;
+			std::vector<int> codePrefix;
+			std::uint64_t cursor;
+			std::vector< std::shared_ptr<const std::string> > outboundFrames;
+			std::chrono::steady_clock::time_point lastActivityTime;
+			bool isSubscribed;
+			bool isWriting;
+		};
+	}
+}
+
+
+/**	\ingroup Networking
+*	Pimple idiom for hiding the private implementation details of CFMEPublisher
+*/
+class Networking::CFMEPublisher::FMEPublisherPrivImplementation
+{
+public:
+	FMEPublisherPrivImplementation( const unsigned short& port, const size_t& ringCapacity );
+	void StartAccept();
+	void HandleAccept( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error );
+	void HandleReadHandshake( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error );
+	void HandleReadSubscriptionHeader( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error );
+	void HandleReadSubscription( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error );
+	void StartReadFrame( std::shared_ptr<Publisher::CSubscriber> subscriber );
+	void HandleReadFrameHeader( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error );
+	void HandleReadFrameData( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error );
+	void AddSequence( const std::vector<int>& code, std::shared_ptr<const std::string> frame );
+	void Deliver( std::shared_ptr<Publisher::CSubscriber> subscriber );
+	void StartWrite( std::shared_ptr<Publisher::CSubscriber> subscriber );
+	void HandleWrite( std::shared_ptr<Publisher::CSubscriber> subscriber, const boost::system::error_code& error );
+	void StartHeartbeatTimer();
+	void HandleHeartbeatTimer( const boost::system::error_code& error );
+	void Disconnect( std::shared_ptr<Publisher::CSubscriber> subscriber );
+	void DisconnectAll();
+	static bool IsMatching( const std::vector<int>& code, const std::vector<int>& codePrefix );
+
+	boost::asio::io_service ioService;
+	boost::asio::ip::tcp::acceptor acceptor;
+	boost::asio::deadline_timer heartbeatTimer;
+	unsigned short port;
+	std::vector<Publisher::CRingEntry> ring;
+	std::uint64_t nextIndex;
+	std::set< std::shared_ptr<Publisher::CSubscriber> > subscribers;
+	std::atomic<size_t> numSubscribers;
+	std::shared_ptr<const std::string> handshakeReply;
+	std::shared_ptr<const std::string> heartbeatFrame;
+	std::shared_ptr<Utilities::Metrics::CGauge> subscribersMetric;
+	std::shared_ptr<Utilities::Metrics::CCounter> droppedMetric;
+	std::shared_ptr<Utilities::Metrics::CCounter> disconnectedMetric;
+	mutable std::mutex threadMutex;
+	std::unique_ptr<std::thread> thread;
+};
+
+/*@}*/
@@ -26,6 +26,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #if defined _WIN32
 	#include "stdafx.h"
 #endif
+#include <thread>
+#include <vector>
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include "FMEServer.h"
 #include "FMEServerPrivImplementation.h"
@@ -44,13 +47,14 @@ Networking::CFMEServer::CFMEServer(void)
 *	@param		address					Address of the server. Examples: "localhost", "192.168.233.23"
 *	@param		port					Number of server port
 *	@param		foundCallback			Name of the callback, which is called if the server received a new sequence. The new data is passed to this function.
+*	@param		numThreads				Number of threads handling the connections. If it is 0, one thread per processor core is used.
 *	@exception							See CFMEServer::Init
 *	@remarks							IPv4- as well as IPv6-addresses might be used
 */
-Networking::CFMEServer::CFMEServer(std::string address, unsigned short port, std::function< void(const Utilities::CSeqData&) > foundCallback)
+Networking::CFMEServer::CFMEServer(std::string address, unsigned short port, std::function< void(const Utilities::CSeqData&) > foundCallback, unsigned int numThreads)
 	: privHandle( new FMEServerPrivImplementation )
 {
-	Init( address, port, foundCallback );
+	Init( address, port, foundCallback, numThreads );
 }
 
 
@@ -59,15 +63,22 @@ Networking::CFMEServer::CFMEServer(std::string address, unsigned short port, std
 *	@param		address					Address of the server. Examples: "localhost", "192.168.233.23"
 *	@param		port					Number of server port
 *	@param		foundCallback			Name of the callback, which is called if the server received a new sequence. The new data is passed to this function.
+*	@param		numThreads				Number of threads handling the connections. If it is 0, one thread per processor core is used.
 *	@exception							Thrown if the preparation of the server in the network was failing
-*	@remarks							IPv4- as well as IPv6-addresses might be used
+*	@remarks							IPv4- as well as IPv6-addresses might be used. The callback is always executed by a single thread, it does not need to be thread-safe.
 */
-void Networking::CFMEServer::Init(std::string address, unsigned short port, std::function< void(const Utilities::CSeqData&) > foundCallback)
+void Networking::CFMEServer::Init(std::string address, unsigned short port, std::function< void(const Utilities::CSeqData&) > foundCallback, unsigned int numThreads)
 {
 	using boost::asio::ip::tcp;
 	
 	// initial settings
 	privHandle->foundCallback = foundCallback;
+	if ( numThreads == 0 ) {
+		numThreads = std::max( std::thread::hardware_concurrency(), 1u );
+	}
+	privHandle->numThreads = numThreads;
+	auto impl = privHandle.get();
+	privHandle->sessionManager->SetAcceptingCallback( [impl]() { return impl->IsAcceptingCallbacks(); } );
 	privHandle->ResetConnection();
 	try {
 		// prepare server for listening in the network
@@ -101,7 +112,9 @@ Networking::CFMEServer::FMEServerPrivImplementation::FMEServerPrivImplementation
 	  acceptor( ioService ),
 	  sessionManager( new Session::CFMESessionManager<float>() ),
 	  newConnection( new Session::CFMESession<float>( ioService, sessionManager, foundCallback ) ),
-	  isRunning( false )
+	  isRunning( false ),
+	  numThreads( 1 ),
+	  isQueueClosed( false )
 {
 	isInit = false;
 }
@@ -145,19 +158,20 @@ void Networking::CFMEServer::FMEServerPrivImplementation::HandleAccept(const boo
 */
 void Networking::CFMEServer::FMEServerPrivImplementation::ResetConnection(void)
 {
-	newConnection.reset( new Session::CFMESession<float>( ioService, sessionManager, foundCallback ) );
+	newConnection.reset( new Session::CFMESession<float>( ioService, sessionManager, GetQueuedCallback( foundCallback ) ) );
 }
 
 
 
 /** @brief		Executing the network connection.
 *	@return								None
-*	@exception	std::runtime_error		Thrown if neither the full constructor nor CFMEServer::Init() were used for initalizing the function or if the server aborted with an error
+*	@exception	std::runtime_error		Thrown if neither the full constructor nor CFMEServer::Init() were used for initalizing the function or if an error occured during the server processing
 *	@remarks							The network communication is only performed during calling this function. It will return after finishing all work.
+*										The calling thread is part of the thread pool. An error in a single connection does not stop the server, it is only reported after the server has finished.
 */
 void Networking::CFMEServer::Run(void)
 {
-	std::string errorMessage;
+	std::vector<std::thread> ioThreads;
 
 	{
 		std::lock_guard<std::mutex> isRunningLock( privHandle->isRunningMutex );
@@ -171,12 +185,28 @@ void Networking::CFMEServer::Run(void)
 		privHandle->isRunning = true;
 	}
 
+	{
+		std::lock_guard<std::mutex> callbackLock( privHandle->callbackMutex );
+		privHandle->isQueueClosed = false;
+	}
+	std::thread dispatcherThread( &FMEServerPrivImplementation::DispatchCallbacks, privHandle.get() );
+
 	// start network processing - it will return when the service has finished execution
-	try {
-		privHandle->ioService.run();
-	} catch ( std::exception& e ) {
-		errorMessage = e.what();
+	for ( unsigned int i = 1; i < privHandle->numThreads; i++ ) {
+		ioThreads.emplace_back( &FMEServerPrivImplementation::RunIOService, privHandle.get() );
 	}
+	privHandle->RunIOService();
+	for ( auto& ioThread : ioThreads ) {
+		ioThread.join();
+	}
+
+	// all sequences already received are still passed to the application
+	{
+		std::lock_guard<std::mutex> callbackLock( privHandle->callbackMutex );
+		privHandle->isQueueClosed = true;
+	}
+	privHandle->callbackAvailableCondition.notify_all();
+	dispatcherThread.join();
 
 	{
 		std::lock_guard<std::mutex> lock( privHandle->isRunningMutex );
@@ -187,10 +217,19 @@ void Networking::CFMEServer::Run(void)
 		privHandle->acceptor.close();
 		privHandle->sessionManager->StopAll();
 
+		// the connections are closed within their strands, the aborted operations are finished as well
+		privHandle->ioService.reset();
+		privHandle->ioService.poll();
+
 		// reset the network service in order to allow later recalls
 		privHandle->ioService.reset();
 
 		// handle potential errors that occured during the server processing
+		std::string errorMessage;
+		{
+			std::lock_guard<std::mutex> errorLock( privHandle->errorMutex );
+			errorMessage.swap( privHandle->errorMessage );
+		}
 		if ( !errorMessage.empty() ) {
 			throw std::runtime_error( errorMessage );
 		}
@@ -250,4 +289,86 @@ Networking::CFMEServer::FMEServerPrivImplementation::~FMEServerPrivImplementatio
 unsigned short Networking::CFMEServer::GetStandardPort(void)
 {
 	return Session::standardPort;
-}
\ No newline at end of file
+}
+
+
+
+/** @brief		Executing the IO service by a thread of the pool
+*	@return								None
+*	@exception							None
+*	@remarks							An exception thrown by a handler only finishes the affected connection, the thread continues to serve the other connections. The first error is stored for CFMEServer::Run().
+*/
+void Networking::CFMEServer::FMEServerPrivImplementation::RunIOService(void)
+{
+	for (;;) {
+		try {
+			ioService.run();
+			return;
+		} catch ( std::exception& e ) {
+			std::lock_guard<std::mutex> errorLock( errorMutex );
+			if ( errorMessage.empty() ) {
+				errorMessage = e.what();
+			}
+		}
+	}
+}
+
+
+
+/** @brief		Passing a received sequence to the dispatcher thread
+*	@param		callback				Call of the application callback with the received sequence
+*	@return								None
+*	@exception							None
+*	@remarks							The calling thread of the IO service is never blocked. The length of the queue is limited by CFMEServer::FMEServerPrivImplementation::IsAcceptingCallbacks().
+*/
+void Networking::CFMEServer::FMEServerPrivImplementation::EnqueueCallback(std::function< void(void) > callback)
+{
+	{
+		std::lock_guard<std::mutex> callbackLock( callbackMutex );
+		callbackQueue.push_back( std::move( callback ) );
+	}
+	callbackAvailableCondition.notify_one();
+}
+
+
+
+/** @brief		Checking if the connections may receive further sequences
+*	@return								True if the queue of the dispatcher thread has space, otherwise false
+*	@exception							None
+*	@remarks							If the queue is full, the connections pause reading until the application has processed older sequences. This delays receiving via TCP instead of losing sequences.
+*										As each connection receives at most one sequence after the check, the queue length exceeds the limit at most by the number of connections.
+*/
+bool Networking::CFMEServer::FMEServerPrivImplementation::IsAcceptingCallbacks(void)
+{
+	std::lock_guard<std::mutex> callbackLock( callbackMutex );
+	return ( callbackQueue.size() < maxCallbackQueueLength );
+}
+
+
+
+/** @brief		Executing the application callbacks for all received sequences
+*	@return								None
+*	@exception							None
+*	@remarks							This is the main function of the dispatcher thread. It finishes after the queue was closed and all remaining sequences were passed to the application.
+*										Exceptions of the application callback are ignored so that they cannot affect the receiving of further sequences.
+*/
+void Networking::CFMEServer::FMEServerPrivImplementation::DispatchCallbacks(void)
+{
+	for (;;) {
+		std::function< void(void) > callback;
+		{
+			std::unique_lock<std::mutex> callbackLock( callbackMutex );
+			callbackAvailableCondition.wait( callbackLock, [this]() { return ( !callbackQueue.empty() || isQueueClosed ); } );
+			if ( callbackQueue.empty() ) {
+				return;
+			}
+			callback = std::move( callbackQueue.front() );
+			callbackQueue.pop_front();
+		}
+
+		try {
+			callback();
+		} catch (...) {
+		}
+	}
+}
@@ -52,14 +52,15 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 namespace Networking {
 	/**	\ingroup Networking
 	*	Server for receiving FME sequences over the network for a client. This class corresponds to the output data of CFMEAudioInput
+	*	The connections are handled by a pool of threads, the received sequences are passed to the application by a single dispatcher thread in the order of their arrival.
 	*/
 	class CFMEServer
 	{
 	public:
 		NETWORKING_API CFMEServer(void);
-		NETWORKING_API CFMEServer(std::string address, unsigned short port, std::function< void(const Utilities::CSeqData&) > foundCallback);
+		NETWORKING_API CFMEServer(std::string address, unsigned short port, std::function< void(const Utilities::CSeqData&) > foundCallback, unsigned int numThreads = 0);
 		NETWORKING_API ~CFMEServer(void);
-		NETWORKING_API void Init(std::string address, unsigned short port, std::function< void(const Utilities::CSeqData&) > foundCallback);
+		NETWORKING_API void Init(std::string address, unsigned short port, std::function< void(const Utilities::CSeqData&) > foundCallback, unsigned int numThreads = 0);
 		NETWORKING_API void Run(void);
 		NETWORKING_API void Stop(void);
 		NETWORKING_API bool IsRunning(void);
@@ -58,13 +58,14 @@ Networking::CFMEServerDebug::CFMEServerDebug(void)
 *	@param		address					Address of the server. Examples: "localhost", "192.168.233.23"
 *	@param		port					Number of server port
 *	@param		foundCallback			Name of the callback, which is called if the server received a new sequence. The new data is passed to this function.
+*	@param		numThreads				Number of threads handling the connections. If it is 0, one thread per processor core is used.
 *	@exception							See CFMEClientDebug::Init
 *	@remarks							IPv4- as well as IPv6-addresses might be used
 */
-Networking::CFMEServerDebug::CFMEServerDebug(std::string address, unsigned short port, std::function< void(const Utilities::CSeqDataComplete<float>&) > foundCallback)
+Networking::CFMEServerDebug::CFMEServerDebug(std::string address, unsigned short port, std::function< void(const Utilities::CSeqDataComplete<float>&) > foundCallback, unsigned int numThreads)
 	: CFMEServer()
 {
-	Init( address, port, foundCallback );
+	Init( address, port, foundCallback, numThreads );
 }
 
 
@@ -73,10 +74,11 @@ Networking::CFMEServerDebug::CFMEServerDebug(std::string address, unsigned short
 *	@param		address					Address of the server. Examples: "localhost", "192.168.233.23"
 *	@param		port					Number of server port
 *	@param		foundCallback			Name of the callback, which is called if the server received a new sequence. The new data is passed to this function.
+*	@param		numThreads				Number of threads handling the connections. If it is 0, one thread per processor core is used.
 *	@exception							Thrown if the preparation of the server in the network was failing
 *	@remarks							IPv4- as well as IPv6-addresses might be used
 */
-void Networking::CFMEServerDebug::Init(std::string address, unsigned short port, std::function< void(const Utilities::CSeqDataComplete<float>&) > foundCallback)
+void Networking::CFMEServerDebug::Init(std::string address, unsigned short port, std::function< void(const Utilities::CSeqDataComplete<float>&) > foundCallback, unsigned int numThreads)
 {
 	// prepare pimpl idiom for derived class
 	privHandle.reset( new FMEServerPrivImplDebug( foundCallback ) );
@@ -84,7 +86,7 @@ void Networking::CFMEServerDebug::Init(std::string address, unsigned short port,
 	privHandle->sessionManager.reset( new Session::CFMESessionManagerDebug<float>() );
 
 	// initialize base class
-	CFMEServer::Init( address, port, dummyBaseServer );
+	CFMEServer::Init( address, port, dummyBaseServer, numThreads );
 }
 
 
@@ -117,5 +119,5 @@ Networking::CFMEServerDebug::~CFMEServerDebug(void)
 */
 void Networking::CFMEServerDebug::FMEServerPrivImplDebug::ResetConnection(void)
 {
-	newConnection.reset( new Session::CFMESessionDebug<float>( ioService, sessionManager, foundCallbackDebug ) );
+	newConnection.reset( new Session::CFMESessionDebug<float>( ioService, sessionManager, GetQueuedCallback( foundCallbackDebug ) ) );
 }
\ No newline at end of file
@@ -55,8 +55,8 @@ namespace Networking {
 	{
 	public:
 		NETWORKING_API CFMEServerDebug(void);
-		NETWORKING_API CFMEServerDebug(std::string address, unsigned short port, std::function< void(const Utilities::CSeqDataComplete<float>&) > foundCallback);
-		NETWORKING_API void Init(std::string address, unsigned short port, std::function< void(const Utilities::CSeqDataComplete<float>&) > foundCallback);
+		NETWORKING_API CFMEServerDebug(std::string address, unsigned short port, std::function< void(const Utilities::CSeqDataComplete<float>&) > foundCallback, unsigned int numThreads = 0);
+		NETWORKING_API void Init(std::string address, unsigned short port, std::function< void(const Utilities::CSeqDataComplete<float>&) > foundCallback, unsigned int numThreads = 0);
 		NETWORKING_API ~CFMEServerDebug(void);		
 			
 	protected:
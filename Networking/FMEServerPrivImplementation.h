@@ -17,6 +17,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #pragma once
 
 #include <mutex>
+#include <deque>
+#include <string>
+#include <condition_variable>
 #include <boost/asio.hpp>
 #include "FMESession.h"
 #include "FMESessionManager.h"
@@ -26,6 +29,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 /** \ingroup Networking
 */
 
+/** @param	maxCallbackQueueLength		Maximum number of received sequences waiting for being passed to the application. If it is reached, the connections pause reading. */
+const size_t maxCallbackQueueLength = 1024;
+
 /**	\ingroup Networking
 *	Pimple idiom for hiding the private implementation details of CFMEServer
 */
@@ -36,6 +42,11 @@ public:
 	virtual ~FMEServerPrivImplementation(void);
 	void HandleAccept(const boost::system::error_code& error);
 	virtual void ResetConnection(void);
+	void RunIOService(void);
+	void EnqueueCallback(std::function< void(void) > callback);
+	bool IsAcceptingCallbacks(void);
+	void DispatchCallbacks(void);
+	template <class S> std::function< void(const S&) > GetQueuedCallback(std::function< void(const S&) > callback);
 
 	std::function< void(const Utilities::CSeqData&) > foundCallback;
 	boost::asio::io_service ioService;
@@ -45,6 +56,28 @@ public:
 	std::mutex isRunningMutex;
 	bool isRunning;
 	bool isInit;
+	unsigned int numThreads;
+	std::mutex errorMutex;
+	std::string errorMessage;
+	std::mutex callbackMutex;
+	std::condition_variable callbackAvailableCondition;
+	std::deque< std::function< void(void) > > callbackQueue;
+	bool isQueueClosed;
 };
 
-/*@}*/
\ No newline at end of file
+/*@}*/
+
+
+
+/** @brief		Generates a callback for the sessions passing the received sequences to the application via the callback queue
+*	@param		callback				Callback of the application
+*	@return								Callback for the sessions
+*	@exception							None
+*	@remarks							The application callback is executed by the dispatcher thread, never by the threads of the IO service
+*/
+template <class S> std::function< void(const S&) > Networking::CFMEServer::FMEServerPrivImplementation::GetQueuedCallback(std::function< void(const S&) > callback)
+{
+	return [this, callback](const S& sequence) {
+		EnqueueCallback( [callback, sequence]() { callback( sequence ); } );
+	};
+}
@@ -16,9 +16,11 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 #pragma once
 
+#include <array>
 #include <vector>
 #include <memory>
 #include <string>
+#include <functional>
 #include <boost/asio.hpp>
 #include <boost/signals2.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -26,6 +28,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include "SerializableSeqData.h"
+#include "FMEFrameCodec.h"
 
 
 /*@{*/
@@ -36,11 +39,28 @@ namespace Networking {
 	namespace Session {
 		/** @param	baseHeaderID	Header string identifying the data format of the network transmission */
 		const std::string baseHeaderID  = " FME/1.0\r\n";
+		/** @param	handshakeID		Preamble by which a client requests protocol version 2, the server confirms it by returning the preamble. It cannot be confused with a header of version 1, which starts with the data length. */
+		const std::string handshakeID = "FME/2.0\r\n";
+		/** @param	handshakeTrailer	Sent by the client directly after the preamble. A server only supporting protocol version 1 reads both as an invalid header and closes the connection, this is the explicit reply for the client to fall back to version 1. */
+		const std::string handshakeTrailer = "0" + baseHeaderID;
+		/** @param	responseTimeout		Maximum time a client waits for the confirmation of protocol version 2, for the answer to a heartbeat or for the acknowledgement of a sequence [s] */
+		const long responseTimeout = 2;
+		/** @param	heartbeatInterval	Idle time of a connection of protocol version 2 after which the client checks it with a heartbeat before sending [s] */
+		const long heartbeatInterval = 30;
+		/** @param	idleTimeout		Time after which the server closes a connection of protocol version 2 without any received frame [s] */
+		const long idleTimeout = 300;
+		/** @param	backPressureInterval	Interval in which a server connection checks again if the application accepts further sequences before continuing to read [ms] */
+		const long backPressureInterval = 50;
 		/**	@param	bufferSize		Size of buffer used in network transmission */
 		const int bufferSize = 128;
 		/**	@param	standardPort	Standard port used for the protocol */
 		const unsigned short standardPort = 6351;
 
+		/**	\ingroup Networking
+		*	Results of a request of the client that is answered by a fixed response of the server
+		*/
+		enum RequestResult { RESPONSE_RECEIVED, CONNECTION_CLOSED, REQUEST_FAILED };
+
 		/**	\ingroup Networking
 		*	Predefinition of Session::CFMESessionManager class
 		*/
@@ -48,6 +68,10 @@ namespace Networking {
 
 		/**	\ingroup Networking
 		*	Class modelling the client-server network connection. It might be used as a client as well as a server.
+		*	Protocol version 1 transmits a single text-serialized sequence per connection. In protocol version 2 the connection stays open and carries binary frames (sequences and heartbeats),
+		*	it is used if the client requests it by a handshake and the server confirms it. Each sequence is acknowledged by the server. A server accepts both versions on the same port.
+		*	All handlers of a session are executed in its own strand, so that the IO service may be run by several threads.
+		*	A server connection only reads further data if the session manager accepts further sequences, otherwise the TCP flow control delays the client.
 		*/
 		template <class T> class CFMESession : public std::enable_shared_from_this<CFMESession<T>>
 		{
@@ -58,8 +82,29 @@ namespace Networking {
 			boost::asio::ip::tcp::socket& Socket(void);
 			void StartRead(void);
 			void StartWrite(const Utilities::CSeqData& newSequence);
+			void StartWriteAcknowledged(const Utilities::CSeqData& newSequence, std::function< void(bool) > acknowledgeCallback);
+			void StartHandshake(std::function< void(int) > handshakeCallback);
+			void StartHeartbeat(std::function< void(bool) > heartbeatCallback);
+			int GetProtocolVersion(void) const;
 			void Stop(void);
 		protected:
+			void Close(void);
+			void StartReadProtocol(void);
+			void WaitForCapacity(void);
+			void HandleWaitForCapacity(const boost::system::error_code& error);
+			void HandleReadProtocol(const boost::system::error_code& error);
+			void HandleReadHandshakeTrailer(const boost::system::error_code& error);
+			void HandleWriteHandshake(const boost::system::error_code& error);
+			void StartReadFrame(void);
+			void HandleReadFrameHeader(const boost::system::error_code& error);
+			void HandleReadFrameData(const boost::system::error_code& error);
+			void ProcessFrame(void);
+			void HandleWriteReply(const boost::system::error_code& error);
+			void HandleTimeout(const boost::system::error_code& error);
+			void StartRequest(const std::string& request, const std::string& expectedResponse, std::function< void(RequestResult) > requestCallback);
+			void HandleWriteRequest(const boost::system::error_code& error);
+			void HandleReadResponse(const boost::system::error_code& error);
+			void FinishRequest(RequestResult result);
 			void HandleReadHeader(const boost::system::error_code& error);
 			void HandleReadData(const boost::system::error_code& error, size_t bytesTransferred);
 			void HandleWrite(const boost::system::error_code& error);
@@ -69,6 +114,8 @@ namespace Networking {
 
 			std::string headerID;
 			std::unique_ptr< boost::asio::ip::tcp::socket > socket;
+			std::unique_ptr< boost::asio::deadline_timer > timer;
+			std::unique_ptr< boost::asio::io_service::strand > strand;
 			boost::asio::streambuf data;
 			std::vector< char > inboundData;
 			std::string outboundData;
@@ -77,6 +124,12 @@ namespace Networking {
   			boost::signals2::signal< void ( const Utilities::CSeqData& ) > foundSequenceSignal;
 			std::shared_ptr< CFMESessionManager<T> > sessionManager;
 			Utilities::CSeqData sequenceData;
+			int protocolVersion;
+			std::array< unsigned char, Codec::frameHeaderSize > frameHeader;
+			Codec::FrameType frameType;
+			std::string expectedResponse;
+			std::vector< char > response;
+			std::function< void(RequestResult) > requestCallback;
 			bool isInit;
 		};
 	}
@@ -92,7 +145,8 @@ namespace Networking {
 *	@remarks							None
 */
 template <class T> Networking::Session::CFMESession<T>::CFMESession(boost::asio::io_service& ioService, std::shared_ptr<CFMESessionManager<T>> manager, std::function< void(const Utilities::CSeqData&) > foundCallback)
-	: isInit( false )
+	: protocolVersion( 1 ),
+	  isInit( false )
 {
 	Init( ioService, manager, foundCallback );
 }
@@ -110,7 +164,10 @@ template <class T> Networking::Session::CFMESession<T>::CFMESession(boost::asio:
 template <class T> void Networking::Session::CFMESession<T>::Init(boost::asio::io_service& ioService, std::shared_ptr<CFMESessionManager<T>> manager, std::function< void(const Utilities::CSeqData&) > foundCallback)
 {
 	socket.reset( new boost::asio::ip::tcp::socket(ioService) );
+	timer.reset( new boost::asio::deadline_timer(ioService) );
+	strand.reset( new boost::asio::io_service::strand(ioService) );
 	sessionManager = manager;
+	protocolVersion = 1;
 
 	// connect callback function for received data
 	if ( isInit ) {
@@ -129,8 +186,8 @@ template <class T> void Networking::Session::CFMESession<T>::Init(boost::asio::i
 */
 template <class T> Networking::Session::CFMESession<T>::~CFMESession(void)
 {
-	// forcing a stop of the network connection
-	Stop();
+	// forcing a stop of the network connection (no handler can be running anymore)
+	Close();
 }
 
 
@@ -150,13 +207,28 @@ template <class T> boost::asio::ip::tcp::socket& Networking::Session::CFMESessio
 /** @brief		Stopping the network connection
 *	@return								None
 *	@exception							None
-*	@remarks							None
+*	@remarks							The connection is closed within the strand of the session, so that it cannot interfere with a running handler. Called from a handler of the session, it is closed immediately.
 */
 template <class T> void Networking::Session::CFMESession<T>::Stop(void)
 {
+	strand->dispatch( boost::bind( &CFMESession<T>::Close, this->shared_from_this() ) );
+}
+
+
+
+/** @brief		Closing the network connection
+*	@return								None
+*	@exception							None
+*	@remarks							All pending operations are aborted. It must only be called within the strand of the session or if no handler can be running anymore.
+*/
+template <class T> void Networking::Session::CFMESession<T>::Close(void)
+{
+	boost::system::error_code ignoredError;
+	timer->expires_at( boost::posix_time::pos_infin, ignoredError );
+
 	if ( socket->is_open() ) {
 		// stop the network connection
-		socket->close();
+		socket->close( ignoredError );
 	}
 }
 	
@@ -173,11 +245,400 @@ template <class T> void Networking::Session::CFMESession<T>::StartRead(void)
 		throw std::runtime_error("The object was not initialized before use!");
 	}
 
+	// Nagle algorithm is not required due to the small transmitted data size (a failure is detected by the following read operation)
+	boost::system::error_code ignoredError;
+	socket->set_option( boost::asio::ip::tcp::no_delay( true ), ignoredError );
+
+	StartReadProtocol();
+}
+
+
+
+/** @brief		Waiting for the beginning of the transmission of the client
+*	@return								None
+*	@remarks							Reading is delayed as long as the session manager does not accept further sequences
+*/
+template <class T> void Networking::Session::CFMESession<T>::StartReadProtocol(void)
+{
+	if ( !sessionManager->IsAccepting() ) {
+		WaitForCapacity();
+		return;
+	}
+
+	// the beginning of the transmission distinguishes a handshake of protocol version 2 from a header of version 1 (which is always longer)
+	boost::asio::async_read( *socket, data, boost::asio::transfer_exactly( handshakeID.size() ), strand->wrap( boost::bind( &CFMESession<T>::HandleReadProtocol, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+}
+
+
+
+/** @brief		Checking again after Session::backPressureInterval if the session manager accepts further sequences
+*	@return								None
+*	@remarks							Reading is not resumed for a stopped session
+*/
+template <class T> void Networking::Session::CFMESession<T>::WaitForCapacity(void)
+{
+	timer->expires_from_now( boost::posix_time::milliseconds( backPressureInterval ) );
+	timer->async_wait( strand->wrap( boost::bind( &CFMESession<T>::HandleWaitForCapacity, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+}
+
+
+
+/** @brief		Resuming reading if the session manager accepts further sequences, otherwise waiting again
+*	@param		error					Error code from Boost ASIO library for the asynchronous wait operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. A connection of protocol version 2 continues with the next frame, otherwise the transmission is started.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleWaitForCapacity(const boost::system::error_code& error)
+{
+	if ( ( error == boost::asio::error::operation_aborted ) || !socket->is_open() ) {
+		return;
+	}
+
+	if ( protocolVersion == 2 ) {
+		StartReadFrame();
+	} else {
+		StartReadProtocol();
+	}
+}
+
+
+
+/** @brief		Determining the protocol version requested by the client
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The session finishes itself in case of an error.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleReadProtocol(const boost::system::error_code& error)
+{
+	if ( error ) {
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	auto dataBegin = boost::asio::buffers_begin( data.data() );
+	if ( std::string( dataBegin, dataBegin + handshakeID.size() ) == handshakeID ) {
+		// the trailer of the handshake is only relevant for servers of protocol version 1
+		data.consume( handshakeID.size() );
+		boost::asio::async_read( *socket, data, boost::asio::transfer_exactly( handshakeTrailer.size() ), strand->wrap( boost::bind( &CFMESession<T>::HandleReadHandshakeTrailer, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+	} else {
+		// protocol version 1: read header (the data already read remains in the buffer and is considered by async_read_until)
+		boost::asio::async_read_until( *socket, data, headerID, strand->wrap( boost::bind( &CFMESession<T>::HandleReadHeader, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+	}
+}
+
+
+
+/** @brief		Confirming protocol version 2 to the client after the complete handshake was received
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The session finishes itself in case of an error or an invalid handshake.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleReadHandshakeTrailer(const boost::system::error_code& error)
+{
+	if ( error ) {
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	auto dataBegin = boost::asio::buffers_begin( data.data() );
+	if ( std::string( dataBegin, dataBegin + handshakeTrailer.size() ) != handshakeTrailer ) {
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+	data.consume( handshakeTrailer.size() );
+
+	protocolVersion = 2;
+	outboundData = handshakeID;
+	boost::asio::async_write( *socket, boost::asio::buffer( outboundData ), strand->wrap( boost::bind( &CFMESession<T>::HandleWriteHandshake, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+}
+
+
+
+/** @brief		Starting to receive frames after the confirmation of protocol version 2 was sent to the client
+*	@param		error					Error code from Boost ASIO library for the asynchronous write operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The session finishes itself in case of an error.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleWriteHandshake(const boost::system::error_code& error)
+{
+	if ( error ) {
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	StartReadFrame();
+}
+
+
+
+/** @brief		Waiting for the next frame of protocol version 2
+*	@return								None
+*	@remarks							The connection is closed if no frame arrives within Session::idleTimeout. Reading is delayed as long as the session manager does not accept further sequences.
+*/
+template <class T> void Networking::Session::CFMESession<T>::StartReadFrame(void)
+{
+	if ( !sessionManager->IsAccepting() ) {
+		WaitForCapacity();
+		return;
+	}
+
+	timer->expires_from_now( boost::posix_time::seconds( idleTimeout ) );
+	timer->async_wait( strand->wrap( boost::bind( &CFMESession<T>::HandleTimeout, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+
+	boost::asio::async_read( *socket, boost::asio::buffer( frameHeader ), strand->wrap( boost::bind( &CFMESession<T>::HandleReadFrameHeader, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+}
+
+
+
+/** @brief		Processing the header of a frame of protocol version 2
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The session finishes itself in case of an error or an invalid header.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleReadFrameHeader(const boost::system::error_code& error)
+{
+	std::uint32_t payloadLength;
+
+	if ( error ) {
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	try {
+		Codec::DecodeFrameHeader( frameHeader, frameType, payloadLength );
+	} catch (...) {
+		// header is not valid
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	inboundData.resize( payloadLength );
+	if ( payloadLength > 0 ) {
+		boost::asio::async_read( *socket, boost::asio::buffer( inboundData ), strand->wrap( boost::bind( &CFMESession<T>::HandleReadFrameData, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+	} else {
+		ProcessFrame();
+	}
+}
+
+
+
+/** @brief		Processing the payload of a frame of protocol version 2
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The session finishes itself in case of an error.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleReadFrameData(const boost::system::error_code& error)
+{
+	if ( error ) {
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	ProcessFrame();
+}
+
+
+
+/** @brief		Evaluating a completely received frame of protocol version 2 and waiting for the next one
+*	@return								None
+*	@remarks							Heartbeats are answered by a heartbeat, sequences by an acknowledgement after they were passed on. The session finishes itself if the frame data is invalid.
+*/
+template <class T> void Networking::Session::CFMESession<T>::ProcessFrame(void)
+{
+	if ( frameType == Codec::HEARTBEAT_FRAME ) {
+		outboundData = Codec::EncodeFrame( Codec::HEARTBEAT_FRAME, std::string() );
+		boost::asio::async_write( *socket, boost::asio::buffer( outboundData ), strand->wrap( boost::bind( &CFMESession<T>::HandleWriteReply, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+		return;
+	}
+
+	if ( frameType != Codec::SEQUENCE_FRAME ) {
+		// subscriptions are only accepted by the publishing server
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	try {
+		DecodeSequenceData( inboundData, inboundData.size() );
+	} catch (...) {
+		// data is not valid
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	// the client considers the sequence as sent only after the acknowledgement
+	outboundData = Codec::EncodeFrame( Codec::ACK_FRAME, std::string() );
+	boost::asio::async_write( *socket, boost::asio::buffer( outboundData ), strand->wrap( boost::bind( &CFMESession<T>::HandleWriteReply, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+}
+
+
+
+/** @brief		Continuing to receive frames after answering a heartbeat or acknowledging a sequence
+*	@param		error					Error code from Boost ASIO library for the asynchronous write operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. The session finishes itself in case of an error.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleWriteReply(const boost::system::error_code& error)
+{
+	if ( error ) {
+		sessionManager->Stop( this->shared_from_this() );
+		return;
+	}
+
+	StartReadFrame();
+}
+
+
+
+/** @brief		Closing the connection if the expected data did not arrive in time
+*	@param		error					Error code from Boost ASIO library for the asynchronous wait operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. Closing the socket aborts the pending operations, their handlers finish the session.
+*										The expiry time is checked because the handler might already have been queued when the timer was moved or cancelled.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleTimeout(const boost::system::error_code& error)
+{
+	if ( ( error != boost::asio::error::operation_aborted ) && ( timer->expires_at() <= boost::asio::deadline_timer::traits_type::now() ) ) {
+		boost::system::error_code ignoredError;
+		socket->close( ignoredError );
+	}
+}
+
+
+
+/** @brief		Requesting protocol version 2 from the server on the already established connection
+*	@param		handshakeCallback		Callback function called with the protocol version supported by the server: 2 if the server confirmed it, 1 if the server closed the connection as a server of protocol version 1 does
+*										and 0 if the result is unknown (no answer in time or any other connection failure)
+*	@return								None
+*	@exception	std::runtime_error		Thrown if the class was not fully initialized before calling this function
+*	@remarks							The network operations will not be started before io_service::run() is executed in the calling function
+*/
+template <class T> void Networking::Session::CFMESession<T>::StartHandshake(std::function< void(int) > handshakeCallback)
+{
+	if ( !isInit ) {
+		throw std::runtime_error("The object was not initialized before use!");
+	}
+
 	// Nagle algorithm is not required due to the small transmitted data size
-	socket->set_option( boost::asio::ip::tcp::no_delay( true ) ); 
+	socket->set_option( boost::asio::ip::tcp::no_delay( true ) );
+
+	auto self = this->shared_from_this();
+	StartRequest( handshakeID + handshakeTrailer, handshakeID, [self, handshakeCallback]( RequestResult result ) {
+		switch ( result ) {
+		case RESPONSE_RECEIVED:
+			self->protocolVersion = 2;
+			handshakeCallback( 2 );
+			break;
+		case CONNECTION_CLOSED:
+			handshakeCallback( 1 );
+			break;
+		default:
+			handshakeCallback( 0 );
+			break;
+		}
+	} );
+}
+
+
+
+/** @brief		Checking an idle connection of protocol version 2 by a heartbeat answered by the server
+*	@param		heartbeatCallback		Callback function called with true if the server answered the heartbeat and with false otherwise
+*	@return								None
+*	@exception	std::runtime_error		Thrown if the class was not fully initialized before calling this function
+*	@remarks							The network operations will not be started before io_service::run() is executed in the calling function
+*/
+template <class T> void Networking::Session::CFMESession<T>::StartHeartbeat(std::function< void(bool) > heartbeatCallback)
+{
+	if ( !isInit ) {
+		throw std::runtime_error("The object was not initialized before use!");
+	}
+
+	auto heartbeat = Codec::EncodeFrame( Codec::HEARTBEAT_FRAME, std::string() );
+	StartRequest( heartbeat, heartbeat, [heartbeatCallback]( RequestResult result ) { heartbeatCallback( result == RESPONSE_RECEIVED ); } );
+}
+
+
+
+/** @brief		Returning the protocol version used by the connection
+*	@return								Protocol version (1 or 2)
+*	@exception							None
+*	@remarks							None
+*/
+template <class T> int Networking::Session::CFMESession<T>::GetProtocolVersion(void) const
+{
+	return protocolVersion;
+}
+
+
+
+/** @brief		Sending a request to the server and waiting for its fixed response
+*	@param		request					Data sent to the server
+*	@param		expectedResponse		Response expected from the server
+*	@param		requestCallback			Callback function called with the result of the request. The expected response must arrive within Session::responseTimeout.
+*	@return								None
+*	@remarks							None
+*/
+template <class T> void Networking::Session::CFMESession<T>::StartRequest(const std::string& request, const std::string& expectedResponse, std::function< void(RequestResult) > requestCallback)
+{
+	outboundData = request;
+	CFMESession<T>::expectedResponse = expectedResponse;
+	CFMESession<T>::requestCallback = requestCallback;
+
+	timer->expires_from_now( boost::posix_time::seconds( responseTimeout ) );
+	timer->async_wait( strand->wrap( boost::bind( &CFMESession<T>::HandleTimeout, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+
+	boost::asio::async_write( *socket, boost::asio::buffer( outboundData ), strand->wrap( boost::bind( &CFMESession<T>::HandleWriteRequest, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+}
+
+
+
+/** @brief		Waiting for the response after the request was sent
+*	@param		error					Error code from Boost ASIO library for the asynchronous write operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations.
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleWriteRequest(const boost::system::error_code& error)
+{
+	if ( error ) {
+		FinishRequest( REQUEST_FAILED );
+		return;
+	}
+
+	response.resize( expectedResponse.size() );
+	boost::asio::async_read( *socket, boost::asio::buffer( response ), strand->wrap( boost::bind( &CFMESession<T>::HandleReadResponse, this->shared_from_this(), boost::asio::placeholders::error ) ) );
+}
+
+
+
+/** @brief		Checking the response of the server
+*	@param		error					Error code from Boost ASIO library for the asynchronous read operation
+*	@return								None
+*	@remarks							This is a handler for Boost ASIO asynchronous operations. A connection closed by the server is distinguished from other failures (a timeout closes the socket locally and aborts the operation).
+*/
+template <class T> void Networking::Session::CFMESession<T>::HandleReadResponse(const boost::system::error_code& error)
+{
+	if ( !error ) {
+		FinishRequest( ( std::string( response.begin(), response.end() ) == expectedResponse ) ? RESPONSE_RECEIVED : REQUEST_FAILED );
+	} else if ( ( error == boost::asio::error::eof ) || ( error == boost::asio::error::connection_reset ) ) {
+		FinishRequest( CONNECTION_CLOSED );
+	} else {
+		FinishRequest( REQUEST_FAILED );
+	}
+}
+
+
+
+/** @brief		Finishing a request and reporting its result
+*	@param		result					Result of the request
+*	@return								None
+*	@remarks							None
+*/
+template <class T> void Networking::Session::CFMESession<T>::FinishRequest(RequestResult result)
+{
+	timer->expires_at( boost::posix_time::pos_infin );
 
-	// read header (some part of the data section might also be read due to implementation of async_read_until)
-	boost::asio::async_read_until( *socket, data, headerID, boost::bind( &CFMESession<T>::HandleReadHeader, this, boost::asio::placeholders::error ) );
+	auto currRequestCallback = std::move( requestCallback );
+	requestCallback = nullptr;
+	currRequestCallback( result );
 }
 
 
@@ -228,7 +689,7 @@ template <class T> void Networking::Session::CFMESession<T>::HandleReadHeader(co
 		inboundData.insert( inboundData.end(), inString.begin(), inString.end() );
 		
 		// read missing data (with another buffer)
-		socket->async_read_some( boost::asio::buffer( buffer ), boost::bind( &CFMESession::HandleReadData, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred ) );
+		socket->async_read_some( boost::asio::buffer( buffer ), strand->wrap( boost::bind( &CFMESession<T>::HandleReadData, this->shared_from_this(), boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred ) ) );
 	} else {
 		// abort network connection
 		sessionManager->Stop( this->shared_from_this() );
@@ -250,7 +711,7 @@ template <class T> void Networking::Session::CFMESession<T>::HandleReadData(cons
 
 	if ( bytesTransferred > 0 ) {
 		// further data might be available from the network client
-		socket->async_read_some( boost::asio::buffer( buffer ), boost::bind( &CFMESession<T>::HandleReadData, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred) );
+		socket->async_read_some( boost::asio::buffer( buffer ), strand->wrap( boost::bind( &CFMESession<T>::HandleReadData, this->shared_from_this(), boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred) ) );
 	} else {
 		if ( inboundData.size() > 0 ) {
 			// decode sequence data and finally signal the information
@@ -277,17 +738,21 @@ template <class T> void Networking::Session::CFMESession<T>::HandleReadData(cons
 *	@param		inboundData				Buffer containing the serialized data
 *	@param		dataLength				Size of data buffer
 *	@return								None
-*	@remarks							The data is stored in the class member CFMESession<T>::sequenceData
+*	@remarks							The data is stored in the class member CFMESession<T>::sequenceData. The encoding depends on the protocol version.
 */
 template <class T> void Networking::Session::CFMESession<T>::DecodeSequenceData(std::vector<char>& inboundData, size_t dataLength)
 {
-	Utilities::CSerializableSeqData serializableSequenceData;
 	// decode sequence data
-	std::string archive_data( &inboundData[0], dataLength );
-	std::istringstream archive_stream( archive_data );
-	boost::archive::text_iarchive archive( archive_stream );
-	archive >> serializableSequenceData;
-	sequenceData = serializableSequenceData;
+	if ( protocolVersion == 2 ) {
+		Codec::DecodeSequence( inboundData.data(), dataLength, sequenceData );
+	} else {
+		Utilities::CSerializableSeqData serializableSequenceData;
+		std::string archive_data( &inboundData[0], dataLength );
+		std::istringstream archive_stream( archive_data );
+		boost::archive::text_iarchive archive( archive_stream );
+		archive >> serializableSequenceData;
+		sequenceData = serializableSequenceData;
+	}
 
 	// signal new received sequence
 	foundSequenceSignal( sequenceData );
@@ -315,9 +780,32 @@ template <class T> void Networking::Session::CFMESession<T>::StartWrite(const Ut
 
 
 
+/** @brief		Sending sequence data to the server on a connection of protocol version 2 and waiting for its acknowledgement
+*	@param		newSequence				Object containing the data of the sequence (from CFMEAudioInput)
+*	@param		acknowledgeCallback		Callback function called with true if the server acknowledged the sequence within Session::responseTimeout and with false otherwise
+*	@return								None
+*	@exception	std::runtime_error		Thrown if the class was not fully initialized before calling this function
+*	@exception	std::logic_error		Thrown if the connection does not use protocol version 2
+*	@remarks							The network operations will not be started before io_service::run() is executed in the calling function
+*/
+template <class T> void Networking::Session::CFMESession<T>::StartWriteAcknowledged(const Utilities::CSeqData& newSequence, std::function< void(bool) > acknowledgeCallback)
+{
+	if ( !isInit ) {
+		throw std::runtime_error("The object was not initialized before use!");
+	}
+	if ( protocolVersion != 2 ) {
+		throw std::logic_error( "Acknowledged sequences require protocol version 2." );
+	}
+
+	sequenceData = newSequence;
+	StartRequest( Codec::EncodeFrame( Codec::SEQUENCE_FRAME, EncodeSequenceData() ), Codec::EncodeFrame( Codec::ACK_FRAME, std::string() ), [acknowledgeCallback]( RequestResult result ) { acknowledgeCallback( result == RESPONSE_RECEIVED ); } );
+}
+
+
+
 /** @brief		Final preparation of sequence data sending to the server
 *	@return								None
-*	@remarks							None
+*	@remarks							Only used for protocol version 1, sequences of version 2 are sent by CFMESession::StartWriteAcknowledged
 */
 template <class T> void Networking::Session::CFMESession<T>::PerformWriting(void)
 {
@@ -340,19 +828,23 @@ template <class T> void Networking::Session::CFMESession<T>::PerformWriting(void
 	socket->set_option( ip::tcp::no_delay( true ) ); 
 	
 	// transfer the header section together with the data section to the server on the already established connection	
-	boost::asio::async_write( *socket, boost::asio::buffer( outboundData ), boost::asio::transfer_all(), boost::bind( &CFMESession::HandleWrite, this, boost::asio::placeholders::error ) );
+	boost::asio::async_write( *socket, boost::asio::buffer( outboundData ), boost::asio::transfer_all(), strand->wrap( boost::bind( &CFMESession<T>::HandleWrite, this->shared_from_this(), boost::asio::placeholders::error ) ) );
 }
 
 
 
 /** @brief		Serialize the data sequence (based on CFMEAudioInput)
 *	@return								Serialized data string
-*	@remarks							The data from the class member CFMESession<T>::sequenceData is serialized
+*	@remarks							The data from the class member CFMESession<T>::sequenceData is serialized. The encoding depends on the protocol version.
 */
 template <class T> std::string Networking::Session::CFMESession<T>::EncodeSequenceData()
 {
 	using namespace std;
 
+	if ( protocolVersion == 2 ) {
+		return Codec::EncodeSequence( sequenceData );
+	}
+
 	const Utilities::CSerializableSeqData constData( sequenceData ); // workaround for proper function of Boost Serialize
 	
 	// encode data sequence
@@ -115,12 +115,16 @@ template <class T> void Networking::Session::CFMESessionDebug<T>::StartWrite(con
 
 /** @brief		Serialize the data sequence (based on CFMEAudioInputDebug)
 *	@return								Serialized data string
-*	@remarks							The data from the class member CFMESession<T>::sequenceDataDebug is serialized
+*	@remarks							The data from the class member CFMESession<T>::sequenceDataDebug is serialized. The encoding depends on the protocol version.
 */
 template <class T> std::string Networking::Session::CFMESessionDebug<T>::EncodeSequenceData(void)
 {
 	using namespace std;
 
+	if ( this->protocolVersion == 2 ) {
+		return Codec::EncodeSequence( sequenceDataDebug );
+	}
+
 	const Utilities::CSerializableSeqDataComplete<T> constData( sequenceDataDebug ); // workaround for proper function of Boost Serialize
 	
 	// encode data sequence
@@ -137,18 +141,21 @@ template <class T> std::string Networking::Session::CFMESessionDebug<T>::EncodeS
 *	@param		inboundData				Buffer containing the serialized data
 *	@param		dataLength				Size of data buffer
 *	@return								None
-*	@remarks							The data is stored in the class member CFMESession<T>::sequenceDataDebug
+*	@remarks							The data is stored in the class member CFMESession<T>::sequenceDataDebug. The encoding depends on the protocol version.
 */
 template <class T> void Networking::Session::CFMESessionDebug<T>::DecodeSequenceData(std::vector<char>& inboundData, size_t dataLength)
 {
-	Utilities::CSerializableSeqDataComplete<T> serializableSequenceData;
-
 	// decode sequence data
-	std::string archive_data( &inboundData[0], dataLength );
-	std::istringstream archive_stream( archive_data );
-	boost::archive::text_iarchive archive( archive_stream );
-	archive >> serializableSequenceData;
-	sequenceDataDebug = serializableSequenceData;
+	if ( this->protocolVersion == 2 ) {
+		Codec::DecodeSequence( inboundData.data(), dataLength, sequenceDataDebug );
+	} else {
+		Utilities::CSerializableSeqDataComplete<T> serializableSequenceData;
+		std::string archive_data( &inboundData[0], dataLength );
+		std::istringstream archive_stream( archive_data );
+		boost::archive::text_iarchive archive( archive_stream );
+		archive >> serializableSequenceData;
+		sequenceDataDebug = serializableSequenceData;
+	}
 
 	// signal new received sequence
 	foundSequenceSignalDebug( sequenceDataDebug );
@@ -16,8 +16,10 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 #pragma once
 #include <set>
+#include <mutex>
 #include <algorithm>
 #include <memory>
+#include <functional>
 #include "FMESession.h"
 #include "SeqData.h"
 
@@ -29,7 +31,8 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 namespace Networking {
 	namespace Session {
 		/**	\ingroup Networking
-		*	Manages open connections so that they may be cleanly stopped when the server needs to shut down.
+		*	Manages open connections so that they may be cleanly stopped when the server needs to shut down. The connections may be started and stopped from several threads.
+		*	It also decides if the server connections may read further sequences.
 		*/
 		template <class T> class CFMESessionManager
 		{
@@ -39,8 +42,12 @@ namespace Networking {
 			void StartRead(std::shared_ptr<CFMESession<T>> newConnection);
 			void Stop(std::shared_ptr<CFMESession<T>> connection);
 			void StopAll(void);
+			void SetAcceptingCallback(std::function< bool(void) > acceptingCallback);
+			bool IsAccepting(void);
 		protected:
 			std::set< std::shared_ptr<CFMESession<T>> > connections;
+			std::mutex connectionsMutex;
+			std::function< bool(void) > isAccepting;
 		};
 	}
 }
@@ -58,7 +65,10 @@ namespace Networking {
 template <class T> void Networking::Session::CFMESessionManager<T>::StartWrite(std::shared_ptr<CFMESession<T>> newConnection, const Utilities::CSeqData& newSequence)
 {
 	// add connection
-	connections.insert( newConnection );
+	{
+		std::lock_guard<std::mutex> lock( connectionsMutex );
+		connections.insert( newConnection );
+	}
 
 	// start sending of sequence data
 	newConnection->StartWrite( newSequence );
@@ -75,7 +85,10 @@ template <class T> void Networking::Session::CFMESessionManager<T>::StartWrite(s
 template <class T> void Networking::Session::CFMESessionManager<T>::StartRead(std::shared_ptr<CFMESession<T>> newConnection)
 {
 	// add connection
-	connections.insert( newConnection );
+	{
+		std::lock_guard<std::mutex> lock( connectionsMutex );
+		connections.insert( newConnection );
+	}
 
 	// start receiving of sequence data
 	newConnection->StartRead();
@@ -92,7 +105,10 @@ template <class T> void Networking::Session::CFMESessionManager<T>::StartRead(st
 template <class T> void Networking::Session::CFMESessionManager<T>::Stop(std::shared_ptr<CFMESession<T>> connection)
 {
 	// remove the connection
-	connections.erase( connection );
+	{
+		std::lock_guard<std::mutex> lock( connectionsMutex );
+		connections.erase( connection );
+	}
 
 	// stop the network connection
 	connection->Stop();
@@ -107,11 +123,45 @@ template <class T> void Networking::Session::CFMESessionManager<T>::Stop(std::sh
 */
 template <class T> void Networking::Session::CFMESessionManager<T>::StopAll()
 {
+	std::set< std::shared_ptr<CFMESession<T>> > stoppedConnections;
+
+	// remove all connections
+	{
+		std::lock_guard<std::mutex> lock( connectionsMutex );
+		stoppedConnections.swap( connections );
+	}
+
 	// stop all connections
-	for ( auto it = connections.begin(); it != connections.end(); it++ ) {
+	for ( auto it = stoppedConnections.begin(); it != stoppedConnections.end(); it++ ) {
 		(*it)->Stop();
 	}
+}
 
-	// remove all connections
-	connections.clear();
+
+
+/**	@brief		Setting the function deciding if the server connections may read further sequences
+*	@param		acceptingCallback		Function returning false as long as no further sequences can be taken. It is called from the threads of the IO service and must be thread-safe.
+*	@return								None
+*	@exception							None
+*	@remarks							The function must be set before any connection is started. Without it, all sequences are accepted.
+*/
+template <class T> void Networking::Session::CFMESessionManager<T>::SetAcceptingCallback(std::function< bool(void) > acceptingCallback)
+{
+	isAccepting = acceptingCallback;
+}
+
+
+
+/**	@brief		Checking if the server connections may read further sequences
+*	@return								True if further sequences are accepted, otherwise false
+*	@exception							None
+*	@remarks							None
+*/
+template <class T> bool Networking::Session::CFMESessionManager<T>::IsAccepting(void)
+{
+	if ( !isAccepting ) {
+		return true;
+	}
+
+	return isAccepting();
 }
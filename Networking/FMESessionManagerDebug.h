@@ -51,7 +51,10 @@ namespace Networking {
 template <class T> void Networking::Session::CFMESessionManagerDebug<T>::StartWrite(std::shared_ptr<CFMESession<T>> newConnection, const Utilities::CSeqDataComplete<T>& newSequence)
 {
 	// add connection
-	this->connections.insert( newConnection );
+	{
+		std::lock_guard<std::mutex> lock( this->connectionsMutex );
+		this->connections.insert( newConnection );
+	}
 
 	// start sending of sequence data
 	std::dynamic_pointer_cast< CFMESessionDebug<T> >( newConnection )->StartWrite( newSequence );
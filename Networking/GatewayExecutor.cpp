@@ -0,0 +1,225 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define NETWORKING_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define NETWORKING_API __declspec(dllexport)
+	#endif
+#endif
+
+#if defined _WIN32
+	#include "stdafx.h"
+#endif
+#include <algorithm>
+#include "GatewayExecutor.h"
+
+
+namespace {
+	/**	@brief	Maximum number of worker threads for all gateway connections. The sending is I/O-bound, so this is independent of the number of processor cores. */
+	const unsigned int maxNumThreads = 4;
+
+	/**	@brief	Default time after which an idle worker thread is finished */
+	const std::chrono::seconds defaultMaxIdleTime( 60 );
+}
+
+
+std::weak_ptr<External::CGatewayExecutor> External::CGatewayExecutor::instance;
+std::mutex External::CGatewayExecutor::instanceMutex;
+
+
+
+/**	@brief		Access to the shared instance
+*	@return								Shared instance of the executor. It is created if it is not existing.
+*	@exception							None
+*	@remarks							The instance is destroyed (and all worker threads are joined) when the last reference is released
+*/
+std::shared_ptr<External::CGatewayExecutor> External::CGatewayExecutor::Instance()
+{
+	std::lock_guard<std::mutex> lock( instanceMutex );
+
+	auto executor = instance.lock();
+	if ( !executor ) {
+		executor.reset( new CGatewayExecutor() );
+		instance = executor;
+	}
+
+	return executor;
+}
+
+
+
+/**	@brief		Obtains the maximum number of worker threads
+*	@return								Maximum number of worker threads shared by all gateway connections
+*	@exception							None
+*	@remarks							None
+*/
+unsigned int External::CGatewayExecutor::GetMaxNumThreads()
+{
+	return maxNumThreads;
+}
+
+
+
+/**	@brief		Constructor
+*	@remarks							The constructor is private and can therefore only be used by CGatewayExecutor::Instance
+*/
+External::CGatewayExecutor::CGatewayExecutor()
+	: numIdleWorkers( 0 ),
+	  maxIdleTime( defaultMaxIdleTime ),
+	  isTerminateThreads( false )
+{
+}
+
+
+
+/**	@brief		Destructor
+*	@remarks							All submitted tasks are finished before the worker threads are joined
+*/
+External::CGatewayExecutor::~CGatewayExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lock( tasksMutex );
+		isTerminateThreads = true;
+	}
+	newTaskCondition.notify_all();
+
+	for ( auto& worker : workers ) {
+		worker.join();
+	}
+	JoinFinishedWorkers();
+}
+
+
+
+/**	@brief		Submits a task for asynchronous execution
+*	@param		task					Task to be executed. It has to handle all its exceptions by itself.
+*	@return								None
+*	@exception							None
+*	@remarks							The method never blocks for the execution. A new worker thread is only started if no idle worker is available and the maximum number is not yet reached.
+*/
+void External::CGatewayExecutor::Submit( std::function<void()> task )
+{
+	JoinFinishedWorkers();
+
+	{
+		std::lock_guard<std::mutex> lock( tasksMutex );
+		tasks.push_back( std::move( task ) );
+		if ( ( tasks.size() > numIdleWorkers ) && ( workers.size() < maxNumThreads ) ) {
+			numIdleWorkers++;
+			workers.emplace_back( &CGatewayExecutor::WorkerThread, this );
+		}
+	}
+	newTaskCondition.notify_one();
+}
+
+
+
+/**	@brief		Sets the time after which an idle worker thread is finished
+*	@param		maxIdleTime				Maximum idle time of a worker thread
+*	@return								None
+*	@exception							None
+*	@remarks							The new time is used by the worker threads after their next task or timeout
+*/
+void External::CGatewayExecutor::SetMaxIdleTime( const std::chrono::seconds& maxIdleTime )
+{
+	{
+		std::lock_guard<std::mutex> lock( tasksMutex );
+		this->maxIdleTime = maxIdleTime;
+	}
+	newTaskCondition.notify_all();
+}
+
+
+
+/**	@brief		Obtains the number of currently started worker threads
+*	@return								Number of worker threads
+*	@exception							None
+*	@remarks							Worker threads finished due to their idle time are not counted
+*/
+unsigned int External::CGatewayExecutor::GetNumThreads() const
+{
+	std::lock_guard<std::mutex> lock( tasksMutex );
+	return static_cast<unsigned int>( workers.size() );
+}
+
+
+
+/**	@brief		Joins the worker threads that have been finished due to their idle time
+*	@return								None
+*	@exception							None
+*	@remarks							The finished threads do not access the executor anymore, so joining them returns immediately
+*/
+void External::CGatewayExecutor::JoinFinishedWorkers()
+{
+	std::vector<std::thread> joinableWorkers;
+	{
+		std::lock_guard<std::mutex> lock( tasksMutex );
+		joinableWorkers.swap( finishedWorkers );
+	}
+
+	for ( auto& worker : joinableWorkers ) {
+		worker.join();
+	}
+}
+
+
+
+/**	@brief		Worker thread executing the submitted tasks
+*	@return								None
+*	@exception							None
+*	@remarks							The thread is finished if it has been idle for longer than the maximum idle time. It is then moved to the finished threads for being joined later.
+*/
+void External::CGatewayExecutor::WorkerThread()
+{
+	using namespace std;
+	function<void()> task;
+
+	unique_lock<mutex> lock( tasksMutex );
+	while ( true ) {
+		bool isTask = newTaskCondition.wait_for( lock, maxIdleTime, [this]() { return ( !tasks.empty() || isTerminateThreads ); } );
+		if ( isTerminateThreads && tasks.empty() ) {
+			break;
+		}
+		if ( !isTask ) {
+			// the idle thread is finished, the destructor does not need to join it anymore
+			auto worker = find_if( begin( workers ), end( workers ), []( const thread& worker ) { return ( worker.get_id() == this_thread::get_id() ); } );
+			if ( worker != end( workers ) ) {
+				finishedWorkers.push_back( move( *worker ) );
+				workers.erase( worker );
+			}
+			numIdleWorkers--;
+			break;
+		}
+
+		task = move( tasks.front() );
+		tasks.pop_front();
+		numIdleWorkers--;
+		lock.unlock();
+
+		try {
+			task();
+		} catch ( ... ) {
+			// the tasks are required to handle their exceptions themselves
+		}
+		task = nullptr;
+
+		lock.lock();
+		numIdleWorkers++;
+	}
+}
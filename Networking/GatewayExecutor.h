@@ -0,0 +1,89 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef NETWORKING_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define NETWORKING_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define NETWORKING_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define NETWORKING_API __attribute__ ((visibility ("default")))
+	#else
+		#define NETWORKING_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	/**	\ingroup Networking
+	*	Class implementing a bounded pool of worker threads shared by the connections of all alarm gateways.
+	*	The number of worker threads is limited by a small fixed number independent of the number of configured connections, further tasks are queued.
+	*	Worker threads are only started on demand and finished again after being idle for some time. The pool exists as long as it is referenced by at least one connection.
+	*/
+	class CGatewayExecutor
+	{
+	public:
+		NETWORKING_API static std::shared_ptr<CGatewayExecutor> Instance();
+		NETWORKING_API static unsigned int GetMaxNumThreads();
+		NETWORKING_API virtual ~CGatewayExecutor();
+		NETWORKING_API void Submit( std::function<void()> task );
+		NETWORKING_API void SetMaxIdleTime( const std::chrono::seconds& maxIdleTime );
+		NETWORKING_API unsigned int GetNumThreads() const;
+	private:
+		CGatewayExecutor(); // this enforces that no object can be created from the class - except in CGatewayExecutor::Instance
+		CGatewayExecutor( const CGatewayExecutor& ) = delete;
+		CGatewayExecutor& operator=( const CGatewayExecutor& ) = delete;
+		void WorkerThread();
+		void JoinFinishedWorkers();
+
+		static std::weak_ptr<CGatewayExecutor> instance;
+		static std::mutex instanceMutex;
+
+		std::deque< std::function<void()> > tasks;
+		std::vector<std::thread> workers;
+		std::vector<std::thread> finishedWorkers;
+		unsigned int numIdleWorkers;
+		std::chrono::seconds maxIdleTime;
+		bool isTerminateThreads;
+		mutable std::mutex tasksMutex;
+		std::condition_variable newTaskCondition;
+	};
+}
+/*@}*/
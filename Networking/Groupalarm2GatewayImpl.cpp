@@ -24,6 +24,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "Poco/Net/HTTPSessionFactory.h"
 #include "Poco/Net/HTTPSClientSession.h"
 #include "Poco/Net/NetException.h"
+#include "Poco/Net/SSLException.h"
 #include "BoostStdTimeConverter.h"
 #include "german_local_date_time.h"
 #include "StringUtilities.h"
@@ -32,6 +33,12 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "Groupalarm2GatewayImpl.h"
 
 
+namespace {
+	/**	@brief	Time after which the cached organization entities (labels, units, users, ...) are requested again from Groupalarm.com */
+	const std::chrono::minutes lookupTimeToLive( 5 );
+}
+
+
 std::string External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::ExtractErrorInfo(const Poco::Net::HTTPResponse& response, const std::string& responseBody) {
 	using namespace std;
 	using namespace Poco::JSON;
@@ -168,14 +175,30 @@ void External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::RaiseFo
 	}
 }
 
-std::string External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetJsonFromEndpoint(const std::string& subEndpoint, const CGroupalarm2LoginData& loginData, const std::string& organizationParam) {
+std::string External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::PerformRequest(Poco::Net::HTTPRequest& request, const std::string& requestBody, const Poco::URI& uri, const CGroupalarm2LoginData& loginData) {
+	using namespace std;
+	using namespace Poco::Net;
+
+	HTTPResponse response;
+	string responseBody = sessionPool->SendRequest(uri.getHost(), uri.getPort(), GetProxyConfig(loginData), request, requestBody, response);
+	RaiseForStatus(response, responseBody);
+
+	return responseBody;
+}
+
+std::string External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetJsonFromEndpoint(const std::string& subEndpoint, const CGroupalarm2LoginData& loginData, const std::string& organizationParam, const bool& isCacheAllowed, bool& isFromCache) {
 	using namespace std;
 	using namespace Poco;
 	using namespace Poco::Net;
 
+	string jsonResponseBody;
+	auto lookupKey = make_tuple(subEndpoint, organizationParam, loginData.GetOrganizationId(), loginData.GetApiToken());
+	if (isCacheAllowed && GetLookupCache().Get(lookupKey, jsonResponseBody)) {
+		isFromCache = true;
+		return jsonResponseBody;
+	}
+
 	URI uri(GROUPALARM_URI + "/" + subEndpoint);
-	HTTPSClientSession session(uri.getHost(), uri.getPort());
-	SetProxy(session, loginData);
 	uri.addQueryParameter(organizationParam, to_string(loginData.GetOrganizationId()));
 	if (subEndpoint != "scenarios") { // note: not supported for scenarios
 		uri.addQueryParameter("all", "true");
@@ -185,31 +208,37 @@ std::string External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::
 	HTTPRequest request(HTTPRequest::HTTP_GET, path, HTTPMessage::HTTP_1_1);
 	request.setContentType("application/json");
 	request.add("API-Token", loginData.GetApiToken());
-	session.sendRequest(request);
+	jsonResponseBody = PerformRequest(request, "", uri, loginData);
 
-	HTTPResponse response;
-	istream& responseStream = session.receiveResponse(response);
-	string jsonResponseBody(istreambuf_iterator<char>(responseStream), {});
-
-	RaiseForStatus(response, jsonResponseBody);
+	GetLookupCache().Put(lookupKey, jsonResponseBody);
+	isFromCache = false;
 
 	return jsonResponseBody;
 }
 
 std::vector<unsigned int> External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetEntityIdsFromEndpoint(const std::vector<std::string>& entityNames, const std::string& subEndpoint, const CGroupalarm2LoginData& loginData) {
-	std::string json = GetJsonFromEndpoint(subEndpoint, loginData, "organization");
 	std::string entry = "";
 	if (subEndpoint != "scenarios") { // note: not supported for scenarios
 		entry = subEndpoint;
 	}
-	auto entityIdMap = ParseResponseJson(json, entry);
-	return GetIdsForEntities(entityIdMap, entityNames, subEndpoint, loginData.GetOrganizationId());
+	return GetEntityIdsFromEndpoint(entityNames, subEndpoint, loginData, "organization", entry);
 }
 
 std::vector<unsigned int> External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetEntityIdsFromEndpoint(const std::vector<std::string>& entityNames, const std::string& subEndpoint, const CGroupalarm2LoginData& loginData, const std::string& organizationParam, const std::string& entry) {
-	std::string json = GetJsonFromEndpoint(subEndpoint, loginData, organizationParam);
-	auto entityIdMap = ParseResponseJson(json, entry);
-	return GetIdsForEntities(entityIdMap, entityNames, subEndpoint, loginData.GetOrganizationId());
+	bool isFromCache;
+	std::string json = GetJsonFromEndpoint(subEndpoint, loginData, organizationParam, true, isFromCache);
+	try {
+		return GetIdsForEntities(ParseResponseJson(json, entry), entityNames, subEndpoint, loginData.GetOrganizationId());
+	}
+	catch (const Exception::GroupalarmClientError&) {
+		if (!isFromCache) {
+			throw;
+		}
+
+		// the cached entities may be outdated if they have been changed in the organization in the meantime
+		json = GetJsonFromEndpoint(subEndpoint, loginData, organizationParam, false, isFromCache);
+		return GetIdsForEntities(ParseResponseJson(json, entry), entityNames, subEndpoint, loginData.GetOrganizationId());
+	}
 }
 
 std::vector<unsigned int> External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetIdsForUnits(const std::vector<std::string>& unitNames, const CGroupalarm2LoginData& loginData) {
@@ -221,9 +250,20 @@ std::vector<unsigned int> External::Groupalarm::CGroupalarm2Gateway::CGroupalarm
 }
 
 std::vector<unsigned int> External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetIdsForUsers(const std::vector<std::pair<std::string, std::string>>& userNames, const CGroupalarm2LoginData& loginData) {
-	std::string json = GetJsonFromEndpoint("users", loginData, "organization");
-	auto userIdMap = ParseResponseJsonForUsers(json);
-	return GetIdsForUsers(userIdMap, userNames, loginData.GetOrganizationId());
+	bool isFromCache;
+	std::string json = GetJsonFromEndpoint("users", loginData, "organization", true, isFromCache);
+	try {
+		return GetIdsForUsers(ParseResponseJsonForUsers(json), userNames, loginData.GetOrganizationId());
+	}
+	catch (const Exception::GroupalarmClientError&) {
+		if (!isFromCache) {
+			throw;
+		}
+
+		// the cached users may be outdated if they have been changed in the organization in the meantime
+		json = GetJsonFromEndpoint("users", loginData, "organization", false, isFromCache);
+		return GetIdsForUsers(ParseResponseJsonForUsers(json), userNames, loginData.GetOrganizationId());
+	}
 }
 
 std::vector<unsigned int> External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetIdsForScenarios(const std::vector<std::string>& scenarioNames, const CGroupalarm2LoginData& loginData) {
@@ -286,19 +326,23 @@ Poco::JSON::Object External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2Gatewa
 	return alarmResources;
 }
 
-void External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::SetProxy(Poco::Net::HTTPSClientSession& session, const CGroupalarm2LoginData& loginData) {
+Poco::Net::HTTPClientSession::ProxyConfig External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetProxyConfig(const CGroupalarm2LoginData& loginData) {
+	Poco::Net::HTTPClientSession::ProxyConfig proxyConfig;
+
 	if (loginData.IsWithProxy()) {
-		session.setProxyHost(loginData.GetProxyAddress());
-		session.setProxyPort(loginData.GetProxyPort());
+		proxyConfig.host = loginData.GetProxyAddress();
+		proxyConfig.port = loginData.GetProxyPort();
 
 		if (loginData.IsWithProxyWithUserNameAndPassword()) {
-			session.setProxyUsername(loginData.GetProxyUserName());
-			session.setProxyPassword(loginData.GetProxyPassword());
+			proxyConfig.username = loginData.GetProxyUserName();
+			proxyConfig.password = loginData.GetProxyPassword();
 		}
 		else if (loginData.IsWithProxyWithUserNameOnly()) {
-			session.setProxyUsername(loginData.GetProxyUserName());
+			proxyConfig.username = loginData.GetProxyUserName();
 		}
 	}
+
+	return proxyConfig;
 }
 
 Poco::JSON::Object External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetJsonPayload(const CGroupalarm2Message& message, const std::string& currIsoTime, const std::string& eventName, const std::string& otherMessagesInfo, const CGroupalarm2LoginData& loginData) {
@@ -380,9 +424,16 @@ Poco::JSON::Object External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2Gatewa
 }
 
 External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::CGroupalarm2GatewayImpl()
+	: sessionPool(External::CHTTPSSessionPool::Instance())
 {
 }
 
+External::CLookupCache<External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::LookupKey, std::string>& External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::GetLookupCache() {
+	// the cache is shared by all connections to Groupalarm.com
+	static CLookupCache<LookupKey, std::string> lookupCache(lookupTimeToLive);
+	return lookupCache;
+}
+
 void External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::PerformSend(const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const bool& isRealAlarm, std::unique_ptr<CGatewayLoginData> loginData, std::unique_ptr<CAlarmMessage> message, const Utilities::CMediaFile& audioFile) {
 	using namespace std;
 	using namespace Poco;
@@ -394,9 +445,6 @@ void External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::Perform
 	Poco::JSON::Object jsonPayload = CreateAlarmJson(code, alarmTime, isRealAlarm, move(message), groupalarmLoginData);
 
 	URI uri(GROUPALARM_URI + "/alarm");
-	HTTPSClientSession session(uri.getHost(), uri.getPort());
-	SetProxy(session, groupalarmLoginData);
-
 	string path(uri.getPathAndQuery());
 	if (isValidation) {
 		path += "/preview";
@@ -408,15 +456,10 @@ void External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::Perform
 
 	stringstream ss;
 	jsonPayload.stringify(ss);
-	request.setContentLength(ss.str().size());
-	ostream& outStream = session.sendRequest(request);
-	jsonPayload.stringify(outStream);
-
-	HTTPResponse response;
-	istream& responseStream = session.receiveResponse(response);
-	string responseBody(istreambuf_iterator<char>(responseStream), {});
+	string requestBody = ss.str();
+	request.setContentLength(requestBody.size());
 
-	RaiseForStatus(response, responseBody);
+	PerformRequest(request, requestBody, uri, groupalarmLoginData);
 }
 
 void External::Groupalarm::CGroupalarm2Gateway::CGroupalarm2GatewayImpl::Send(const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const bool& isRealAlarm, std::unique_ptr<CGatewayLoginData> loginData, std::unique_ptr<CAlarmMessage> message, const Utilities::CMediaFile& audioFile) {
@@ -16,9 +16,14 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 #pragma once
 
+#include <tuple>
 #include "Poco/JSON/Parser.h"
+#include "Poco/URI.h"
+#include "Poco/Net/HTTPRequest.h"
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPSClientSession.h"
+#include "HTTPSSessionPool.h"
+#include "LookupCache.h"
 #include "InfoalarmMessageDecorator.h"
 #include "EmailMessage.h"
 #include "ExternalProgramMessage.h"
@@ -37,9 +42,12 @@ public:
 	void Send(const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const bool& isRealAlarm, std::unique_ptr<CGatewayLoginData> loginData, std::unique_ptr<CAlarmMessage> message, const Utilities::CMediaFile& audioFile);
 
 private:
+	using LookupKey = std::tuple<std::string, std::string, unsigned int, std::string>;
+
 	const std::string GROUPALARM_URI = "https://app.groupalarm.com/api/v1";
 
-	void SetProxy(Poco::Net::HTTPSClientSession& session, const CGroupalarm2LoginData& loginData);
+	Poco::Net::HTTPClientSession::ProxyConfig GetProxyConfig(const CGroupalarm2LoginData& loginData);
+	std::string PerformRequest(Poco::Net::HTTPRequest& request, const std::string& requestBody, const Poco::URI& uri, const CGroupalarm2LoginData& loginData);
 	std::string ExtractErrorInfo(const Poco::Net::HTTPResponse& response, const std::string& responseBody);
 	std::map<std::string, unsigned int> ParseResponseJson(const std::string& json, const std::string& entry);
 	std::map<std::pair<std::string, std::string>, unsigned int> ParseResponseJsonForUsers(const std::string& json);
@@ -49,7 +57,7 @@ private:
 	Poco::JSON::Object CreateAlarmJson(const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const bool& isRealAlarm, std::unique_ptr<External::CAlarmMessage> message, const CGroupalarm2LoginData& loginData);
 	Poco::JSON::Object GetJsonPayload(const CGroupalarm2Message& message, const std::string& currIsoTime, const std::string& eventName, const std::string& otherMessagesInfo, const CGroupalarm2LoginData& loginData);
 	Poco::JSON::Object GetAlarmResources(const CGroupalarm2Message& message, const CGroupalarm2LoginData& loginData);
-	std::string GetJsonFromEndpoint(const std::string& subEndpoint, const CGroupalarm2LoginData& loginData, const std::string& organizationParam);
+	std::string GetJsonFromEndpoint(const std::string& subEndpoint, const CGroupalarm2LoginData& loginData, const std::string& organizationParam, const bool& isCacheAllowed, bool& isFromCache);
 	std::vector<unsigned int> GetEntityIdsFromEndpoint(const std::vector<std::string>& entityNames, const std::string& subEndpoint, const CGroupalarm2LoginData& loginData);
 	std::vector<unsigned int> GetEntityIdsFromEndpoint(const std::vector<std::string>& entityNames, const std::string& subEndpoint, const CGroupalarm2LoginData& loginData, const std::string& organizationParam, const std::string& entry);
 	std::vector<unsigned int> GetIdsForUnits(const std::vector<std::string>& unitNames, const CGroupalarm2LoginData& loginData);
@@ -63,5 +71,9 @@ private:
 	std::string CreateGroupalarmMessageInfo(const External::Groupalarm::CGroupalarm2Message& message);
 	std::string CreateExternalProgramMessageInfo(const External::ExternalProgram::CExternalProgramMessage& message);
 	void PerformSend(const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const bool& isRealAlarm, std::unique_ptr<CGatewayLoginData> loginData, std::unique_ptr<CAlarmMessage> message, const Utilities::CMediaFile& audioFile);
+
+	static CLookupCache<LookupKey, std::string>& GetLookupCache();
+
+	std::shared_ptr<External::CHTTPSSessionPool> sessionPool;
 };
 /*@}*/
\ No newline at end of file
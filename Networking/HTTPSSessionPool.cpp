@@ -0,0 +1,328 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define NETWORKING_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define NETWORKING_API __declspec(dllexport)
+	#endif
+#endif
+
+#if defined _WIN32
+	#include "stdafx.h"
+#endif
+#include <Poco/Exception.h>
+#include <Poco/Timespan.h>
+#include <Poco/Net/Socket.h>
+#include <Poco/Net/SSLManager.h>
+#include <Poco/Net/NetException.h>
+#include <Poco/Net/SSLException.h>
+#include "GatewayExecutor.h"
+#include "HTTPSSessionPool.h"
+
+
+namespace {
+	/**	@brief	Maximum time a session is kept idle in the pool. It is shorter than the keep-alive timeout of common web servers. */
+	const std::chrono::seconds maxIdleTime( 30 );
+}
+
+
+std::weak_ptr<External::CHTTPSSessionPool> External::CHTTPSSessionPool::instance;
+std::mutex External::CHTTPSSessionPool::instanceMutex;
+
+
+
+/**	@brief		Access to the shared instance
+*	@return								Shared instance of the session pool. It is created if it is not existing.
+*	@exception							None
+*	@remarks							The instance is destroyed (and all idle sessions are closed) when the last reference is released
+*/
+std::shared_ptr<External::CHTTPSSessionPool> External::CHTTPSSessionPool::Instance()
+{
+	std::lock_guard<std::mutex> lock( instanceMutex );
+
+	auto pool = instance.lock();
+	if ( !pool ) {
+		pool.reset( new CHTTPSSessionPool() );
+		instance = pool;
+	}
+
+	return pool;
+}
+
+
+
+/**	@brief		Constructor
+*	@remarks							The constructor is private and can therefore only be used by CHTTPSSessionPool::Instance
+*/
+External::CHTTPSSessionPool::CHTTPSSessionPool()
+{
+}
+
+
+
+/**	@brief		Obtains a session to the host, an idle session from the pool is preferred
+*	@param		host					Host name
+*	@param		port					Port of the host
+*	@param		proxyConfig				Proxy configuration of the session
+*	@return								Session to the host with keep-alive enabled. It is already connected if it is taken from the pool.
+*	@exception	Poco::Exception			Thrown if the default TLS context of the client is not available
+*	@remarks							The session should be returned by CHTTPSSessionPool::Release after the response has been completely read. In case of any errors, it should simply be destroyed.
+*/
+std::unique_ptr<Poco::Net::HTTPSClientSession> External::CHTTPSSessionPool::Acquire( const std::string& host, const unsigned short& port, const Poco::Net::HTTPClientSession::ProxyConfig& proxyConfig )
+{
+	using namespace std;
+
+	auto key = GetKey( host, port, proxyConfig );
+	auto currTime = chrono::steady_clock::now();
+
+	{
+		lock_guard<mutex> lock( poolMutex );
+		auto& sessions = idleSessions[key];
+		while ( !sessions.empty() ) {
+			// the most recently used session is the most likely one to be still alive
+			auto idleSession = move( sessions.back() );
+			sessions.pop_back();
+			if ( ( currTime - idleSession.idleSince < maxIdleTime ) && IsHealthy( *idleSession.session ) ) {
+				return move( idleSession.session );
+			}
+		}
+	}
+
+	return CreateSession( key, host, port, proxyConfig );
+}
+
+
+
+/**	@brief		Performs a complete request to the host via a session of the pool
+*	@param		host					Host name
+*	@param		port					Port of the host
+*	@param		proxyConfig				Proxy configuration of the session
+*	@param		request					Request to be sent
+*	@param		requestBody				Body of the request, it is empty if the request has no body
+*	@param		response				Response of the host
+*	@return								Body of the response
+*	@exception	Poco::Exception			Thrown in case of any connection errors
+*	@remarks							If a session from the pool has been closed by the host in the meantime, the request is transparently repeated once with a new session.
+*										This is only performed if the request has not been completely sent or if it is idempotent, otherwise the host might already have processed it (for example an alarm sent via POST).
+*										The session is returned to the pool after the response has been completely read.
+*/
+std::string External::CHTTPSSessionPool::SendRequest( const std::string& host, const unsigned short& port, const Poco::Net::HTTPClientSession::ProxyConfig& proxyConfig, Poco::Net::HTTPRequest& request, const std::string& requestBody, Poco::Net::HTTPResponse& response )
+{
+	using namespace std;
+	using namespace Poco::Net;
+
+	string responseBody;
+	auto session = Acquire( host, port, proxyConfig );
+	bool isReusedSession = session->connected();
+
+	while ( true ) {
+		bool isRequestSent = false;
+		try {
+			ostream& outStream = session->sendRequest( request );
+			outStream << requestBody;
+			if ( !outStream.flush() ) {
+				throw ConnectionResetException( "The request could not be sent completely." );
+			}
+			isRequestSent = true;
+
+			istream& responseStream = session->receiveResponse( response );
+			responseBody.assign( istreambuf_iterator<char>( responseStream ), {} );
+			break;
+		} catch ( const NoMessageException& ) {
+			// the pooled connection has been closed by the host - possibly only after the request was processed
+			if ( !IsRetryAllowed( isReusedSession, isRequestSent, request ) ) {
+				throw;
+			}
+		} catch ( const ConnectionResetException& ) {
+			if ( !IsRetryAllowed( isReusedSession, isRequestSent, request ) ) {
+				throw;
+			}
+		} catch ( const SSLConnectionUnexpectedlyClosedException& ) {
+			if ( !IsRetryAllowed( isReusedSession, isRequestSent, request ) ) {
+				throw;
+			}
+		}
+
+		// the only retry is performed with a new session, because the other idle sessions to the host are likely to be closed as well
+		session = CreateSession( GetKey( host, port, proxyConfig ), host, port, proxyConfig );
+		isReusedSession = false;
+	}
+
+	Release( move( session ) );
+
+	return responseBody;
+}
+
+
+
+/**	@brief		Creates a new session to the host
+*	@param		key						Key of the pool for the host and proxy configuration
+*	@param		host					Host name
+*	@param		port					Port of the host
+*	@param		proxyConfig				Proxy configuration of the session
+*	@return								New session to the host with keep-alive enabled. It resumes the last TLS session to the same host.
+*	@exception	Poco::Exception			Thrown if the default TLS context of the client is not available
+*	@remarks							None
+*/
+std::unique_ptr<Poco::Net::HTTPSClientSession> External::CHTTPSSessionPool::CreateSession( const SessionKey& key, const std::string& host, const unsigned short& port, const Poco::Net::HTTPClientSession::ProxyConfig& proxyConfig )
+{
+	using namespace std;
+	using namespace Poco::Net;
+
+	Context::Ptr context;
+	Session::Ptr tlsSession;
+
+	{
+		lock_guard<mutex> lock( poolMutex );
+		if ( tlsSessions.count( key ) > 0 ) {
+			tlsSession = tlsSessions[key];
+		}
+
+		// the default context is obtained only now because it is configured by the gateways
+		context = SSLManager::instance().defaultClientContext();
+		if ( !context->sessionCacheEnabled() ) {
+			context->enableSessionCache( true ); // required for resuming TLS sessions on the client side
+		}
+	}
+
+	auto session = make_unique<HTTPSClientSession>( host, port, context, tlsSession );
+	session->setProxyConfig( proxyConfig );
+	session->setKeepAlive( true );
+	session->setKeepAliveTimeout( Poco::Timespan( static_cast<long>( maxIdleTime.count() ), 0 ) );
+
+	return session;
+}
+
+
+
+/**	@brief		Returns a session to the pool after a completed request
+*	@param		session					Session that has been obtained by CHTTPSSessionPool::Acquire. The response needs to be completely read.
+*	@return								None
+*	@exception							None
+*	@remarks							Sessions that are not connected anymore are discarded. The TLS session is kept for resuming it with new sessions to the same host.
+*/
+void External::CHTTPSSessionPool::Release( std::unique_ptr<Poco::Net::HTTPSClientSession> session )
+{
+	using namespace std;
+
+	if ( !session ) {
+		return;
+	}
+
+	auto key = GetKey( session->getHost(), session->getPort(), session->getProxyConfig() );
+	Poco::Net::Session::Ptr tlsSession;
+	try {
+		tlsSession = session->sslSession();
+	} catch ( Poco::Exception& ) {
+		// no TLS session available for resumption
+	}
+
+	lock_guard<mutex> lock( poolMutex );
+	if ( tlsSession ) {
+		tlsSessions[key] = tlsSession;
+	}
+
+	// more idle sessions than worker threads sending in parallel are never required
+	auto& sessions = idleSessions[key];
+	if ( session->connected() && ( sessions.size() < CGatewayExecutor::GetMaxNumThreads() ) ) {
+		sessions.push_back( IdleSession{ move( session ), chrono::steady_clock::now() } );
+	}
+}
+
+
+
+/**	@brief		Obtains the number of idle sessions in the pool
+*	@return								Number of idle sessions for all hosts
+*	@exception							None
+*	@remarks							None
+*/
+unsigned int External::CHTTPSSessionPool::GetNumIdleSessions() const
+{
+	std::size_t numIdleSessions = 0;
+
+	std::lock_guard<std::mutex> lock( poolMutex );
+	for ( const auto& sessions : idleSessions ) {
+		numIdleSessions += sessions.second.size();
+	}
+
+	return static_cast<unsigned int>( numIdleSessions );
+}
+
+
+
+/**	@brief		Obtains the key of the pool for a host and proxy configuration
+*	@param		host					Host name
+*	@param		port					Port of the host
+*	@param		proxyConfig				Proxy configuration of the session
+*	@return								Key of the pool. Sessions are only shared for identical keys.
+*	@exception							None
+*	@remarks							None
+*/
+External::CHTTPSSessionPool::SessionKey External::CHTTPSSessionPool::GetKey( const std::string& host, const unsigned short& port, const Poco::Net::HTTPClientSession::ProxyConfig& proxyConfig )
+{
+	return std::make_tuple( host, port, proxyConfig.host, proxyConfig.port, proxyConfig.username, proxyConfig.password );
+}
+
+
+
+/**	@brief		Health check of an idle session
+*	@param		session					Idle session
+*	@return								True if the session can be reused, false otherwise
+*	@exception							None
+*	@remarks							An idle connection must not be readable, otherwise it has been closed by the server
+*/
+bool External::CHTTPSSessionPool::IsHealthy( Poco::Net::HTTPSClientSession& session )
+{
+	using namespace Poco::Net;
+
+	if ( !session.connected() ) {
+		return false;
+	}
+
+	try {
+		return !session.socket().poll( Poco::Timespan( 0 ), Socket::SELECT_READ | Socket::SELECT_ERROR );
+	} catch ( Poco::Exception& ) {
+		return false;
+	}
+}
+
+
+
+/**	@brief		Checks if a failed request may be repeated with a new session
+*	@param		isReusedSession			Flag stating if the failed session has been taken from the pool
+*	@param		isRequestSent			Flag stating if the request has been completely sent before the failure
+*	@param		request					Failed request
+*	@return								True if the request may be repeated, false otherwise
+*	@exception							None
+*	@remarks							A completely sent request might have been processed by the host, therefore only idempotent requests (RFC 7231) are repeated then
+*/
+bool External::CHTTPSSessionPool::IsRetryAllowed( const bool& isReusedSession, const bool& isRequestSent, const Poco::Net::HTTPRequest& request )
+{
+	using namespace Poco::Net;
+
+	if ( !isReusedSession ) {
+		return false;
+	}
+	if ( !isRequestSent ) {
+		return true;
+	}
+
+	const auto& method = request.getMethod();
+	return ( ( method == HTTPRequest::HTTP_GET ) || ( method == HTTPRequest::HTTP_HEAD ) || ( method == HTTPRequest::HTTP_PUT ) || ( method == HTTPRequest::HTTP_DELETE ) || ( method == HTTPRequest::HTTP_OPTIONS ) );
+}
@@ -0,0 +1,99 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <map>
+#include <vector>
+#include <tuple>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <Poco/Net/HTTPSClientSession.h>
+#include <Poco/Net/HTTPRequest.h>
+#include <Poco/Net/HTTPResponse.h>
+#include <Poco/Net/Session.h>
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef NETWORKING_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define NETWORKING_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define NETWORKING_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define NETWORKING_API __attribute__ ((visibility ("default")))
+	#else
+		#define NETWORKING_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	/**	\ingroup Networking
+	*	Class implementing a pool of persistent HTTPS sessions (keep-alive) shared by the connections of all alarm gateways.
+	*	Idle sessions are kept per host and proxy configuration, new sessions resume the last TLS session of the same host.
+	*	The pool exists as long as it is referenced by at least one gateway.
+	*/
+	class CHTTPSSessionPool
+	{
+	public:
+		NETWORKING_API static std::shared_ptr<CHTTPSSessionPool> Instance();
+		NETWORKING_API virtual ~CHTTPSSessionPool() {};
+		NETWORKING_API std::unique_ptr<Poco::Net::HTTPSClientSession> Acquire( const std::string& host, const unsigned short& port, const Poco::Net::HTTPClientSession::ProxyConfig& proxyConfig );
+		NETWORKING_API void Release( std::unique_ptr<Poco::Net::HTTPSClientSession> session );
+		NETWORKING_API std::string SendRequest( const std::string& host, const unsigned short& port, const Poco::Net::HTTPClientSession::ProxyConfig& proxyConfig, Poco::Net::HTTPRequest& request, const std::string& requestBody, Poco::Net::HTTPResponse& response );
+		NETWORKING_API unsigned int GetNumIdleSessions() const;
+	private:
+		using SessionKey = std::tuple<std::string, unsigned short, std::string, unsigned short, std::string, std::string>;
+
+		/**	\ingroup Networking
+		*	Structure containing an idle session of the pool
+		*/
+		struct IdleSession {
+			std::unique_ptr<Poco::Net::HTTPSClientSession> session;
+			std::chrono::steady_clock::time_point idleSince;
+		};
+
+		CHTTPSSessionPool(); // this enforces that no object can be created from the class - except in CHTTPSSessionPool::Instance
+		CHTTPSSessionPool( const CHTTPSSessionPool& ) = delete;
+		CHTTPSSessionPool& operator=( const CHTTPSSessionPool& ) = delete;
+		std::unique_ptr<Poco::Net::HTTPSClientSession> CreateSession( const SessionKey& key, const std::string& host, const unsigned short& port, const Poco::Net::HTTPClientSession::ProxyConfig& proxyConfig );
+		static SessionKey GetKey( const std::string& host, const unsigned short& port, const Poco::Net::HTTPClientSession::ProxyConfig& proxyConfig );
+		static bool IsHealthy( Poco::Net::HTTPSClientSession& session );
+		static bool IsRetryAllowed( const bool& isReusedSession, const bool& isRequestSent, const Poco::Net::HTTPRequest& request );
+
+		static std::weak_ptr<CHTTPSSessionPool> instance;
+		static std::mutex instanceMutex;
+
+		std::map< SessionKey, std::vector<IdleSession> > idleSessions;
+		std::map< SessionKey, Poco::Net::Session::Ptr > tlsSessions;
+		mutable std::mutex poolMutex;
+	};
+}
+/*@}*/
@@ -0,0 +1,148 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <map>
+#include <chrono>
+#include <mutex>
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	/**	\ingroup Networking
+	*	Thread-safe cache for the results of lookups at web services. Each entry expires after a fixed time-to-live.
+	*/
+	template <class Key, class Value>
+	class CLookupCache
+	{
+	public:
+		CLookupCache( const std::chrono::steady_clock::duration& timeToLive );
+		bool Get( const Key& key, Value& value );
+		void Put( const Key& key, const Value& value );
+		void Invalidate( const Key& key );
+		void Clear();
+	private:
+		/**	\ingroup Networking
+		*	Structure containing a cached value
+		*/
+		struct Entry {
+			Value value;
+			std::chrono::steady_clock::time_point expiryTime;
+		};
+
+		const std::chrono::steady_clock::duration timeToLive;
+		std::map<Key, Entry> entries;
+		std::mutex cacheMutex;
+	};
+}
+/*@}*/
+
+
+
+/**	@brief		Constructor
+*	@param		timeToLive				Time after which a cached value expires
+*	@remarks							None
+*/
+template <class Key, class Value>
+External::CLookupCache<Key, Value>::CLookupCache( const std::chrono::steady_clock::duration& timeToLive )
+	: timeToLive( timeToLive )
+{
+}
+
+
+
+/**	@brief		Obtains a cached value
+*	@param		key						Key of the value
+*	@param		value					Cached value if available, otherwise it is unchanged
+*	@return								True if a value has been found that is not yet expired, otherwise false
+*	@exception							None
+*	@remarks							Expired values are removed from the cache
+*/
+template <class Key, class Value>
+bool External::CLookupCache<Key, Value>::Get( const Key& key, Value& value )
+{
+	std::lock_guard<std::mutex> lock( cacheMutex );
+
+	auto entryIt = entries.find( key );
+	if ( entryIt == entries.end() ) {
+		return false;
+	}
+
+	if ( std::chrono::steady_clock::now() >= entryIt->second.expiryTime ) {
+		entries.erase( entryIt );
+		return false;
+	}
+
+	value = entryIt->second.value;
+	return true;
+}
+
+
+
+/**	@brief		Stores a value in the cache
+*	@param		key						Key of the value
+*	@param		value					Value to be cached. An existing value for the key is replaced.
+*	@return								None
+*	@exception							None
+*	@remarks							All expired values are removed from the cache, this limits its size
+*/
+template <class Key, class Value>
+void External::CLookupCache<Key, Value>::Put( const Key& key, const Value& value )
+{
+	auto currTime = std::chrono::steady_clock::now();
+
+	std::lock_guard<std::mutex> lock( cacheMutex );
+	for ( auto entryIt = entries.begin(); entryIt != entries.end(); ) {
+		if ( currTime >= entryIt->second.expiryTime ) {
+			entryIt = entries.erase( entryIt );
+		} else {
+			entryIt++;
+		}
+	}
+
+	entries[key] = Entry{ value, currTime + timeToLive };
+}
+
+
+
+/**	@brief		Removes a value from the cache
+*	@param		key						Key of the value
+*	@return								None
+*	@exception							None
+*	@remarks							Nothing is done if the value is not cached
+*/
+template <class Key, class Value>
+void External::CLookupCache<Key, Value>::Invalidate( const Key& key )
+{
+	std::lock_guard<std::mutex> lock( cacheMutex );
+	entries.erase( key );
+}
+
+
+
+/**	@brief		Removes all values from the cache
+*	@return								None
+*	@exception							None
+*	@remarks							None
+*/
+template <class Key, class Value>
+void External::CLookupCache<Key, Value>::Clear()
+{
+	std::lock_guard<std::mutex> lock( cacheMutex );
+	entries.clear();
+}
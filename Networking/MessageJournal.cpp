@@ -0,0 +1,669 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define NETWORKING_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define NETWORKING_API __declspec(dllexport)
+	#endif
+#endif
+
+#if defined _WIN32
+	#include "stdafx.h"
+	#include <io.h>
+#else
+	#include <unistd.h>
+	#include <sys/types.h>
+#endif
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <boost/crc.hpp>
+#include "MessageJournal.h"
+
+
+namespace {
+	/**	@brief	Types of the journal records */
+	enum RecordType : std::uint8_t { ENQUEUED = 1, DISPATCHED = 2, RETRY = 3, COMPLETED = 4 };
+
+	/**	@brief	Minimum number of records in the journal file before a compaction is considered */
+	const unsigned int minRecordsForCompaction = 256;
+
+	/**	@brief	Compaction is performed if the journal file contains more records than this factor times the number of pending messages */
+	const unsigned int compactionFactor = 4;
+
+	/**	@brief	Size of the record header (payload length) and trailer (checksum) */
+	const size_t recordFrameSize = 2 * sizeof( std::uint32_t );
+
+	/**	@brief	Size of the smallest possible record payload (type and message ID) */
+	const size_t minPayloadSize = sizeof( std::uint8_t ) + sizeof( std::uint64_t );
+
+
+
+	/**	@brief		Appends an integer value in little-endian byte order to a binary buffer
+	*	@param		buffer					Buffer to be extended
+	*	@param		value					Value to be appended
+	*	@return								None
+	*	@exception							None
+	*	@remarks							None
+	*/
+	template <class T> void AppendInteger( std::string& buffer, const T& value )
+	{
+		for ( size_t i = 0; i < sizeof( T ); i++ ) {
+			buffer.push_back( static_cast<char>( ( static_cast<std::uint64_t>( value ) >> ( 8 * i ) ) & 0xFF ) );
+		}
+	}
+
+
+
+	/**	@brief		Reads an integer value in little-endian byte order from a binary buffer
+	*	@param		buffer					Buffer to be read
+	*	@param		pos						Reading position. It is advanced behind the value after the call.
+	*	@return								Read value
+	*	@exception	std::out_of_range		Thrown if the buffer is too short
+	*	@remarks							None
+	*/
+	template <class T> T ReadInteger( const std::string& buffer, size_t& pos )
+	{
+		std::uint64_t value = 0;
+
+		if ( pos + sizeof( T ) > buffer.size() ) {
+			throw std::out_of_range( "journal record is truncated" );
+		}
+		for ( size_t i = 0; i < sizeof( T ); i++ ) {
+			value |= static_cast<std::uint64_t>( static_cast<unsigned char>( buffer[pos + i] ) ) << ( 8 * i );
+		}
+		pos += sizeof( T );
+
+		return static_cast<T>( value );
+	}
+
+
+
+	/**	@brief		Appends a string with a length prefix to a binary buffer
+	*	@param		buffer					Buffer to be extended
+	*	@param		text					String to be appended
+	*	@return								None
+	*	@exception	std::length_error		Thrown if the string is too long
+	*	@remarks							None
+	*/
+	void AppendString( std::string& buffer, const std::string& text )
+	{
+		if ( text.size() > UINT16_MAX ) {
+			throw std::length_error( "journal string is too long" );
+		}
+		AppendInteger( buffer, static_cast<std::uint16_t>( text.size() ) );
+		buffer += text;
+	}
+
+
+
+	/**	@brief		Reads a string with a length prefix from a binary buffer
+	*	@param		buffer					Buffer to be read
+	*	@param		pos						Reading position. It is advanced behind the string after the call.
+	*	@return								Read string
+	*	@exception	std::out_of_range		Thrown if the buffer is too short
+	*	@remarks							None
+	*/
+	std::string ReadString( const std::string& buffer, size_t& pos )
+	{
+		auto length = ReadInteger<std::uint16_t>( buffer, pos );
+		if ( pos + length > buffer.size() ) {
+			throw std::out_of_range( "journal record is truncated" );
+		}
+		pos += length;
+
+		return buffer.substr( pos - length, length );
+	}
+
+
+
+	/**	@brief		Encodes a journal entry in the compact binary format
+	*	@param		entry					Journal entry
+	*	@return								Binary representation of the entry
+	*	@exception	std::length_error		Thrown if the entry contains too long data
+	*	@remarks							None
+	*/
+	std::string EncodeEntry( const External::JournalEntry& entry )
+	{
+		int day, month, year, hour, minute, second, millisec;
+		Utilities::CTime timeOfDay;
+		std::string payload;
+
+		entry.time.Get( day, month, year, timeOfDay );
+		timeOfDay.Get( hour, minute, second, millisec );
+
+		AppendInteger( payload, static_cast<std::uint8_t>( entry.isRealAlarm ) );
+		AppendInteger( payload, static_cast<std::uint32_t>( entry.messageIndex ) );
+		AppendInteger( payload, static_cast<std::uint32_t>( entry.numTrials ) );
+		AppendInteger( payload, static_cast<std::uint16_t>( year ) );
+		AppendInteger( payload, static_cast<std::uint8_t>( month ) );
+		AppendInteger( payload, static_cast<std::uint8_t>( day ) );
+		AppendInteger( payload, static_cast<std::uint8_t>( hour ) );
+		AppendInteger( payload, static_cast<std::uint8_t>( minute ) );
+		AppendInteger( payload, static_cast<std::uint8_t>( second ) );
+		AppendInteger( payload, static_cast<std::uint16_t>( millisec ) );
+		AppendInteger( payload, static_cast<std::uint8_t>( entry.sequence.size() ) );
+		for ( auto digit : entry.sequence ) {
+			AppendInteger( payload, static_cast<std::int32_t>( digit ) );
+		}
+		AppendString( payload, entry.audioFile.GetFilePath().string() );
+		AppendString( payload, entry.audioFile.GetMIMEtype() );
+
+		return payload;
+	}
+
+
+
+	/**	@brief		Decodes a journal entry from the compact binary format
+	*	@param		payload					Binary data
+	*	@param		pos						Reading position. It is advanced behind the entry after the call.
+	*	@return								Journal entry
+	*	@exception	std::out_of_range		Thrown if the data is truncated
+	*	@remarks							None
+	*/
+	External::JournalEntry DecodeEntry( const std::string& payload, size_t& pos )
+	{
+		External::JournalEntry entry;
+
+		entry.isRealAlarm = ( ReadInteger<std::uint8_t>( payload, pos ) != 0 );
+		entry.messageIndex = ReadInteger<std::uint32_t>( payload, pos );
+		entry.numTrials = ReadInteger<std::uint32_t>( payload, pos );
+		int year = ReadInteger<std::uint16_t>( payload, pos );
+		int month = ReadInteger<std::uint8_t>( payload, pos );
+		int day = ReadInteger<std::uint8_t>( payload, pos );
+		int hour = ReadInteger<std::uint8_t>( payload, pos );
+		int minute = ReadInteger<std::uint8_t>( payload, pos );
+		int second = ReadInteger<std::uint8_t>( payload, pos );
+		int millisec = ReadInteger<std::uint16_t>( payload, pos );
+		entry.time.Set( day, month, year, Utilities::CTime( hour, minute, second, millisec ) );
+		auto numDigits = ReadInteger<std::uint8_t>( payload, pos );
+		for ( size_t i = 0; i < numDigits; i++ ) {
+			entry.sequence.push_back( ReadInteger<std::int32_t>( payload, pos ) );
+		}
+		auto filePath = ReadString( payload, pos );
+		auto mimeType = ReadString( payload, pos );
+		if ( !filePath.empty() ) {
+			entry.audioFile.Reset( filePath, mimeType );
+		}
+		entry.isInFlight = false;
+
+		return entry;
+	}
+
+
+
+	/**	@brief		Frames a record with its length and checksum
+	*	@param		type					Record type
+	*	@param		id						Message ID the record refers to
+	*	@param		data					Type specific data of the record
+	*	@return								Framed record
+	*	@exception							None
+	*	@remarks							The checksum allows detecting records that have been only partially written before a crash
+	*/
+	std::string FrameRecord( const std::uint8_t& type, const std::uint64_t& id, const std::string& data )
+	{
+		std::string payload, record;
+		boost::crc_32_type crc;
+
+		AppendInteger( payload, type );
+		AppendInteger( payload, id );
+		payload += data;
+		crc.process_bytes( payload.data(), payload.size() );
+
+		AppendInteger( record, static_cast<std::uint32_t>( payload.size() ) );
+		record += payload;
+		AppendInteger( record, static_cast<std::uint32_t>( crc.checksum() ) );
+
+		return record;
+	}
+
+
+
+	/**	@brief		Reads a record framed by FrameRecord from the journal file content
+	*	@param		content					Content of the journal file
+	*	@param		pos						Reading position. It is advanced behind the record if a valid record has been found.
+	*	@param		payload					Payload of the record (type, message ID and type specific data)
+	*	@return								True if a complete record with a valid checksum is found at the reading position, otherwise false
+	*	@exception							None
+	*	@remarks							None
+	*/
+	bool ReadRecord( const std::string& content, size_t& pos, std::string& payload )
+	{
+		size_t recordPos = pos;
+		boost::crc_32_type crc;
+
+		if ( pos + recordFrameSize + minPayloadSize > content.size() ) {
+			return false;
+		}
+		auto length = ReadInteger<std::uint32_t>( content, recordPos );
+		if ( ( length < minPayloadSize ) || ( length > content.size() - recordPos - sizeof( std::uint32_t ) ) ) {
+			return false;
+		}
+		crc.process_bytes( content.data() + recordPos, length );
+		size_t checksumPos = recordPos + length;
+		if ( crc.checksum() != ReadInteger<std::uint32_t>( content, checksumPos ) ) {
+			return false;
+		}
+
+		payload.assign( content, recordPos, length );
+		pos = checksumPos;
+
+		return true;
+	}
+
+
+
+	/**	@brief		Truncates a file to the given size, the writing position is set to the new end of the file
+	*	@param		file					File to be truncated. It must be unbuffered.
+	*	@param		size					New size of the file
+	*	@return								None
+	*	@exception	std::runtime_error		Thrown if the file cannot be truncated
+	*	@remarks							None
+	*/
+	void TruncateFile( std::FILE* file, const long& size )
+	{
+		std::clearerr( file );
+		#ifdef _WIN32
+			if ( _chsize( _fileno( file ), size ) != 0 ) {
+		#else
+			if ( ftruncate( fileno( file ), static_cast<off_t>( size ) ) != 0 ) {
+		#endif
+			throw std::runtime_error( u8"Die Journaldatei kann nach einem Schreibfehler nicht zurückgesetzt werden." );
+		}
+		std::fseek( file, 0, SEEK_END );
+	}
+
+
+
+	/**	@brief		Synchronizes a file to disk
+	*	@param		file					File to be synchronized
+	*	@return								None
+	*	@exception	std::runtime_error		Thrown if the synchronization failed
+	*	@remarks							None
+	*/
+	void SyncFile( std::FILE* file )
+	{
+		if ( std::fflush( file ) != 0 ) {
+			throw std::runtime_error( u8"Die Journaldatei ist nicht beschreibbar." );
+		}
+
+		#ifdef _WIN32
+			if ( _commit( _fileno( file ) ) != 0 ) {
+		#else
+			if ( fsync( fileno( file ) ) != 0 ) {
+		#endif
+			throw std::runtime_error( u8"Die Journaldatei kann nicht auf den Datenträger geschrieben werden." );
+		}
+	}
+}
+
+
+
+/**	@brief		Constructor
+*	@param		journalFile							Journal file. If it is already existing, its content is replayed and the file is compacted.
+*	@param		errorCallback						Callback function called if writing of the journal failed. The message sending is not affected by such failures.
+*	@exception	std::runtime_error					Thrown if the journal file cannot be opened
+*	@remarks 										None
+*/
+External::CMessageJournal::CMessageJournal( const boost::filesystem::path& journalFile, std::function<void( const std::string& )> errorCallback )
+	: journalFile( journalFile ),
+	  errorCallback( errorCallback ),
+	  file( nullptr ),
+	  nextID( 1 ),
+	  numRecordsInFile( 0 ),
+	  numAppendedRecords( 0 ),
+	  numSyncedRecords( 0 ),
+	  isTerminateThread( false ),
+	  isWriteError( false )
+{
+	Replay();
+	numRecordsInFile = Compact( pendingEntries );
+
+	writerThread = std::thread( &CMessageJournal::WriterThread, this );
+}
+
+
+
+/**	@brief		Destructor
+*	@remarks 										All records are written to disk before the destruction
+*/
+External::CMessageJournal::~CMessageJournal()
+{
+	{
+		std::lock_guard<std::mutex> lock( journalMutex );
+		isTerminateThread = true;
+	}
+	writeCondition.notify_all();
+	writerThread.join();
+
+	if ( file ) {
+		std::fclose( file );
+	}
+}
+
+
+
+/**	@brief		Obtains all messages that are not yet completed
+*	@return 										Pending messages with their journal IDs
+*	@exception 										None
+*	@remarks 										Directly after construction these are the messages to be resent after a restart
+*/
+std::map<std::uint64_t, External::JournalEntry> External::CMessageJournal::GetPendingEntries() const
+{
+	std::lock_guard<std::mutex> lock( journalMutex );
+	return pendingEntries;
+}
+
+
+
+/**	@brief		Journals a newly enqueued message
+*	@param		entry								Message data
+*	@return 										Journal ID of the message
+*	@exception 	std::length_error					Thrown if the message data is too long for the journal format
+*	@remarks 										The method only appends to an in-memory buffer, the file access is performed asynchronously
+*/
+std::uint64_t External::CMessageJournal::AddEnqueued( const JournalEntry& entry )
+{
+	auto data = EncodeEntry( entry );
+
+	std::lock_guard<std::mutex> lock( journalMutex );
+	auto id = nextID++;
+	pendingEntries[id] = entry;
+	pendingEntries[id].isInFlight = false;
+	AppendRecord( ENQUEUED, id, data );
+
+	return id;
+}
+
+
+
+/**	@brief		Journals that a message has been handed over to a connection for sending
+*	@param		id									Journal ID of the message
+*	@return 										None
+*	@exception 										None
+*	@remarks 										Unknown IDs are ignored
+*/
+void External::CMessageJournal::AddDispatched( const std::uint64_t& id )
+{
+	std::lock_guard<std::mutex> lock( journalMutex );
+	auto entry = pendingEntries.find( id );
+	if ( entry != end( pendingEntries ) ) {
+		entry->second.isInFlight = true;
+		AppendRecord( DISPATCHED, id, std::string() );
+	}
+}
+
+
+
+/**	@brief		Journals that a message will be retried after a non-fatal failure
+*	@param		id									Journal ID of the message
+*	@param		numTrials							Number of sending trials performed so far
+*	@return 										None
+*	@exception 										None
+*	@remarks 										Unknown IDs are ignored
+*/
+void External::CMessageJournal::AddRetry( const std::uint64_t& id, const unsigned int& numTrials )
+{
+	std::string data;
+
+	AppendInteger( data, static_cast<std::uint32_t>( numTrials ) );
+
+	std::lock_guard<std::mutex> lock( journalMutex );
+	auto entry = pendingEntries.find( id );
+	if ( entry != end( pendingEntries ) ) {
+		entry->second.isInFlight = false;
+		entry->second.numTrials = numTrials;
+		AppendRecord( RETRY, id, data );
+	}
+}
+
+
+
+/**	@brief		Journals that a message has been finished (either successfully sent or finally failed)
+*	@param		id									Journal ID of the message
+*	@return 										None
+*	@exception 										None
+*	@remarks 										Unknown IDs are ignored
+*/
+void External::CMessageJournal::AddCompleted( const std::uint64_t& id )
+{
+	std::lock_guard<std::mutex> lock( journalMutex );
+	if ( pendingEntries.erase( id ) > 0 ) {
+		AppendRecord( COMPLETED, id, std::string() );
+	}
+}
+
+
+
+/**	@brief		Waits until all records journaled so far have been written to disk
+*	@return 										None
+*	@exception 										None
+*	@remarks 										This method blocks the caller
+*/
+void External::CMessageJournal::Flush()
+{
+	std::unique_lock<std::mutex> lock( journalMutex );
+	auto targetRecords = numAppendedRecords;
+	batchWrittenCondition.wait( lock, [&]() { return ( numSyncedRecords >= targetRecords ); } );
+}
+
+
+
+/**	@brief		Appends a record to the write buffer and notifies the writer thread
+*	@param		type								Record type
+*	@param		id									Journal ID of the message
+*	@param		data								Type specific data of the record
+*	@return 										None
+*	@exception 										None
+*	@remarks 										The journal mutex must be locked by the caller
+*/
+void External::CMessageJournal::AppendRecord( const std::uint8_t& type, const std::uint64_t& id, const std::string& data )
+{
+	writeBuffer += FrameRecord( type, id, data );
+	numAppendedRecords++;
+	writeCondition.notify_one();
+}
+
+
+
+/**	@brief		Reads the journal file and reconstructs the pending messages
+*	@return 										None
+*	@exception 										None
+*	@remarks 										Incomplete or corrupted records (for example due to a crash while writing) are skipped, reading continues with the next valid record
+*/
+void External::CMessageJournal::Replay()
+{
+	using namespace std;
+
+	ifstream inFile( journalFile.string(), ios::binary );
+	if ( !inFile.is_open() ) {
+		return;
+	}
+	string content( ( istreambuf_iterator<char>( inFile ) ), istreambuf_iterator<char>() );
+
+	size_t pos = 0;
+	string payload;
+	while ( pos < content.size() ) {
+		if ( !ReadRecord( content, pos, payload ) ) {
+			// search for the next valid record behind a corrupted one
+			pos++;
+			continue;
+		}
+
+		try {
+			size_t payloadPos = 0;
+			auto type = ReadInteger<std::uint8_t>( payload, payloadPos );
+			auto id = ReadInteger<std::uint64_t>( payload, payloadPos );
+			switch ( type ) {
+			case ENQUEUED:
+				pendingEntries[id] = DecodeEntry( payload, payloadPos );
+				break;
+			case DISPATCHED:
+				if ( pendingEntries.count( id ) > 0 ) {
+					pendingEntries[id].isInFlight = true;
+				}
+				break;
+			case RETRY:
+				if ( pendingEntries.count( id ) > 0 ) {
+					pendingEntries[id].numTrials = ReadInteger<std::uint32_t>( payload, payloadPos );
+					pendingEntries[id].isInFlight = false;
+				}
+				break;
+			case COMPLETED:
+				pendingEntries.erase( id );
+				break;
+			}
+			nextID = std::max( nextID, id + 1 );
+		} catch ( std::out_of_range& ) {
+			// a record with a valid checksum but inconsistent data is ignored
+		}
+	}
+}
+
+
+
+/**	@brief		Replaces the journal file by a file only containing the given pending messages
+*	@param		entries								Pending messages
+*	@return 										Number of records in the new journal file
+*	@exception 	std::runtime_error					Thrown if the journal file cannot be written
+*	@remarks 										The new file is written completely before it atomically replaces the old one. Messages in flight keep their state.
+*/
+unsigned int External::CMessageJournal::Compact( const std::map<std::uint64_t, JournalEntry>& entries )
+{
+	using namespace std;
+
+	string content;
+	auto tempFile = journalFile;
+	tempFile += ".tmp";
+
+	unsigned int numRecords = 0;
+	for ( const auto& entry : entries ) {
+		content += FrameRecord( ENQUEUED, entry.first, EncodeEntry( entry.second ) );
+		numRecords++;
+		if ( entry.second.isInFlight ) {
+			content += FrameRecord( DISPATCHED, entry.first, std::string() );
+			numRecords++;
+		}
+	}
+
+	auto newFile = std::fopen( tempFile.string().c_str(), "wb" );
+	if ( !newFile ) {
+		throw std::runtime_error( u8"Die Journaldatei kann nicht angelegt werden." );
+	}
+	if ( std::fwrite( content.data(), 1, content.size(), newFile ) != content.size() ) {
+		std::fclose( newFile );
+		throw std::runtime_error( u8"Die Journaldatei ist nicht beschreibbar." );
+	}
+	SyncFile( newFile );
+	std::fclose( newFile );
+
+	if ( file ) {
+		std::fclose( file );
+		file = nullptr;
+	}
+	boost::filesystem::rename( tempFile, journalFile );
+
+	file = std::fopen( journalFile.string().c_str(), "ab" );
+	if ( !file ) {
+		throw std::runtime_error( u8"Die Journaldatei kann nicht geöffnet werden." );
+	}
+	std::setvbuf( file, nullptr, _IONBF, 0 ); // each batch is written at once, a failed write must not remain in a buffer
+
+	return numRecords;
+}
+
+
+
+/**	@brief		Background thread writing the buffered records to the journal file
+*	@return 										None
+*	@exception 										None
+*	@remarks 										All records buffered at a time are written with a single synchronization to disk (group commit).
+*													The file is compacted if it mainly consists of records of already completed messages.
+*/
+void External::CMessageJournal::WriterThread()
+{
+	using namespace std;
+
+	string batch;
+	map<std::uint64_t, JournalEntry> snapshot;
+
+	unique_lock<mutex> lock( journalMutex );
+	while ( true ) {
+		writeCondition.wait( lock, [this]() { return ( !writeBuffer.empty() || isTerminateThread ); } );
+		if ( writeBuffer.empty() ) {
+			break;
+		}
+
+		batch.clear();
+		batch.swap( writeBuffer );
+		auto targetRecords = numAppendedRecords;
+		auto numBatchRecords = static_cast<unsigned int>( numAppendedRecords - numSyncedRecords );
+		bool isCompaction = ( ( numRecordsInFile + numBatchRecords > minRecordsForCompaction ) && ( numRecordsInFile + numBatchRecords > compactionFactor * pendingEntries.size() ) ) || isWriteError; // after a write error the lost records are restored by the compaction
+		if ( isCompaction ) {
+			snapshot = pendingEntries; // the snapshot already contains the state of the present batch
+		}
+		lock.unlock();
+
+		string errorText;
+		unsigned int numCompactedRecords = 0;
+		try {
+			if ( isCompaction ) {
+				numCompactedRecords = Compact( snapshot );
+			} else if ( file ) {
+				// a partially written batch is removed again, otherwise it would be followed by the next batch
+				std::fseek( file, 0, SEEK_END );
+				auto lastGoodSize = std::ftell( file );
+				try {
+					if ( std::fwrite( batch.data(), 1, batch.size(), file ) != batch.size() ) {
+						throw std::runtime_error( u8"Die Journaldatei ist nicht beschreibbar." );
+					}
+					SyncFile( file );
+				} catch ( std::exception& ) {
+					if ( lastGoodSize >= 0 ) {
+						TruncateFile( file, lastGoodSize );
+					}
+					throw;
+				}
+			} else {
+				throw std::runtime_error( u8"Die Journaldatei ist nicht beschreibbar." );
+			}
+		} catch ( std::exception& e ) {
+			errorText = e.what();
+		}
+
+		lock.lock();
+		if ( isCompaction ) {
+			numRecordsInFile = numCompactedRecords;
+		} else if ( errorText.empty() ) {
+			numRecordsInFile += numBatchRecords;
+		}
+		numSyncedRecords = targetRecords;
+		batchWrittenCondition.notify_all();
+
+		// errors are only reported once until writing succeeds again
+		bool isReportError = !errorText.empty() && !isWriteError;
+		isWriteError = !errorText.empty();
+		if ( isReportError ) {
+			lock.unlock();
+			errorCallback( errorText );
+			lock.lock();
+		}
+	}
+}
@@ -0,0 +1,114 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <boost/filesystem.hpp>
+#include "DateTime.h"
+#include "MediaFile.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef NETWORKING_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define NETWORKING_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define NETWORKING_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define NETWORKING_API __attribute__ ((visibility ("default")))
+	#else
+		#define NETWORKING_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	/**	\ingroup Networking
+	*	@brief	Structure containing all data of a journaled alarm message required for resending it after a restart
+	*/
+	struct JournalEntry {
+		std::vector<int> sequence;
+		Utilities::CDateTime time;
+		bool isRealAlarm;
+		unsigned int messageIndex;
+		Utilities::CMediaFile audioFile;
+		unsigned int numTrials;
+		bool isInFlight;
+	};
+
+
+	/**	\ingroup Networking
+	*	Class implementing an append-only journal of the messages of a connection manager.
+	*	The journal file is written by a background thread with a single synchronization to disk per batch of records.
+	*	The alarm message itself is not stored, only its index within the alarm messages database search result (the login data is therefore never written to disk).
+	*/
+	class CMessageJournal
+	{
+	public:
+		NETWORKING_API CMessageJournal( const boost::filesystem::path& journalFile, std::function<void( const std::string& )> errorCallback );
+		NETWORKING_API virtual ~CMessageJournal();
+		NETWORKING_API virtual std::map<std::uint64_t, JournalEntry> GetPendingEntries() const;
+		NETWORKING_API virtual std::uint64_t AddEnqueued( const JournalEntry& entry );
+		NETWORKING_API virtual void AddDispatched( const std::uint64_t& id );
+		NETWORKING_API virtual void AddRetry( const std::uint64_t& id, const unsigned int& numTrials );
+		NETWORKING_API virtual void AddCompleted( const std::uint64_t& id );
+		NETWORKING_API virtual void Flush();
+	private:
+		CMessageJournal( const CMessageJournal& ) = delete;
+		CMessageJournal& operator=( const CMessageJournal& ) = delete;
+		void Replay();
+		unsigned int Compact( const std::map<std::uint64_t, JournalEntry>& entries );
+		void WriterThread();
+		void AppendRecord( const std::uint8_t& type, const std::uint64_t& id, const std::string& payload );
+
+		boost::filesystem::path journalFile;
+		std::function<void( const std::string& )> errorCallback;
+		std::FILE* file;
+		std::map<std::uint64_t, JournalEntry> pendingEntries;
+		std::uint64_t nextID;
+		std::string writeBuffer;
+		unsigned int numRecordsInFile;
+		std::uint64_t numAppendedRecords;
+		std::uint64_t numSyncedRecords;
+		bool isTerminateThread;
+		bool isWriteError;
+		mutable std::mutex journalMutex;
+		std::condition_variable writeCondition;
+		std::condition_variable batchWrittenCondition;
+		std::thread writerThread;
+	};
+}
+/*@}*/
@@ -0,0 +1,206 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define NETWORKING_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define NETWORKING_API __declspec(dllexport)
+	#endif
+#endif
+
+#if defined _WIN32
+	#include "stdafx.h"
+#endif
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include "MessageScheduler.h"
+
+
+namespace {
+	/**	@brief	Heap ordering of the waiting messages: the message with the earliest due time is on top, equal due times keep the insertion order */
+	bool IsLaterDue( const External::ScheduledMessage& lhs, const External::ScheduledMessage& rhs )
+	{
+		return std::tie( lhs.dueTime, lhs.sequenceNumber ) > std::tie( rhs.dueTime, rhs.sequenceNumber );
+	}
+
+	/**	@brief	Heap ordering of the due messages: the message with the highest priority (i.e. the lowest value) is on top, then the earliest due time and then the insertion order */
+	bool IsLowerPriority( const External::ScheduledMessage& lhs, const External::ScheduledMessage& rhs )
+	{
+		return std::tie( lhs.priority, lhs.dueTime, lhs.sequenceNumber ) > std::tie( rhs.priority, rhs.dueTime, rhs.sequenceNumber );
+	}
+}
+
+
+
+/**	@brief		Constructor
+*	@remarks 										None
+*/
+External::CMessageScheduler::CMessageScheduler()
+	: nextSequenceNumber( 0 )
+{
+}
+
+
+
+/**	@brief		Destructor
+*	@remarks 										None
+*/
+External::CMessageScheduler::~CMessageScheduler()
+{
+}
+
+
+
+/**	@brief		Adds a message to the scheduler
+*	@param		message								Message to be sent
+*	@param		numTrials							Number of sending trials already performed for the message
+*	@param		dueTime								Time when the message is due for sending
+*	@return 										None
+*	@exception 	std::runtime_error					Thrown if the message is empty
+*	@remarks 										Messages with identical due times are all kept and provided in the order of their insertion
+*/
+void External::CMessageScheduler::Push( std::unique_ptr<Message> message, const unsigned int& numTrials, const std::chrono::time_point< std::chrono::steady_clock >& dueTime )
+{
+	if ( !message ) {
+		throw std::runtime_error( "The message is empty." );
+	}
+
+	auto priority = GetPriority( *message );
+	waitingMessages.push_back( ScheduledMessage{ dueTime, priority, nextSequenceNumber++, std::move( message ), numTrials } );
+	std::push_heap( begin( waitingMessages ), end( waitingMessages ), IsLaterDue );
+}
+
+
+
+/**	@brief		Checks if a message is due for sending
+*	@param		currTime							Current time
+*	@return 										True if at least one message is due, false otherwise
+*	@exception 										None
+*	@remarks 										None
+*/
+bool External::CMessageScheduler::HasDueMessage( const std::chrono::time_point< std::chrono::steady_clock >& currTime )
+{
+	PromoteDueMessages( currTime );
+	return !dueMessages.empty();
+}
+
+
+
+/**	@brief		Removes the due message with the highest priority from the scheduler
+*	@param		currTime							Current time
+*	@return 										Message and the number of sending trials already performed for it
+*	@exception 	std::logic_error					Thrown if no message is due
+*	@remarks 										None
+*/
+std::pair< std::unique_ptr<External::Message>, unsigned int > External::CMessageScheduler::PopDueMessage( const std::chrono::time_point< std::chrono::steady_clock >& currTime )
+{
+	PromoteDueMessages( currTime );
+	if ( dueMessages.empty() ) {
+		throw std::logic_error( "No message is due." );
+	}
+
+	std::pop_heap( begin( dueMessages ), end( dueMessages ), IsLowerPriority );
+	auto dueMessage = std::make_pair( std::move( dueMessages.back().message ), dueMessages.back().numTrials );
+	dueMessages.pop_back();
+
+	return dueMessage;
+}
+
+
+
+/**	@brief		Obtains the time when the next message will be due
+*	@return 										Due time of the next message. If messages are already due, it is the due time of the one with the highest priority (which lies in the past).
+*	@exception 	std::logic_error					Thrown if the scheduler is empty
+*	@remarks 										None
+*/
+std::chrono::time_point< std::chrono::steady_clock > External::CMessageScheduler::GetNextDueTime() const
+{
+	if ( !dueMessages.empty() ) {
+		return dueMessages.front().dueTime;
+	}
+	if ( waitingMessages.empty() ) {
+		throw std::logic_error( "The scheduler is empty." );
+	}
+
+	return waitingMessages.front().dueTime;
+}
+
+
+
+/**	@brief		Checks if the scheduler is empty
+*	@return 										True if no messages are contained, false otherwise
+*	@exception 										None
+*	@remarks 										None
+*/
+bool External::CMessageScheduler::IsEmpty() const
+{
+	return ( waitingMessages.empty() && dueMessages.empty() );
+}
+
+
+
+/**	@brief		Obtains the number of messages in the scheduler
+*	@return 										Number of messages (both due and waiting)
+*	@exception 										None
+*	@remarks 										None
+*/
+size_t External::CMessageScheduler::Size() const
+{
+	return ( waitingMessages.size() + dueMessages.size() );
+}
+
+
+
+/**	@brief		Obtains the priority of a message
+*	@param		message								Message
+*	@return 										Priority of the message, lower values are sent first
+*	@exception 										None
+*	@remarks 										Real alarms are preferred to test alarms, messages required directly after the detection to messages after the recording
+*/
+unsigned int External::CMessageScheduler::GetPriority( const Message& message )
+{
+	unsigned int priority = 0;
+
+	if ( !message.isRealAlarm ) {
+		priority += 2;
+	}
+	if ( message.message && !message.message->RequiredState() ) {
+		priority += 1;
+	}
+
+	return priority;
+}
+
+
+
+/**	@brief		Moves all messages that have become due into the heap of due messages
+*	@param		currTime							Current time
+*	@return 										None
+*	@exception 										None
+*	@remarks 										None
+*/
+void External::CMessageScheduler::PromoteDueMessages( const std::chrono::time_point< std::chrono::steady_clock >& currTime )
+{
+	while ( !waitingMessages.empty() && ( waitingMessages.front().dueTime <= currTime ) ) {
+		std::pop_heap( begin( waitingMessages ), end( waitingMessages ), IsLaterDue );
+		dueMessages.push_back( std::move( waitingMessages.back() ) );
+		waitingMessages.pop_back();
+		std::push_heap( begin( dueMessages ), end( dueMessages ), IsLowerPriority );
+	}
+}
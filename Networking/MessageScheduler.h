@@ -0,0 +1,90 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cstdint>
+#include "ConnectionThread.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef NETWORKING_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define NETWORKING_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define NETWORKING_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define NETWORKING_API __attribute__ ((visibility ("default")))
+	#else
+		#define NETWORKING_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	/**	\ingroup Networking
+	*	@brief	Structure containing a message waiting in the scheduler
+	*/
+	struct ScheduledMessage {
+		std::chrono::time_point< std::chrono::steady_clock > dueTime;
+		unsigned int priority;
+		std::uint64_t sequenceNumber;
+		std::unique_ptr<Message> message;
+		unsigned int numTrials;
+	};
+
+
+	/**	\ingroup Networking
+	*	Class implementing the scheduler of the messages of a connection manager.
+	*	Messages wait in a heap ordered by their due time. Due messages are provided ordered by their priority (real alarms before test alarms,
+	*	messages directly after the detection before messages after the recording), then by their due time and finally by their insertion order.
+	*/
+	class CMessageScheduler
+	{
+	public:
+		NETWORKING_API CMessageScheduler();
+		NETWORKING_API virtual ~CMessageScheduler();
+		NETWORKING_API void Push( std::unique_ptr<Message> message, const unsigned int& numTrials, const std::chrono::time_point< std::chrono::steady_clock >& dueTime );
+		NETWORKING_API bool HasDueMessage( const std::chrono::time_point< std::chrono::steady_clock >& currTime );
+		NETWORKING_API std::pair< std::unique_ptr<Message>, unsigned int > PopDueMessage( const std::chrono::time_point< std::chrono::steady_clock >& currTime );
+		NETWORKING_API std::chrono::time_point< std::chrono::steady_clock > GetNextDueTime() const;
+		NETWORKING_API bool IsEmpty() const;
+		NETWORKING_API size_t Size() const;
+		NETWORKING_API static unsigned int GetPriority( const Message& message );
+	private:
+		void PromoteDueMessages( const std::chrono::time_point< std::chrono::steady_clock >& currTime );
+
+		std::vector<ScheduledMessage> waitingMessages;
+		std::vector<ScheduledMessage> dueMessages;
+		std::uint64_t nextSequenceNumber;
+	};
+}
+/*@}*/
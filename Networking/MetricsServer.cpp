@@ -0,0 +1,204 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define NETWORKING_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define NETWORKING_API __declspec(dllexport)
+	#endif
+#endif
+
+#if defined _WIN32
+	#include "stdafx.h"
+#endif
+#include <string>
+#include <stdexcept>
+#include <Poco/Exception.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include "MetricsRegistry.h"
+#include "MetricsServer.h"
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	namespace Metrics {
+		/**	\ingroup Networking
+		*	Request handler answering a single request to the metrics server
+		*/
+		class CMetricsRequestHandler : public Poco::Net::HTTPRequestHandler
+		{
+		public:
+			virtual void handleRequest( Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response ) override;
+		};
+
+		/**	\ingroup Networking
+		*	Factory creating the request handlers of the metrics server
+		*/
+		class CMetricsRequestHandlerFactory : public Poco::Net::HTTPRequestHandlerFactory
+		{
+		public:
+			virtual Poco::Net::HTTPRequestHandler* createRequestHandler( const Poco::Net::HTTPServerRequest& request ) override;
+		};
+	}
+}
+/*@}*/
+
+
+
+/**	@brief		Answers a request to the metrics server
+*	@param		request								HTTP request
+*	@param		response							HTTP response containing all metrics for "GET /metrics", otherwise an error status
+*	@return											None
+*	@exception										None
+*	@remarks										None
+*/
+void External::Metrics::CMetricsRequestHandler::handleRequest( Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response )
+{
+	using namespace Poco::Net;
+
+	if ( request.getMethod() != HTTPRequest::HTTP_GET ) {
+		response.setStatusAndReason( HTTPResponse::HTTP_METHOD_NOT_ALLOWED );
+		response.send();
+		return;
+	}
+
+	if ( request.getURI() != "/metrics" ) {
+		response.setStatusAndReason( HTTPResponse::HTTP_NOT_FOUND );
+		response.send();
+		return;
+	}
+
+	auto metrics = Utilities::Metrics::CMetricsRegistry::Instance().Serialize();
+	response.setContentType( "text/plain; version=0.0.4; charset=utf-8" );
+	response.setContentLength( static_cast<std::streamsize>( metrics.size() ) );
+	response.send() << metrics;
+}
+
+
+
+/**	@brief		Creates the request handler for a new request
+*	@param		request								HTTP request
+*	@return											New request handler, the ownership is passed to the caller
+*	@exception										None
+*	@remarks										None
+*/
+Poco::Net::HTTPRequestHandler* External::Metrics::CMetricsRequestHandlerFactory::createRequestHandler( const Poco::Net::HTTPServerRequest& request )
+{
+	return new CMetricsRequestHandler();
+}
+
+
+
+/**	@brief		Constructor
+*	@param		port								TCP port of the metrics server. The server is listening on all network interfaces.
+*	@exception										None
+*	@remarks										The server is only started by CMetricsServer::Start()
+*/
+External::Metrics::CMetricsServer::CMetricsServer( const unsigned short& port )
+	: port( port )
+{
+}
+
+
+
+/**	@brief		Destructor
+*/
+External::Metrics::CMetricsServer::~CMetricsServer()
+{
+	Stop();
+}
+
+
+
+/**	@brief		Starts the metrics server
+*	@return											None
+*	@exception	std::logic_error					Thrown if the server is already running
+*	@exception	std::runtime_error					Thrown if the port could not be opened
+*	@remarks										The requests are answered by a small thread pool in the background
+*/
+void External::Metrics::CMetricsServer::Start()
+{
+	using namespace Poco::Net;
+
+	std::lock_guard<std::mutex> lock( serverMutex );
+	if ( server ) {
+		throw std::logic_error( "The metrics server is already running." );
+	}
+
+	try {
+		auto params = new HTTPServerParams();
+		params->setMaxThreads( 2 );
+		params->setMaxQueued( 16 );
+		params->setKeepAlive( false );
+
+		server = std::make_unique<HTTPServer>( new CMetricsRequestHandlerFactory(), ServerSocket( port ), params );
+		server->start();
+	} catch ( Poco::Exception& e ) {
+		server.reset();
+		throw std::runtime_error( u8"Der Metrik-Server kann nicht auf Port " + std::to_string( port ) + u8" gestartet werden: " + e.displayText() );
+	}
+}
+
+
+
+/**	@brief		Stops the metrics server
+*	@return											None
+*	@exception										None
+*	@remarks										Requests currently in processing are aborted. Calling the method for a stopped server has no effect.
+*/
+void External::Metrics::CMetricsServer::Stop()
+{
+	std::lock_guard<std::mutex> lock( serverMutex );
+	if ( server ) {
+		server->stopAll( true );
+		server.reset();
+	}
+}
+
+
+
+/**	@brief		Checks if the metrics server is running
+*	@return											True if the server is running, otherwise false
+*	@exception										None
+*	@remarks										None
+*/
+bool External::Metrics::CMetricsServer::IsRunning() const
+{
+	std::lock_guard<std::mutex> lock( serverMutex );
+	return static_cast<bool>( server );
+}
+
+
+
+/**	@brief		Obtains the port of the metrics server
+*	@return											TCP port of the metrics server
+*	@exception										None
+*	@remarks										None
+*/
+unsigned short External::Metrics::CMetricsServer::GetPort() const
+{
+	return port;
+}
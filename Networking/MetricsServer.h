@@ -0,0 +1,78 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <mutex>
+
+namespace Poco {
+	namespace Net {
+		class HTTPServer;
+	}
+}
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef NETWORKING_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define NETWORKING_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define NETWORKING_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define NETWORKING_API __attribute__ ((visibility ("default")))
+	#else
+		#define NETWORKING_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	namespace Metrics {
+		/**	\ingroup Networking
+		*	Class implementing an embedded HTTP server providing all metrics of Utilities::Metrics::CMetricsRegistry in the Prometheus text format at the path "/metrics"
+		*/
+		class CMetricsServer
+		{
+		public:
+			NETWORKING_API CMetricsServer( const unsigned short& port );
+			NETWORKING_API virtual ~CMetricsServer();
+			NETWORKING_API void Start();
+			NETWORKING_API void Stop();
+			NETWORKING_API bool IsRunning() const;
+			NETWORKING_API unsigned short GetPort() const;
+		private:
+			CMetricsServer( const CMetricsServer& ) = delete;
+			CMetricsServer& operator=( const CMetricsServer& ) = delete;
+
+			unsigned short port;
+			std::unique_ptr<Poco::Net::HTTPServer> server;
+			mutable std::mutex serverMutex;
+		};
+	}
+}
+/*@}*/
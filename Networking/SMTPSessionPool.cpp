@@ -0,0 +1,289 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define NETWORKING_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define NETWORKING_API __declspec(dllexport)
+	#endif
+#endif
+
+#if defined _WIN32
+	#include "stdafx.h"
+#endif
+#include <algorithm>
+#include <Poco/Exception.h>
+#include "GatewayExecutor.h"
+#include "SMTPSessionPool.h"
+
+
+namespace {
+	/**	@brief	SMTP reply code of a successfully completed command */
+	const int smtpReplyOk = 250;
+}
+
+
+std::weak_ptr<External::Email::CSMTPSessionPool> External::Email::CSMTPSessionPool::instance;
+std::mutex External::Email::CSMTPSessionPool::instanceMutex;
+
+
+
+/**	@brief		Access to the shared instance
+*	@return								Shared instance of the session pool. It is created if it is not existing.
+*	@exception							None
+*	@remarks							The instance is destroyed (and all idle sessions are closed) when the last reference is released
+*/
+std::shared_ptr<External::Email::CSMTPSessionPool> External::Email::CSMTPSessionPool::Instance()
+{
+	std::lock_guard<std::mutex> lock( instanceMutex );
+
+	auto pool = instance.lock();
+	if ( !pool ) {
+		pool.reset( new CSMTPSessionPool() );
+		instance = pool;
+	}
+
+	return pool;
+}
+
+
+
+/**	@brief		Constructor
+*	@remarks							The constructor is private and can therefore only be used by CSMTPSessionPool::Instance
+*/
+External::Email::CSMTPSessionPool::CSMTPSessionPool()
+	: isTerminateThread( false )
+{
+	expiryThread = std::thread( &CSMTPSessionPool::ExpiryThread, this );
+}
+
+
+
+/**	@brief		Destructor
+*	@remarks							All idle sessions are closed
+*/
+External::Email::CSMTPSessionPool::~CSMTPSessionPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( poolMutex );
+		isTerminateThread = true;
+	}
+	expiryCondition.notify_all();
+	expiryThread.join();
+
+	for ( auto& sessions : idleSessions ) {
+		for ( auto& idleSession : sessions.second ) {
+			CloseSession( std::move( idleSession.session ) );
+		}
+	}
+}
+
+
+
+/**	@brief		Obtains an idle authenticated session for the login from the pool
+*	@param		loginData				Login data of the e-mail server
+*	@return								Authenticated session ready for sending a message. It is empty if no usable session is available.
+*	@exception							None
+*	@remarks							Each session is checked with the SMTP-command RSET before it is returned. The session should be returned by CSMTPSessionPool::Release after a successful sending, in case of any errors it should simply be destroyed.
+*/
+std::unique_ptr<Poco::Net::SMTPClientSession> External::Email::CSMTPSessionPool::Acquire( const CEmailLoginData& loginData )
+{
+	using namespace std;
+
+	auto key = GetKey( loginData );
+
+	while ( true ) {
+		IdleSession idleSession;
+		{
+			lock_guard<mutex> lock( poolMutex );
+			auto& sessions = idleSessions[key];
+			if ( sessions.empty() ) {
+				return nullptr;
+			}
+
+			// the most recently used session is the most likely one to be still alive
+			idleSession = move( sessions.back() );
+			sessions.pop_back();
+		}
+
+		if ( chrono::steady_clock::now() >= idleSession.expiryTime ) {
+			CloseSession( move( idleSession.session ) );
+		} else if ( IsHealthy( *idleSession.session ) ) {
+			return move( idleSession.session );
+		}
+	}
+}
+
+
+
+/**	@brief		Returns a session to the pool after a successful sending
+*	@param		loginData				Login data of the e-mail server used for the session
+*	@param		session					Authenticated session that has been used for sending without any error
+*	@return								None
+*	@exception							None
+*	@remarks							The session is kept for the idle time of the login data (CEmailLoginData::GetSessionIdleTime). If it is zero or the pool is already full for this login, the session is closed.
+*/
+void External::Email::CSMTPSessionPool::Release( const CEmailLoginData& loginData, std::unique_ptr<Poco::Net::SMTPClientSession> session )
+{
+	using namespace std;
+
+	if ( !session ) {
+		return;
+	}
+
+	auto idleTime = chrono::seconds( loginData.GetSessionIdleTime() );
+	if ( idleTime > chrono::seconds::zero() ) {
+		lock_guard<mutex> lock( poolMutex );
+
+		// more idle sessions than worker threads sending in parallel are never required
+		auto& sessions = idleSessions[GetKey( loginData )];
+		if ( sessions.size() < CGatewayExecutor::GetMaxNumThreads() ) {
+			sessions.push_back( IdleSession{ move( session ), chrono::steady_clock::now() + idleTime } );
+			expiryCondition.notify_all();
+			return;
+		}
+	}
+
+	CloseSession( move( session ) );
+}
+
+
+
+/**	@brief		Obtains the number of idle sessions in the pool
+*	@return								Number of idle sessions for all logins
+*	@exception							None
+*	@remarks							None
+*/
+unsigned int External::Email::CSMTPSessionPool::GetNumIdleSessions() const
+{
+	std::size_t numIdleSessions = 0;
+
+	std::lock_guard<std::mutex> lock( poolMutex );
+	for ( const auto& sessions : idleSessions ) {
+		numIdleSessions += sessions.second.size();
+	}
+
+	return static_cast<unsigned int>( numIdleSessions );
+}
+
+
+
+/**	@brief		Obtains the key of the pool for a login
+*	@param		loginData				Login data of the e-mail server
+*	@return								Key of the pool. Sessions are only shared for identical server and login information.
+*	@exception							None
+*	@remarks							None
+*/
+External::Email::CSMTPSessionPool::SessionKey External::Email::CSMTPSessionPool::GetKey( const CEmailLoginData& loginData )
+{
+	using namespace std;
+
+	ConnectionType connectionType;
+	AuthType authType;
+	unsigned short port;
+	string hostName, senderAddress, userName, password;
+
+	loginData.GetServerInformation( connectionType, hostName, port );
+	loginData.GetLoginInformation( senderAddress, authType, userName, password );
+
+	return make_tuple( connectionType, hostName, port, authType, userName, password );
+}
+
+
+
+/**	@brief		Health check of an idle session
+*	@param		session					Idle session
+*	@return								True if the session can be reused, false otherwise
+*	@exception							None
+*	@remarks							The SMTP-command RSET also clears any remaining transaction state of the server
+*/
+bool External::Email::CSMTPSessionPool::IsHealthy( Poco::Net::SMTPClientSession& session )
+{
+	std::string response;
+
+	try {
+		return ( session.sendCommand( "RSET", response ) == smtpReplyOk );
+	} catch ( Poco::Exception& ) {
+		return false;
+	}
+}
+
+
+
+/**	@brief		Closes a session that is not used anymore
+*	@param		session					Session to be closed
+*	@return								None
+*	@exception							None
+*	@remarks							The server is informed by the SMTP-command QUIT, errors are ignored because the session is discarded anyway
+*/
+void External::Email::CSMTPSessionPool::CloseSession( std::unique_ptr<Poco::Net::SMTPClientSession> session )
+{
+	try {
+		session->close();
+	} catch ( Poco::Exception& ) {
+		// the session is discarded anyway
+	}
+}
+
+
+
+/**	@brief		Background thread closing the idle sessions after their idle time
+*	@return								None
+*	@exception							None
+*	@remarks							The thread sleeps until the next session expires or a new session is added to the pool
+*/
+void External::Email::CSMTPSessionPool::ExpiryThread()
+{
+	using namespace std;
+
+	vector< unique_ptr<Poco::Net::SMTPClientSession> > expiredSessions;
+
+	unique_lock<mutex> lock( poolMutex );
+	while ( !isTerminateThread ) {
+		auto currTime = chrono::steady_clock::now();
+		auto nextExpiryTime = chrono::steady_clock::time_point::max();
+
+		for ( auto& sessions : idleSessions ) {
+			for ( auto& idleSession : sessions.second ) {
+				if ( idleSession.expiryTime <= currTime ) {
+					expiredSessions.push_back( move( idleSession.session ) );
+				} else {
+					nextExpiryTime = min( nextExpiryTime, idleSession.expiryTime );
+				}
+			}
+			sessions.second.erase( remove_if( begin( sessions.second ), end( sessions.second ), []( const IdleSession& idleSession ) { return !idleSession.session; } ), end( sessions.second ) );
+		}
+
+		// the sessions are closed outside of the lock, because the server might react slowly
+		if ( !expiredSessions.empty() ) {
+			lock.unlock();
+			for ( auto& session : expiredSessions ) {
+				CloseSession( move( session ) );
+			}
+			expiredSessions.clear();
+			lock.lock();
+			continue;
+		}
+
+		if ( nextExpiryTime == chrono::steady_clock::time_point::max() ) {
+			expiryCondition.wait( lock );
+		} else {
+			expiryCondition.wait_until( lock, nextExpiryTime );
+		}
+	}
+}
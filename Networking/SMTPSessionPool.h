@@ -0,0 +1,102 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <memory>
+#include <map>
+#include <vector>
+#include <tuple>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <Poco/Net/SMTPClientSession.h>
+#include "EmailLoginData.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef NETWORKING_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define NETWORKING_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define NETWORKING_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define NETWORKING_API __attribute__ ((visibility ("default")))
+	#else
+		#define NETWORKING_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+namespace External {
+	namespace Email {
+		/**	\ingroup Networking
+		*	Class implementing a cache of authenticated SMTP sessions shared by the connections of all e-mail gateways.
+		*	Idle sessions are kept per e-mail server login for the idle time configured in the login data, expired sessions are closed by a background thread.
+		*	The pool exists as long as it is referenced by at least one gateway.
+		*/
+		class CSMTPSessionPool
+		{
+		public:
+			NETWORKING_API static std::shared_ptr<CSMTPSessionPool> Instance();
+			NETWORKING_API virtual ~CSMTPSessionPool();
+			NETWORKING_API std::unique_ptr<Poco::Net::SMTPClientSession> Acquire( const CEmailLoginData& loginData );
+			NETWORKING_API void Release( const CEmailLoginData& loginData, std::unique_ptr<Poco::Net::SMTPClientSession> session );
+			NETWORKING_API unsigned int GetNumIdleSessions() const;
+		private:
+			using SessionKey = std::tuple<ConnectionType, std::string, unsigned short, AuthType, std::string, std::string>;
+
+			/**	\ingroup Networking
+			*	Structure containing an idle session of the pool
+			*/
+			struct IdleSession {
+				std::unique_ptr<Poco::Net::SMTPClientSession> session;
+				std::chrono::steady_clock::time_point expiryTime;
+			};
+
+			CSMTPSessionPool(); // this enforces that no object can be created from the class - except in CSMTPSessionPool::Instance
+			CSMTPSessionPool( const CSMTPSessionPool& ) = delete;
+			CSMTPSessionPool& operator=( const CSMTPSessionPool& ) = delete;
+			static SessionKey GetKey( const CEmailLoginData& loginData );
+			static bool IsHealthy( Poco::Net::SMTPClientSession& session );
+			static void CloseSession( std::unique_ptr<Poco::Net::SMTPClientSession> session );
+			void ExpiryThread();
+
+			static std::weak_ptr<CSMTPSessionPool> instance;
+			static std::mutex instanceMutex;
+
+			std::map< SessionKey, std::vector<IdleSession> > idleSessions;
+			bool isTerminateThread;
+			mutable std::mutex poolMutex;
+			std::condition_variable expiryCondition;
+			std::thread expiryThread;
+		};
+	}
+}
+/*@}*/
@@ -23,6 +23,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 	#endif
 #endif
 
+#include <set>
 #include <sstream>
 #include <boost/lexical_cast.hpp>
 #include "XMLSerializableAlarmValidities.h"
@@ -47,7 +48,7 @@ void External::CXMLSerializableAlarmMessagesDatabase::SetFromXML( Poco::AutoPtr<
 	using namespace Poco::Util;
 
 	vector<string> availableCodes;
-	vector< vector<int> > processedCodes;
+	set< vector<int> > processedCodes;
 	vector<int> code;
 	string codeString;
 
@@ -69,10 +70,9 @@ void External::CXMLSerializableAlarmMessagesDatabase::SetFromXML( Poco::AutoPtr<
 				code.push_back( boost::lexical_cast<int>( digit ) );
 			}
 
-			if ( find( begin( processedCodes ), end( processedCodes ), code ) != end( processedCodes ) ) {
+			if ( !processedCodes.insert( code ).second ) {
 				throw Utilities::Exception::xml_error( "error:\tThe call code " + codeString + " is defined multiple times. This is not allowed." );
 			}
-			processedCodes.push_back( code );
 		}
 
 		Poco::AutoPtr<AbstractConfiguration> callView( xmlFile->createView( currCode ) );
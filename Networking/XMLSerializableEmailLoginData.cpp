@@ -46,6 +46,7 @@ const std::string AUTH_KEY = "authentification";
 const std::string TRIALS_KEY = "trials";
 const std::string WAIT_TIME_KEY = "waitTime";
 const std::string CONNECTIONS_KEY = "connections";
+const std::string SESSION_IDLE_TIME_KEY = "sessionIdleTime";
 
 const std::string USER_KEY = "user";
 const std::string PASSWORD_KEY = "password";
@@ -66,7 +67,7 @@ void External::Email::CXMLSerializableEmailLoginData::SetFromXML( Poco::AutoPtr<
 	float timeDistTrial;
 	External::Email::AuthType authType;
 	External::Email::ConnectionType connectionType;
-	unsigned int numTrials, maxNumConnections;
+	unsigned int numTrials, maxNumConnections, sessionIdleTime;
 
 	// read the data from the XML-file (it is assumed that the XML-file is well-formed and valid)
 	smtpServerName = boost::algorithm::trim_copy( xmlFile->getString( SMTP_SERVER_KEY ) );
@@ -107,6 +108,7 @@ void External::Email::CXMLSerializableEmailLoginData::SetFromXML( Poco::AutoPtr<
 	numTrials = xmlFile->getUInt( TRIALS_KEY, 10 ); // default value: 10 trials
 	timeDistTrial = static_cast<float>( xmlFile->getDouble( WAIT_TIME_KEY, 60.0 ) ); // default value: 60s
 	maxNumConnections = xmlFile->getUInt( CONNECTIONS_KEY, 1 ); // default value: 1 parallel connection
+	sessionIdleTime = xmlFile->getUInt( SESSION_IDLE_TIME_KEY, External::Email::DEFAULT_SESSION_IDLE_TIME );
 
 	if ( authType != External::Email::NO_AUTH ) {
 		SetLoginInformation( senderAddress, authType, userName, password );
@@ -115,6 +117,7 @@ void External::Email::CXMLSerializableEmailLoginData::SetFromXML( Poco::AutoPtr<
 	}
 	SetServerInformation( connectionType, smtpServerName, port );
 	SetConnectionTrialInfos( numTrials, timeDistTrial, maxNumConnections );
+	SetSessionIdleTime( sessionIdleTime );
 }
 
 
@@ -188,5 +191,6 @@ void External::Email::CXMLSerializableEmailLoginData::GenerateXML( Poco::AutoPtr
 		xmlFile->setUInt( TRIALS_KEY, numTrials );
 		xmlFile->setDouble( WAIT_TIME_KEY, timeDistTrial );
 		xmlFile->setUInt( CONNECTIONS_KEY, maxNumConnections );
+		xmlFile->setUInt( SESSION_IDLE_TIME_KEY, GetSessionIdleTime() );
 	}
 }
@@ -23,7 +23,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <algorithm>
 #include <boost/date_time/posix_time/ptime.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 #include "BoostStdTimeConverter.h"
 #include "DefaultValidity.h"
@@ -39,6 +41,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "SendStatusMessage.h"
 #include "InfoalarmMessageDecorator.h"
 #include "AlarmGatewaysManager.h"
+#include "ConnectionMocks.h"
 
 using boost::unit_test::label;
 
@@ -125,6 +128,33 @@ namespace Networking {
 		}
 
 
+		std::vector<Utilities::CDateTime> sentAlarmTimes;
+		std::mutex sentAlarmTimesMutex;
+
+
+		/**	@brief	Mock class implementing a test gateway that always succeeds after a fixed sending time and records the sent alarms
+		*/
+		class CSlowMockGateway : public ConnectionMocks::CMockGateway {
+		public:
+			virtual void Send( const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const bool& isRealAlarm, std::unique_ptr<External::CGatewayLoginData> loginData, std::unique_ptr<External::CAlarmMessage> message, const Utilities::CMediaFile& audioFile ) override {
+				std::this_thread::sleep_for( std::chrono::milliseconds( 300 ) );
+				std::lock_guard<std::mutex> lock( sentAlarmTimesMutex );
+				sentAlarmTimes.push_back( alarmTime );
+			};
+			virtual std::unique_ptr<External::CAlarmGateway> Clone() const override { return std::make_unique<CSlowMockGateway>(); };
+		};
+
+
+		/**	@brief	Mock class implementing a message for the slow test gateway
+		*/
+		class CSlowMockMessage : public ConnectionMocks::CMockMessage {
+		public:
+			CSlowMockMessage() : CMockMessage( "slow message" ) {};
+			virtual std::unique_ptr<External::CAlarmMessage> Clone() const override { return std::make_unique<CSlowMockMessage>( *this ); };
+			virtual std::type_index GetGatewayType() const override { return typeid( CSlowMockGateway ); };
+		};
+
+
 		External::CGatewayLoginDatabase GetTestLoginDB()
 		{
 			using namespace std;
@@ -271,6 +301,50 @@ namespace Networking {
 			BOOST_REQUIRE_THROW( gateways.Send( code, eventTime2, Utilities::CMediaFile(), true ), std::range_error ); // there is no alarm for the present time (due to an exception)
 		}
 
+
+		/**	@brief		Testing the reset of the login database during sending with an enabled journal
+		*/
+		BOOST_AUTO_TEST_CASE( resetLoginDatabase_journal_test_case )
+		{
+			using namespace std;
+			using namespace External;
+
+			CAlarmMessageDatabase alarmDatabase;
+			CGatewayLoginDatabase loginDatabase;
+			auto journalDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+			auto eventTime1 = Utilities::CDateTime( 10, 11, 2015, Utilities::CTime( 13, 58, 2, 234 ) ); // UTC
+			auto eventTime2 = Utilities::CDateTime( 10, 11, 2015, Utilities::CTime( 13, 58, 3, 234 ) ); // UTC
+
+			// only one connection is available, the second alarm is still waiting in the queue during the reset
+			unique_ptr<CGatewayLoginData> login = make_unique<ConnectionMocks::CMockLoginData>();
+			login->SetConnectionTrialInfos( 1, 0.2f, 1 );
+			loginDatabase.Add( make_unique<CSlowMockGateway>(), move( login ) );
+			alarmDatabase.Add( code, Validities::DEFAULT_VALIDITY, make_shared<CSlowMockMessage>() );
+			sentAlarmTimes.clear();
+
+			{
+				CAlarmGatewaysManager gateways( []( unique_ptr<Utilities::Message::CStatusMessage> ) {}, OnException );
+				gateways.ResetGatewayLoginDatabase( loginDatabase );
+				gateways.ResetAlarmMessagesDatabase( alarmDatabase );
+				gateways.SetJournalDirectory( journalDir );
+
+				gateways.Send( code, eventTime1, Utilities::CMediaFile(), true );
+				gateways.Send( code, eventTime2, Utilities::CMediaFile(), true );
+				this_thread::sleep_for( 100ms );
+				BOOST_REQUIRE_NO_THROW( gateways.ResetGatewayLoginDatabase( loginDatabase ) );
+
+				// the dispatched alarm has been finished by the previous gateway, the waiting one is resent from the journal by the new gateway
+				this_thread::sleep_for( 1s );
+			}
+
+			// each alarm is sent exactly once
+			BOOST_REQUIRE( sentAlarmTimes.size() == 2 );
+			BOOST_CHECK( count( begin( sentAlarmTimes ), end( sentAlarmTimes ), eventTime1 ) == 1 );
+			BOOST_CHECK( count( begin( sentAlarmTimes ), end( sentAlarmTimes ), eventTime2 ) == 1 );
+
+			boost::filesystem::remove_all( journalDir );
+		}
+
 		BOOST_AUTO_TEST_SUITE_END();
 	}
 	/*@}*/
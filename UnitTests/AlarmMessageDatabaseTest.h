@@ -18,6 +18,8 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 
 #include <memory>
 #include <set>
+#include <thread>
+#include <atomic>
 #include <boost/test/unit_test.hpp>
 #include "AlarmMessagesDatabase.h"
 #include "Groupalarm2Message.h"
@@ -126,6 +128,165 @@ namespace Networking {
 
 
 
+		/** @brief		Generating a test database with overlapping exceptions crossing the month boundaries
+		*/
+		External::CAlarmMessageDatabase GenerateDatabaseWithOverlappingExceptions( void ) {
+			using namespace std;
+			using namespace External;
+			using namespace External::Validities;
+			using namespace External::Groupalarm;
+			using namespace External::Email;
+
+			CAlarmMessageDatabase database = GenerateDatabaseWithAllAndFallback();
+
+			database.Add( code4, DEFAULT_VALIDITY, make_shared<CEmailMessage>( email ) );
+			database.Add( code4, make_shared<CWeeklyValidity>( weeklyException ), make_shared<CGroupalarm2Message>( groupalarmException ) );
+			database.Add( code4, make_shared<CWeeklyValidity>( Utilities::Time::THURSDAY, Utilities::CTime( 22, 00, 00 ), Utilities::CTime( 22, 45, 00 ) ), make_shared<CEmailMessage>( emailFallback ) );
+			database.Add( code4, make_shared<CMonthlyValidity>( monthlyException3 ), make_shared<CGroupalarm2Message>( groupalarmEmpty ) );
+			database.Add( code4, make_shared<CSingleTimeValidity>( Utilities::CDateTime( 31, 10, 2013, Utilities::CTime( 22, 30, 0, 0 ) ), Utilities::CDateTime( 1, 11, 2013, Utilities::CTime( 1, 0, 0, 0 ) ) ), make_shared<CGroupalarm2Message>( groupalarmDefault ) );
+			database.Add( code4, make_shared<CSingleTimeValidity>( Utilities::CDateTime( 31, 12, 2013, Utilities::CTime( 23, 0, 0, 0 ) ), Utilities::CDateTime( 1, 1, 2014, Utilities::CTime( 2, 0, 0, 0 ) ) ), make_shared<CGroupalarm2Message>( groupalarmException ) );
+
+			return database;
+		}
+
+
+
+		/**	@brief		Obtains the valid alarms of alarm validities for a certain UTC time, reference implementation evaluating all validity periods on each call
+		*/
+		bool ReferenceValidAlarms( std::vector< std::shared_ptr<External::CAlarmMessage> >& alarms, const External::CAlarmValidities& alarmValidities, const boost::posix_time::ptime& alarmTime )
+		{
+			using namespace std;
+			using namespace boost::posix_time;
+			using namespace Utilities::Time;
+
+			vector< shared_ptr<External::CAlarmMessage> > defaultAlarms;
+			bool noExceptions = true;
+
+			if ( alarmValidities.Size() == 0 ) {
+				return true;
+			}
+
+			alarmValidities.GetEntry( External::Validities::DEFAULT_VALIDITY, back_inserter( defaultAlarms ) );
+			for ( auto const& validityEntry : alarmValidities.GetAllEntries() ) {
+				if ( *validityEntry.first != External::Validities::CDefaultValidity() ) {
+					for ( auto const& period : validityEntry.first->GetValidityPeriods( alarmTime.date().month(), alarmTime.date().year() ) ) {
+						if ( time_period( CBoostStdTimeConverter::ConvertToBoostTime( period.first ), CBoostStdTimeConverter::ConvertToBoostTime( period.second ) ).contains( alarmTime ) ) {
+							alarms.insert( end( alarms ), begin( validityEntry.second ), end( validityEntry.second ) );
+							noExceptions = false;
+						}
+					}
+				}
+			}
+
+			if ( noExceptions ) {
+				alarms.insert( end( alarms ), begin( defaultAlarms ), end( defaultAlarms ) );
+			}
+
+			return noExceptions;
+		}
+
+
+
+		/**	@brief		Searches the alarms of a code for a certain UTC time, reference implementation of the semantics of CAlarmMessageDatabase::Search
+		*/
+		std::vector< std::shared_ptr<External::CAlarmMessage> > ReferenceSearch( const External::CAlarmMessageDatabase& database, const std::vector<int>& code, const Utilities::CDateTime& time, bool& isDefaultDataset )
+		{
+			using namespace std;
+
+			vector< shared_ptr<External::CAlarmMessage> > alarms;
+			bool noExceptionsForCode = true;
+			bool noExceptionsAsFallback = true;
+			auto alarmTime = Utilities::Time::CBoostStdTimeConverter::ConvertToBoostTime( time );
+
+			auto codeIt = database.GetDatabase().find( code );
+			if ( codeIt != database.GetDatabase().end() ) {
+				noExceptionsForCode = ReferenceValidAlarms( alarms, codeIt->second, alarmTime );
+			}
+			if ( alarms.empty() ) {
+				noExceptionsAsFallback = ReferenceValidAlarms( alarms, database.GetFallbackAlarms(), alarmTime );
+			}
+			isDefaultDataset = noExceptionsForCode && noExceptionsAsFallback;
+			ReferenceValidAlarms( alarms, database.GetAlarmsForAllCodes(), alarmTime );
+
+			if ( alarms.empty() ) {
+				throw std::logic_error( "No alarm message valid for this code during the alarm time." );
+			}
+			alarms.erase( remove_if( begin( alarms ), end( alarms ), []( auto const& alarm ) { return alarm->IsEmpty(); } ), end( alarms ) );
+
+			return alarms;
+		}
+
+
+
+		/**	@brief		Checks if the search result of the database is identical to the reference implementation
+		*/
+		bool IsSearchAsReference( const External::CAlarmMessageDatabase& database, const std::vector<int>& code, const Utilities::CDateTime& time )
+		{
+			std::vector< std::shared_ptr<External::CAlarmMessage> > alarms, referenceAlarms;
+			bool isDefaultDataset = false, isReferenceDefaultDataset = false;
+			bool isFound = true, isReferenceFound = true;
+
+			try {
+				alarms = database.Search( code, time, isDefaultDataset );
+			} catch ( std::logic_error& ) {
+				isFound = false;
+			}
+			try {
+				referenceAlarms = ReferenceSearch( database, code, time, isReferenceDefaultDataset );
+			} catch ( std::logic_error& ) {
+				isReferenceFound = false;
+			}
+
+			if ( ( isFound != isReferenceFound ) || ( alarms.size() != referenceAlarms.size() ) ) {
+				return false;
+			}
+			if ( isFound && ( isDefaultDataset != isReferenceDefaultDataset ) ) {
+				return false;
+			}
+
+			return std::equal( begin( alarms ), end( alarms ), begin( referenceAlarms ), []( auto const& lhs, auto const& rhs ) { return *lhs == *rhs; } );
+		}
+
+
+
+		/**	@brief		Generates the test times: a regular grid and all boundaries of the validity periods of the database (and their neighbouring seconds)
+		*/
+		std::vector<Utilities::CDateTime> GenerateTestTimes( const External::CAlarmMessageDatabase& database, const boost::posix_time::ptime& startTime, const boost::posix_time::ptime& endTime )
+		{
+			using namespace std;
+			using namespace boost::posix_time;
+			using namespace boost::gregorian;
+			using namespace Utilities::Time;
+
+			vector<Utilities::CDateTime> times;
+			vector<External::CAlarmValidities> allValidities = { database.GetAlarmsForAllCodes(), database.GetFallbackAlarms() };
+
+			for ( auto currTime = startTime; currTime < endTime; currTime += minutes( 30 ) ) {
+				times.push_back( CBoostStdTimeConverter::ConvertToStdTime( currTime ) );
+			}
+
+			for ( auto const& entry : database.GetDatabase() ) {
+				allValidities.push_back( entry.second );
+			}
+			for ( auto currMonth = startTime.date(); currMonth <= endTime.date(); currMonth += months( 1 ) ) {
+				for ( auto const& validities : allValidities ) {
+					for ( auto const& validityEntry : validities.GetAllEntries() ) {
+						for ( auto const& period : validityEntry.first->GetValidityPeriods( currMonth.month(), currMonth.year() ) ) {
+							for ( auto const& boundary : { period.first, period.second } ) {
+								auto boundaryTime = CBoostStdTimeConverter::ConvertToBoostTime( boundary );
+								times.push_back( CBoostStdTimeConverter::ConvertToStdTime( boundaryTime - seconds( 1 ) ) );
+								times.push_back( boundary );
+								times.push_back( CBoostStdTimeConverter::ConvertToStdTime( boundaryTime + seconds( 1 ) ) );
+							}
+						}
+					}
+				}
+			}
+
+			return times;
+		}
+
+
 		// Test section
 		BOOST_AUTO_TEST_SUITE( AlarmMessageDatabase_test_suite, *label("default") );
 
@@ -379,6 +540,92 @@ namespace Networking {
 			BOOST_CHECK_THROW( database.GetDataset( notExistingCode ), std::logic_error );
 		}
 
+
+
+		/**	@brief		Testing of the compiled search index against the reference implementation with overlapping exceptions, segment boundaries, month rollovers, fallback and "all" alarms
+		*/
+		BOOST_AUTO_TEST_CASE( AlarmMessageDatabase_search_reference_test_case )
+		{
+			using namespace std;
+			using namespace boost::posix_time;
+			using namespace boost::gregorian;
+
+			const vector< vector<int> > codes = { code1, code2, code3, code4, notExistingCode };
+
+			for ( auto const& database : { GenerateDatabase(), GenerateDatabaseWithOverlappingExceptions() } ) {
+				auto times = GenerateTestTimes( database, ptime( date( 2013, Oct, 25 ) ), ptime( date( 2014, Jan, 5 ) ) );
+
+				// searching forward in time crosses the month boundaries in the order of a running system
+				sort( begin( times ), end( times ) );
+				for ( auto const& time : times ) {
+					for ( auto const& code : codes ) {
+						BOOST_REQUIRE( IsSearchAsReference( database, code, time ) );
+					}
+				}
+
+				// searching backward in time requires recompiling already replaced months
+				for ( auto timeIt = times.rbegin(); timeIt != times.rend(); timeIt++ ) {
+					BOOST_REQUIRE( IsSearchAsReference( database, code4, *timeIt ) );
+				}
+			}
+		}
+
+
+
+		/**	@brief		Testing of installing precomputed months concurrently to the search
+		*/
+		BOOST_AUTO_TEST_CASE( AlarmMessageDatabase_concurrent_install_test_case )
+		{
+			using namespace std;
+			using namespace boost::posix_time;
+			using namespace boost::gregorian;
+			using namespace Utilities::Time;
+
+			const vector< vector<int> > codes = { code1, code4, notExistingCode };
+			vector< vector<int> > testCodes;
+			vector<Utilities::CDateTime> testTimes;
+			vector<bool> isReferenceDefaultDataset;
+			vector< vector< shared_ptr<External::CAlarmMessage> > > referenceAlarms;
+			atomic<bool> isTerminate( false );
+			atomic<unsigned int> numInstallations( 0 );
+
+			auto database = GenerateDatabaseWithOverlappingExceptions();
+
+			// the reference results around the month boundary are determined in advance
+			for ( auto const& time : GenerateTestTimes( database, ptime( date( 2013, Oct, 31 ), hours( 12 ) ), ptime( date( 2013, Nov, 1 ), hours( 12 ) ) ) ) {
+				for ( auto const& code : codes ) {
+					bool isDefaultDataset;
+					testCodes.push_back( code );
+					testTimes.push_back( time );
+					referenceAlarms.push_back( ReferenceSearch( database, code, time, isDefaultDataset ) );
+					isReferenceDefaultDataset.push_back( isDefaultDataset );
+				}
+			}
+
+			// the current and the next month are installed continuously
+			thread installThread( [&]() {
+				auto currMonth = CBoostStdTimeConverter::ConvertToStdTime( ptime( date( 2013, Oct, 15 ) ) );
+				auto nextMonth = CBoostStdTimeConverter::ConvertToStdTime( ptime( date( 2013, Nov, 15 ) ) );
+				while ( !isTerminate ) {
+					database.InstallValidities( database.CompileValidities( nextMonth ) );
+					database.InstallValidities( database.CompileValidities( currMonth ) );
+					numInstallations++;
+				}
+			} );
+
+			for ( int run = 0; ( run < 20 ) || ( numInstallations < 10 ); run++ ) {
+				for ( size_t i = 0; i < testTimes.size(); i++ ) {
+					bool isDefaultDataset;
+					auto alarms = database.Search( testCodes[i], testTimes[i], isDefaultDataset );
+					BOOST_REQUIRE( isDefaultDataset == isReferenceDefaultDataset[i] );
+					BOOST_REQUIRE( equal( begin( alarms ), end( alarms ), begin( referenceAlarms[i] ), end( referenceAlarms[i] ), []( auto const& lhs, auto const& rhs ) { return *lhs == *rhs; } ) );
+				}
+			}
+
+			isTerminate = true;
+			installThread.join();
+		}
+
 		BOOST_AUTO_TEST_SUITE_END();
 	}
 	/*@}*/
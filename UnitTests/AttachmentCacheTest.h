@@ -0,0 +1,116 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <chrono>
+#include <thread>
+#include <string>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "AttachmentCache.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Networking {
+	/*@{*/
+	/** \ingroup AttachmentCacheTest
+	*/
+	namespace AttachmentCacheTest {
+		/**	@brief		Writes the test audio file
+		*/
+		void WriteFile( const boost::filesystem::path& filePath, const std::string& content )
+		{
+			std::ofstream file( filePath.string(), std::ios::binary | std::ios::trunc );
+			file << content;
+		}
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( AttachmentCache_test_suite, *label("default") );
+
+		/**	@brief		Testing of the caching and the invalidation of the attachments after modifications of the file
+		*/
+		BOOST_AUTO_TEST_CASE( AttachmentCache_invalidation_test_case )
+		{
+			using namespace std;
+			using namespace boost::filesystem;
+
+			auto filePath = temp_directory_path() / unique_path( "attachment_%%%%-%%%%.mp3" );
+			External::Email::CAttachmentCache cache( chrono::minutes( 5 ) );
+
+			WriteFile( filePath, "first" );
+			auto modificationTime = last_write_time( filePath );
+			auto attachmentData = cache.Read( filePath );
+			BOOST_REQUIRE( *attachmentData == "first" );
+			BOOST_REQUIRE( cache.Read( filePath ) == attachmentData ); // the file is read only once
+
+			// a modified content with the same size and modification time cannot be detected
+			WriteFile( filePath, "other" );
+			last_write_time( filePath, modificationTime );
+			BOOST_REQUIRE( *cache.Read( filePath ) == "first" );
+
+			// a changed modification time invalidates the cached content
+			last_write_time( filePath, modificationTime + 10 );
+			attachmentData = cache.Read( filePath );
+			BOOST_REQUIRE( *attachmentData == "other" );
+			BOOST_REQUIRE( cache.Read( filePath ) == attachmentData );
+
+			// a changed size invalidates the cached content
+			WriteFile( filePath, "longer content" );
+			last_write_time( filePath, modificationTime + 10 );
+			BOOST_REQUIRE( *cache.Read( filePath ) == "longer content" );
+
+			remove( filePath );
+			BOOST_CHECK_THROW( cache.Read( filePath ), boost::filesystem::filesystem_error );
+		}
+
+
+
+		/**	@brief		Testing of the expiry of the cached attachments
+		*/
+		BOOST_AUTO_TEST_CASE( AttachmentCache_expiry_test_case )
+		{
+			using namespace std;
+			using namespace std::literals;
+			using namespace boost::filesystem;
+
+			auto filePath = temp_directory_path() / unique_path( "attachment_%%%%-%%%%.mp3" );
+			External::Email::CAttachmentCache cache( 50ms );
+
+			WriteFile( filePath, "content" );
+			auto attachmentData = cache.Read( filePath );
+			this_thread::sleep_for( 100ms );
+			BOOST_REQUIRE( cache.Read( filePath ) != attachmentData );
+			BOOST_REQUIRE( *cache.Read( filePath ) == "content" );
+
+			remove( filePath );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
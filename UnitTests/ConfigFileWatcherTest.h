@@ -0,0 +1,190 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include "StatusMessage.h"
+#include "AudioDevice.h"
+#include "SettingsParam.h"
+#include "ExecutionRuntime.h"
+#include "ConfigFileWatcher.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Middleware {
+	/*@{*/
+	/** \ingroup ConfigFileWatcherTest
+	*/
+	namespace ConfigFileWatcherTest {
+		/**	@brief		Maximum time between a change of the file and the call of the change callback (including the settling time) */
+		const std::chrono::seconds maxNotificationTime{ 5 };
+
+
+		/**	@brief	Runtime without any detection or server operation, only the parameter handling is available
+		*/
+		class CTestRuntime : public CExecutionRuntime {
+		public:
+			CTestRuntime( const CSettingsParam& newParams, const boost::filesystem::path& appSettingsDir, std::function<void( std::unique_ptr<Utilities::Message::CStatusMessage> )> messageCallback )
+				: CExecutionRuntime( newParams, appSettingsDir, []( const std::string& ) {}, messageCallback ) {};
+			virtual void Run( void ) override {};
+			using CExecutionRuntime::GetParams;
+		protected:
+			virtual void OnProcessingSequence( const Utilities::CSeqData& sequence ) override {};
+		};
+
+
+		/**	@brief		Writes a file with the given content (replacing an existing file)
+		*/
+		void WriteFile( const boost::filesystem::path& file, const std::string& content )
+		{
+			boost::filesystem::ofstream stream( file, std::ios::out | std::ios::trunc );
+			stream << content;
+		}
+
+
+		/**	@brief		Counter of the calls of a callback that can be waited for
+		*/
+		class CCallCounter {
+		public:
+			void Increment() {
+				{
+					std::lock_guard<std::mutex> lock( counterMutex );
+					numCalls++;
+				}
+				counterCondition.notify_all();
+			}
+			unsigned int WaitFor( const unsigned int& minNumCalls, const std::chrono::seconds& timeout ) {
+				std::unique_lock<std::mutex> lock( counterMutex );
+				counterCondition.wait_for( lock, timeout, [&]() { return ( numCalls >= minNumCalls ); } );
+				return numCalls;
+			}
+		private:
+			std::mutex counterMutex;
+			std::condition_variable counterCondition;
+			unsigned int numCalls = 0;
+		};
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( ConfigFileWatcher_test_suite, *label("default") );
+
+		/**	@brief		Testing that a burst of changes of the configuration file causes a single notification
+		*/
+		BOOST_AUTO_TEST_CASE( ConfigFileWatcher_burst_test_case )
+		{
+			using namespace std;
+
+			CCallCounter counter;
+			auto configDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+			auto configFile = configDir / "config.xml";
+			boost::filesystem::create_directories( configDir );
+			WriteFile( configFile, "initial" );
+
+			{
+				CConfigFileWatcher watcher( configFile, [&]() { counter.Increment(); } );
+
+				// changes of other files in the directory are ignored
+				WriteFile( configDir / "other.xml", "other" );
+				this_thread::sleep_for( 2s );
+				BOOST_CHECK( counter.WaitFor( 1, 0s ) == 0 );
+
+				// saving the file several times in quick succession (also by replacing it)
+				for ( int i = 0; i < 10; i++ ) {
+					WriteFile( configFile, "change " + to_string( i ) );
+					this_thread::sleep_for( 50ms );
+				}
+				WriteFile( configDir / "config.xml.tmp", "replaced" );
+				boost::filesystem::rename( configDir / "config.xml.tmp", configFile );
+
+				BOOST_REQUIRE( counter.WaitFor( 1, maxNotificationTime ) == 1 );
+				this_thread::sleep_for( 2s );
+				BOOST_CHECK( counter.WaitFor( 2, 0s ) == 1 );
+
+				// a later change is notified again
+				WriteFile( configFile, "later change" );
+				BOOST_CHECK( counter.WaitFor( 2, maxNotificationTime ) == 2 );
+			}
+
+			boost::filesystem::remove_all( configDir );
+		}
+
+
+		/**	@brief		Testing that an invalid configuration file is reported and does not change the running parameters
+		*/
+		BOOST_AUTO_TEST_CASE( ConfigFileWatcher_invalid_config_test_case )
+		{
+			using namespace std;
+			using namespace Utilities::Message;
+
+			CCallCounter errorCounter, reloadCounter;
+			auto configDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+			auto configFile = configDir / "config.xml";
+			boost::filesystem::create_directories( configDir );
+			WriteFile( configFile, "initial" );
+
+			CSettingsParam params;
+			params.SetFunctionalitySettings( Core::Processing::CAudioDevice( Core::IN_DEVICE, "Microsoft", "MME" ), 10.0, false );
+			params.SetRecordingSettings( 15.0, false, "OGG" );
+			params.SetGatewaySettings( External::CGatewayLoginDatabase(), External::CAlarmMessageDatabase() );
+			CTestRuntime runtime( params, configDir, [&]( unique_ptr<CStatusMessage> message ) {
+				if ( message->GetType() == MESSAGE_ERROR ) {
+					errorCounter.Increment();
+				}
+			} );
+
+			{
+				CConfigFileWatcher watcher( configFile, [&]() {
+					runtime.ReloadParams( configFile, configDir, configDir );
+					reloadCounter.Increment();
+				} );
+
+				// the burst of changes results in a single reload, the invalid file is reported only once
+				for ( int i = 0; i < 5; i++ ) {
+					WriteFile( configFile, "<config><invalid" );
+					this_thread::sleep_for( 50ms );
+				}
+				BOOST_REQUIRE( reloadCounter.WaitFor( 1, maxNotificationTime ) == 1 );
+				this_thread::sleep_for( 2s );
+				BOOST_CHECK( reloadCounter.WaitFor( 2, 0s ) == 1 );
+				BOOST_CHECK( errorCounter.WaitFor( 2, 0s ) == 1 );
+			}
+
+			// the previous settings remain valid
+			BOOST_CHECK( runtime.GetParams() == params );
+			boost::filesystem::remove_all( configDir );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+	/*@}*/
+}
+/*@}*/
+/*@}*/
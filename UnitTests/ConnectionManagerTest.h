@@ -23,11 +23,13 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <algorithm>
 #include <boost/test/unit_test.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/date_time/posix_time/ptime.hpp>
 #include "ConnectionMocks.h"
 #include "SendStatusMessage.h"
 #include "BoostStdTimeConverter.h"
 #include "ConnectionManager.h"
+#include "MessageJournal.h"
 
 using boost::unit_test::label;
 
@@ -79,6 +81,17 @@ namespace Networking {
 		}
 
 
+		/**	@brief	Mock class implementing a test gateway that always succeeds after a fixed sending time
+		*/
+		class CSlowMockGateway : public ConnectionMocks::CMockGateway {
+		public:
+			virtual void Send( const std::vector<int>& code, const Utilities::CDateTime& alarmTime, const bool& isRealAlarm, std::unique_ptr<External::CGatewayLoginData> loginData, std::unique_ptr<External::CAlarmMessage> message, const Utilities::CMediaFile& audioFile ) override {
+				std::this_thread::sleep_for( std::chrono::milliseconds( 300 ) );
+			};
+			virtual std::unique_ptr<External::CAlarmGateway> Clone() const override { return std::make_unique<CSlowMockGateway>(); };
+		};
+
+
 		/** @brief	Callback function used for signalling exception in the thread class */
 		void OnThreadException( const std::exception_ptr& error ) {
 			// in production code the notification of the caller thread is required here (followed by std::rethrow_exception( error )
@@ -212,6 +225,44 @@ namespace Networking {
 			BOOST_REQUIRE( all_of( begin( timeDists ), end( timeDists ), []( auto entry ) { return ( entry >= chrono::milliseconds( static_cast<long long>( timeDistTrials * 1000 ) ) ); } ) );
 		}
 
+
+
+		/**	@brief		Testing of the journal if the connection manager is destroyed during a running sending trial
+		*/
+		BOOST_AUTO_TEST_CASE( shutdown_during_sending_test_case )
+		{
+			using namespace std;
+			using namespace literals;
+			using namespace ConnectionMocks;
+			using namespace boost::filesystem;
+
+			auto journalFile = temp_directory_path() / unique_path( "journal_%%%%-%%%%.dat" );
+			unique_ptr< External::CGatewayLoginData > login( new CMockLoginData );
+			login->SetConnectionTrialInfos( maxNumTrials, timeDistTrials, 1 );
+			auto time = Utilities::Time::CBoostStdTimeConverter::ConvertToStdTime( boost::posix_time::microsec_clock::universal_time() );
+
+			{
+				External::CConnectionManager connectionManager( make_unique<CSlowMockGateway>(), login->Clone(), []( unique_ptr<Utilities::Message::CStatusMessage> ) {}, OnThreadException );
+				BOOST_REQUIRE( connectionManager.OpenJournal( journalFile ).empty() );
+				connectionManager.AddMessage( sequence, time, isRealAlarm, make_unique<CMockMessage>( "message 1" ), audioFile, 0 );
+				connectionManager.AddMessage( sequence, time, isRealAlarm, make_unique<CMockMessage>( "message 2" ), audioFile, 1 );
+
+				// the first message is sent, the second one is waiting for the only connection
+				this_thread::sleep_for( 100ms );
+			}
+
+			// only the message that has never been dispatched must be replayed
+			{
+				External::CMessageJournal journal( journalFile, []( const string& ) {} );
+				auto pendingEntries = journal.GetPendingEntries();
+				BOOST_REQUIRE( pendingEntries.size() == 1 );
+				BOOST_REQUIRE( pendingEntries.begin()->second.messageIndex == 1 );
+				BOOST_REQUIRE( !pendingEntries.begin()->second.isInFlight );
+			}
+
+			remove( journalFile );
+		}
+
 		BOOST_AUTO_TEST_SUITE_END();
 	}
 	/*@}*/
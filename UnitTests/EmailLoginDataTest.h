@@ -42,6 +42,7 @@ namespace Networking {
 			const External::Email::AuthType authTypeSet = External::Email::UNENCRYPTED_AUTH;
 			const std::string userNameSet = "user";
 			const std::string passwordSet = "password";
+			const unsigned int sessionIdleTimeSet = 20;
 
 			// Test section
 			BOOST_AUTO_TEST_SUITE( EmailLoginData_test_suite, *label("default") );
@@ -103,6 +104,10 @@ namespace Networking {
 				BOOST_REQUIRE( userNameSet == userNameGet );
 				BOOST_REQUIRE( passwordSet == passwordGet );
 
+				BOOST_REQUIRE( dynamic_cast<CEmailLoginData*>( login.get() )->GetSessionIdleTime() == DEFAULT_SESSION_IDLE_TIME );
+				dynamic_cast<CEmailLoginData*>( login.get() )->SetSessionIdleTime( sessionIdleTimeSet );
+				BOOST_REQUIRE( dynamic_cast<CEmailLoginData*>( login.get() )->GetSessionIdleTime() == sessionIdleTimeSet );
+
 				BOOST_REQUIRE( CEmailLoginData::GetDefaultPort( connectionTypeSet, authTypeSet ) == 465 );
 			}
 
@@ -125,6 +130,9 @@ namespace Networking {
 				BOOST_REQUIRE( login == login );
 				BOOST_REQUIRE( !( login == login2 ) );
 				BOOST_REQUIRE( ( login != login2 ) );
+				unique_ptr<CGatewayLoginData> login3 = login->Clone();
+				dynamic_cast<Email::CEmailLoginData*>( login3.get() )->SetSessionIdleTime( sessionIdleTimeSet );
+				BOOST_REQUIRE( *login != *login3 );
 				BOOST_REQUIRE( Email::CEmailLoginData() == Email::CEmailLoginData() );
 			}
 
@@ -0,0 +1,140 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "StatusMessage.h"
+#include "AudioDevice.h"
+#include "SettingsParam.h"
+#include "BoostStdTimeConverter.h"
+#include "FMEClient.h"
+#include "ExecutionServerRuntime.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Middleware {
+	/*@{*/
+	/** \ingroup ExecutionServerRuntimeTest
+	*/
+	namespace ExecutionServerRuntimeTest {
+		/** @param	serverPort			TCP port of the server runtime used for the tests */
+		const unsigned short serverPort = 16355;
+		/** @param	maxForwardingTime	Maximum time between sending a sequence and its forwarding by the server runtime */
+		const std::chrono::seconds maxForwardingTime{ 5 };
+
+
+		/**	@brief	Storage of the forwarded sequences that can be waited for
+		*/
+		class CForwardedSequences {
+		public:
+			void Add( const Utilities::CSeqData& sequence ) {
+				{
+					std::lock_guard<std::mutex> lock( sequencesMutex );
+					sequences.push_back( sequence );
+				}
+				sequencesCondition.notify_all();
+			}
+			std::vector<Utilities::CSeqData> WaitFor( const size_t& minNumSequences, const std::chrono::seconds& timeout ) {
+				std::unique_lock<std::mutex> lock( sequencesMutex );
+				sequencesCondition.wait_for( lock, timeout, [&]() { return ( sequences.size() >= minNumSequences ); } );
+				return sequences;
+			}
+		private:
+			std::mutex sequencesMutex;
+			std::condition_variable sequencesCondition;
+			std::vector<Utilities::CSeqData> sequences;
+		};
+
+
+		/**	@brief		Sends a sequence as a detector site
+		*/
+		void SendFromSite( Networking::CFMEClient& site, const std::vector<int>& code, const boost::posix_time::ptime& time )
+		{
+			site.Send( Utilities::CSeqData( Utilities::Time::CBoostStdTimeConverter::ConvertToStdTime( time ), code, "" ) );
+			BOOST_REQUIRE( site.Run() );
+		}
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( ExecutionServerRuntime_test_suite, *label("default") );
+
+		/**	@brief		Testing that an alarm received from two detector sites is forwarded only once
+		*/
+		BOOST_AUTO_TEST_CASE( ExecutionServerRuntime_two_sites_test_case )
+		{
+			using namespace std;
+			using namespace boost::posix_time;
+
+			const vector<int> code = { 0, 1, 2, 3, 4 };
+			const vector<int> otherCode = { 0, 1, 2, 3, 5 };
+			CForwardedSequences forwarded;
+			auto dataDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+			boost::filesystem::create_directories( dataDir );
+
+			CSettingsParam params;
+			params.SetFunctionalitySettings( Core::Processing::CAudioDevice( Core::IN_DEVICE, "Microsoft", "MME" ), 2.0, false );
+			params.SetRecordingSettings( 15.0, false, "OGG" );
+			params.SetGatewaySettings( External::CGatewayLoginDatabase(), External::CAlarmMessageDatabase() );
+
+			{
+				CExecutionServerRuntime runtime( params, dataDir, dataDir, "127.0.0.1", serverPort, [&]( const Utilities::CSeqData& sequence ) { forwarded.Add( sequence ); }, []( const string& ) {}, []( unique_ptr<Utilities::Message::CStatusMessage> ) {} );
+				runtime.Run();
+
+				Networking::CFMEClient siteA( "127.0.0.1", serverPort );
+				Networking::CFMEClient siteB( "127.0.0.1", serverPort );
+				auto refTime = microsec_clock::universal_time();
+
+				// both sites detect the same alarm, the clocks of the sites deviate slightly
+				SendFromSite( siteA, code, refTime );
+				SendFromSite( siteB, code, refTime + milliseconds( 500 ) );
+
+				// different alarms are forwarded independent of the site
+				SendFromSite( siteB, otherCode, refTime + milliseconds( 300 ) );
+				SendFromSite( siteA, code, refTime + seconds( 5 ) );
+
+				auto sequences = forwarded.WaitFor( 3, maxForwardingTime );
+				BOOST_REQUIRE( sequences.size() == 3 );
+				BOOST_CHECK( sequences[0].GetCode() == code );
+				BOOST_CHECK( sequences[1].GetCode() == otherCode );
+				BOOST_CHECK( sequences[2].GetCode() == code );
+			}
+
+			// no further sequence has been forwarded until the server was stopped
+			BOOST_CHECK( forwarded.WaitFor( 4, chrono::seconds( 0 ) ).size() == 3 );
+			boost::filesystem::remove_all( dataDir );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+	/*@}*/
+}
+/*@}*/
+/*@}*/
@@ -0,0 +1,253 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <array>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+#include "FMEClient.h"
+#include "FMESession.h"
+#include "FMEFrameCodec.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+
+/**	\defgroup	FMEClient			Unit test for the protocol handling of the client of the FME network transmission
+*/
+
+namespace Networking {
+	/*@{*/
+	/** \ingroup FMEClient
+	*/
+	namespace FMEClientTest {
+		/**	@brief	Server for testing the client, the connections are accepted one after the other and handled by the given functions in their order
+		*/
+		class CScriptedServer {
+		public:
+			CScriptedServer( std::vector< std::function<void( boost::asio::ip::tcp::socket& )> > connectionHandlers )
+				: acceptor( ioService, boost::asio::ip::tcp::endpoint( boost::asio::ip::address_v4::loopback(), 0 ) )
+			{
+				serverThread = std::thread( [this, connectionHandlers]() {
+					for ( const auto& handler : connectionHandlers ) {
+						boost::asio::ip::tcp::socket socket( ioService );
+						boost::system::error_code error;
+						acceptor.accept( socket, error );
+						if ( error ) {
+							return;
+						}
+						try {
+							handler( socket );
+						} catch (...) {
+						}
+					}
+				} );
+			}
+			~CScriptedServer() {
+				serverThread.join();
+			}
+			unsigned short GetPort() {
+				return acceptor.local_endpoint().port();
+			}
+		private:
+			boost::asio::io_service ioService;
+			boost::asio::ip::tcp::acceptor acceptor;
+			std::thread serverThread;
+		};
+
+
+		/**	@brief		Reads the complete handshake of a client requesting protocol version 2
+		*/
+		std::string ReadHandshake( boost::asio::ip::tcp::socket& socket )
+		{
+			std::string handshake( Session::handshakeID.size() + Session::handshakeTrailer.size(), '\0' );
+			boost::asio::read( socket, boost::asio::buffer( &handshake[0], handshake.size() ) );
+			return handshake;
+		}
+
+
+		/**	@brief		Reads a sequence frame of protocol version 2
+		*/
+		Utilities::CSeqData ReadSequenceFrame( boost::asio::ip::tcp::socket& socket )
+		{
+			std::array<unsigned char, Session::Codec::frameHeaderSize> header;
+			Session::Codec::FrameType frameType;
+			std::uint32_t payloadLength;
+			Utilities::CSeqData sequence;
+
+			boost::asio::read( socket, boost::asio::buffer( header ) );
+			Session::Codec::DecodeFrameHeader( header, frameType, payloadLength );
+			std::vector<char> payload( payloadLength );
+			boost::asio::read( socket, boost::asio::buffer( payload ) );
+			BOOST_CHECK( frameType == Session::Codec::SEQUENCE_FRAME );
+			Session::Codec::DecodeSequence( payload.data(), payload.size(), sequence );
+
+			return sequence;
+		}
+
+
+		/**	@brief		Reads all data until the client closes the connection
+		*/
+		std::string ReadUntilClosed( boost::asio::ip::tcp::socket& socket )
+		{
+			boost::asio::streambuf data;
+			boost::system::error_code error;
+			boost::asio::read( socket, data, boost::asio::transfer_all(), error );
+			return std::string( boost::asio::buffers_begin( data.data() ), boost::asio::buffers_end( data.data() ) );
+		}
+
+
+		/**	@brief		Behaviour of a server of protocol version 2
+		*/
+		void ConfirmHandshake( boost::asio::ip::tcp::socket& socket )
+		{
+			BOOST_CHECK( ReadHandshake( socket ) == Session::handshakeID + Session::handshakeTrailer );
+			boost::asio::write( socket, boost::asio::buffer( Session::handshakeID ) );
+		}
+
+
+		void Acknowledge( boost::asio::ip::tcp::socket& socket )
+		{
+			boost::asio::write( socket, boost::asio::buffer( Session::Codec::EncodeFrame( Session::Codec::ACK_FRAME, std::string() ) ) );
+		}
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( FMEClient_test_suite, *label("default") );
+
+		/**	@brief		Testing the fallback to protocol version 1 if the server replies as a server of this version
+		*/
+		BOOST_AUTO_TEST_CASE( FMEClient_legacy_server_test_case )
+		{
+			using namespace std;
+			string legacyData;
+
+			Utilities::CSeqData sequence( Utilities::CDateTime( 10, 6, 2012, Utilities::CTime( 11, 7, 20, 205 ) ), vector<int>{ 1, 2, 3, 4, 5 }, "" );
+			{
+				CScriptedServer server( {
+					// a server of protocol version 1 reads the handshake as an invalid header and closes the connection
+					[]( boost::asio::ip::tcp::socket& socket ) {
+						boost::asio::streambuf data;
+						boost::asio::read_until( socket, data, Session::baseHeaderID );
+						socket.close();
+					},
+					[&]( boost::asio::ip::tcp::socket& socket ) { legacyData = ReadUntilClosed( socket ); }
+				} );
+
+				CFMEClient client( "127.0.0.1", server.GetPort() );
+				client.Send( sequence );
+				BOOST_REQUIRE( client.Run() );
+			}
+
+			// the sequence is sent as a header of protocol version 1 followed by the data
+			BOOST_REQUIRE( legacyData.find( Session::baseHeaderID ) != string::npos );
+			BOOST_CHECK( isdigit( static_cast<unsigned char>( legacyData.front() ) ) );
+		}
+
+
+		/**	@brief		Testing that a missing answer to the handshake does not cause the fallback to protocol version 1
+		*/
+		BOOST_AUTO_TEST_CASE( FMEClient_handshake_timeout_test_case )
+		{
+			using namespace std;
+			Utilities::CSeqData receivedSequence;
+
+			Utilities::CSeqData sequence( Utilities::CDateTime( 10, 6, 2012, Utilities::CTime( 11, 7, 20, 205 ) ), vector<int>{ 1, 2, 3, 4, 5 }, "" );
+			{
+				CScriptedServer server( {
+					// the server does not answer in time
+					[]( boost::asio::ip::tcp::socket& socket ) {
+						ReadHandshake( socket );
+						ReadUntilClosed( socket );
+					},
+					[&]( boost::asio::ip::tcp::socket& socket ) {
+						ConfirmHandshake( socket );
+						receivedSequence = ReadSequenceFrame( socket );
+						Acknowledge( socket );
+						ReadUntilClosed( socket );
+					}
+				} );
+
+				CFMEClient client( "127.0.0.1", server.GetPort() );
+				client.Send( sequence );
+				BOOST_REQUIRE( !client.Run() );
+
+				// protocol version 2 is requested again
+				client.Send( sequence );
+				BOOST_REQUIRE( client.Run() );
+			}
+
+			BOOST_CHECK( receivedSequence.GetCode() == sequence.GetCode() );
+		}
+
+
+		/**	@brief		Testing that a sequence not acknowledged on a reused connection is sent once more on a new connection
+		*/
+		BOOST_AUTO_TEST_CASE( FMEClient_acknowledgement_test_case )
+		{
+			using namespace std;
+			vector<Utilities::CSeqData> receivedSequences;
+
+			Utilities::CSeqData sequence1( Utilities::CDateTime( 10, 6, 2012, Utilities::CTime( 11, 7, 20, 205 ) ), vector<int>{ 1, 2, 3, 4, 5 }, "" );
+			Utilities::CSeqData sequence2( Utilities::CDateTime( 10, 6, 2012, Utilities::CTime( 11, 7, 30, 205 ) ), vector<int>{ 5, 4, 3, 2, 1 }, "" );
+			{
+				CScriptedServer server( {
+					// the connection breaks down after the first sequence without notice
+					[&]( boost::asio::ip::tcp::socket& socket ) {
+						ConfirmHandshake( socket );
+						receivedSequences.push_back( ReadSequenceFrame( socket ) );
+						Acknowledge( socket );
+						ReadSequenceFrame( socket );
+						ReadUntilClosed( socket );
+					},
+					[&]( boost::asio::ip::tcp::socket& socket ) {
+						ConfirmHandshake( socket );
+						receivedSequences.push_back( ReadSequenceFrame( socket ) );
+						Acknowledge( socket );
+						ReadUntilClosed( socket );
+					}
+				} );
+
+				CFMEClient client( "127.0.0.1", server.GetPort() );
+				client.Send( sequence1 );
+				BOOST_REQUIRE( client.Run() );
+				client.Send( sequence2 );
+				BOOST_REQUIRE( client.Run() );
+			}
+
+			BOOST_REQUIRE( receivedSequences.size() == 2 );
+			BOOST_CHECK( receivedSequences[0].GetCode() == sequence1.GetCode() );
+			BOOST_CHECK( receivedSequences[1].GetCode() == sequence2.GetCode() );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+	/*@}*/
+}
+/*@}*/
+/*@}*/
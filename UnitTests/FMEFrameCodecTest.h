@@ -0,0 +1,165 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <boost/test/unit_test.hpp>
+#include "FMEFrameCodec.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+
+/**	\defgroup	FMEFrameCodec			Unit test for the binary encoding of protocol version 2 of the FME network transmission
+*/
+
+namespace Networking {
+	/*@{*/
+	/** \ingroup FMEFrameCodec
+	*/
+	namespace FMEFrameCodecTest {
+		// Test section
+		BOOST_AUTO_TEST_SUITE( FMEFrameCodec_test_suite, *label("default") );
+
+		/**	@brief		Testing of the encoding and decoding of a sequence
+		*/
+		BOOST_AUTO_TEST_CASE( FMEFrameCodec_sequence_test_case )
+		{
+			using namespace std;
+			using namespace Networking::Session;
+			vector<int> tones;
+			Utilities::CSeqData dataGet;
+
+			// generate test data
+			for (int i=0; i < 5; i++) {
+				tones.push_back( i );
+			}
+			Utilities::CSeqData dataSet( Utilities::CDateTime( 10, 6, 2012, Utilities::CTime( 11, 07, 20, 205 ) ), tones, "Test string." );
+
+			// encode and decode
+			auto encodedData = Codec::EncodeSequence( dataSet );
+			Codec::DecodeSequence( encodedData.data(), encodedData.size(), dataGet );
+
+			// check for identity
+			BOOST_REQUIRE( dataSet == dataGet );
+
+			// sequences with an invalid start time are transmitted as well
+			dataSet = Utilities::CSeqData( Utilities::CDateTime(), tones, "" );
+			encodedData = Codec::EncodeSequence( dataSet );
+			Codec::DecodeSequence( encodedData.data(), encodedData.size(), dataGet );
+			BOOST_REQUIRE( dataSet == dataGet );
+		}
+
+
+
+		/**	@brief		Testing of the encoding and decoding of a sequence with the full tone information
+		*/
+		BOOST_AUTO_TEST_CASE( FMEFrameCodec_sequence_complete_test_case )
+		{
+			using namespace std;
+			using namespace Networking::Session;
+			Utilities::CCodeData<float> codeData;
+			Utilities::CSeqDataComplete<float> dataGet;
+
+			// generate test data
+			for (int i=0; i < 5; i++) {
+				codeData.AddOneTone( i, 0.07f * i, 0.0701f, 1060.0f + i, 0.35f );
+			}
+			Utilities::CSeqDataComplete<float> dataSet( Utilities::CDateTime( 10, 6, 2012, Utilities::CTime( 11, 07, 20, 205 ) ), codeData, "Test string." );
+
+			// encode and decode
+			auto encodedData = Codec::EncodeSequence( dataSet );
+			Codec::DecodeSequence( encodedData.data(), encodedData.size(), dataGet );
+
+			// check for identity
+			BOOST_REQUIRE( dataSet == dataGet );
+		}
+
+
+
+		/**	@brief		Testing of the rejection of invalid data
+		*/
+		BOOST_AUTO_TEST_CASE( FMEFrameCodec_invalid_data_test_case )
+		{
+			using namespace std;
+			using namespace Networking::Session;
+			Utilities::CSeqData dataGet;
+			array<unsigned char, Codec::frameHeaderSize> header;
+			Codec::FrameType frameType;
+			uint32_t payloadLength;
+
+			Utilities::CSeqData dataSet( Utilities::CDateTime( 10, 6, 2012, Utilities::CTime( 11, 07, 20, 205 ) ), vector<int>{ 1, 2, 3 }, "Test string." );
+			auto encodedData = Codec::EncodeSequence( dataSet );
+
+			// truncated and too long data
+			BOOST_CHECK_THROW( Codec::DecodeSequence( encodedData.data(), encodedData.size() - 1, dataGet ), std::length_error );
+			encodedData.push_back( 0 );
+			BOOST_CHECK_THROW( Codec::DecodeSequence( encodedData.data(), encodedData.size(), dataGet ), std::length_error );
+
+			// frame header
+			auto frame = Codec::EncodeFrame( Codec::SEQUENCE_FRAME, string( 10, 'a' ) );
+			BOOST_REQUIRE( frame.size() == Codec::frameHeaderSize + 10 );
+			copy( frame.begin(), frame.begin() + Codec::frameHeaderSize, header.begin() );
+			Codec::DecodeFrameHeader( header, frameType, payloadLength );
+			BOOST_REQUIRE( frameType == Codec::SEQUENCE_FRAME );
+			BOOST_REQUIRE( payloadLength == 10 );
+
+			header[0] = 0;
+			BOOST_CHECK_THROW( Codec::DecodeFrameHeader( header, frameType, payloadLength ), std::domain_error );
+			header = { Codec::HEARTBEAT_FRAME, 0xFF, 0xFF, 0xFF, 0xFF };
+			BOOST_CHECK_THROW( Codec::DecodeFrameHeader( header, frameType, payloadLength ), std::length_error );
+		}
+
+
+
+		/**	@brief		Testing of the encoding and decoding of a subscription request
+		*/
+		BOOST_AUTO_TEST_CASE( FMEFrameCodec_subscription_test_case )
+		{
+			using namespace std;
+			using namespace Networking::Session;
+			Codec::SlowSubscriberPolicy policy;
+			vector<int> codePrefix;
+
+			auto encodedData = Codec::EncodeSubscription( Codec::DISCONNECT_SUBSCRIBER, vector<int>{ 2, 3, 10 } );
+			Codec::DecodeSubscription( encodedData.data(), encodedData.size(), policy, codePrefix );
+			BOOST_REQUIRE( policy == Codec::DISCONNECT_SUBSCRIBER );
+			BOOST_REQUIRE( codePrefix == vector<int>( { 2, 3, 10 } ) );
+
+			// subscription of all sequences
+			encodedData = Codec::EncodeSubscription( Codec::DROP_SEQUENCES, vector<int>() );
+			Codec::DecodeSubscription( encodedData.data(), encodedData.size(), policy, codePrefix );
+			BOOST_REQUIRE( policy == Codec::DROP_SEQUENCES );
+			BOOST_REQUIRE( codePrefix.empty() );
+
+			// invalid data
+			BOOST_CHECK_THROW( Codec::DecodeSubscription( encodedData.data(), encodedData.size() - 1, policy, codePrefix ), std::length_error );
+			encodedData[0] = 0;
+			BOOST_CHECK_THROW( Codec::DecodeSubscription( encodedData.data(), encodedData.size(), policy, codePrefix ), std::domain_error );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
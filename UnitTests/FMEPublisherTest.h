@@ -0,0 +1,201 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+#include "FMEPublisher.h"
+#include "FMESession.h"
+#include "FMEFrameCodec.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup Networking
+*/
+
+/**	\defgroup	FMEPublisher		Unit test for the publishing server of the FME network transmission
+*/
+
+namespace Networking {
+	/*@{*/
+	/** \ingroup FMEPublisher
+	*/
+	namespace FMEPublisherTest {
+		/** @param	publisherPort		TCP port of the publishing server used for the tests */
+		const unsigned short publisherPort = 16399;
+		/** @param	numSequences		Number of sequences published in the tests */
+		const int numSequences = 300;
+		/** @param	ringCapacity		Number of sequences kept for the subscribers in the tests */
+		const size_t ringCapacity = 32;
+
+
+		/**	@brief		Connects to the publishing server and subscribes to all sequences
+		*/
+		std::unique_ptr<boost::asio::ip::tcp::socket> Subscribe( boost::asio::io_service& ioService, const boost::asio::ip::address& address, const int& receiveBufferSize = 0 )
+		{
+			using namespace Session;
+			auto socket = std::make_unique<boost::asio::ip::tcp::socket>( ioService );
+
+			socket->open( address.is_v6() ? boost::asio::ip::tcp::v6() : boost::asio::ip::tcp::v4() );
+			if ( receiveBufferSize > 0 ) {
+				socket->set_option( boost::asio::socket_base::receive_buffer_size( receiveBufferSize ) );
+			}
+			socket->connect( boost::asio::ip::tcp::endpoint( address, publisherPort ) );
+			boost::asio::write( *socket, boost::asio::buffer( handshakeID + Codec::EncodeFrame( Codec::SUBSCRIBE_FRAME, Codec::EncodeSubscription( Codec::DROP_SEQUENCES, std::vector<int>() ) ) ) );
+
+			std::string reply( handshakeID.size(), '\0' );
+			boost::asio::read( *socket, boost::asio::buffer( &reply[0], reply.size() ) );
+			BOOST_REQUIRE( reply == handshakeID );
+
+			return socket;
+		}
+
+
+		/**	@brief		Receives the next sequence, heartbeats are skipped. The number of the sequence is returned.
+		*/
+		int ReceiveSequence( boost::asio::ip::tcp::socket& socket )
+		{
+			using namespace Session;
+			std::array<unsigned char, Codec::frameHeaderSize> header;
+			Codec::FrameType frameType;
+			std::uint32_t payloadLength;
+			std::vector<char> payload;
+			Utilities::CSeqData sequence;
+
+			do {
+				boost::asio::read( socket, boost::asio::buffer( header ) );
+				Codec::DecodeFrameHeader( header, frameType, payloadLength );
+				payload.resize( payloadLength );
+				boost::asio::read( socket, boost::asio::buffer( payload ) );
+			} while ( frameType != Codec::SEQUENCE_FRAME );
+			Codec::DecodeSequence( payload.data(), payload.size(), sequence );
+
+			return std::stoi( sequence.GetInfoString() );
+		}
+
+
+		/**	@brief		Publishes the sequences with the number in the info string
+		*/
+		void PublishSequences( CFMEPublisher& publisher )
+		{
+			Utilities::CDateTime startTime( 10, 6, 2012, Utilities::CTime( 11, 7, 20, 205 ) );
+
+			for ( int i = 0; i < numSequences; i++ ) {
+				publisher.Publish( Utilities::CSeqData( startTime, std::vector<int>{ 1, 2, 3, 4, 5 }, std::to_string( i ) + " " + std::string( 50000, 'x' ) ) );
+				std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+			}
+		}
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( FMEPublisher_test_suite, *label("default") );
+
+		/**	@brief		Testing that a stalled subscriber skips the overwritten sequences without delaying the other subscriber or the publisher
+		*/
+		BOOST_AUTO_TEST_CASE( FMEPublisher_stalled_subscriber_test_case )
+		{
+			using namespace std;
+			boost::asio::io_service ioService;
+			vector<int> liveSequences, stalledSequences;
+
+			CFMEPublisher publisher( publisherPort, ringCapacity );
+			publisher.Start();
+			auto liveSocket = Subscribe( ioService, boost::asio::ip::address_v4::loopback() );
+			auto stalledSocket = Subscribe( ioService, boost::asio::ip::address_v4::loopback(), 4096 );
+
+			// the stalled subscriber does not read anything during the publishing
+			thread liveThread( [&]() {
+				for ( int i = 0; i < numSequences; i++ ) {
+					liveSequences.push_back( ReceiveSequence( *liveSocket ) );
+				}
+			} );
+			auto startTime = chrono::steady_clock::now();
+			PublishSequences( publisher );
+			auto publishingTime = chrono::steady_clock::now() - startTime;
+			liveThread.join();
+
+			do {
+				stalledSequences.push_back( ReceiveSequence( *stalledSocket ) );
+			} while ( stalledSequences.back() < numSequences - 1 );
+
+			// the live subscriber received all sequences in time
+			BOOST_CHECK( publishingTime < chrono::seconds( 5 ) );
+			BOOST_REQUIRE( liveSequences.size() == numSequences );
+			for ( int i = 0; i < numSequences; i++ ) {
+				BOOST_CHECK( liveSequences[i] == i );
+			}
+
+			// the stalled subscriber skipped the overwritten sequences but it is still connected
+			BOOST_CHECK( stalledSequences.size() < numSequences );
+			BOOST_CHECK( is_sorted( stalledSequences.begin(), stalledSequences.end() ) );
+			BOOST_CHECK( adjacent_find( stalledSequences.begin(), stalledSequences.end() ) == stalledSequences.end() );
+			BOOST_CHECK( publisher.GetNumSubscribers() == 2 );
+
+			publisher.Stop();
+		}
+
+
+		/**	@brief		Testing that the publishing server accepts subscribers both via IPv6 and IPv4
+		*/
+		BOOST_AUTO_TEST_CASE( FMEPublisher_dual_stack_test_case )
+		{
+			using namespace std;
+			boost::asio::io_service ioService;
+			boost::system::error_code error;
+
+			// the test requires IPv6 to be available on the system
+			boost::asio::ip::tcp::socket testSocket( ioService );
+			testSocket.open( boost::asio::ip::tcp::v6(), error );
+			if ( !error ) {
+				testSocket.bind( boost::asio::ip::tcp::endpoint( boost::asio::ip::address_v6::loopback(), 0 ), error );
+			}
+			testSocket.close();
+			if ( error ) {
+				BOOST_TEST_MESSAGE( "IPv6 is not available, the test is skipped." );
+				return;
+			}
+
+			CFMEPublisher publisher( publisherPort, ringCapacity );
+			publisher.Start();
+			auto socketV4 = Subscribe( ioService, boost::asio::ip::address_v4::loopback() );
+			auto socketV6 = Subscribe( ioService, boost::asio::ip::address_v6::loopback() );
+
+			publisher.Publish( Utilities::CSeqData( Utilities::CDateTime( 10, 6, 2012, Utilities::CTime( 11, 7, 20, 205 ) ), vector<int>{ 1, 2, 3, 4, 5 }, "7" ) );
+			BOOST_CHECK( ReceiveSequence( *socketV4 ) == 7 );
+			BOOST_CHECK( ReceiveSequence( *socketV6 ) == 7 );
+
+			publisher.Stop();
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+	/*@}*/
+}
+/*@}*/
+/*@}*/
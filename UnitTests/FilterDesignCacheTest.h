@@ -0,0 +1,118 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "FilterDesignCache.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace FilterTests {
+	/*@{*/
+	/** \ingroup FilterDesignCacheTest
+	*/
+	namespace FilterDesignCacheTest {
+		// Test section
+		BOOST_AUTO_TEST_SUITE( FilterDesignCache_test_suite, *label("default") );
+
+		/**	@brief		Testing of the persistence of the cached filter orders
+		*/
+		BOOST_AUTO_TEST_CASE( FilterDesignCache_test_case )
+		{
+			using namespace boost::filesystem;
+			using Core::Processing::Filter::CFilterDesignCache;
+
+			int filterOrder;
+			auto cacheFile = temp_directory_path() / unique_path();
+
+			auto& designCache = CFilterDesignCache::Instance();
+			designCache.Clear();
+			designCache.SetCacheFile( cacheFile.string() );
+			BOOST_REQUIRE( !designCache.GetFilterOrder( 250.0, 3400.0, 44100.0, 500, 1000, filterOrder ) );
+
+			BOOST_REQUIRE( designCache.AddFilterOrder( 250.0, 3400.0, 44100.0, 500, 1000, 582 ) );
+			BOOST_REQUIRE( designCache.AddFilterOrder( 1.0 / 3.0, 3400.0, 44100.0, 500, 1000, 996 ) );
+			BOOST_REQUIRE( !exists( cacheFile.string() + ".tmp" ) );
+			BOOST_REQUIRE( designCache.GetFilterOrder( 250.0, 3400.0, 44100.0, 500, 1000, filterOrder ) );
+			BOOST_REQUIRE( filterOrder == 582 );
+			BOOST_REQUIRE( !designCache.GetFilterOrder( 250.0, 3400.0, 44100.0, 500, 800, filterOrder ) );
+
+			// the filter orders are restored exactly from the file
+			designCache.Clear();
+			designCache.SetCacheFile( cacheFile.string() );
+			BOOST_REQUIRE( designCache.GetFilterOrder( 250.0, 3400.0, 44100.0, 500, 1000, filterOrder ) );
+			BOOST_REQUIRE( filterOrder == 582 );
+			BOOST_REQUIRE( designCache.GetFilterOrder( 1.0 / 3.0, 3400.0, 44100.0, 500, 1000, filterOrder ) );
+			BOOST_REQUIRE( filterOrder == 996 );
+
+			designCache.Clear();
+			designCache.SetCacheFile( "" );
+			remove( cacheFile );
+		}
+
+
+
+		/**	@brief		Testing that a failed write of the cache file is reported and does not affect the existing file
+		*/
+		BOOST_AUTO_TEST_CASE( FilterDesignCache_write_error_test_case )
+		{
+			using namespace boost::filesystem;
+			using Core::Processing::Filter::CFilterDesignCache;
+
+			int filterOrder;
+			auto cacheDir = temp_directory_path() / unique_path();
+			auto cacheFile = cacheDir / "filterDesignCache.dat";
+
+			create_directory( cacheDir );
+			auto& designCache = CFilterDesignCache::Instance();
+			designCache.Clear();
+			designCache.SetCacheFile( cacheFile.string() );
+			BOOST_REQUIRE( designCache.AddFilterOrder( 250.0, 3400.0, 44100.0, 500, 1000, 582 ) );
+
+			// the temporary file cannot be created if it is blocked by a directory
+			create_directory( cacheFile.string() + ".tmp" );
+			BOOST_REQUIRE( !designCache.AddFilterOrder( 1.0 / 3.0, 3400.0, 44100.0, 500, 1000, 996 ) );
+			BOOST_REQUIRE( designCache.GetFilterOrder( 1.0 / 3.0, 3400.0, 44100.0, 500, 1000, filterOrder ) );
+			BOOST_REQUIRE( filterOrder == 996 );
+
+			// the previous cache file is still complete
+			designCache.Clear();
+			designCache.SetCacheFile( cacheFile.string() );
+			BOOST_REQUIRE( designCache.GetFilterOrder( 250.0, 3400.0, 44100.0, 500, 1000, filterOrder ) );
+			BOOST_REQUIRE( filterOrder == 582 );
+			BOOST_REQUIRE( !designCache.GetFilterOrder( 1.0 / 3.0, 3400.0, 44100.0, 500, 1000, filterOrder ) );
+
+			designCache.Clear();
+			designCache.SetCacheFile( "" );
+			remove_all( cacheDir );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
@@ -0,0 +1,152 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <boost/test/unit_test.hpp>
+#include "GatewayExecutor.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Networking {
+	/*@{*/
+	/** \ingroup GatewayExecutorTest
+	*/
+	namespace GatewayExecutorTest {
+		// Test section
+		BOOST_AUTO_TEST_SUITE( GatewayExecutor_test_suite, *label("default") );
+
+		/**	@brief		Testing of the execution of the tasks with a bounded number of threads
+		*/
+		BOOST_AUTO_TEST_CASE( GatewayExecutor_basic_test_case )
+		{
+			using namespace std;
+			using namespace std::literals;
+
+			const unsigned int numTasks = 50;
+			atomic<unsigned int> numFinishedTasks( 0 );
+
+			{
+				auto executor = External::CGatewayExecutor::Instance();
+				BOOST_REQUIRE( executor == External::CGatewayExecutor::Instance() );
+				BOOST_REQUIRE( executor->GetNumThreads() == 0 );
+
+				for ( unsigned int i = 0; i < numTasks; i++ ) {
+					executor->Submit( [&]() {
+						this_thread::sleep_for( 5ms );
+						numFinishedTasks++;
+					} );
+				}
+				executor->Submit( []() { throw std::runtime_error( "failing task" ); } );
+				BOOST_REQUIRE( executor->GetNumThreads() == External::CGatewayExecutor::GetMaxNumThreads() );
+			}
+
+			// the last reference finishes all tasks and joins the worker threads
+			BOOST_REQUIRE( numFinishedTasks == numTasks );
+		}
+
+
+
+		/**	@brief		Testing that a blocked connection does not block the other connections
+		*/
+		BOOST_AUTO_TEST_CASE( GatewayExecutor_starvation_test_case )
+		{
+			using namespace std;
+			using namespace std::literals;
+
+			mutex blockingMutex;
+			condition_variable blockingCondition;
+			bool isReleased = false;
+			atomic<bool> isFastTaskFinished( false );
+
+			auto executor = External::CGatewayExecutor::Instance();
+
+			// the first connection is blocked by a slow gateway
+			executor->Submit( [&]() {
+				unique_lock<mutex> lock( blockingMutex );
+				blockingCondition.wait( lock, [&]() { return isReleased; } );
+			} );
+
+			// the second connection needs to be executed nevertheless
+			executor->Submit( [&]() { isFastTaskFinished = true; } );
+			for ( int i = 0; ( i < 100 ) && !isFastTaskFinished; i++ ) {
+				this_thread::sleep_for( 10ms );
+			}
+			BOOST_REQUIRE( isFastTaskFinished );
+
+			{
+				lock_guard<mutex> lock( blockingMutex );
+				isReleased = true;
+			}
+			blockingCondition.notify_all();
+		}
+
+
+
+		/**	@brief		Testing that the worker threads are finished again after a burst of tasks
+		*/
+		BOOST_AUTO_TEST_CASE( GatewayExecutor_idle_test_case )
+		{
+			using namespace std;
+			using namespace std::literals;
+
+			atomic<unsigned int> numFinishedTasks( 0 );
+
+			auto executor = External::CGatewayExecutor::Instance();
+			executor->SetMaxIdleTime( 1s );
+
+			for ( unsigned int i = 0; i < 20; i++ ) {
+				executor->Submit( [&]() {
+					this_thread::sleep_for( 20ms );
+					numFinishedTasks++;
+				} );
+			}
+			BOOST_REQUIRE( executor->GetNumThreads() == External::CGatewayExecutor::GetMaxNumThreads() );
+
+			// all threads are finished after the idle time
+			for ( int i = 0; ( i < 50 ) && ( executor->GetNumThreads() > 0 ); i++ ) {
+				this_thread::sleep_for( 100ms );
+			}
+			BOOST_REQUIRE( numFinishedTasks == 20 );
+			BOOST_REQUIRE( executor->GetNumThreads() == 0 );
+
+			// a new task starts a thread again
+			executor->Submit( [&]() { numFinishedTasks++; } );
+			BOOST_REQUIRE( executor->GetNumThreads() == 1 );
+			for ( int i = 0; ( i < 100 ) && ( numFinishedTasks < 21 ); i++ ) {
+				this_thread::sleep_for( 10ms );
+			}
+			BOOST_REQUIRE( numFinishedTasks == 21 );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
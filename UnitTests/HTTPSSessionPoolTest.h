@@ -0,0 +1,242 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <boost/test/unit_test.hpp>
+#include <Poco/Exception.h>
+#include <Poco/Timespan.h>
+#include <Poco/Net/Context.h>
+#include <Poco/Net/SSLManager.h>
+#include <Poco/Net/AcceptCertificateHandler.h>
+#include <Poco/Net/SecureServerSocket.h>
+#include <Poco/Net/SecureStreamSocket.h>
+#include <Poco/Net/HTTPRequest.h>
+#include <Poco/Net/HTTPResponse.h>
+#include "HTTPSSessionPool.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Networking {
+	/*@{*/
+	/** \ingroup HTTPSSessionPoolTest
+	*/
+	namespace HTTPSSessionPoolTest {
+		/**	@brief	Self-signed certificate and private key of the local test server */
+		const std::string certificateFile = "TestServerCertificate.pem";
+
+
+
+		/**	@brief	Local HTTPS server answering a fixed number of requests per connection
+		*/
+		class CTestHTTPSServer {
+		public:
+			CTestHTTPSServer( const unsigned int& numResponsesPerConnection, const bool& isClosingAfterResponses )
+				: context( new Poco::Net::Context( Poco::Net::Context::SERVER_USE, certificateFile, certificateFile, "", Poco::Net::Context::VERIFY_NONE ) ),
+				  serverSocket( Poco::Net::SocketAddress( "127.0.0.1", 0 ), 64, context ),
+				  numResponsesPerConnection( numResponsesPerConnection ),
+				  isClosingAfterResponses( isClosingAfterResponses ),
+				  numConnections( 0 ),
+				  isTerminate( false )
+			{
+				serverThread = std::thread( [this]() { Run(); } );
+			};
+			~CTestHTTPSServer() {
+				isTerminate = true;
+				serverThread.join();
+			};
+			unsigned short GetPort() const { return serverSocket.address().port(); };
+			unsigned int GetNumConnections() const { return numConnections; };
+		private:
+			void Run() {
+				while ( !isTerminate ) {
+					try {
+						if ( serverSocket.poll( Poco::Timespan( 0, 10000 ), Poco::Net::Socket::SELECT_READ ) ) {
+							Poco::Net::SecureStreamSocket socket = serverSocket.acceptConnection();
+							numConnections++;
+							HandleConnection( socket );
+						}
+					} catch ( Poco::Exception& ) {
+						// the client has closed the connection
+					}
+				}
+			};
+			void HandleConnection( Poco::Net::SecureStreamSocket& socket ) {
+				const std::string response = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: Keep-Alive\r\n\r\nOK";
+
+				socket.setReceiveTimeout( Poco::Timespan( 2, 0 ) );
+				for ( unsigned int i = 0; i < numResponsesPerConnection; i++ ) {
+					if ( !ReceiveRequest( socket ) ) {
+						return;
+					}
+					socket.sendBytes( response.data(), static_cast<int>( response.size() ) );
+				}
+
+				// the connection is either closed while being idle or when the next request arrives
+				if ( !isClosingAfterResponses ) {
+					ReceiveRequest( socket );
+				}
+				socket.close();
+			};
+			static bool ReceiveRequest( Poco::Net::SecureStreamSocket& socket ) {
+				std::string request;
+				char buffer[1024];
+
+				while ( request.find( "\r\n\r\n" ) == std::string::npos ) {
+					int numBytes = socket.receiveBytes( buffer, sizeof( buffer ) );
+					if ( numBytes <= 0 ) {
+						return false;
+					}
+					request.append( buffer, numBytes );
+				}
+
+				return true;
+			};
+
+			Poco::Net::Context::Ptr context;
+			Poco::Net::SecureServerSocket serverSocket;
+			const unsigned int numResponsesPerConnection;
+			const bool isClosingAfterResponses;
+			std::atomic<unsigned int> numConnections;
+			std::atomic<bool> isTerminate;
+			std::thread serverThread;
+		};
+
+
+
+		/**	@brief	Configures the default client context accepting the self-signed certificate of the test server
+		*/
+		void InitializeClientContext()
+		{
+			Poco::SharedPtr<Poco::Net::InvalidCertificateHandler> certificateHandler = new Poco::Net::AcceptCertificateHandler( false );
+			Poco::Net::Context::Ptr clientContext = new Poco::Net::Context( Poco::Net::Context::CLIENT_USE, "", "", "", Poco::Net::Context::VERIFY_NONE );
+			Poco::Net::SSLManager::instance().initializeClient( 0, certificateHandler, clientContext );
+		}
+
+
+
+		/**	@brief	Performs a request (GET by default) to the test server via the pool
+		*/
+		std::string PerformRequest( External::CHTTPSSessionPool& pool, const CTestHTTPSServer& server, const std::string& method = Poco::Net::HTTPRequest::HTTP_GET )
+		{
+			Poco::Net::HTTPRequest request( method, "/", Poco::Net::HTTPMessage::HTTP_1_1 );
+			request.setContentLength( 0 );
+			Poco::Net::HTTPResponse response;
+
+			auto responseBody = pool.SendRequest( "127.0.0.1", server.GetPort(), Poco::Net::HTTPClientSession::ProxyConfig(), request, "", response );
+			BOOST_REQUIRE( response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK );
+
+			return responseBody;
+		}
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( HTTPSSessionPool_test_suite, *label("default") );
+
+		/**	@brief		Testing of the reuse of an idle session
+		*/
+		BOOST_AUTO_TEST_CASE( HTTPSSessionPool_reuse_test_case )
+		{
+			InitializeClientContext();
+			auto pool = External::CHTTPSSessionPool::Instance();
+			CTestHTTPSServer server( 10, false );
+
+			BOOST_REQUIRE( PerformRequest( *pool, server ) == "OK" );
+			BOOST_REQUIRE( PerformRequest( *pool, server ) == "OK" );
+			BOOST_REQUIRE( PerformRequest( *pool, server ) == "OK" );
+			BOOST_REQUIRE( server.GetNumConnections() == 1 );
+			BOOST_REQUIRE( pool->GetNumIdleSessions() >= 1 );
+		}
+
+
+
+		/**	@brief		Testing that an idle session closed by the server (i.e. a readable socket) is discarded before it is used
+		*/
+		BOOST_AUTO_TEST_CASE( HTTPSSessionPool_closed_session_test_case )
+		{
+			using namespace std::literals;
+
+			InitializeClientContext();
+			auto pool = External::CHTTPSSessionPool::Instance();
+			CTestHTTPSServer server( 1, true );
+
+			BOOST_REQUIRE( PerformRequest( *pool, server ) == "OK" );
+			std::this_thread::sleep_for( 200ms );
+			BOOST_REQUIRE( PerformRequest( *pool, server ) == "OK" );
+			BOOST_REQUIRE( server.GetNumConnections() == 2 );
+		}
+
+
+
+		/**	@brief		Testing of the transparent retry if an idle session is closed by the server during the request
+		*/
+		BOOST_AUTO_TEST_CASE( HTTPSSessionPool_stale_session_retry_test_case )
+		{
+			InitializeClientContext();
+			auto pool = External::CHTTPSSessionPool::Instance();
+			CTestHTTPSServer server( 1, false );
+
+			BOOST_REQUIRE( PerformRequest( *pool, server ) == "OK" );
+			BOOST_REQUIRE( PerformRequest( *pool, server ) == "OK" ); // the retry is performed with a new session
+			BOOST_REQUIRE( server.GetNumConnections() == 2 );
+		}
+
+
+
+		/**	@brief		Testing that a non-idempotent request is not repeated if the idle session is closed by the server after receiving it
+		*/
+		BOOST_AUTO_TEST_CASE( HTTPSSessionPool_stale_session_post_test_case )
+		{
+			InitializeClientContext();
+			auto pool = External::CHTTPSSessionPool::Instance();
+			CTestHTTPSServer server( 1, false );
+
+			BOOST_REQUIRE( PerformRequest( *pool, server, Poco::Net::HTTPRequest::HTTP_POST ) == "OK" );
+			BOOST_CHECK_THROW( PerformRequest( *pool, server, Poco::Net::HTTPRequest::HTTP_POST ), Poco::Exception ); // the alarm might have been processed already
+			BOOST_REQUIRE( server.GetNumConnections() == 1 );
+		}
+
+
+
+		/**	@brief		Testing that a failing new session is not retried
+		*/
+		BOOST_AUTO_TEST_CASE( HTTPSSessionPool_no_retry_test_case )
+		{
+			InitializeClientContext();
+			auto pool = External::CHTTPSSessionPool::Instance();
+			CTestHTTPSServer server( 0, false );
+
+			BOOST_CHECK_THROW( PerformRequest( *pool, server ), Poco::Exception );
+			BOOST_REQUIRE( server.GetNumConnections() == 1 );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
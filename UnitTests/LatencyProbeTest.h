@@ -0,0 +1,137 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <vector>
+#include <memory>
+#include <boost/test/unit_test.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "BoostStdTimeConverter.h"
+#include "LatencyProbe.h"
+#include "LatencyMetrics.h"
+#include "LatencyStatusMessage.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup Utility
+*/
+
+namespace Utilitites {
+	/*@{*/
+	/** \ingroup StatusMessage
+	*/
+	namespace Latency {
+		namespace LatencyProbe {
+			// Test section
+			BOOST_AUTO_TEST_SUITE( LatencyProbe_test_suite, *label("default") );
+
+			/**	@brief		Testing of the latency record emitted for each gateway hand-off
+			*/
+			BOOST_AUTO_TEST_CASE( LatencyProbe_record_test_case )
+			{
+				using namespace std;
+				using namespace boost::posix_time;
+				using namespace Utilities::Latency;
+				using namespace Utilities::Message;
+				using namespace Utilities::Time;
+
+				vector< unique_ptr<CStatusMessage> > records;
+				vector<int> code = { 1, 2, 3, 4, 5 }, codeGet;
+				Utilities::CDateTime sequenceTimeGet;
+				string gatewayGet;
+				vector< pair<LatencyStage, ptime> > stageTimesGet;
+
+				auto toneEndTime = ptime( microsec_clock::universal_time() );
+				auto sequenceTime = CBoostStdTimeConverter::ConvertToStdTime( toneEndTime - milliseconds( 350 ) );
+				auto metrics = make_shared<CLatencyHistogram>();
+
+				CLatencyProbe::Instance().SetRecordCallback( [&]( unique_ptr<CStatusMessage> message ) { records.push_back( move( message ) ); } );
+				CLatencyProbe::Instance().SetMetrics( metrics );
+
+				CLatencyProbe::Instance().Mark( code, sequenceTime, TONE_END, toneEndTime );
+				CLatencyProbe::Instance().Mark( code, sequenceTime, SEQUENCE_DETECTED, toneEndTime + milliseconds( 200 ) );
+				CLatencyProbe::Instance().Mark( code, sequenceTime, SEQUENCE_PASSED, toneEndTime + milliseconds( 201 ) );
+				CLatencyProbe::Instance().Mark( code, sequenceTime, SEQUENCE_PROCESSED, toneEndTime + milliseconds( 202 ) );
+				CLatencyProbe::Instance().Mark( code, sequenceTime, ALARM_ENQUEUED, toneEndTime + milliseconds( 203 ) );
+				CLatencyProbe::Instance().MarkGatewayHandoff( code, sequenceTime, "Gateway1", toneEndTime + milliseconds( 300 ) );
+				CLatencyProbe::Instance().MarkGatewayHandoff( code, sequenceTime, "Gateway1", toneEndTime + milliseconds( 60300 ) ); // a repeated trial is not recorded
+				CLatencyProbe::Instance().MarkGatewayHandoff( code, sequenceTime, "Gateway2", toneEndTime + milliseconds( 400 ) );
+
+				// a discarded alarm is not recorded anymore
+				CLatencyProbe::Instance().Discard( code, sequenceTime );
+				CLatencyProbe::Instance().MarkGatewayHandoff( code, sequenceTime, "Gateway3", toneEndTime + milliseconds( 500 ) );
+
+				CLatencyProbe::Instance().SetRecordCallback( nullptr );
+				CLatencyProbe::Instance().SetMetrics( nullptr );
+
+				BOOST_REQUIRE( records.size() == 2 );
+				BOOST_REQUIRE( typeid( *records.front() ) == typeid( CLatencyStatusMessage ) );
+				dynamic_cast<const CLatencyStatusMessage&>( *records.front() ).GetMessageContent( codeGet, sequenceTimeGet, gatewayGet, stageTimesGet );
+				BOOST_REQUIRE( codeGet == code );
+				BOOST_REQUIRE( sequenceTimeGet == sequenceTime );
+				BOOST_REQUIRE( gatewayGet == "Gateway1" );
+				BOOST_REQUIRE( stageTimesGet.size() == 6 );
+				BOOST_REQUIRE( stageTimesGet.front().first == TONE_END );
+				BOOST_REQUIRE( stageTimesGet.back().first == GATEWAY_HANDOFF );
+				BOOST_REQUIRE( ( stageTimesGet.back().second - stageTimesGet.front().second ) == milliseconds( 300 ) );
+
+				// the histograms contain each probe point once
+				auto histograms = metrics->GetHistograms();
+				BOOST_REQUIRE( histograms.size() == 6 );
+				BOOST_REQUIRE( histograms.count( make_pair( GATEWAY_HANDOFF, string( "Gateway2" ) ) ) == 1 );
+				auto handoffHistogram = histograms.at( make_pair( GATEWAY_HANDOFF, string( "Gateway1" ) ) );
+				BOOST_REQUIRE( handoffHistogram.first.size() == metrics->GetBucketLimits().size() + 1 );
+				BOOST_REQUIRE( handoffHistogram.first[5] == 1 ); // bucket up to 0.5 s
+				BOOST_CHECK_CLOSE( handoffHistogram.second, 0.3, 1.0e-6 );
+			}
+
+
+			/**	@brief		Testing of the probe without any consumer
+			*/
+			BOOST_AUTO_TEST_CASE( LatencyProbe_disabled_test_case )
+			{
+				using namespace std;
+				using namespace boost::posix_time;
+				using namespace Utilities::Latency;
+				using namespace Utilities::Message;
+				using namespace Utilities::Time;
+
+				vector< unique_ptr<CStatusMessage> > records;
+				vector<int> code = { 5, 4, 3, 2, 1 };
+				auto sequenceTime = CBoostStdTimeConverter::ConvertToStdTime( ptime( microsec_clock::universal_time() ) );
+
+				// marks are ignored without a consumer
+				CLatencyProbe::Instance().Mark( code, sequenceTime, TONE_END );
+				CLatencyProbe::Instance().SetRecordCallback( [&]( unique_ptr<CStatusMessage> message ) { records.push_back( move( message ) ); } );
+				CLatencyProbe::Instance().MarkGatewayHandoff( code, sequenceTime, "Gateway1" );
+				CLatencyProbe::Instance().SetRecordCallback( nullptr );
+
+				BOOST_REQUIRE( records.empty() );
+			}
+
+			BOOST_AUTO_TEST_SUITE_END();
+		}
+	}
+}
+
+/*@}*/
+/*@}*/
@@ -0,0 +1,76 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <chrono>
+#include <thread>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include "LookupCache.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Networking {
+	/*@{*/
+	/** \ingroup LookupCacheTest
+	*/
+	namespace LookupCacheTest {
+		// Test section
+		BOOST_AUTO_TEST_SUITE( LookupCache_test_suite, *label("default") );
+
+		/**	@brief		Testing of the expiry and invalidation of the cached values
+		*/
+		BOOST_AUTO_TEST_CASE( LookupCache_test_case )
+		{
+			using namespace std;
+			using namespace std::literals;
+
+			string value;
+			External::CLookupCache<string, string> cache( 100ms );
+
+			BOOST_REQUIRE( !cache.Get( "labels", value ) );
+			cache.Put( "labels", "[]" );
+			cache.Put( "units", "[1]" );
+			BOOST_REQUIRE( cache.Get( "labels", value ) );
+			BOOST_REQUIRE( value == "[]" );
+
+			cache.Invalidate( "labels" );
+			BOOST_REQUIRE( !cache.Get( "labels", value ) );
+			BOOST_REQUIRE( cache.Get( "units", value ) );
+			BOOST_REQUIRE( value == "[1]" );
+
+			this_thread::sleep_for( 150ms );
+			BOOST_REQUIRE( !cache.Get( "units", value ) );
+
+			cache.Put( "users", "[2]" );
+			cache.Clear();
+			BOOST_REQUIRE( !cache.Get( "users", value ) );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
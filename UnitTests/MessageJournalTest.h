@@ -0,0 +1,194 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "MessageJournal.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Networking {
+	/*@{*/
+	/** \ingroup MessageJournalTest
+	*/
+	namespace MessageJournalTest {
+		/**	@brief		Generates a journal entry for the tests
+		*/
+		External::JournalEntry GenerateEntry( const unsigned int& messageIndex )
+		{
+			return External::JournalEntry{ { 1, 2, 3, 4, 5 }, Utilities::CDateTime( 24, 12, 2023, Utilities::CTime( 18, 30, 15, 250 ) ), true, messageIndex, Utilities::CMediaFile( "/var/lib/personalfme/alarm.mp3", "audio/mpeg" ), 0, false };
+		}
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( MessageJournal_test_suite, *label("default") );
+
+		/**	@brief		Testing of the replay of the journal after a restart
+		*/
+		BOOST_AUTO_TEST_CASE( MessageJournal_replay_test_case )
+		{
+			using namespace std;
+			using namespace boost::filesystem;
+
+			auto journalFile = temp_directory_path() / unique_path( "journal_%%%%-%%%%.dat" );
+			std::uint64_t firstID, secondID, thirdID;
+
+			{
+				External::CMessageJournal journal( journalFile, []( const string& ) {} );
+				BOOST_REQUIRE( journal.GetPendingEntries().empty() );
+				firstID = journal.AddEnqueued( GenerateEntry( 0 ) );
+				secondID = journal.AddEnqueued( GenerateEntry( 1 ) );
+				thirdID = journal.AddEnqueued( GenerateEntry( 2 ) );
+				journal.AddDispatched( firstID );
+				journal.AddCompleted( firstID );
+				journal.AddDispatched( secondID );
+				journal.AddRetry( secondID, 3 );
+				journal.AddDispatched( thirdID );
+				journal.Flush();
+			}
+
+			// simulate a crash during writing of a record
+			{
+				std::ofstream file( journalFile.string(), ios::binary | ios::app );
+				file << "\x20\x00";
+			}
+
+			{
+				External::CMessageJournal journal( journalFile, []( const string& ) {} );
+				auto pendingEntries = journal.GetPendingEntries();
+				BOOST_REQUIRE( pendingEntries.size() == 2 );
+				BOOST_REQUIRE( pendingEntries.count( firstID ) == 0 );
+				BOOST_REQUIRE( pendingEntries.at( secondID ).numTrials == 3 );
+				BOOST_REQUIRE( !pendingEntries.at( secondID ).isInFlight );
+				BOOST_REQUIRE( pendingEntries.at( thirdID ).isInFlight );
+				BOOST_REQUIRE( pendingEntries.at( thirdID ).messageIndex == 2 );
+				BOOST_REQUIRE( pendingEntries.at( thirdID ).sequence == GenerateEntry( 2 ).sequence );
+				BOOST_REQUIRE( pendingEntries.at( thirdID ).time == GenerateEntry( 2 ).time );
+				BOOST_REQUIRE( pendingEntries.at( thirdID ).audioFile == GenerateEntry( 2 ).audioFile );
+
+				// new IDs must not collide with the replayed ones
+				BOOST_REQUIRE( journal.AddEnqueued( GenerateEntry( 3 ) ) > thirdID );
+			}
+
+			remove( journalFile );
+		}
+
+
+		/**	@brief		Testing of the compaction of the journal
+		*/
+		BOOST_AUTO_TEST_CASE( MessageJournal_compaction_test_case )
+		{
+			using namespace std;
+			using namespace boost::filesystem;
+
+			auto journalFile = temp_directory_path() / unique_path( "journal_%%%%-%%%%.dat" );
+			std::uint64_t pendingID, inFlightID;
+
+			{
+				External::CMessageJournal journal( journalFile, []( const string& ) {} );
+				pendingID = journal.AddEnqueued( GenerateEntry( 0 ) );
+				inFlightID = journal.AddEnqueued( GenerateEntry( 2 ) );
+				journal.AddDispatched( inFlightID );
+				for ( unsigned int i = 0; i < 1000; i++ ) {
+					auto id = journal.AddEnqueued( GenerateEntry( 1 ) );
+					journal.AddDispatched( id );
+					journal.AddCompleted( id );
+					if ( i % 10 == 0 ) {
+						journal.Flush();
+					}
+				}
+				journal.Flush();
+			}
+			BOOST_REQUIRE( file_size( journalFile ) < 30000 ); // without compaction it would be about 100 kB
+
+			{
+				External::CMessageJournal journal( journalFile, []( const string& ) {} );
+				BOOST_REQUIRE( file_size( journalFile ) < 400 );
+				auto pendingEntries = journal.GetPendingEntries();
+				BOOST_REQUIRE( pendingEntries.size() == 2 );
+				BOOST_REQUIRE( !pendingEntries.at( pendingID ).isInFlight );
+				BOOST_REQUIRE( pendingEntries.at( inFlightID ).isInFlight );
+			}
+
+			// the state of the messages in flight survives the compaction during the restart as well
+			{
+				External::CMessageJournal journal( journalFile, []( const string& ) {} );
+				BOOST_REQUIRE( journal.GetPendingEntries().at( inFlightID ).isInFlight );
+			}
+
+			remove( journalFile );
+		}
+
+
+
+		/**	@brief		Testing that a corrupted record in the middle of the journal does not cause the loss of the following records
+		*/
+		BOOST_AUTO_TEST_CASE( MessageJournal_corrupted_record_test_case )
+		{
+			using namespace std;
+			using namespace boost::filesystem;
+
+			auto journalFile = temp_directory_path() / unique_path( "journal_%%%%-%%%%.dat" );
+			std::uint64_t firstID, secondID, thirdID;
+
+			{
+				External::CMessageJournal journal( journalFile, []( const string& ) {} );
+				firstID = journal.AddEnqueued( GenerateEntry( 0 ) );
+				secondID = journal.AddEnqueued( GenerateEntry( 1 ) );
+				thirdID = journal.AddEnqueued( GenerateEntry( 2 ) );
+				journal.AddDispatched( thirdID );
+				journal.Flush();
+			}
+
+			// corrupt a byte within the second record - the entry records are of equal size and followed by the short dispatch record
+			{
+				auto recordSize = ( file_size( journalFile ) - 17 ) / 3;
+				std::fstream file( journalFile.string(), ios::binary | ios::in | ios::out );
+				file.seekg( recordSize + recordSize / 2 );
+				auto value = static_cast<char>( file.get() ^ 0xFF );
+				file.seekp( recordSize + recordSize / 2 );
+				file.put( value );
+			}
+
+			{
+				External::CMessageJournal journal( journalFile, []( const string& ) {} );
+				auto pendingEntries = journal.GetPendingEntries();
+				BOOST_REQUIRE( pendingEntries.size() == 2 );
+				BOOST_REQUIRE( pendingEntries.at( firstID ).messageIndex == 0 );
+				BOOST_REQUIRE( pendingEntries.count( secondID ) == 0 );
+				BOOST_REQUIRE( pendingEntries.at( thirdID ).messageIndex == 2 );
+				BOOST_REQUIRE( pendingEntries.at( thirdID ).isInFlight );
+			}
+
+			remove( journalFile );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
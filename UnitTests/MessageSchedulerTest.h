@@ -0,0 +1,107 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <boost/test/unit_test.hpp>
+#include "ConnectionMocks.h"
+#include "MessageScheduler.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Networking {
+	/*@{*/
+	/** \ingroup MessageSchedulerTest
+	*/
+	namespace MessageSchedulerTest {
+		/**	@brief		Generates a message for the tests, it is identified by its sequence
+		*/
+		std::unique_ptr<External::Message> GenerateMessage( const int& messageID, const bool& isRealAlarm, const bool& requiredState )
+		{
+			std::unique_ptr<External::Message> message( new External::Message );
+
+			message->sequence = { messageID };
+			message->isRealAlarm = isRealAlarm;
+			message->message = std::make_unique<ConnectionMocks::CMockMessage>( std::to_string( messageID ) );
+			message->message->SetRequiredState( requiredState );
+			message->journalID = 0;
+
+			return message;
+		}
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( MessageScheduler_test_suite, *label("default") );
+
+		/**	@brief		Testing of the ordering of the messages
+		*/
+		BOOST_AUTO_TEST_CASE( MessageScheduler_ordering_test_case )
+		{
+			using namespace std;
+			using namespace std::chrono;
+
+			External::CMessageScheduler scheduler;
+			auto currTime = steady_clock::now();
+
+			BOOST_REQUIRE( scheduler.IsEmpty() );
+			BOOST_REQUIRE( !scheduler.HasDueMessage( currTime ) );
+			BOOST_CHECK_THROW( scheduler.GetNextDueTime(), std::logic_error );
+			BOOST_CHECK_THROW( scheduler.PopDueMessage( currTime ), std::logic_error );
+
+			// messages with identical due times must all be kept
+			scheduler.Push( GenerateMessage( 1, false, true ), 0, currTime );
+			scheduler.Push( GenerateMessage( 2, true, false ), 0, currTime );
+			scheduler.Push( GenerateMessage( 3, true, true ), 2, currTime );
+			scheduler.Push( GenerateMessage( 4, true, true ), 0, currTime );
+			scheduler.Push( GenerateMessage( 5, true, true ), 0, currTime + seconds( 10 ) );
+			BOOST_REQUIRE( scheduler.Size() == 5 );
+			BOOST_REQUIRE( scheduler.GetNextDueTime() == currTime );
+
+			// real alarms first, messages directly after the detection before those after the recording, equal priorities in the order of insertion
+			vector<int> sentMessages;
+			while ( scheduler.HasDueMessage( currTime ) ) {
+				auto dueMessage = scheduler.PopDueMessage( currTime );
+				if ( dueMessage.first->sequence.front() == 3 ) {
+					BOOST_REQUIRE( dueMessage.second == 2 );
+				}
+				sentMessages.push_back( dueMessage.first->sequence.front() );
+			}
+			BOOST_REQUIRE( sentMessages == vector<int>( { 3, 4, 2, 1 } ) );
+
+			// the message in the future is not yet due
+			BOOST_REQUIRE( scheduler.Size() == 1 );
+			BOOST_REQUIRE( scheduler.GetNextDueTime() == currTime + seconds( 10 ) );
+			BOOST_REQUIRE( scheduler.HasDueMessage( currTime + seconds( 10 ) ) );
+			BOOST_REQUIRE( scheduler.PopDueMessage( currTime + seconds( 10 ) ).first->sequence.front() == 5 );
+			BOOST_REQUIRE( scheduler.IsEmpty() );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
@@ -0,0 +1,87 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <string>
+#include <chrono>
+#include <boost/test/unit_test.hpp>
+#include "MetricsRegistry.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup Utility
+*/
+
+namespace Utilitites {
+	/*@{*/
+	/** \ingroup Metrics
+	*/
+	namespace Metrics {
+		namespace MetricsRegistry {
+			// Test section
+			BOOST_AUTO_TEST_SUITE( MetricsRegistry_test_suite, *label("default") );
+
+			/**	@brief		Testing of the counters, gauges and histograms
+			*/
+			BOOST_AUTO_TEST_CASE( MetricsRegistry_update_test_case )
+			{
+				using namespace std;
+				using namespace Utilities::Metrics;
+
+				auto counter = CMetricsRegistry::Instance().GetCounter( "test_counter_total", "Test counter", { { "code", "12345" } } );
+				auto gauge = CMetricsRegistry::Instance().GetGauge( "test_gauge", "Test gauge" );
+				auto histogram = CMetricsRegistry::Instance().GetHistogram( "test_histogram_seconds", "Test histogram", { { "stage", "test" } }, { 0.1, 1.0 } );
+
+				counter->Increment();
+				counter->Increment( 2 );
+				gauge->Set( 10 );
+				gauge->Add( -3 );
+				histogram->Observe( 0.05 );
+				histogram->Observe( 0.5 );
+				histogram->Observe( std::chrono::milliseconds( 2500 ) );
+
+				// the same name and labels always provide the same metric
+				BOOST_REQUIRE( CMetricsRegistry::Instance().GetCounter( "test_counter_total", "Test counter", { { "code", "12345" } } ) == counter );
+				BOOST_REQUIRE( CMetricsRegistry::Instance().GetCounter( "test_counter_total", "Test counter", { { "code", "54321" } } ) != counter );
+				BOOST_REQUIRE_THROW( CMetricsRegistry::Instance().GetGauge( "test_counter_total", "Test gauge" ), std::logic_error );
+
+				BOOST_REQUIRE( counter->GetValue() == 3 );
+				BOOST_REQUIRE( gauge->GetValue() == 7 );
+
+				auto text = CMetricsRegistry::Instance().Serialize();
+				BOOST_REQUIRE( text.find( "# TYPE test_counter_total counter\n" ) != string::npos );
+				BOOST_REQUIRE( text.find( "test_counter_total{code=\"12345\"} 3\n" ) != string::npos );
+				BOOST_REQUIRE( text.find( "test_gauge 7\n" ) != string::npos );
+				BOOST_REQUIRE( text.find( "test_histogram_seconds_bucket{stage=\"test\",le=\"0.1\"} 1\n" ) != string::npos );
+				BOOST_REQUIRE( text.find( "test_histogram_seconds_bucket{stage=\"test\",le=\"1\"} 2\n" ) != string::npos );
+				BOOST_REQUIRE( text.find( "test_histogram_seconds_bucket{stage=\"test\",le=\"+Inf\"} 3\n" ) != string::npos );
+				BOOST_REQUIRE( text.find( "test_histogram_seconds_sum{stage=\"test\"} 3.05\n" ) != string::npos );
+				BOOST_REQUIRE( text.find( "test_histogram_seconds_count{stage=\"test\"} 3\n" ) != string::npos );
+			}
+
+			BOOST_AUTO_TEST_SUITE_END();
+		}
+	}
+}
+
+/*@}*/
+/*@}*/
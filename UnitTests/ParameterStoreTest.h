@@ -0,0 +1,95 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <string>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "ParameterStore.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Core {
+	/*@{*/
+	/** \ingroup ParameterStoreTest
+	*/
+	namespace ParameterStoreTest {
+		// Test section
+		BOOST_AUTO_TEST_SUITE( ParameterStore_test_suite, *label("default") );
+
+		/**	@brief		Testing of the shared loading of the parameter files in the text and the binary format
+		*/
+		BOOST_AUTO_TEST_CASE( ParameterStore_test_case )
+		{
+			using namespace std;
+			using namespace boost::filesystem;
+
+			int codeLength;
+			double excessTime, deltaTMaxTwice, minLength, maxLength, maxToneLevelRatio;
+			FME::CFMEAnalysisParam params, loadedParams;
+
+			auto textFileName = ( temp_directory_path() / unique_path() ).string();
+			auto binaryFileName = ( temp_directory_path() / unique_path() ).string();
+			params.Set( 5, 0.1, 0.02, 0.04, 0.13, 15.0 );
+			CParameterStore::Save( textFileName, params );
+			CParameterStore::Save( binaryFileName, params, BINARY_FORMAT );
+
+			// the files are only read once
+			auto versionBefore = CParameterStore::Instance().GetVersion();
+			auto textParams = CParameterStore::Instance().GetFMEAnalysisParam( textFileName );
+			auto binaryParams = CParameterStore::Instance().GetFMEAnalysisParam( binaryFileName );
+			BOOST_REQUIRE( CParameterStore::Instance().GetFMEAnalysisParam( textFileName ) == textParams );
+			BOOST_REQUIRE( CParameterStore::Instance().GetVersion() == versionBefore + 2 );
+
+			for ( const auto& storedParams : { textParams, binaryParams } ) {
+				loadedParams = *storedParams;
+				loadedParams.Get( codeLength, excessTime, deltaTMaxTwice, minLength, maxLength, maxToneLevelRatio );
+				BOOST_REQUIRE( codeLength == 5 );
+				BOOST_REQUIRE( maxLength == 0.13 );
+				BOOST_REQUIRE( maxToneLevelRatio == 15.0 );
+			}
+
+			// saving a file discards the stored parameters
+			params.Set( 6, 0.1, 0.02, 0.04, 0.13, 15.0 );
+			CParameterStore::Save( binaryFileName, params, BINARY_FORMAT );
+			loadedParams = *CParameterStore::Instance().GetFMEAnalysisParam( binaryFileName );
+			loadedParams.Get( codeLength, excessTime, deltaTMaxTwice, minLength, maxLength, maxToneLevelRatio );
+			BOOST_REQUIRE( codeLength == 6 );
+
+			// a binary file cannot be read as another parameter type
+			BOOST_CHECK_THROW( CParameterStore::Instance().GetAudioInputParam( binaryFileName ), std::ios_base::failure );
+			BOOST_CHECK_THROW( CParameterStore::Instance().GetFMEAnalysisParam( ( temp_directory_path() / unique_path() ).string() ), std::ios_base::failure );
+
+			CParameterStore::Instance().Clear();
+			remove( textFileName );
+			remove( binaryFileName );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
@@ -0,0 +1,291 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <boost/test/unit_test.hpp>
+#include <Poco/Exception.h>
+#include <Poco/Timespan.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/StreamSocket.h>
+#include <Poco/Net/SMTPClientSession.h>
+#include "EmailLoginData.h"
+#include "SMTPSessionPool.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Networking {
+	/*@{*/
+	/** \ingroup SMTPSessionPoolTest
+	*/
+	namespace SMTPSessionPoolTest {
+		/**	@brief	Behaviour of the local test server */
+		enum ServerMode { ACCEPTING_RESET, REJECTING_RESET, CLOSING_AFTER_LOGIN };
+
+
+
+		/**	@brief	Local SMTP server implementing the minimum of the protocol required by the session pool
+		*/
+		class CTestSMTPServer {
+		public:
+			CTestSMTPServer( const ServerMode& mode )
+				: serverSocket( Poco::Net::SocketAddress( "127.0.0.1", 0 ) ),
+				  mode( mode ),
+				  numConnections( 0 ),
+				  numResets( 0 ),
+				  numQuits( 0 ),
+				  isTerminate( false )
+			{
+				serverThread = std::thread( [this]() { Run(); } );
+			};
+			~CTestSMTPServer() {
+				isTerminate = true;
+				serverThread.join();
+			};
+			unsigned short GetPort() const { return serverSocket.address().port(); };
+			unsigned int GetNumConnections() const { return numConnections; };
+			unsigned int GetNumResets() const { return numResets; };
+			unsigned int GetNumQuits() const { return numQuits; };
+		private:
+			void Run() {
+				while ( !isTerminate ) {
+					try {
+						if ( serverSocket.poll( Poco::Timespan( 0, 10000 ), Poco::Net::Socket::SELECT_READ ) ) {
+							Poco::Net::StreamSocket socket = serverSocket.acceptConnection();
+							numConnections++;
+							HandleConnection( socket );
+						}
+					} catch ( Poco::Exception& ) {
+						// the client has closed the connection
+					}
+				}
+			};
+			void HandleConnection( Poco::Net::StreamSocket& socket ) {
+				std::string buffer, command;
+
+				socket.setReceiveTimeout( Poco::Timespan( 1, 0 ) );
+				SendReply( socket, "220 localhost ESMTP" );
+				while ( !isTerminate ) {
+					try {
+						if ( !ReceiveCommand( socket, buffer, command ) ) {
+							break;
+						}
+					} catch ( Poco::TimeoutException& ) {
+						continue;
+					}
+
+					if ( ( command.compare( 0, 4, "EHLO" ) == 0 ) || ( command.compare( 0, 4, "HELO" ) == 0 ) ) {
+						SendReply( socket, "250 localhost" );
+						if ( mode == CLOSING_AFTER_LOGIN ) {
+							break;
+						}
+					} else if ( command == "RSET" ) {
+						numResets++;
+						if ( mode == REJECTING_RESET ) {
+							SendReply( socket, "421 localhost Service not available, closing transmission channel" );
+							break;
+						}
+						SendReply( socket, "250 OK" );
+					} else if ( command == "QUIT" ) {
+						numQuits++;
+						SendReply( socket, "221 localhost closing connection" );
+						break;
+					} else {
+						SendReply( socket, "250 OK" );
+					}
+				}
+				socket.close();
+			};
+			static bool ReceiveCommand( Poco::Net::StreamSocket& socket, std::string& buffer, std::string& command ) {
+				char data[1024];
+
+				while ( buffer.find( "\r\n" ) == std::string::npos ) {
+					int numBytes = socket.receiveBytes( data, sizeof( data ) );
+					if ( numBytes <= 0 ) {
+						return false;
+					}
+					buffer.append( data, numBytes );
+				}
+				command = buffer.substr( 0, buffer.find( "\r\n" ) );
+				buffer.erase( 0, command.size() + 2 );
+
+				return true;
+			};
+			static void SendReply( Poco::Net::StreamSocket& socket, const std::string& reply ) {
+				std::string line = reply + "\r\n";
+				socket.sendBytes( line.data(), static_cast<int>( line.size() ) );
+			};
+
+			Poco::Net::ServerSocket serverSocket;
+			const ServerMode mode;
+			std::atomic<unsigned int> numConnections;
+			std::atomic<unsigned int> numResets;
+			std::atomic<unsigned int> numQuits;
+			std::atomic<bool> isTerminate;
+			std::thread serverThread;
+		};
+
+
+
+		/**	@brief	Generates the login data for the test server
+		*/
+		External::Email::CEmailLoginData GenerateLoginData( const CTestSMTPServer& server, const unsigned int& sessionIdleTime = External::Email::DEFAULT_SESSION_IDLE_TIME )
+		{
+			External::Email::CEmailLoginData loginData;
+			loginData.SetConnectionTrialInfos( 1, 1.0f, 1 );
+			loginData.SetServerInformation( External::Email::UNENCRYPTED_CONN, "127.0.0.1", server.GetPort() );
+			loginData.SetLoginInformation( "alarm@personalfme.de", External::Email::NO_AUTH );
+			loginData.SetSessionIdleTime( sessionIdleTime );
+
+			return loginData;
+		}
+
+
+
+		/**	@brief	Opens a new session to the test server
+		*/
+		std::unique_ptr<Poco::Net::SMTPClientSession> OpenSession( const CTestSMTPServer& server )
+		{
+			auto session = std::make_unique<Poco::Net::SMTPClientSession>( "127.0.0.1", server.GetPort() );
+			session->login();
+
+			return session;
+		}
+
+
+		// Test section
+		BOOST_AUTO_TEST_SUITE( SMTPSessionPool_test_suite, *label("default") );
+
+		/**	@brief		Testing of the reuse of an idle session
+		*/
+		BOOST_AUTO_TEST_CASE( SMTPSessionPool_reuse_test_case )
+		{
+			auto pool = External::Email::CSMTPSessionPool::Instance();
+			CTestSMTPServer server( ACCEPTING_RESET );
+			auto loginData = GenerateLoginData( server );
+
+			BOOST_REQUIRE( pool->Acquire( loginData ) == nullptr );
+			auto session = OpenSession( server );
+			auto sessionPtr = session.get();
+			pool->Release( loginData, std::move( session ) );
+
+			session = pool->Acquire( loginData );
+			BOOST_REQUIRE( session.get() == sessionPtr );
+			BOOST_REQUIRE( server.GetNumResets() == 1 );
+			BOOST_REQUIRE( server.GetNumConnections() == 1 );
+			BOOST_REQUIRE( pool->Acquire( loginData ) == nullptr );
+		}
+
+
+
+		/**	@brief		Testing that an idle session is discarded if the server rejects the RSET-command
+		*/
+		BOOST_AUTO_TEST_CASE( SMTPSessionPool_rejected_reset_test_case )
+		{
+			auto pool = External::Email::CSMTPSessionPool::Instance();
+			CTestSMTPServer server( REJECTING_RESET );
+			auto loginData = GenerateLoginData( server );
+
+			pool->Release( loginData, OpenSession( server ) );
+			BOOST_REQUIRE( pool->Acquire( loginData ) == nullptr );
+			BOOST_REQUIRE( server.GetNumResets() == 1 );
+
+			// the discarded session is not offered again, a new session is required
+			BOOST_REQUIRE( pool->Acquire( loginData ) == nullptr );
+			BOOST_REQUIRE( server.GetNumResets() == 1 );
+		}
+
+
+
+		/**	@brief		Testing that an idle session closed by the server is discarded
+		*/
+		BOOST_AUTO_TEST_CASE( SMTPSessionPool_closed_session_test_case )
+		{
+			using namespace std::literals;
+
+			auto pool = External::Email::CSMTPSessionPool::Instance();
+			CTestSMTPServer server( CLOSING_AFTER_LOGIN );
+			auto loginData = GenerateLoginData( server );
+
+			pool->Release( loginData, OpenSession( server ) );
+			std::this_thread::sleep_for( 200ms );
+			BOOST_REQUIRE( pool->Acquire( loginData ) == nullptr );
+			BOOST_REQUIRE( server.GetNumResets() == 0 );
+		}
+
+
+
+		/**	@brief		Testing that sessions are not kept in the pool if the idle time of the login is zero
+		*/
+		BOOST_AUTO_TEST_CASE( SMTPSessionPool_no_idle_time_test_case )
+		{
+			using namespace std::literals;
+
+			auto pool = External::Email::CSMTPSessionPool::Instance();
+			CTestSMTPServer server( ACCEPTING_RESET );
+			auto loginData = GenerateLoginData( server, 0 );
+
+			pool->Release( loginData, OpenSession( server ) );
+			BOOST_REQUIRE( pool->GetNumIdleSessions() == 0 );
+			BOOST_REQUIRE( pool->Acquire( loginData ) == nullptr );
+			BOOST_REQUIRE( server.GetNumResets() == 0 );
+			std::this_thread::sleep_for( 200ms );
+			BOOST_REQUIRE( server.GetNumQuits() == 1 );
+		}
+
+
+
+		/**	@brief		Testing that an idle session is closed after the idle time of the login without any further use of the pool
+		*/
+		BOOST_AUTO_TEST_CASE( SMTPSessionPool_idle_time_test_case )
+		{
+			using namespace std::literals;
+
+			auto pool = External::Email::CSMTPSessionPool::Instance();
+			CTestSMTPServer server( ACCEPTING_RESET );
+			auto loginData = GenerateLoginData( server, 1 );
+
+			pool->Release( loginData, OpenSession( server ) );
+			BOOST_REQUIRE( pool->GetNumIdleSessions() == 1 );
+			std::this_thread::sleep_for( 200ms );
+			BOOST_REQUIRE( server.GetNumQuits() == 0 );
+
+			for ( int i = 0; ( i < 30 ) && ( server.GetNumQuits() == 0 ); i++ ) {
+				std::this_thread::sleep_for( 100ms );
+			}
+			BOOST_REQUIRE( server.GetNumQuits() == 1 );
+			BOOST_REQUIRE( pool->GetNumIdleSessions() == 0 );
+			BOOST_REQUIRE( server.GetNumResets() == 0 );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
@@ -0,0 +1,109 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+/*@{*/
+/** \ingroup UnitTests
+*/
+
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "SequenceDeduplicator.h"
+
+using boost::unit_test::label;
+
+
+/*@{*/
+/** \ingroup UnitTests
+*/
+namespace Middleware {
+	/*@{*/
+	/** \ingroup SequenceDeduplicatorTest
+	*/
+	namespace SequenceDeduplicatorTest {
+		// Test section
+		BOOST_AUTO_TEST_SUITE( SequenceDeduplicator_test_suite, *label("default") );
+
+		/**	@brief		Testing of the de-duplication of sequences received from several sites
+		*/
+		BOOST_AUTO_TEST_CASE( SequenceDeduplicator_test_case )
+		{
+			using namespace std;
+			using namespace boost::posix_time;
+			using namespace boost::gregorian;
+
+			const vector<int> code = { 0, 1, 2, 3, 4 };
+			const vector<int> otherCode = { 0, 1, 2, 3, 5 };
+			const ptime refTime( date( 2023, Jan, 10 ), hours( 12 ) );
+			CSequenceDeduplicator deduplicator( seconds( 10 ) );
+
+			// the same alarm from several sites, also out of order
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( code, refTime, refTime ) );
+			BOOST_REQUIRE( deduplicator.IsDuplicate( code, refTime + seconds( 2 ), refTime + seconds( 2 ) ) );
+			BOOST_REQUIRE( deduplicator.IsDuplicate( code, refTime - seconds( 3 ), refTime + seconds( 2 ) ) );
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( otherCode, refTime + seconds( 1 ), refTime + seconds( 2 ) ) );
+
+			// duplicates do not extend the window
+			BOOST_REQUIRE( deduplicator.IsDuplicate( code, refTime + seconds( 9 ), refTime + seconds( 9 ) ) );
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( code, refTime + seconds( 12 ), refTime + seconds( 12 ) ) );
+			BOOST_REQUIRE( deduplicator.IsDuplicate( code, refTime + seconds( 15 ), refTime + seconds( 15 ) ) );
+			BOOST_REQUIRE( deduplicator.Size() == 3 );
+
+			// sequences without a valid time are never suppressed
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( code, ptime(), refTime + seconds( 15 ) ) );
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( code, ptime(), refTime + seconds( 15 ) ) );
+
+			// the store only keeps the recent sequences
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( code, refTime + minutes( 5 ), refTime + minutes( 5 ) ) );
+			BOOST_REQUIRE( deduplicator.Size() == 1 );
+
+			BOOST_CHECK_THROW( CSequenceDeduplicator( seconds( 0 ) ), std::invalid_argument );
+		}
+
+		/**	@brief		Testing that a site with a clock running ahead does not affect the de-duplication of the other sites
+		*/
+		BOOST_AUTO_TEST_CASE( SequenceDeduplicator_clock_deviation_test_case )
+		{
+			using namespace std;
+			using namespace boost::posix_time;
+			using namespace boost::gregorian;
+
+			const vector<int> code = { 0, 1, 2, 3, 4 };
+			const vector<int> otherCode = { 0, 1, 2, 3, 5 };
+			const ptime refTime( date( 2023, Jan, 10 ), hours( 12 ) );
+			CSequenceDeduplicator deduplicator( seconds( 10 ) );
+
+			// the timestamp of the wrong clock is limited to the receive time and the time window
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( code, refTime, refTime ) );
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( otherCode, refTime + hours( 24 ), refTime + seconds( 1 ) ) );
+			BOOST_REQUIRE( deduplicator.Size() == 2 );
+
+			// the sequences of the other sites are still available
+			BOOST_REQUIRE( deduplicator.IsDuplicate( code, refTime + seconds( 1 ), refTime + seconds( 2 ) ) );
+			BOOST_REQUIRE( deduplicator.IsDuplicate( otherCode, refTime + seconds( 5 ), refTime + seconds( 5 ) ) );
+
+			// the sequence of the wrong clock expires with the local time
+			BOOST_REQUIRE( !deduplicator.IsDuplicate( code, refTime + minutes( 1 ), refTime + minutes( 1 ) ) );
+			BOOST_REQUIRE( deduplicator.Size() == 1 );
+		}
+
+		BOOST_AUTO_TEST_SUITE_END();
+	}
+}
+
+/*@}*/
+/*@}*/
@@ -44,6 +44,7 @@ bool Utilitites::XMLTest::XMLEmailLoginDataTest::Test()
 	setLoginData.SetConnectionTrialInfos( 7, 19.3f, 5 );
 	setLoginData.SetLoginInformation( "First Last <first.last@test.de>", External::Email::UNENCRYPTED_AUTH, "user3", "password10" );
 	setLoginData.SetServerInformation( External::Email::TLS_SSL_CONN, "smtp.host.de", 465 );
+	setLoginData.SetSessionIdleTime( 45 );
 
 	// write the XML-file
 	Utilities::XML::WriteXML( xmlFileName, setLoginData, rootTag, make_pair( namespaceName, schemaDefinitionFilePath ) );
@@ -33,6 +33,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "XMLMonthlyValidityTest.h"
 #include "XMLSingleTimeValidityTest.h"
 #include "XMLAlarmMessagesDatabaseTest.h"
+#include "XMLValidatorTest.h"
 
 using boost::unit_test::label;
 
@@ -149,6 +150,13 @@ namespace Utilitites {
 			BOOST_REQUIRE( XMLAlarmMessagesDatabaseTest::Test() );
 		}
 
+		/**	@brief		Testing that the cached XML schemas are updated if the schema file has changed
+		*/
+		BOOST_AUTO_TEST_CASE( XML_ValidatorTest_test_case )
+		{
+			BOOST_REQUIRE( XMLValidatorTest::SchemaChangeTest() );
+		}
+
 		BOOST_AUTO_TEST_SUITE_END();
 	}
 }
@@ -0,0 +1,77 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32
+	#include "stdafx.h"
+#endif
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include "XMLException.h"
+#include "XMLValidator.h"
+#include "XMLValidatorTest.h"
+
+
+namespace {
+	/**	@brief		Writes a XML schema for a root element containing a single element of the given name
+	*/
+	void WriteSchema( const boost::filesystem::path& schemaFile, const std::string& elementName )
+	{
+		boost::filesystem::ofstream schemaStream( schemaFile, std::ios::out | std::ios::trunc );
+		schemaStream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+		schemaStream << "<xs:schema xmlns:xs=\"http://www.w3.org/2001/XMLSchema\" targetNamespace=\"http://www.personalfme.de/validatorTest\" elementFormDefault=\"qualified\">\n";
+		schemaStream << "\t<xs:element name=\"config\"><xs:complexType><xs:sequence><xs:element name=\"" << elementName << "\" type=\"xs:int\"/></xs:sequence></xs:complexType></xs:element>\n";
+		schemaStream << "</xs:schema>\n";
+	}
+}
+
+
+/**	@brief		Testing that a changed XML schema defined in the XML-file itself is used by the following validations
+*	@return										True if the test succeeded, false otherwise
+*	@exception									None
+*	@remarks									The compiled schemas are cached process-wide, the cache must not hide the change of the schema file
+*/
+bool Utilitites::XMLTest::XMLValidatorTest::SchemaChangeTest()
+{
+	using namespace boost::filesystem;
+
+	bool isSuccess = true;
+	auto testDir = temp_directory_path() / unique_path();
+	auto schemaFile = testDir / "validatorTest.xsd";
+	auto xmlFile = testDir / "validatorTest.xml";
+	const std::string xmlContent = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<config xmlns=\"http://www.personalfme.de/validatorTest\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xsi:schemaLocation=\"http://www.personalfme.de/validatorTest ./validatorTest.xsd\">\n"
+		"\t<value>1</value>\n"
+		"</config>\n";
+	Utilities::XML::CXMLValidator validator;
+
+	create_directories( testDir );
+	WriteSchema( schemaFile, "value" );
+	validator.ValidateSchema( xmlContent, xmlFile ); // the schema is compiled and cached
+
+	// the schema does not allow for the element anymore (the modification time is changed explicitly, because its resolution might be coarse)
+	WriteSchema( schemaFile, "otherValue" );
+	last_write_time( schemaFile, last_write_time( schemaFile ) + 10 );
+	try {
+		validator.ValidateSchema( xmlContent, xmlFile );
+		isSuccess = false;
+	} catch ( Utilities::Exception::xml_error& ) {
+	}
+
+	remove_all( testDir );
+
+	return isSuccess;
+}
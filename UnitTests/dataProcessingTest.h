@@ -212,6 +212,156 @@ namespace ProcessingTests {
 			BOOST_REQUIRE( Core::Processing::CDataProcessing<float>::NextLargerEven( -2.9999f ) == -2 );
 		}
 
+
+
+		/**	@brief		Testing of the peak finding by indices for all frames of a spectrogram
+		*/
+		BOOST_AUTO_TEST_CASE( FindSpectrogramPeakIndices_test_case )
+		{
+			using namespace std;
+
+			const int numBins = 256;
+			const int maxNumPeaks = 20;
+			const double delta = 0.05;
+			vector< vector<double> > spectrum( 8, vector<double>( numBins ) );
+			vector<double> x( numBins ), normalizedSpectrum( numBins ), minPeaks, maxPeaks;
+			vector<int> peakIndices( spectrum.size() * maxNumPeaks ), numPeaks( spectrum.size() );
+
+			// frames with a varying number of peaks, the last frame is noise with too many peaks
+			iota( x.begin(), x.end(), 0.0 );
+			for ( size_t i = 0; i < spectrum.size(); i++ ) {
+				for ( int bin = 0; bin < numBins; bin++ ) {
+					spectrum[i][bin] = 1.0 + sin( ( i + 1 ) * 0.1 * bin ) + 0.5 * sin( 0.37 * bin );
+				}
+			}
+			for ( int bin = 0; bin < numBins; bin++ ) {
+				spectrum.back()[bin] = ( bin % 2 ) ? 1.0 : 0.1;
+			}
+			Core::Processing::CDataProcessing<double>::FindSpectrogramPeakIndices( spectrum.begin(), spectrum.end(), peakIndices.begin(), numPeaks.begin(), maxNumPeaks, delta );
+
+			// the result must be identical to the peak finding in the normalized data
+			for ( size_t i = 0; i < spectrum.size(); i++ ) {
+				Core::Processing::CDataProcessing<double>::NormalizeData( spectrum[i].begin(), spectrum[i].end(), normalizedSpectrum.begin() );
+				minPeaks.clear();
+				maxPeaks.clear();
+				Core::Processing::CDataProcessing<double>::FindPeaks( x.begin(), x.end(), normalizedSpectrum.begin(), back_inserter( minPeaks ), back_inserter( maxPeaks ), delta );
+				if ( static_cast<int>( maxPeaks.size() ) > maxNumPeaks ) {
+					maxPeaks.clear();
+				}
+
+				BOOST_REQUIRE( numPeaks[i] == static_cast<int>( maxPeaks.size() ) );
+				for ( int j = 0; j < numPeaks[i]; j++ ) {
+					BOOST_REQUIRE( peakIndices[i * maxNumPeaks + j] == static_cast<int>( maxPeaks[j] ) );
+				}
+			}
+			BOOST_REQUIRE( numPeaks.front() > 0 );
+			BOOST_REQUIRE( numPeaks.back() == 0 );
+
+			// no peaks without a positive maximum
+			vector<double> zeros( numBins, 0.0 );
+			BOOST_REQUIRE( Core::Processing::CDataProcessing<double>::FindPeakIndices( zeros.begin(), zeros.end(), peakIndices.begin(), maxNumPeaks, delta ) == 0 );
+			BOOST_CHECK_THROW( Core::Processing::CDataProcessing<double>::FindPeakIndices( zeros.begin(), zeros.end(), peakIndices.begin(), maxNumPeaks, -1.0 ), std::out_of_range );
+		}
+
+
+
+		/**	@brief		Testing of the peak interpolation for all frames of a spectrogram stored in a contiguous buffer
+		*/
+		BOOST_AUTO_TEST_CASE( InterpolateSpectrogramPeaks_test_case )
+		{
+			using namespace std;
+
+			const int numBins = 128;
+			const int numFrames = 6;
+			const int maxNumPeaks = 10;
+			const double delta = 0.05;
+			const double binWidth = 7.8125;
+			double interpolatedLevel;
+			vector<double> spectrum( numFrames * numBins + numBins / 2 ), freq( numBins );
+			vector< boost::iterator_range< vector<double>::iterator > > frames;
+			vector<int> peakIndices( numFrames * maxNumPeaks ), numPeaks( numFrames );
+			vector< vector<float> > peaks( numFrames ), levels( numFrames );
+			vector<const float*> peakBuffers;
+
+			// frames with Gaussian peaks between the bins, the incomplete frame at the end is ignored
+			for ( int bin = 0; bin < numBins; bin++ ) {
+				freq[bin] = bin * binWidth;
+			}
+			for ( int i = 0; i < numFrames; i++ ) {
+				for ( int bin = 0; bin < numBins; bin++ ) {
+					spectrum[i * numBins + bin] = 1.0e-3 + exp( -pow( bin - ( 20.3 + 10 * i ), 2 ) / 8.0 ) + 0.5 * exp( -pow( bin - 100.6, 2 ) / 8.0 );
+				}
+			}
+			Core::Processing::CDataProcessing<double>::SplitIntoFrames( spectrum.begin(), spectrum.end(), numBins, back_inserter( frames ) );
+			BOOST_REQUIRE( frames.size() == numFrames );
+			BOOST_REQUIRE( &frames[2].front() == &spectrum[2 * numBins] );
+			BOOST_CHECK_THROW( Core::Processing::CDataProcessing<double>::SplitIntoFrames( spectrum.begin(), spectrum.end(), 0, back_inserter( frames ) ), std::out_of_range );
+
+			// the output containers are not reallocated if they have a capacity of maxNumPeaks
+			for ( int i = 0; i < numFrames; i++ ) {
+				peaks[i].reserve( maxNumPeaks );
+				levels[i].reserve( maxNumPeaks );
+				peakBuffers.push_back( peaks[i].data() );
+			}
+			Core::Processing::CDataProcessing<double>::FindSpectrogramPeakIndices( frames.begin(), frames.end(), peakIndices.begin(), numPeaks.begin(), maxNumPeaks, delta );
+			Core::Processing::CDataProcessing<double>::InterpolateSpectrogramPeaks( frames.begin(), frames.end(), freq.begin(), peakIndices.begin(), numPeaks.begin(), maxNumPeaks, peaks.begin(), levels.begin() );
+
+			for ( int i = 0; i < numFrames; i++ ) {
+				BOOST_REQUIRE( numPeaks[i] == 2 );
+				BOOST_REQUIRE( peaks[i].size() == 2 );
+				BOOST_REQUIRE( levels[i].size() == 2 );
+				BOOST_REQUIRE( peaks[i].data() == peakBuffers[i] );
+				BOOST_CHECK_CLOSE( peaks[i][0], ( 20.3 + 10 * i ) * binWidth, 0.5 );
+				BOOST_CHECK_CLOSE( peaks[i][1], 100.6 * binWidth, 0.5 );
+
+				// identical to the interpolation of a single peak
+				auto peakIndex = peakIndices[i * maxNumPeaks];
+				auto offset = Core::Processing::CDataProcessing<double>::InterpolatePeak( frames[i][peakIndex - 1], frames[i][peakIndex], frames[i][peakIndex + 1], interpolatedLevel );
+				BOOST_CHECK_CLOSE( peaks[i][0], static_cast<float>( freq[peakIndex] + offset * binWidth ), 1.0e-4 );
+				BOOST_CHECK_CLOSE( levels[i][0], static_cast<float>( interpolatedLevel ), 1.0e-4 );
+			}
+		}
+
+
+
+		/**	@brief		Testing of the peak interpolation between the frequency bins
+		*/
+		BOOST_AUTO_TEST_CASE( InterpolatePeak_test_case )
+		{
+			using namespace std;
+			using namespace boost::math::constants;
+
+			const int numSamples = 64;
+			const double peakBin = 10.3;
+			double interpolatedLevel, offset;
+			vector<double> powerSpectrum( 3 );
+
+			// the parabola fit is exact for a Gaussian peak
+			auto gaussian = [=]( int bin ) { return ( exp( -( bin - peakBin ) * ( bin - peakBin ) / 2.0 ) ); };
+			offset = Core::Processing::CDataProcessing<double>::InterpolatePeak( gaussian( 9 ), gaussian( 10 ), gaussian( 11 ), interpolatedLevel );
+			BOOST_REQUIRE( abs( offset - 0.3 ) < 1.0e-9 );
+			BOOST_REQUIRE( abs( interpolatedLevel - 1.0 ) < 1.0e-9 );
+
+			// power spectrum of a sinus with Hamming-window, the frequency lies between the bins
+			for ( int bin = 9; bin <= 11; bin++ ) {
+				double re = 0, im = 0;
+				for ( int i = 0; i < numSamples; i++ ) {
+					double value = sin( 2 * pi<double>() * peakBin * i / numSamples ) * ( 0.54 - 0.46 * cos( 2 * pi<double>() * i / ( numSamples - 1 ) ) );
+					re += value * cos( 2 * pi<double>() * bin * i / numSamples );
+					im -= value * sin( 2 * pi<double>() * bin * i / numSamples );
+				}
+				powerSpectrum[bin - 9] = re * re + im * im;
+			}
+			offset = Core::Processing::CDataProcessing<double>::InterpolatePeak( powerSpectrum[0], powerSpectrum[1], powerSpectrum[2], interpolatedLevel );
+			BOOST_REQUIRE( abs( 10 + offset - peakBin ) < 0.02 );
+			BOOST_REQUIRE( interpolatedLevel >= powerSpectrum[1] );
+
+			// no interpolation without a proper local maximum
+			BOOST_REQUIRE( Core::Processing::CDataProcessing<double>::InterpolatePeak( 1.0, 1.0, 1.0, interpolatedLevel ) == 0 );
+			BOOST_REQUIRE( Core::Processing::CDataProcessing<double>::InterpolatePeak( 0.0, 1.0, 0.5, interpolatedLevel ) == 0 );
+			BOOST_REQUIRE( interpolatedLevel == 1.0 );
+		}
+
 		BOOST_AUTO_TEST_SUITE_END();
 	}
 }
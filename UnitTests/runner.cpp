@@ -22,23 +22,32 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 // test suites
 #include "XMLTests.h"
 #include "ConnectionThreadTest.h"
+#include "GatewayExecutorTest.h"
 #include "ConnectionManagerTest.h"
+#include "MessageJournalTest.h"
+#include "MessageSchedulerTest.h"
 #include "ExternalProgramGatewayTest.h"
 #include "ExternalProgramLoginDataTest.h"
 #include "ExternalProgramMessageTest.h"
 #include "EmailGatewayTest.h"
 #include "EmailLoginDataTest.h"
 #include "EmailMessageTest.h"
+#include "SMTPSessionPoolTest.h"
+#include "AttachmentCacheTest.h"
 #include "AlarmGatewaysManagerTest.h"
 #include "Groupalarm2GatewayTest.h"
 #include "Groupalarm2LoginDataTest.h"
 #include "Groupalarm2MessageTest.h"
+#include "HTTPSSessionPoolTest.h"
+#include "LookupCacheTest.h"
 #include "GatewayLoginDatabaseTest.h"
 #include "FileUtilsTest.h"
 #include "AlarmValiditiesTest.h"
 #include "AlarmMessageDatabaseTest.h"
 #include "GeneralStatusMessageTest.h"
 #include "DetectorStatusMessageTest.h"
+#include "LatencyProbeTest.h"
+#include "MetricsRegistryTest.h"
 #include "SendStatusMessageTest.h"
 #include "InfoalarmMessageDecoratorTest.h"
 #include "MonthlyValidityTest.h"
@@ -46,7 +55,12 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "SingleTimeValidityTest.h"
 #include "DefaultValidityTest.h"
 #include "fmeDetectionTest.h"
+#include "FMEFrameCodecTest.h"
+#include "FMEClientTest.h"
+#include "FMEPublisherTest.h"
 #include "filterTest.h"
+#include "FilterDesignCacheTest.h"
+#include "ParameterStoreTest.h"
 #include "fftTest.h"
 #include "audioSignalReaderTest.h"
 #include "sequencePasserTest.h"
@@ -56,6 +70,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include "SeqDataCompleteTest.h"
 #include "SeqDataTest.h"
 #include "SettingsParamTest.h"
+#include "ConfigFileWatcherTest.h"
+#include "SequenceDeduplicatorTest.h"
+#include "ExecutionServerRuntimeTest.h"
 #include "TimeTest.h"
 #include "DateTimeTest.h"
 #include "CodeDataTest.h"
@@ -0,0 +1,186 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define UTILITY_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define UTILITY_API __declspec(dllexport)
+	#endif
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "LatencyMetrics.h"
+
+
+
+/**	@brief		Constructor
+*/
+Utilities::Latency::CLatencyMetrics::CLatencyMetrics()
+{
+}
+
+
+
+/**	@brief		Destructor
+*/
+Utilities::Latency::CLatencyMetrics::~CLatencyMetrics()
+{
+}
+
+
+
+/**	@brief		Obtains the name of a probe point as it is used in the log and the metrics
+*	@param		stage								Probe point
+*	@return											Name of the probe point
+*	@exception										None
+*	@remarks										None
+*/
+std::string Utilities::Latency::CLatencyMetrics::GetStageName( const LatencyStage& stage )
+{
+	switch ( stage ) {
+	case TONE_END:
+		return "tone_end";
+	case SEQUENCE_DETECTED:
+		return "detected";
+	case SEQUENCE_PASSED:
+		return "passed";
+	case SEQUENCE_PROCESSED:
+		return "processed";
+	case ALARM_ENQUEUED:
+		return "enqueued";
+	case GATEWAY_HANDOFF:
+		return "handoff";
+	}
+
+	return "unknown";
+}
+
+
+
+/**	@brief		Constructor
+*	@param		bucketLimits						Upper limits of the histogram buckets [s]. An overflow bucket is added automatically.
+*	@exception	std::invalid_argument				Thrown if the bucket limits are empty or not strictly increasing
+*	@remarks										None
+*/
+Utilities::Latency::CLatencyHistogram::CLatencyHistogram( const std::vector<double>& bucketLimits )
+	: bucketLimits( bucketLimits )
+{
+	if ( bucketLimits.empty() || ( std::adjacent_find( bucketLimits.begin(), bucketLimits.end(), std::greater_equal<double>() ) != bucketLimits.end() ) ) {
+		throw std::invalid_argument( "The histogram bucket limits must be strictly increasing." );
+	}
+}
+
+
+
+/**	@brief		Destructor
+*/
+Utilities::Latency::CLatencyHistogram::~CLatencyHistogram()
+{
+}
+
+
+
+/**	@brief		Records the latency of a single alarm at a probe point
+*	@param		stage								Probe point
+*	@param		gateway								Name of the alarm gateway. It is empty for all probe points before the hand-off to the gateways.
+*	@param		latency								Latency of the probe point relative to the end of the last tone of the sequence
+*	@return											None
+*	@exception										None
+*	@remarks										Negative latencies are counted in the first bucket
+*/
+void Utilities::Latency::CLatencyHistogram::Observe( const LatencyStage& stage, const std::string& gateway, const boost::posix_time::time_duration& latency )
+{
+	using namespace std;
+
+	double latencySeconds = latency.total_microseconds() / 1.0e6;
+	auto bucket = distance( bucketLimits.begin(), lower_bound( bucketLimits.begin(), bucketLimits.end(), latencySeconds ) );
+
+	lock_guard<mutex> lock( histogramMutex );
+	auto& histogram = histograms[ make_pair( stage, gateway ) ];
+	if ( histogram.first.empty() ) {
+		histogram.first.resize( bucketLimits.size() + 1, 0 );
+		histogram.second = 0.0;
+	}
+	histogram.first[ bucket ]++;
+	histogram.second += latencySeconds;
+}
+
+
+
+/**	@brief		Obtains the upper limits of the histogram buckets
+*	@return											Upper limits of the histogram buckets [s], without the overflow bucket
+*	@exception										None
+*	@remarks										None
+*/
+std::vector<double> Utilities::Latency::CLatencyHistogram::GetBucketLimits() const
+{
+	return bucketLimits;
+}
+
+
+
+/**	@brief		Obtains a snapshot of all histograms
+*	@return											Histograms of all probe points and alarm gateways recorded so far
+*	@exception										None
+*	@remarks										None
+*/
+std::map< std::pair<Utilities::Latency::LatencyStage, std::string>, Utilities::Latency::CLatencyHistogram::HistogramData > Utilities::Latency::CLatencyHistogram::GetHistograms() const
+{
+	std::lock_guard<std::mutex> lock( histogramMutex );
+	return histograms;
+}
+
+
+
+/**	@brief		Constructor
+*/
+Utilities::Latency::CRegistryLatencyMetrics::CRegistryLatencyMetrics()
+{
+}
+
+
+
+/**	@brief		Destructor
+*/
+Utilities::Latency::CRegistryLatencyMetrics::~CRegistryLatencyMetrics()
+{
+}
+
+
+
+/**	@brief		Records the latency of a single alarm at a probe point in the histogram "personalfme_alarm_latency_seconds"
+*	@param		stage								Probe point
+*	@param		gateway								Name of the alarm gateway. It is empty for all probe points before the hand-off to the gateways.
+*	@param		latency								Latency of the probe point relative to the end of the last tone of the sequence
+*	@return											None
+*	@exception										None
+*	@remarks										None
+*/
+void Utilities::Latency::CRegistryLatencyMetrics::Observe( const LatencyStage& stage, const std::string& gateway, const boost::posix_time::time_duration& latency )
+{
+	using namespace Utilities::Metrics;
+
+	MetricLabels labels = { { "stage", GetStageName( stage ) } };
+	if ( !gateway.empty() ) {
+		labels[ "gateway" ] = gateway;
+	}
+
+	CMetricsRegistry::Instance().GetHistogram( "personalfme_alarm_latency_seconds", "Latency of the alarms relative to the end of the last tone", labels )->Observe( latency.total_microseconds() / 1.0e6 );
+}
@@ -0,0 +1,112 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "MetricsRegistry.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef UTILITY_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define UTILITY_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define UTILITY_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define UTILITY_API __attribute__ ((visibility ("default")))
+	#else
+		#define UTILITY_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Utilities
+*/
+namespace Utilities {
+	namespace Latency {
+		/** @param LatencyStage		Probe points along the alarm path from the end of the last tone to the hand-off to the alarm gateways
+		*/
+		enum LatencyStage { TONE_END, SEQUENCE_DETECTED, SEQUENCE_PASSED, SEQUENCE_PROCESSED, ALARM_ENQUEUED, GATEWAY_HANDOFF };
+
+		/**	\ingroup Utilities
+		*	Abstract interface for collecting the alarm latencies as metrics
+		*/
+		class CLatencyMetrics
+		{
+		public:
+			UTILITY_API CLatencyMetrics();
+			UTILITY_API virtual ~CLatencyMetrics();
+
+			/**	@brief		Records the latency of a single alarm at a probe point
+			*	@param		stage						Probe point
+			*	@param		gateway						Name of the alarm gateway. It is empty for all probe points before the hand-off to the gateways.
+			*	@param		latency						Latency of the probe point relative to the end of the last tone of the sequence
+			*	@return									None
+			*	@exception								None
+			*	@remarks								The method is called from several threads at the same time
+			*/
+			UTILITY_API virtual void Observe( const LatencyStage& stage, const std::string& gateway, const boost::posix_time::time_duration& latency ) = 0;
+			UTILITY_API static std::string GetStageName( const LatencyStage& stage );
+		};
+
+		/**	\ingroup Utilities
+		*	Thread-safe latency metrics storing a histogram with fixed buckets for each probe point and alarm gateway
+		*/
+		class CLatencyHistogram : public CLatencyMetrics
+		{
+		public:
+			/** @param HistogramData	Counts of all buckets (the last one is the overflow bucket), sum of all latencies [s] */
+			typedef std::pair< std::vector<unsigned long long>, double > HistogramData;
+
+			UTILITY_API CLatencyHistogram( const std::vector<double>& bucketLimits = std::vector<double>{ 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0 } );
+			UTILITY_API virtual ~CLatencyHistogram();
+			UTILITY_API virtual void Observe( const LatencyStage& stage, const std::string& gateway, const boost::posix_time::time_duration& latency ) override;
+			UTILITY_API std::vector<double> GetBucketLimits() const;
+			UTILITY_API std::map< std::pair<LatencyStage, std::string>, HistogramData > GetHistograms() const;
+		private:
+			std::vector<double> bucketLimits;
+			std::map< std::pair<LatencyStage, std::string>, HistogramData > histograms;
+			mutable std::mutex histogramMutex;
+		};
+
+		/**	\ingroup Utilities
+		*	Latency metrics exported as histograms of the metrics registry (Utilities::Metrics::CMetricsRegistry)
+		*/
+		class CRegistryLatencyMetrics : public CLatencyMetrics
+		{
+		public:
+			UTILITY_API CRegistryLatencyMetrics();
+			UTILITY_API virtual ~CRegistryLatencyMetrics();
+			UTILITY_API virtual void Observe( const LatencyStage& stage, const std::string& gateway, const boost::posix_time::time_duration& latency ) override;
+		};
+	}
+}
+/*@}*/
@@ -0,0 +1,260 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define UTILITY_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define UTILITY_API __declspec(dllexport)
+	#endif
+#endif
+
+#include "BoostStdTimeConverter.h"
+#include "LatencyStatusMessage.h"
+#include "LatencyProbe.h"
+
+/** @brief	Records older than this are regarded as lost (for example filtered out or failed) and are removed */
+const boost::posix_time::time_duration maxRecordAge = boost::posix_time::hours( 1 );
+
+
+
+/**	@brief		Access to the singleton instance
+*	@return											Singleton instance
+*	@exception										None
+*	@remarks										None
+*/
+Utilities::Latency::CLatencyProbe& Utilities::Latency::CLatencyProbe::Instance()
+{
+	std::call_once( onceFlag, []() {
+		instancePtr.reset( new CLatencyProbe() );
+	} );
+
+	return *instancePtr;
+}
+
+
+
+/**	@brief		Constructor
+*	@exception										None
+*	@remarks										The constructor is private and can therefore only be used for instantiating the singleton
+*/
+Utilities::Latency::CLatencyProbe::CLatencyProbe()
+{
+}
+
+
+
+/**	@brief		Destructor
+*/
+Utilities::Latency::CLatencyProbe::~CLatencyProbe()
+{
+}
+
+
+
+/**	@brief		Sets the function receiving the latency records
+*	@param		recordCallback						Function called with a Utilities::Message::CLatencyStatusMessage for each hand-off of an alarm to a gateway. An empty function disables the records.
+*	@return											None
+*	@exception										None
+*	@remarks										The function is called from the sending threads and must be thread-safe
+*/
+void Utilities::Latency::CLatencyProbe::SetRecordCallback( std::function< void( std::unique_ptr<Utilities::Message::CStatusMessage> ) > recordCallback )
+{
+	std::lock_guard<std::mutex> lock( probeMutex );
+	CLatencyProbe::recordCallback = recordCallback;
+}
+
+
+
+/**	@brief		Sets the optional metrics interface receiving the latencies of all probe points
+*	@param		metrics								Metrics interface. A nullptr disables the metrics.
+*	@return											None
+*	@exception										None
+*	@remarks										None
+*/
+void Utilities::Latency::CLatencyProbe::SetMetrics( std::shared_ptr<CLatencyMetrics> metrics )
+{
+	std::lock_guard<std::mutex> lock( probeMutex );
+	CLatencyProbe::metrics = metrics;
+}
+
+
+
+/**	@brief		Stores the time an alarm has passed a probe point
+*	@param		code								Alarm code
+*	@param		sequenceTime						Start time of the sequence (UTC)
+*	@param		stage								Probe point. Use CLatencyProbe::MarkGatewayHandoff for the hand-off to the gateways.
+*	@param		time								Time the probe point was passed (UTC). Default is the current time.
+*	@return											None
+*	@exception										None
+*	@remarks										The call has no effect if neither a record callback nor metrics are set. Only the first passing of a probe point is stored for each alarm.
+*/
+void Utilities::Latency::CLatencyProbe::Mark( const std::vector<int>& code, const Utilities::CDateTime& sequenceTime, const LatencyStage& stage, const boost::posix_time::ptime& time )
+{
+	using namespace std;
+	using namespace Utilities::Time;
+
+	shared_ptr<CLatencyMetrics> currMetrics;
+	boost::posix_time::time_duration latency;
+
+	{
+		lock_guard<mutex> lock( probeMutex );
+		if ( !IsEnabled() ) {
+			return;
+		}
+
+		RemoveExpiredRecords( time );
+		auto& record = records[ make_pair( code, CBoostStdTimeConverter::ConvertToBoostTime( sequenceTime ) ) ];
+		for ( const auto& stageTime : record.first ) {
+			if ( stageTime.first == stage ) {
+				return;
+			}
+		}
+		record.first.push_back( make_pair( stage, time ) );
+
+		if ( ( stage != TONE_END ) && metrics ) {
+			currMetrics = metrics;
+			latency = GetLatency( record, time );
+		}
+	}
+
+	if ( currMetrics && !latency.is_special() ) {
+		currMetrics->Observe( stage, string(), latency );
+	}
+}
+
+
+
+/**	@brief		Stores the time an alarm was handed off to an alarm gateway and emits the latency record
+*	@param		code								Alarm code
+*	@param		sequenceTime						Start time of the sequence (UTC)
+*	@param		gateway								Name of the alarm gateway
+*	@param		time								Time of the hand-off (UTC). Default is the current time.
+*	@return											None
+*	@exception										None
+*	@remarks										Only the first hand-off to each gateway is recorded, repeated trials are not regarded as a new hand-off
+*/
+void Utilities::Latency::CLatencyProbe::MarkGatewayHandoff( const std::vector<int>& code, const Utilities::CDateTime& sequenceTime, const std::string& gateway, const boost::posix_time::ptime& time )
+{
+	using namespace std;
+	using namespace Utilities::Time;
+	using namespace Utilities::Message;
+
+	function< void( unique_ptr<CStatusMessage> ) > currRecordCallback;
+	shared_ptr<CLatencyMetrics> currMetrics;
+	vector< pair<LatencyStage, boost::posix_time::ptime> > stageTimes;
+	boost::posix_time::time_duration latency;
+
+	{
+		lock_guard<mutex> lock( probeMutex );
+		if ( !IsEnabled() ) {
+			return;
+		}
+
+		RemoveExpiredRecords( time );
+		auto it = records.find( make_pair( code, CBoostStdTimeConverter::ConvertToBoostTime( sequenceTime ) ) );
+		if ( ( it == records.end() ) || !it->second.second.insert( gateway ).second ) {
+			return;
+		}
+
+		stageTimes = it->second.first;
+		stageTimes.push_back( make_pair( GATEWAY_HANDOFF, time ) );
+		latency = GetLatency( it->second, time );
+		currRecordCallback = recordCallback;
+		currMetrics = metrics;
+	}
+
+	if ( currMetrics && !latency.is_special() ) {
+		currMetrics->Observe( GATEWAY_HANDOFF, gateway, latency );
+	}
+	if ( currRecordCallback ) {
+		currRecordCallback( make_unique<CLatencyStatusMessage>( time, code, sequenceTime, gateway, stageTimes ) );
+	}
+}
+
+
+
+/**	@brief		Removes an alarm that will not be sent (for example filtered out by the blacklist or the whitelist)
+*	@param		code								Alarm code
+*	@param		sequenceTime						Start time of the sequence (UTC)
+*	@return											None
+*	@exception										None
+*	@remarks										None
+*/
+void Utilities::Latency::CLatencyProbe::Discard( const std::vector<int>& code, const Utilities::CDateTime& sequenceTime )
+{
+	using namespace Utilities::Time;
+
+	std::lock_guard<std::mutex> lock( probeMutex );
+	records.erase( std::make_pair( code, CBoostStdTimeConverter::ConvertToBoostTime( sequenceTime ) ) );
+}
+
+
+
+/**	@brief		Checks if any consumer of the latencies is set
+*	@return											True if a record callback or metrics are set, otherwise false
+*	@exception										None
+*	@remarks										The method is not thread-safe
+*/
+bool Utilities::Latency::CLatencyProbe::IsEnabled() const
+{
+	return ( static_cast<bool>( recordCallback ) || static_cast<bool>( metrics ) );
+}
+
+
+
+/**	@brief		Removes all records that are older than the maximum record age
+*	@param		currTime							Current time (UTC)
+*	@return											None
+*	@exception										None
+*	@remarks										The method is not thread-safe
+*/
+void Utilities::Latency::CLatencyProbe::RemoveExpiredRecords( const boost::posix_time::ptime& currTime )
+{
+	for ( auto it = records.begin(); it != records.end(); ) {
+		if ( !it->second.first.empty() && ( ( currTime - it->second.first.front().second ) > maxRecordAge ) ) {
+			it = records.erase( it );
+		} else {
+			it++;
+		}
+	}
+}
+
+
+
+/**	@brief		Calculates the latency of a time relative to the end of the last tone of an alarm
+*	@param		record								Record of the alarm
+*	@param		time								Time (UTC)
+*	@return											Latency relative to the end of the last tone. It is not_a_date_time if the end of the last tone is unknown.
+*	@exception										None
+*	@remarks										None
+*/
+boost::posix_time::time_duration Utilities::Latency::CLatencyProbe::GetLatency( const ProbeRecord& record, const boost::posix_time::ptime& time )
+{
+	for ( const auto& stageTime : record.first ) {
+		if ( stageTime.first == TONE_END ) {
+			return time - stageTime.second;
+		}
+	}
+
+	return boost::posix_time::time_duration( boost::posix_time::not_a_date_time );
+}
+
+
+// instantiation of static class members
+std::unique_ptr<Utilities::Latency::CLatencyProbe> Utilities::Latency::CLatencyProbe::instancePtr;
+std::once_flag Utilities::Latency::CLatencyProbe::onceFlag;
@@ -0,0 +1,94 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <utility>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "DateTime.h"
+#include "StatusMessage.h"
+#include "LatencyMetrics.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef UTILITY_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define UTILITY_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define UTILITY_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define UTILITY_API __attribute__ ((visibility ("default")))
+	#else
+		#define UTILITY_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Utilities
+*/
+namespace Utilities {
+	namespace Latency {
+		/**	\ingroup Utilities
+		*	Thread safe singleton collecting the timestamps of each alarm along the processing chain from the end of the last tone to the hand-off to the alarm gateways.
+		*	An alarm is identified by its code and the start time of the sequence. For each hand-off to a gateway a latency record (Utilities::Message::CLatencyStatusMessage) is emitted.
+		*/
+		class CLatencyProbe
+		{
+		public:
+			UTILITY_API static CLatencyProbe& Instance();
+			UTILITY_API void SetRecordCallback( std::function< void( std::unique_ptr<Utilities::Message::CStatusMessage> ) > recordCallback );
+			UTILITY_API void SetMetrics( std::shared_ptr<CLatencyMetrics> metrics );
+			UTILITY_API void Mark( const std::vector<int>& code, const Utilities::CDateTime& sequenceTime, const LatencyStage& stage, const boost::posix_time::ptime& time = boost::posix_time::microsec_clock::universal_time() );
+			UTILITY_API void MarkGatewayHandoff( const std::vector<int>& code, const Utilities::CDateTime& sequenceTime, const std::string& gateway, const boost::posix_time::ptime& time = boost::posix_time::microsec_clock::universal_time() );
+			UTILITY_API void Discard( const std::vector<int>& code, const Utilities::CDateTime& sequenceTime );
+			UTILITY_API virtual ~CLatencyProbe();
+		private:
+			/** @param ProbeRecord	Times of all passed probe points (UTC), gateways the alarm was already handed off to */
+			typedef std::pair< std::vector< std::pair<LatencyStage, boost::posix_time::ptime> >, std::set<std::string> > ProbeRecord;
+
+			CLatencyProbe(); // this enforces that no object can be created from the class - except in the static variable instancePtr during the first call of CLatencyProbe::Instance
+			CLatencyProbe( const CLatencyProbe& ) = delete;
+			CLatencyProbe& operator=( const CLatencyProbe& ) = delete;
+			bool IsEnabled() const;
+			void RemoveExpiredRecords( const boost::posix_time::ptime& currTime );
+			static boost::posix_time::time_duration GetLatency( const ProbeRecord& record, const boost::posix_time::ptime& time );
+
+			static std::unique_ptr<CLatencyProbe> instancePtr;
+			static std::once_flag onceFlag;
+			std::map< std::pair< std::vector<int>, boost::posix_time::ptime >, ProbeRecord > records;
+			std::function< void( std::unique_ptr<Utilities::Message::CStatusMessage> ) > recordCallback;
+			std::shared_ptr<CLatencyMetrics> metrics;
+			mutable std::mutex probeMutex;
+		};
+	}
+}
+/*@}*/
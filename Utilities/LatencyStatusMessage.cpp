@@ -0,0 +1,71 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define UTILITY_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define UTILITY_API __declspec(dllexport)
+	#endif
+#endif
+
+#include "LatencyStatusMessage.h"
+
+
+/**	@brief		Constructor
+*	@param		messageTime							Timestamp of the message
+*	@param		code								Alarm code
+*	@param		sequenceTime						Start time of the sequence (UTC)
+*	@param		gateway								Name of the alarm gateway the alarm was handed off to
+*	@param		stageTimes							Times of all passed probe points (UTC) in chronological order
+*	@exception										None
+*	@remarks										None
+*/
+Utilities::Message::CLatencyStatusMessage::CLatencyStatusMessage( const boost::posix_time::ptime& messageTime, const std::vector<int>& code, const Utilities::CDateTime& sequenceTime, const std::string& gateway, const std::vector< std::pair<Latency::LatencyStage, boost::posix_time::ptime> >& stageTimes )
+	: CStatusMessage(),
+	  code( code ),
+	  sequenceTime( sequenceTime ),
+	  gateway( gateway ),
+	  stageTimes( stageTimes )
+{
+	CStatusMessage::Reset( MESSAGE_SUCCESS, messageTime );
+}
+
+
+/**	@brief		Obtains the complete contents of the latency status message
+*	@param		code								Alarm code
+*	@param		sequenceTime						Start time of the sequence (UTC)
+*	@param		gateway								Name of the alarm gateway the alarm was handed off to
+*	@param		stageTimes							Times of all passed probe points (UTC) in chronological order
+*	@return											None
+*	@exception										None
+*	@remarks										None
+*/
+void Utilities::Message::CLatencyStatusMessage::GetMessageContent( std::vector<int>& code, Utilities::CDateTime& sequenceTime, std::string& gateway, std::vector< std::pair<Latency::LatencyStage, boost::posix_time::ptime> >& stageTimes ) const
+{
+	code = CLatencyStatusMessage::code;
+	sequenceTime = CLatencyStatusMessage::sequenceTime;
+	gateway = CLatencyStatusMessage::gateway;
+	stageTimes = CLatencyStatusMessage::stageTimes;
+}
+
+
+/**	@brief		Destructor
+*/
+Utilities::Message::CLatencyStatusMessage::~CLatencyStatusMessage( void )
+{
+}
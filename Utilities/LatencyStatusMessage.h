@@ -0,0 +1,71 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include "DateTime.h"
+#include "StatusMessage.h"
+#include "LatencyMetrics.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef UTILITY_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define UTILITY_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define UTILITY_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define UTILITY_API __attribute__ ((visibility ("default")))
+	#else
+		#define UTILITY_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Utilities
+*/
+namespace Utilities {
+	namespace Message {
+		/**	\ingroup Utilities
+		*	Class representing the latency record of a single alarm from the end of the last tone to the hand-off to an alarm gateway
+		*/
+		class CLatencyStatusMessage : public CStatusMessage
+		{
+		public:
+			UTILITY_API CLatencyStatusMessage( const boost::posix_time::ptime& messageTime, const std::vector<int>& code, const Utilities::CDateTime& sequenceTime, const std::string& gateway, const std::vector< std::pair<Latency::LatencyStage, boost::posix_time::ptime> >& stageTimes );
+			UTILITY_API virtual void GetMessageContent( std::vector<int>& code, Utilities::CDateTime& sequenceTime, std::string& gateway, std::vector< std::pair<Latency::LatencyStage, boost::posix_time::ptime> >& stageTimes ) const;
+			UTILITY_API virtual ~CLatencyStatusMessage();
+		private:
+			std::vector<int> code;
+			Utilities::CDateTime sequenceTime;
+			std::string gateway;
+			std::vector< std::pair<Latency::LatencyStage, boost::posix_time::ptime> > stageTimes;
+		};
+	}
+}
+/*@}*/
@@ -0,0 +1,488 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef __GNUC__
+		#define UTILITY_API __attribute__ ((dllexport))
+	#else
+		// Microsoft Visual Studio
+		#define UTILITY_API __declspec(dllexport)
+	#endif
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include "MetricsRegistry.h"
+
+
+
+/**	@brief		Constructor
+*/
+Utilities::Metrics::CCounter::CCounter()
+	: value( 0 )
+{
+}
+
+
+
+/**	@brief		Increments the counter
+*	@param		value								Increment. Default is 1.
+*	@return											None
+*	@exception										None
+*	@remarks										The method is lock-free
+*/
+void Utilities::Metrics::CCounter::Increment( const std::uint64_t& value )
+{
+	CCounter::value.fetch_add( value, std::memory_order_relaxed );
+}
+
+
+
+/**	@brief		Obtains the current value of the counter
+*	@return											Current value
+*	@exception										None
+*	@remarks										None
+*/
+std::uint64_t Utilities::Metrics::CCounter::GetValue() const
+{
+	return value.load( std::memory_order_relaxed );
+}
+
+
+
+/**	@brief		Constructor
+*/
+Utilities::Metrics::CGauge::CGauge()
+	: value( 0 )
+{
+}
+
+
+
+/**	@brief		Sets the gauge
+*	@param		value								New value
+*	@return											None
+*	@exception										None
+*	@remarks										The method is lock-free
+*/
+void Utilities::Metrics::CGauge::Set( const std::int64_t& value )
+{
+	CGauge::value.store( value, std::memory_order_relaxed );
+}
+
+
+
+/**	@brief		Changes the gauge relative to its current value
+*	@param		value								Change (may be negative)
+*	@return											None
+*	@exception										None
+*	@remarks										The method is lock-free
+*/
+void Utilities::Metrics::CGauge::Add( const std::int64_t& value )
+{
+	CGauge::value.fetch_add( value, std::memory_order_relaxed );
+}
+
+
+
+/**	@brief		Obtains the current value of the gauge
+*	@return											Current value
+*	@exception										None
+*	@remarks										None
+*/
+std::int64_t Utilities::Metrics::CGauge::GetValue() const
+{
+	return value.load( std::memory_order_relaxed );
+}
+
+
+
+/**	@brief		Constructor
+*	@param		bucketLimits						Upper limits of the histogram buckets. A bucket for all larger values is added automatically.
+*	@exception	std::invalid_argument				Thrown if the bucket limits are empty or not strictly increasing
+*	@remarks										None
+*/
+Utilities::Metrics::CHistogram::CHistogram( const std::vector<double>& bucketLimits )
+	: bucketLimits( bucketLimits ),
+	  bucketCounts( new std::atomic<std::uint64_t>[ bucketLimits.size() + 1 ] ),
+	  sumMicroseconds( 0 ),
+	  count( 0 )
+{
+	if ( bucketLimits.empty() || ( std::adjacent_find( bucketLimits.begin(), bucketLimits.end(), std::greater_equal<double>() ) != bucketLimits.end() ) ) {
+		throw std::invalid_argument( "The histogram bucket limits must be strictly increasing." );
+	}
+
+	for ( size_t i = 0; i <= bucketLimits.size(); i++ ) {
+		bucketCounts[i].store( 0 );
+	}
+}
+
+
+
+/**	@brief		Adds a value to the histogram
+*	@param		value								New value. Negative values are counted as zero in the sum.
+*	@return											None
+*	@exception										None
+*	@remarks										The method is lock-free
+*/
+void Utilities::Metrics::CHistogram::Observe( const double& value )
+{
+	using namespace std;
+
+	auto bucket = distance( bucketLimits.begin(), lower_bound( bucketLimits.begin(), bucketLimits.end(), value ) );
+	bucketCounts[ bucket ].fetch_add( 1, memory_order_relaxed );
+	sumMicroseconds.fetch_add( static_cast<uint64_t>( max( 0.0, value * 1.0e6 + 0.5 ) ), memory_order_relaxed );
+	count.fetch_add( 1, memory_order_relaxed );
+}
+
+
+
+/**	@brief		Adds a duration to the histogram
+*	@param		duration							New duration, it is stored in seconds
+*	@return											None
+*	@exception										None
+*	@remarks										The method is lock-free
+*/
+void Utilities::Metrics::CHistogram::Observe( const std::chrono::steady_clock::duration& duration )
+{
+	Observe( std::chrono::duration_cast< std::chrono::duration<double> >( duration ).count() );
+}
+
+
+
+/**	@brief		Obtains the current state of the histogram
+*	@param		bucketLimits						Upper limits of the histogram buckets (without the bucket for all larger values)
+*	@param		cumulativeCounts					Cumulative counts of all buckets. The last entry is the bucket for all values.
+*	@param		sum									Sum of all values
+*	@param		count								Number of all values
+*	@return											None
+*	@exception										None
+*	@remarks										Concurrent updates may be contained only partially in the returned values
+*/
+void Utilities::Metrics::CHistogram::GetValues( std::vector<double>& bucketLimits, std::vector<std::uint64_t>& cumulativeCounts, double& sum, std::uint64_t& count ) const
+{
+	std::uint64_t cumulativeCount = 0;
+
+	bucketLimits = CHistogram::bucketLimits;
+	cumulativeCounts.clear();
+	for ( size_t i = 0; i <= bucketLimits.size(); i++ ) {
+		cumulativeCount += bucketCounts[i].load( std::memory_order_relaxed );
+		cumulativeCounts.push_back( cumulativeCount );
+	}
+	sum = sumMicroseconds.load( std::memory_order_relaxed ) / 1.0e6;
+	count = cumulativeCount;
+}
+
+
+
+/**	@brief		Access to the singleton instance
+*	@return											Singleton instance
+*	@exception										None
+*	@remarks										None
+*/
+Utilities::Metrics::CMetricsRegistry& Utilities::Metrics::CMetricsRegistry::Instance()
+{
+	std::call_once( onceFlag, []() {
+		instancePtr.reset( new CMetricsRegistry() );
+	} );
+
+	return *instancePtr;
+}
+
+
+
+/**	@brief		Constructor
+*	@exception										None
+*	@remarks										The constructor is private and can therefore only be used for instantiating the singleton
+*/
+Utilities::Metrics::CMetricsRegistry::CMetricsRegistry()
+{
+}
+
+
+
+/**	@brief		Destructor
+*/
+Utilities::Metrics::CMetricsRegistry::~CMetricsRegistry()
+{
+}
+
+
+
+/**	@brief		Obtains a counter, it is created if it does not exist yet
+*	@param		name								Name of the metric (Prometheus naming conventions, i.e. ending with "_total")
+*	@param		help								Description of the metric
+*	@param		labels								Labels of the metric
+*	@return											Counter. All callers with the same name and labels obtain the same counter.
+*	@exception	std::logic_error					Thrown if the name is already used by a metric of another type
+*	@remarks										The counter can be stored by the caller for lock-free updates
+*/
+std::shared_ptr<Utilities::Metrics::CCounter> Utilities::Metrics::CMetricsRegistry::GetCounter( const std::string& name, const std::string& help, const MetricLabels& labels )
+{
+	std::lock_guard<std::mutex> lock( registryMutex );
+	auto& counter = GetFamily( name, help, COUNTER ).counters[ labels ];
+	if ( !counter ) {
+		counter = std::make_shared<CCounter>();
+	}
+
+	return counter;
+}
+
+
+
+/**	@brief		Obtains a gauge, it is created if it does not exist yet
+*	@param		name								Name of the metric
+*	@param		help								Description of the metric
+*	@param		labels								Labels of the metric
+*	@return											Gauge. All callers with the same name and labels obtain the same gauge.
+*	@exception	std::logic_error					Thrown if the name is already used by a metric of another type
+*	@remarks										The gauge can be stored by the caller for lock-free updates
+*/
+std::shared_ptr<Utilities::Metrics::CGauge> Utilities::Metrics::CMetricsRegistry::GetGauge( const std::string& name, const std::string& help, const MetricLabels& labels )
+{
+	std::lock_guard<std::mutex> lock( registryMutex );
+	auto& gauge = GetFamily( name, help, GAUGE ).gauges[ labels ];
+	if ( !gauge ) {
+		gauge = std::make_shared<CGauge>();
+	}
+
+	return gauge;
+}
+
+
+
+/**	@brief		Obtains a histogram, it is created if it does not exist yet
+*	@param		name								Name of the metric (Prometheus naming conventions, i.e. ending with the unit such as "_seconds")
+*	@param		help								Description of the metric
+*	@param		labels								Labels of the metric
+*	@param		bucketLimits						Upper limits of the histogram buckets. It is only used if the histogram is created.
+*	@return											Histogram. All callers with the same name and labels obtain the same histogram.
+*	@exception	std::logic_error					Thrown if the name is already used by a metric of another type
+*	@exception	std::invalid_argument				Thrown if the bucket limits are empty or not strictly increasing
+*	@remarks										The histogram can be stored by the caller for lock-free updates
+*/
+std::shared_ptr<Utilities::Metrics::CHistogram> Utilities::Metrics::CMetricsRegistry::GetHistogram( const std::string& name, const std::string& help, const MetricLabels& labels, const std::vector<double>& bucketLimits )
+{
+	std::lock_guard<std::mutex> lock( registryMutex );
+	auto& histogram = GetFamily( name, help, HISTOGRAM ).histograms[ labels ];
+	if ( !histogram ) {
+		histogram = std::make_shared<CHistogram>( bucketLimits );
+	}
+
+	return histogram;
+}
+
+
+
+/**	@brief		Obtains the default bucket limits of the histograms
+*	@return											Default bucket limits [s], suitable both for processing times and alarm latencies
+*	@exception										None
+*	@remarks										None
+*/
+std::vector<double> Utilities::Metrics::CMetricsRegistry::GetDefaultBucketLimits()
+{
+	return std::vector<double>{ 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0 };
+}
+
+
+
+/**	@brief		Provides all metrics in the Prometheus text exposition format (version 0.0.4)
+*	@return											All metrics
+*	@exception										None
+*	@remarks										None
+*/
+std::string Utilities::Metrics::CMetricsRegistry::Serialize() const
+{
+	using namespace std;
+
+	stringstream ss;
+	vector<double> bucketLimits;
+	vector<uint64_t> cumulativeCounts;
+	double sum;
+	uint64_t count;
+
+	lock_guard<mutex> lock( registryMutex );
+	for ( const auto& family : families ) {
+		ss << "# HELP " << family.first << " " << family.second.help << "\n";
+		switch ( family.second.type ) {
+		case COUNTER:
+			ss << "# TYPE " << family.first << " counter\n";
+			for ( const auto& counter : family.second.counters ) {
+				ss << family.first << FormatLabels( counter.first ) << " " << counter.second->GetValue() << "\n";
+			}
+			break;
+		case GAUGE:
+			ss << "# TYPE " << family.first << " gauge\n";
+			for ( const auto& gauge : family.second.gauges ) {
+				ss << family.first << FormatLabels( gauge.first ) << " " << gauge.second->GetValue() << "\n";
+			}
+			break;
+		case HISTOGRAM:
+			ss << "# TYPE " << family.first << " histogram\n";
+			for ( const auto& histogram : family.second.histograms ) {
+				histogram.second->GetValues( bucketLimits, cumulativeCounts, sum, count );
+				for ( size_t i = 0; i < bucketLimits.size(); i++ ) {
+					ss << family.first << "_bucket" << FormatLabels( histogram.first, "le=\"" + FormatValue( bucketLimits[i] ) + "\"" ) << " " << cumulativeCounts[i] << "\n";
+				}
+				ss << family.first << "_bucket" << FormatLabels( histogram.first, "le=\"+Inf\"" ) << " " << cumulativeCounts.back() << "\n";
+				ss << family.first << "_sum" << FormatLabels( histogram.first ) << " " << FormatValue( sum ) << "\n";
+				ss << family.first << "_count" << FormatLabels( histogram.first ) << " " << count << "\n";
+			}
+			break;
+		}
+	}
+
+	return ss.str();
+}
+
+
+
+/**	@brief		Obtains a metric family, it is created if it does not exist yet
+*	@param		name								Name of the metric family
+*	@param		help								Description of the metric family
+*	@param		type								Type of the metric family
+*	@return											Metric family
+*	@exception	std::logic_error					Thrown if the name is already used by a metric family of another type
+*	@remarks										The method is not thread-safe
+*/
+Utilities::Metrics::CMetricsRegistry::MetricFamily& Utilities::Metrics::CMetricsRegistry::GetFamily( const std::string& name, const std::string& help, const MetricType& type )
+{
+	auto it = families.find( name );
+	if ( it == families.end() ) {
+		it = families.insert( std::make_pair( name, MetricFamily() ) ).first;
+		it->second.type = type;
+		it->second.help = help;
+	} else if ( it->second.type != type ) {
+		throw std::logic_error( "The metric " + name + " is already registered with another type." );
+	}
+
+	return it->second;
+}
+
+
+
+/**	@brief		Formats the labels of a metric
+*	@param		labels								Labels of the metric
+*	@param		additionalLabel						Already formatted label added at the end (for example the bucket limit of a histogram)
+*	@return											Formatted labels including the braces, empty if there are no labels
+*	@exception										None
+*	@remarks										Backslashes, double-quotes and line feeds in the values are escaped
+*/
+std::string Utilities::Metrics::CMetricsRegistry::FormatLabels( const MetricLabels& labels, const std::string& additionalLabel )
+{
+	using namespace std;
+
+	vector<string> formattedLabels;
+	string formattedString;
+
+	for ( const auto& label : labels ) {
+		string value;
+		for ( auto character : label.second ) {
+			switch ( character ) {
+			case '\\':
+				value += "\\\\";
+				break;
+			case '"':
+				value += "\\\"";
+				break;
+			case '\n':
+				value += "\\n";
+				break;
+			default:
+				value += character;
+			}
+		}
+		formattedLabels.push_back( label.first + "=\"" + value + "\"" );
+	}
+	if ( !additionalLabel.empty() ) {
+		formattedLabels.push_back( additionalLabel );
+	}
+
+	if ( formattedLabels.empty() ) {
+		return string();
+	}
+
+	for ( const auto& formattedLabel : formattedLabels ) {
+		formattedString += ( formattedString.empty() ? "" : "," ) + formattedLabel;
+	}
+
+	return "{" + formattedString + "}";
+}
+
+
+
+/**	@brief		Formats a floating point value independently of the locale
+*	@param		value								Value
+*	@return											Formatted value
+*	@exception										None
+*	@remarks										None
+*/
+std::string Utilities::Metrics::CMetricsRegistry::FormatValue( const double& value )
+{
+	std::stringstream ss;
+
+	ss.imbue( std::locale::classic() );
+	ss << std::setprecision( 15 ) << value;
+
+	return ss.str();
+}
+
+
+
+/**	@brief		Constructor
+*	@param		stage								Name of the signal processing stage
+*	@exception										None
+*	@remarks										None
+*/
+Utilities::Metrics::CStageMetrics::CStageMetrics( const std::string& stage )
+	: queueLength( CMetricsRegistry::Instance().GetGauge( "personalfme_stage_queue_length", "Number of elements waiting in the input queue of a signal processing stage", { { "stage", stage } } ) ),
+	  processingTime( CMetricsRegistry::Instance().GetHistogram( "personalfme_stage_processing_seconds", "Processing time of a single step of a signal processing stage", { { "stage", stage } } ) )
+{
+}
+
+
+
+/**	@brief		Sets the current length of the input queue
+*	@param		queueLength							Number of elements waiting in the input queue
+*	@return											None
+*	@exception										None
+*	@remarks										The method is lock-free
+*/
+void Utilities::Metrics::CStageMetrics::SetQueueLength( const std::size_t& queueLength )
+{
+	CStageMetrics::queueLength->Set( static_cast<std::int64_t>( queueLength ) );
+}
+
+
+
+/**	@brief		Adds the processing time of a single processing step
+*	@param		processingTime						Processing time
+*	@return											None
+*	@exception										None
+*	@remarks										The method is lock-free
+*/
+void Utilities::Metrics::CStageMetrics::ObserveProcessingTime( const std::chrono::steady_clock::duration& processingTime )
+{
+	CStageMetrics::processingTime->Observe( processingTime );
+}
+
+
+// instantiation of static class members
+std::unique_ptr<Utilities::Metrics::CMetricsRegistry> Utilities::Metrics::CMetricsRegistry::instancePtr;
+std::once_flag Utilities::Metrics::CMetricsRegistry::onceFlag;
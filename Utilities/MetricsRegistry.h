@@ -0,0 +1,167 @@
+/*	PersonalFME - Gateway linking analog radio selcalls to internet communication services
+Copyright(C) 2010-2023 Ralf Rettig (www.personalfme.de)
+
+This program is free software: you can redistribute it and / or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.If not, see <http://www.gnu.org/licenses/>
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined _WIN32 || defined __CYGWIN__
+	#ifdef UTILITY_API
+		// All functions in this file are exported
+	#else
+		// All functions in this file are imported
+		// Windows
+		#ifdef __GNUC__
+			// GCC
+			#define UTILITY_API __attribute__ ((dllimport))
+		#else
+			// Microsoft Visual Studio
+			#define UTILITY_API __declspec(dllimport)
+		#endif
+	#endif
+#else
+	// Linux
+	#if __GNUC__ >= 4
+		#define UTILITY_API __attribute__ ((visibility ("default")))
+	#else
+		#define UTILITY_API
+	#endif		
+#endif
+
+
+/*@{*/
+/** \ingroup Utilities
+*/
+namespace Utilities {
+	namespace Metrics {
+		/** @param MetricLabels		Labels of a metric (name, value) */
+		typedef std::map<std::string, std::string> MetricLabels;
+
+		/**	\ingroup Utilities
+		*	Lock-free monotonic counter
+		*/
+		class CCounter
+		{
+		public:
+			UTILITY_API CCounter();
+			UTILITY_API void Increment( const std::uint64_t& value = 1 );
+			UTILITY_API std::uint64_t GetValue() const;
+		private:
+			CCounter( const CCounter& ) = delete;
+			CCounter& operator=( const CCounter& ) = delete;
+
+			std::atomic<std::uint64_t> value;
+		};
+
+		/**	\ingroup Utilities
+		*	Lock-free gauge that can go up and down
+		*/
+		class CGauge
+		{
+		public:
+			UTILITY_API CGauge();
+			UTILITY_API void Set( const std::int64_t& value );
+			UTILITY_API void Add( const std::int64_t& value );
+			UTILITY_API std::int64_t GetValue() const;
+		private:
+			CGauge( const CGauge& ) = delete;
+			CGauge& operator=( const CGauge& ) = delete;
+
+			std::atomic<std::int64_t> value;
+		};
+
+		/**	\ingroup Utilities
+		*	Lock-free histogram with fixed buckets. The sum is stored with a resolution of microseconds.
+		*/
+		class CHistogram
+		{
+		public:
+			UTILITY_API CHistogram( const std::vector<double>& bucketLimits );
+			UTILITY_API void Observe( const double& value );
+			UTILITY_API void Observe( const std::chrono::steady_clock::duration& duration );
+			UTILITY_API void GetValues( std::vector<double>& bucketLimits, std::vector<std::uint64_t>& cumulativeCounts, double& sum, std::uint64_t& count ) const;
+		private:
+			CHistogram( const CHistogram& ) = delete;
+			CHistogram& operator=( const CHistogram& ) = delete;
+
+			std::vector<double> bucketLimits;
+			std::unique_ptr< std::atomic<std::uint64_t>[] > bucketCounts;
+			std::atomic<std::uint64_t> sumMicroseconds;
+			std::atomic<std::uint64_t> count;
+		};
+
+		/**	\ingroup Utilities
+		*	Thread safe singleton registry of all metrics of the program. It creates the metrics and provides them in the Prometheus text exposition format.
+		*	Only the creation of a metric requires a lock, all updates of an obtained metric are lock-free and can be used in the processing threads.
+		*/
+		class CMetricsRegistry
+		{
+		public:
+			UTILITY_API static CMetricsRegistry& Instance();
+			UTILITY_API std::shared_ptr<CCounter> GetCounter( const std::string& name, const std::string& help, const MetricLabels& labels = MetricLabels() );
+			UTILITY_API std::shared_ptr<CGauge> GetGauge( const std::string& name, const std::string& help, const MetricLabels& labels = MetricLabels() );
+			UTILITY_API std::shared_ptr<CHistogram> GetHistogram( const std::string& name, const std::string& help, const MetricLabels& labels = MetricLabels(), const std::vector<double>& bucketLimits = GetDefaultBucketLimits() );
+			UTILITY_API std::string Serialize() const;
+			UTILITY_API static std::vector<double> GetDefaultBucketLimits();
+			UTILITY_API virtual ~CMetricsRegistry();
+		private:
+			/** @param MetricType	Type of a metric family */
+			enum MetricType { COUNTER, GAUGE, HISTOGRAM };
+
+			/** @param MetricFamily		All metrics sharing the same name */
+			struct MetricFamily {
+				MetricType type;
+				std::string help;
+				std::map< MetricLabels, std::shared_ptr<CCounter> > counters;
+				std::map< MetricLabels, std::shared_ptr<CGauge> > gauges;
+				std::map< MetricLabels, std::shared_ptr<CHistogram> > histograms;
+			};
+
+			CMetricsRegistry(); // this enforces that no object can be created from the class - except in the static variable instancePtr during the first call of CMetricsRegistry::Instance
+			CMetricsRegistry( const CMetricsRegistry& ) = delete;
+			CMetricsRegistry& operator=( const CMetricsRegistry& ) = delete;
+			MetricFamily& GetFamily( const std::string& name, const std::string& help, const MetricType& type );
+			static std::string FormatLabels( const MetricLabels& labels, const std::string& additionalLabel = std::string() );
+			static std::string FormatValue( const double& value );
+
+			static std::unique_ptr<CMetricsRegistry> instancePtr;
+			static std::once_flag onceFlag;
+			std::map<std::string, MetricFamily> families;
+			mutable std::mutex registryMutex;
+		};
+
+		/**	\ingroup Utilities
+		*	Processing time and input queue length of a signal processing stage
+		*/
+		class CStageMetrics
+		{
+		public:
+			UTILITY_API CStageMetrics( const std::string& stage );
+			UTILITY_API void SetQueueLength( const std::size_t& queueLength );
+			UTILITY_API void ObserveProcessingTime( const std::chrono::steady_clock::duration& processingTime );
+		private:
+			std::shared_ptr<CGauge> queueLength;
+			std::shared_ptr<CHistogram> processingTime;
+		};
+	}
+}
+/*@}*/
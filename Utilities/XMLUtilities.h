@@ -18,7 +18,9 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <iterator>
 #include <boost/filesystem.hpp>
+#include <Poco/SAX/InputSource.h>
 #include <Poco/Util/XMLConfiguration.h>
 #include "FileUtils.h"
 #include "XMLException.h"
@@ -115,14 +117,23 @@ void Utilities::XML::ReadXML( const boost::filesystem::path& xmlFile, T& data, c
 	std::string exceptionMessage;
 	Utilities::XML::CXMLValidator xmlValidator;
 
-	// validate the XML-file with the Xerces-library using the XML-schema file
 	try {
-		xmlValidator.ValidateSchema( xmlFile, xmlSchemaLocation ); // this will throw a Utilities::Exception::xml_error exception if the XML-file is invalid
+		// the file is read only once for both the validation and the deserialization
+		std::ifstream xmlFileStream( xmlFile.string(), std::ios::binary );
+		if ( !xmlFileStream ) {
+			throw Exception::xml_error( "error:\tThe file cannot be opened." );
+		}
+		std::string xmlContent( ( std::istreambuf_iterator<char>( xmlFileStream ) ), std::istreambuf_iterator<char>() );
+
+		// validate the XML-file with the Xerces-library using the XML-schema file
+		xmlValidator.ValidateSchema( xmlContent, xmlFile, xmlSchemaLocation ); // this will throw a Utilities::Exception::xml_error exception if the XML-file is invalid
 
 		// parse the valid XML-file using the Poco-library
 		try {
-			auto tempPathChanger = Utilities::File::TemporaryPathChange( xmlFile.parent_path() ); // will change back to the current directory when going out of scope
-			Poco::AutoPtr<XMLConfiguration> xmlFileReader( new XMLConfiguration( xmlFile.filename().string() ) );
+			std::istringstream xmlContentStream( xmlContent );
+			Poco::XML::InputSource inputSource( xmlContentStream );
+			Poco::AutoPtr<XMLConfiguration> xmlFileReader( new XMLConfiguration() );
+			xmlFileReader->load( &inputSource );
 			data.SetFromXML( xmlFileReader );
 		} catch ( Poco::Exception& e ) {
 			throw Exception::xml_error( "error:\t" + e.message() );
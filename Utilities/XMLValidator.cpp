@@ -23,13 +23,270 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 	#endif
 #endif
 
+#include <map>
+#include <mutex>
+#include <memory>
+#include <ctime>
+#include <regex>
+#include <vector>
+#include <fstream>
+#include <iterator>
 #include <boost/algorithm/string.hpp>
-#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/XMLGrammarPoolImpl.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
 #include <xercesc/validators/common/Grammar.hpp>
+#include "XMLException.h"
 #include "ParserErrorHandler.h"
 #include "XMLValidator.h"
 
 
+/*@{*/
+/** \ingroup Utilities
+*/
+namespace Utilities {
+	namespace XML {
+		/**	\ingroup Utilities
+		*	Process-wide validating SAX-parser. The compiled XML schemas are kept in a grammar pool and are only reloaded if the schema file has changed.
+		*	Only schemas with a known local file are cached, this comprises the external schema locations and the schema locations defined in the XML-file.
+		*/
+		class CValidationParser
+		{
+		public:
+			static CValidationParser& Instance();
+			~CValidationParser();
+			void Validate( const std::string& xmlContent, const boost::filesystem::path& xmlFile, const std::pair<std::string, boost::filesystem::path>& xmlSchemaLocation );
+		private:
+			CValidationParser();
+			void LoadSchema( const std::string& schemaNamespace, const boost::filesystem::path& schemaFile );
+			static std::string GetSchemaURI( const boost::filesystem::path& schemaFile );
+			static std::vector< std::pair<std::string, boost::filesystem::path> > GetDocumentSchemaLocations( const std::string& xmlContent, const boost::filesystem::path& xmlFile );
+
+			static std::once_flag onceFlag;
+			static std::unique_ptr<CValidationParser> instancePtr;
+			std::mutex parserMutex;
+			std::unique_ptr<xercesc::XMLGrammarPool> grammarPool;
+			std::unique_ptr<xercesc::SAX2XMLReader> reader;
+			CParserErrorHandler parserErrorHandler;
+			std::map< std::string, std::pair<boost::filesystem::path, std::time_t> > loadedSchemas;
+		};
+	}
+}
+/*@}*/
+
+
+std::once_flag Utilities::XML::CValidationParser::onceFlag;
+std::unique_ptr<Utilities::XML::CValidationParser> Utilities::XML::CValidationParser::instancePtr;
+
+
+/** @brief		Obtains the process-wide validation parser
+*	@return									Validation parser
+*	@exception								None
+*	@remarks								The parser is created on the first call. It keeps the Xerces-library initialized until the end of the program.
+*/
+Utilities::XML::CValidationParser& Utilities::XML::CValidationParser::Instance()
+{
+	std::call_once( onceFlag, []() {
+		instancePtr.reset( new CValidationParser() );
+	} );
+
+	return *instancePtr;
+}
+
+
+/** @brief		Constructor
+*	@remarks								None
+*/
+Utilities::XML::CValidationParser::CValidationParser()
+{
+	using namespace xercesc;
+
+	XMLPlatformUtils::Initialize( "de_DE" ); // currently the locale has no effect in Xerces
+
+	grammarPool.reset( new XMLGrammarPoolImpl( XMLPlatformUtils::fgMemoryManager ) );
+	reader.reset( XMLReaderFactory::createXMLReader( XMLPlatformUtils::fgMemoryManager, grammarPool.get() ) );
+
+	// corresponds to the automatic schema validation as fatal error
+	reader->setErrorHandler( &parserErrorHandler );
+	reader->setFeature( XMLUni::fgSAX2CoreNameSpaces, true );
+	reader->setFeature( XMLUni::fgSAX2CoreValidation, true );
+	reader->setFeature( XMLUni::fgXercesDynamic, true );
+	reader->setFeature( XMLUni::fgXercesSchema, true );
+	reader->setFeature( XMLUni::fgXercesValidationErrorAsFatal, true );
+
+	// the compiled schemas are reused for all following files, only the schemas loaded by CValidationParser::LoadSchema are cached because only these are checked for changes
+	reader->setFeature( XMLUni::fgXercesCacheGrammarFromParse, false );
+	reader->setFeature( XMLUni::fgXercesUseCachedGrammarInParse, true );
+}
+
+
+/** @brief		Destructor
+*	@remarks								None
+*/
+Utilities::XML::CValidationParser::~CValidationParser()
+{
+	reader.reset();
+	grammarPool.reset();
+	xercesc::XMLPlatformUtils::Terminate();
+}
+
+
+/** @brief		Validates XML-data if it fullfills its XML schema
+*	@param		xmlContent					Content of the XML-file to be validated
+*	@param		xmlFile						Name of the XML-file, relative schema locations within the file are resolved with respect to it
+*	@param		xmlSchemaLocation			External XML schema location (XML namespace, XSD file location) to be used instead of that possibly defined in the XML-file. Omit it, if that defined in the XML-file should be used.
+*	@return									None
+*	@exception	Exception:xml_error			Thrown if the XML-file is invalid or not well-formed
+*	@remarks								The parser is streaming and does not build a DOM-tree. Concurrent validations are serialized.
+*/
+void Utilities::XML::CValidationParser::Validate( const std::string& xmlContent, const boost::filesystem::path& xmlFile, const std::pair<std::string, boost::filesystem::path>& xmlSchemaLocation )
+{
+	using namespace xercesc;
+
+	std::lock_guard<std::mutex> lock( parserMutex );
+
+	XMLCh* externalSchemaLocation = nullptr;
+	if ( xmlSchemaLocation != std::pair<std::string, boost::filesystem::path>() ) {
+		LoadSchema( xmlSchemaLocation.first, xmlSchemaLocation.second );
+		externalSchemaLocation = XMLString::transcode( ( xmlSchemaLocation.first + " " + GetSchemaURI( xmlSchemaLocation.second ) ).c_str() );
+	} else {
+		// the schemas defined in the XML-file are taken from the grammar pool by their namespace, which requires them to be up-to-date
+		for ( const auto& schemaLocation : GetDocumentSchemaLocations( xmlContent, xmlFile ) ) {
+			LoadSchema( schemaLocation.first, schemaLocation.second );
+		}
+	}
+
+	try {
+		reader->setProperty( XMLUni::fgXercesSchemaExternalSchemaLocation, externalSchemaLocation ? externalSchemaLocation : const_cast<XMLCh*>( XMLUni::fgZeroLenString ) );
+
+		// validate the XML-data
+		MemBufInputSource inputSource( reinterpret_cast<const XMLByte*>( xmlContent.data() ), xmlContent.size(), xmlFile.string().c_str(), false );
+		reader->parse( inputSource ); // will throw Utilities::Exception::xml_error in case of a parsing error
+	} catch ( ... ) {
+		XMLString::release( &externalSchemaLocation );
+		throw;
+	}
+	XMLString::release( &externalSchemaLocation );
+}
+
+
+/** @brief		Loads a XML schema into the grammar pool if it has not been loaded before or if it has been changed meanwhile
+*	@param		schemaNamespace				Target namespace of the XML schema, the grammar pool contains only one schema per namespace
+*	@param		schemaFile					XML schema file
+*	@return									None
+*	@exception	Exception:xml_error			Thrown if the XML schema is invalid
+*	@remarks								The parser mutex must be locked by the caller. All sub-schemas are loaded together with the schema.
+*											The cached schema is identified by the path of the schema file and its last modification time.
+*/
+void Utilities::XML::CValidationParser::LoadSchema( const std::string& schemaNamespace, const boost::filesystem::path& schemaFile )
+{
+	using namespace xercesc;
+
+	boost::system::error_code error;
+	auto lastWriteTime = boost::filesystem::last_write_time( schemaFile, error );
+	if ( error ) {
+		throw Exception::xml_error( "error:\tThe XML schema file " + schemaFile.string() + " cannot be read." );
+	}
+
+	auto loadedSchemaIt = loadedSchemas.find( schemaNamespace );
+	if ( ( loadedSchemaIt != loadedSchemas.end() ) && ( loadedSchemaIt->second == std::make_pair( schemaFile, lastWriteTime ) ) ) {
+		return;
+	}
+
+	// a changed schema may also have changed sub-schemas, therefore all compiled schemas are discarded
+	if ( loadedSchemaIt != loadedSchemas.end() ) {
+		reader->resetCachedGrammarPool();
+		loadedSchemas.clear();
+	}
+
+	reader->loadGrammar( GetSchemaURI( schemaFile ).c_str(), Grammar::SchemaGrammarType, true );
+	loadedSchemas[schemaNamespace] = std::make_pair( schemaFile, lastWriteTime );
+}
+
+
+/** @brief		Obtains the URI of a XML schema file
+*	@param		schemaFile					XML schema file with an absolute path
+*	@return									URI of the XML schema file
+*	@exception								None
+*	@remarks								None
+*/
+std::string Utilities::XML::CValidationParser::GetSchemaURI( const boost::filesystem::path& schemaFile )
+{
+	auto uri = "file:///" + schemaFile.string();
+	boost::replace_all( uri, " ", "%20" ); // URI-encoding of whitespaces
+
+	return uri;
+}
+
+
+/** @brief		Obtains the local XML schema files defined in the root element of the XML-file
+*	@param		xmlContent					Content of the XML-file
+*	@param		xmlFile						Name of the XML-file, relative schema locations are resolved with respect to it
+*	@return									Container with the schema locations (XML namespace, absolute path of the XSD file). The namespace is empty for xsi:noNamespaceSchemaLocation.
+*	@exception								None
+*	@remarks								Schema locations which are not local files are omitted, these schemas are compiled during each validation
+*/
+std::vector< std::pair<std::string, boost::filesystem::path> > Utilities::XML::CValidationParser::GetDocumentSchemaLocations( const std::string& xmlContent, const boost::filesystem::path& xmlFile )
+{
+	using namespace std;
+
+	vector< pair<string, boost::filesystem::path> > schemaLocations;
+
+	// find the start tag of the root element (skipping the XML declaration, processing instructions, comments and the document type declaration)
+	auto tagPos = xmlContent.find( '<' );
+	while ( ( tagPos != string::npos ) && ( tagPos + 1 < xmlContent.size() ) && ( ( xmlContent[tagPos + 1] == '?' ) || ( xmlContent[tagPos + 1] == '!' ) ) ) {
+		auto tagEndPos = ( xmlContent.compare( tagPos, 4, "<!--" ) == 0 ) ? xmlContent.find( "-->", tagPos ) : xmlContent.find( '>', tagPos );
+		tagPos = ( tagEndPos == string::npos ) ? string::npos : xmlContent.find( '<', tagEndPos );
+	}
+	if ( tagPos == string::npos ) {
+		return schemaLocations;
+	}
+	auto rootTag = xmlContent.substr( tagPos, xmlContent.find( '>', tagPos ) - tagPos );
+
+	// the locations are given as pairs of namespace and schema file or as a single schema file without namespace
+	vector< pair<string, string> > locations;
+	const regex schemaLocationRegex( R"((^|\s)[\w.-]+:(schemaLocation|noNamespaceSchemaLocation)\s*=\s*(["'])([^"']*)\3)" );
+	for ( sregex_iterator it( rootTag.begin(), rootTag.end(), schemaLocationRegex ), end; it != end; ++it ) {
+		vector<string> tokens;
+		auto value = boost::trim_copy( ( *it )[4].str() );
+		boost::split( tokens, value, boost::is_space(), boost::token_compress_on );
+		if ( ( *it )[2] == "noNamespaceSchemaLocation" ) {
+			locations.push_back( make_pair( string(), value ) );
+		} else {
+			for ( size_t i = 0; i + 1 < tokens.size(); i += 2 ) {
+				locations.push_back( make_pair( tokens[i], tokens[i + 1] ) );
+			}
+		}
+	}
+
+	for ( auto& location : locations ) {
+		auto& schemaFileName = location.second;
+		if ( boost::istarts_with( schemaFileName, "file:" ) ) {
+			// local file URIs are "file:///C:/..." (Windows) or "file:///home/..."
+			schemaFileName.erase( 0, schemaFileName.find_first_not_of( '/', 5 ) );
+#ifndef _WIN32
+			schemaFileName.insert( 0, "/" );
+#endif
+			boost::replace_all( schemaFileName, "%20", " " );
+		} else if ( schemaFileName.find( "://" ) != string::npos ) {
+			continue;
+		}
+
+		boost::system::error_code error;
+		auto schemaFile = boost::filesystem::canonical( schemaFileName, boost::filesystem::absolute( xmlFile ).parent_path(), error );
+		if ( !error ) {
+			schemaLocations.push_back( make_pair( location.first, schemaFile ) );
+		}
+	}
+
+	return schemaLocations;
+}
+
+
 /** @brief		Standard constructor
 *	@remarks								None
 */
@@ -59,26 +316,27 @@ Utilities::XML::CXMLValidator::~CXMLValidator()
 */
 void Utilities::XML::CXMLValidator::ValidateSchema( const boost::filesystem::path& xmlFile, const std::pair<std::string, boost::filesystem::path>& xmlSchemaLocation )
 {
-	using namespace xercesc;
-
-	std::string location;
-	CParserErrorHandler parserErrorHandler;
-	XercesDOMParser domParser;
-
-	// set up the XML-parser
-	domParser.setErrorHandler( &parserErrorHandler );
-	domParser.setValidationScheme( XercesDOMParser::Val_Auto );
-	domParser.setDoNamespaces( true );
-	domParser.setDoSchema( true );
-	domParser.setValidationConstraintFatal( true );
-	if ( xmlSchemaLocation != std::pair<std::string, boost::filesystem::path>()  ) {
-		location = "file:///" + xmlSchemaLocation.second.string();
-		boost::replace_all( location, " ", "%20" ); // URI-encoding of whitespaces
-		domParser.setExternalSchemaLocation( ( xmlSchemaLocation.first + " " +  location ).c_str() );
+	std::ifstream xmlFileStream( xmlFile.string(), std::ios::binary );
+	if ( !xmlFileStream ) {
+		throw Exception::xml_error( "error:\tThe file cannot be opened." );
 	}
+	std::string xmlContent( ( std::istreambuf_iterator<char>( xmlFileStream ) ), std::istreambuf_iterator<char>() );
+
+	ValidateSchema( xmlContent, xmlFile, xmlSchemaLocation );
+}
 
-	// validate the XML-file
-	domParser.parse( xmlFile.string().c_str() ); // will throw Utilities::Exception::xml_error in case of a parsing error
+
+/** @brief		Validates the content of a XML-file if it fullfills its XML schema
+*	@param		xmlContent					Content of the XML-file to be validated
+*	@param		xmlFile						Name of the XML-file, relative schema locations within the file are resolved with respect to it
+*	@param		xmlSchemaLocation			External XML schema location (XML namespace, XSD file location) to be used instead of that possibly defined in the XML-file. Omit it, if that defined in the XML-file should be used.
+*	@return									None
+*	@exception	Exception:xml_error			Thrown if the XML-file is invalid or not well-formed
+*	@remarks								This allows to read a file only once for the validation and the deserialization
+*/
+void Utilities::XML::CXMLValidator::ValidateSchema( const std::string& xmlContent, const boost::filesystem::path& xmlFile, const std::pair<std::string, boost::filesystem::path>& xmlSchemaLocation )
+{
+	CValidationParser::Instance().Validate( xmlContent, xmlFile, xmlSchemaLocation );
 }
 
 
@@ -15,6 +15,8 @@ You should have received a copy of the GNU General Public License
 along with this program.If not, see <http://www.gnu.org/licenses/>
 */
 #pragma once
+#include <string>
+#include <utility>
 #include <boost/filesystem.hpp>
 
 #if defined _WIN32 || defined __CYGWIN__
@@ -46,7 +48,7 @@ along with this program.If not, see <http://www.gnu.org/licenses/>
 namespace Utilities {
 	namespace XML {
 		/**	\ingroup Utilities
-		*	Class for validating a XML-file.
+		*	Class for validating a XML-file. All validators share a single streaming parser caching the compiled XML schemas, so a schema is only read once.
 		*/
 		class CXMLValidator
 		{
@@ -54,6 +56,7 @@ namespace Utilities {
 			UTILITY_API CXMLValidator();
 			UTILITY_API virtual ~CXMLValidator();
 			UTILITY_API void ValidateSchema( const boost::filesystem::path& xmlFile, const std::pair<std::string, boost::filesystem::path>& xmlSchemaLocation = std::pair< std::string, boost::filesystem::path>() );
+			UTILITY_API void ValidateSchema( const std::string& xmlContent, const boost::filesystem::path& xmlFile, const std::pair<std::string, boost::filesystem::path>& xmlSchemaLocation = std::pair< std::string, boost::filesystem::path>() );
 			UTILITY_API static void GetXercesVersion( std::string& versionString, std::string& dateString, std::string& licenseText );
 		private:
 			CXMLValidator( const CXMLValidator& ) = delete;